@@ -27,6 +27,11 @@ if (MKL_FOUND)
     target_include_directories(${LIBRARY_NAME} PRIVATE ${MKL_INCLUDE_DIRS})
 endif()
 
+# Include OpenMP (optional)
+if (OpenMP_CXX_FOUND)
+    target_link_libraries(${LIBRARY_NAME} PUBLIC OpenMP::OpenMP_CXX)
+endif()
+
 # Include librt
 target_link_libraries(${LIBRARY_NAME} PUBLIC rt)
 
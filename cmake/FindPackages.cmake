@@ -16,6 +16,9 @@ find_package(cpputil 1.5.1 REQUIRED)
 # Find numopt
 find_package(numopt 1.5.1 REQUIRED)
 
+# Find OpenMP (optional): used for the thread-parallel CI routines
+find_package(OpenMP)
+
 # Find doxygen
 if(BUILD_DOCS)
     find_package(Doxygen REQUIRED dot)
@@ -28,23 +28,34 @@ set(PROJECT_SOURCE_FOLDER ${CMAKE_SOURCE_DIR}/src)
 
 # Find the source files
 set(PROJECT_SOURCE_FILES
+        ${PROJECT_SOURCE_FOLDER}/CISolver/BlockDavidsonSolver.cpp
+        ${PROJECT_SOURCE_FOLDER}/CISolver/CIPSI.cpp
         ${PROJECT_SOURCE_FOLDER}/CISolver/CISolver.cpp
+        ${PROJECT_SOURCE_FOLDER}/CISolver/DavidsonCheckpoint.cpp
+        ${PROJECT_SOURCE_FOLDER}/CISolver/EpsteinNesbetPT2.cpp
+        ${PROJECT_SOURCE_FOLDER}/CISolver/ExcitationGenerator.cpp
+        ${PROJECT_SOURCE_FOLDER}/CISolver/HeatBathScreening.cpp
         ${PROJECT_SOURCE_FOLDER}/AP1roG/AP1roG.cpp
         ${PROJECT_SOURCE_FOLDER}/AP1roG/AP1roGGeminalCoefficients.cpp
         ${PROJECT_SOURCE_FOLDER}/AP1roG/AP1roGJacobiOrbitalOptimizer.cpp
         ${PROJECT_SOURCE_FOLDER}/AP1roG/AP1roGPSESolver.cpp
         ${PROJECT_SOURCE_FOLDER}/FockSpace/BaseFockSpace.cpp
         ${PROJECT_SOURCE_FOLDER}/FockSpace/FockSpace.cpp
+        ${PROJECT_SOURCE_FOLDER}/FockSpace/FockSpacePartition.cpp
         ${PROJECT_SOURCE_FOLDER}/FockSpace/ONV.cpp
         ${PROJECT_SOURCE_FOLDER}/FockSpace/ProductFockSpace.cpp
         ${PROJECT_SOURCE_FOLDER}/FockSpace/SelectedFockSpace.cpp
+        ${PROJECT_SOURCE_FOLDER}/HamiltonianBuilder/DiagonalEngine.cpp
         ${PROJECT_SOURCE_FOLDER}/HamiltonianBuilder/DOCI.cpp
         ${PROJECT_SOURCE_FOLDER}/HamiltonianBuilder/FCI.cpp
         ${PROJECT_SOURCE_FOLDER}/HamiltonianBuilder/HamiltonianBuilder.cpp
         ${PROJECT_SOURCE_FOLDER}/HamiltonianBuilder/Hubbard.cpp
+        ${PROJECT_SOURCE_FOLDER}/HamiltonianBuilder/HubbardMomentumSector.cpp
+        ${PROJECT_SOURCE_FOLDER}/HamiltonianBuilder/SelectedCI.cpp
         ${PROJECT_SOURCE_FOLDER}/HamiltonianParameters/BaseHamiltonianParameters.cpp
         ${PROJECT_SOURCE_FOLDER}/HamiltonianParameters/HamiltonianParameters.cpp
         ${PROJECT_SOURCE_FOLDER}/HamiltonianParameters/HamiltonianParameters_constructors.cpp
+        ${PROJECT_SOURCE_FOLDER}/HamiltonianParameters/ModelHamiltonianParameters.cpp
         ${PROJECT_SOURCE_FOLDER}/Operator/BaseOperator.cpp
         ${PROJECT_SOURCE_FOLDER}/Operator/OneElectronOperator.cpp
         ${PROJECT_SOURCE_FOLDER}/Operator/TwoElectronOperator.cpp
@@ -63,6 +74,10 @@ set(PROJECT_SOURCE_FILES
         ${PROJECT_SOURCE_FOLDER}/RHF/PlainRHFSCFSolver.cpp
         ${PROJECT_SOURCE_FOLDER}/RHF/RHF.cpp
         ${PROJECT_SOURCE_FOLDER}/RHF/RHFSCFSolver.cpp
+        ${PROJECT_SOURCE_FOLDER}/WaveFunction/BinaryWaveFunctionFormat.cpp
+        ${PROJECT_SOURCE_FOLDER}/WaveFunction/BinaryWaveFunctionReader.cpp
+        ${PROJECT_SOURCE_FOLDER}/WaveFunction/BinaryWaveFunctionWriter.cpp
+        ${PROJECT_SOURCE_FOLDER}/WaveFunction/SparseWaveFunction.cpp
         ${PROJECT_SOURCE_FOLDER}/WaveFunction/WaveFunction.cpp
         ${PROJECT_SOURCE_FOLDER}/WaveFunction/WaveFunctionReader.cpp
         ${PROJECT_SOURCE_FOLDER}/AOBasis.cpp
@@ -80,7 +95,13 @@ set(PROJECT_INCLUDE_FOLDER ${CMAKE_SOURCE_DIR}/include)
 
 # Find the header files
 set(PROJECT_INCLUDE_FILES
+        ${PROJECT_INCLUDE_FOLDER}/CISolver/BlockDavidsonSolver.hpp
+        ${PROJECT_INCLUDE_FOLDER}/CISolver/CIPSI.hpp
         ${PROJECT_INCLUDE_FOLDER}/CISolver/CISolver.hpp
+        ${PROJECT_INCLUDE_FOLDER}/CISolver/DavidsonCheckpoint.hpp
+        ${PROJECT_INCLUDE_FOLDER}/CISolver/EpsteinNesbetPT2.hpp
+        ${PROJECT_INCLUDE_FOLDER}/CISolver/ExcitationGenerator.hpp
+        ${PROJECT_INCLUDE_FOLDER}/CISolver/HeatBathScreening.hpp
         ${PROJECT_INCLUDE_FOLDER}/AP1roG/AP1roG.hpp
         ${PROJECT_INCLUDE_FOLDER}/AP1roG/AP1roGGeminalCoefficients.hpp
         ${PROJECT_INCLUDE_FOLDER}/AP1roG/AP1roGJacobiOrbitalOptimizer.hpp
@@ -88,17 +109,22 @@ set(PROJECT_INCLUDE_FILES
         ${PROJECT_INCLUDE_FOLDER}/FockSpace/BaseFockSpace.hpp
         ${PROJECT_INCLUDE_FOLDER}/FockSpace/Configuration.hpp
         ${PROJECT_INCLUDE_FOLDER}/FockSpace/FockSpace.hpp
+        ${PROJECT_INCLUDE_FOLDER}/FockSpace/FockSpacePartition.hpp
         ${PROJECT_INCLUDE_FOLDER}/FockSpace/FockSpaceType.hpp
         ${PROJECT_INCLUDE_FOLDER}/FockSpace/ONV.hpp
         ${PROJECT_INCLUDE_FOLDER}/FockSpace/SelectedFockSpace.hpp
         ${PROJECT_INCLUDE_FOLDER}/FockSpace/ProductFockSpace.hpp
+        ${PROJECT_INCLUDE_FOLDER}/HamiltonianBuilder/DiagonalEngine.hpp
         ${PROJECT_INCLUDE_FOLDER}/HamiltonianBuilder/DOCI.hpp
         ${PROJECT_INCLUDE_FOLDER}/HamiltonianBuilder/FCI.hpp
         ${PROJECT_INCLUDE_FOLDER}/HamiltonianBuilder/HamiltonianBuilder.hpp
         ${PROJECT_INCLUDE_FOLDER}/HamiltonianBuilder/Hubbard.hpp
+        ${PROJECT_INCLUDE_FOLDER}/HamiltonianBuilder/HubbardMomentumSector.hpp
+        ${PROJECT_INCLUDE_FOLDER}/HamiltonianBuilder/SelectedCI.hpp
         ${PROJECT_INCLUDE_FOLDER}/HamiltonianParameters/BaseHamiltonianParameters.hpp
         ${PROJECT_INCLUDE_FOLDER}/HamiltonianParameters/HamiltonianParameters.hpp
         ${PROJECT_INCLUDE_FOLDER}/HamiltonianParameters/HamiltonianParameters_constructors.hpp
+        ${PROJECT_INCLUDE_FOLDER}/HamiltonianParameters/ModelHamiltonianParameters.hpp
         ${PROJECT_INCLUDE_FOLDER}/Operator/BaseOperator.hpp
         ${PROJECT_INCLUDE_FOLDER}/Operator/OneElectronOperator.hpp
         ${PROJECT_INCLUDE_FOLDER}/Operator/TwoElectronOperator.hpp
@@ -117,6 +143,10 @@ set(PROJECT_INCLUDE_FILES
         ${PROJECT_INCLUDE_FOLDER}/RHF/PlainRHFSCFSolver.hpp
         ${PROJECT_INCLUDE_FOLDER}/RHF/RHF.hpp
         ${PROJECT_INCLUDE_FOLDER}/RHF/RHFSCFSolver.hpp
+        ${PROJECT_INCLUDE_FOLDER}/WaveFunction/BinaryWaveFunctionFormat.hpp
+        ${PROJECT_INCLUDE_FOLDER}/WaveFunction/BinaryWaveFunctionReader.hpp
+        ${PROJECT_INCLUDE_FOLDER}/WaveFunction/BinaryWaveFunctionWriter.hpp
+        ${PROJECT_INCLUDE_FOLDER}/WaveFunction/SparseWaveFunction.hpp
         ${PROJECT_INCLUDE_FOLDER}/WaveFunction/WaveFunction.hpp
         ${PROJECT_INCLUDE_FOLDER}/AOBasis.hpp
         ${PROJECT_INCLUDE_FOLDER}/Atom.hpp
@@ -135,6 +165,8 @@ set(PROJECT_TESTS_FOLDER ${CMAKE_SOURCE_DIR}/tests)
 
 # Find the source files for the tests
 set(PROJECT_TEST_SOURCE_FILES
+        ${PROJECT_TESTS_FOLDER}/CISolver/BlockDavidsonSolver_test.cpp
+        ${PROJECT_TESTS_FOLDER}/CISolver/CIPSI_test.cpp
         ${PROJECT_TESTS_FOLDER}/CISolver/CISolver_DOCI_Davidson_test.cpp
         ${PROJECT_TESTS_FOLDER}/CISolver/CISolver_DOCI_Dense_test.cpp
         ${PROJECT_TESTS_FOLDER}/CISolver/CISolver_FCI_Davidson_test.cpp
@@ -142,19 +174,27 @@ set(PROJECT_TEST_SOURCE_FILES
         ${PROJECT_TESTS_FOLDER}/CISolver/CISolver_Hubbard_Davidson_test.cpp
         ${PROJECT_TESTS_FOLDER}/CISolver/CISolver_Hubbard_Dense_test.cpp
         ${PROJECT_TESTS_FOLDER}/CISolver/CISolver_test.cpp
+        ${PROJECT_TESTS_FOLDER}/CISolver/DavidsonCheckpoint_test.cpp
+        ${PROJECT_TESTS_FOLDER}/CISolver/EpsteinNesbetPT2_test.cpp
+        ${PROJECT_TESTS_FOLDER}/CISolver/HeatBathScreening_test.cpp
         ${PROJECT_TESTS_FOLDER}/AP1roG/AP1roG_test.cpp
         ${PROJECT_TESTS_FOLDER}/AP1roG/AP1roGGeminalCoefficients_test.cpp
         ${PROJECT_TESTS_FOLDER}/AP1roG/OO_AP1roG_test.cpp
         ${PROJECT_TESTS_FOLDER}/AP1roG/AP1roGPSESolver_test.cpp
         ${PROJECT_TESTS_FOLDER}/FockSpace/FockSpace_test.cpp
+        ${PROJECT_TESTS_FOLDER}/FockSpace/FockSpacePartition_test.cpp
         ${PROJECT_TESTS_FOLDER}/FockSpace/ONV_test.cpp
         ${PROJECT_TESTS_FOLDER}/FockSpace/SelectedFockSpace_test.cpp
         ${PROJECT_TESTS_FOLDER}/FockSpace/ProductFockSpace_test.cpp
+        ${PROJECT_TESTS_FOLDER}/HamiltonianBuilder/DiagonalEngine_test.cpp
         ${PROJECT_TESTS_FOLDER}/HamiltonianBuilder/DOCI_test.cpp
         ${PROJECT_TESTS_FOLDER}/HamiltonianBuilder/FCI_test.cpp
         ${PROJECT_TESTS_FOLDER}/HamiltonianBuilder/Hubbard_test.cpp
+        ${PROJECT_TESTS_FOLDER}/HamiltonianBuilder/HubbardMomentumSector_test.cpp
+        ${PROJECT_TESTS_FOLDER}/HamiltonianBuilder/SelectedCI_test.cpp
         ${PROJECT_TESTS_FOLDER}/HamiltonianParameters/HamiltonianParameters_test.cpp
         ${PROJECT_TESTS_FOLDER}/HamiltonianParameters/HamiltonianParameters_constructors_test.cpp
+        ${PROJECT_TESTS_FOLDER}/HamiltonianParameters/ModelHamiltonianParameters_test.cpp
         ${PROJECT_TESTS_FOLDER}/Operator/OneElectronOperator_test.cpp
         ${PROJECT_TESTS_FOLDER}/Operator/TwoElectronOperator_test.cpp
         ${PROJECT_TESTS_FOLDER}/properties/expectation_values_test.cpp
@@ -166,6 +206,8 @@ set(PROJECT_TEST_SOURCE_FILES
         ${PROJECT_TESTS_FOLDER}/RHF/DIISRHFSCFSolver_test.cpp
         ${PROJECT_TESTS_FOLDER}/RHF/PlainRHFSCFSolver_test.cpp
         ${PROJECT_TESTS_FOLDER}/RHF/RHF_test.cpp
+        ${PROJECT_TESTS_FOLDER}/WaveFunction/BinaryWaveFunction_test.cpp
+        ${PROJECT_TESTS_FOLDER}/WaveFunction/SparseWaveFunction_test.cpp
         ${PROJECT_TESTS_FOLDER}/AOBasis_test.cpp
         ${PROJECT_TESTS_FOLDER}/Atom_test.cpp
         ${PROJECT_TESTS_FOLDER}/elements_test.cpp
@@ -0,0 +1,148 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2018  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#ifndef GQCP_BLOCKDAVIDSONSOLVER_HPP
+#define GQCP_BLOCKDAVIDSONSOLVER_HPP
+
+
+#include "CISolver/DavidsonCheckpoint.hpp"
+#include "HamiltonianBuilder/HamiltonianBuilder.hpp"
+#include "HamiltonianBuilder/Hubbard.hpp"
+#include "HamiltonianParameters/HamiltonianParameters.hpp"
+#include "HamiltonianParameters/ModelHamiltonianParameters.hpp"
+
+#include <numopt.hpp>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace GQCP {
+
+
+/**
+ *  A struct that holds options for a block Davidson calculation
+ */
+struct BlockDavidsonSolverOptions {
+    size_t number_of_requested_eigenpairs = 1;
+
+    double residue_tolerance = 1.0e-08;  // a root is converged (and locked) if the norm of its residual vector is smaller than this tolerance
+    double correction_threshold = 1.0e-12;  // correction vectors whose norm (after orthogonalization) is smaller than this threshold are discarded
+
+    size_t maximum_subspace_dimension = 0;  // the subspace is restarted if it would grow beyond this dimension: 0 means 8 times the number of requested eigenpairs (but at least 16)
+    size_t collapsed_subspace_dimension = 0;  // the subspace is (thick-)restarted onto this number of lowest Ritz vectors: 0 means 2 times the number of requested eigenpairs
+    size_t maximum_number_of_iterations = 128;  // the maximum number of iterations of one call to solve(), also when resuming from a checkpoint
+
+    Eigen::MatrixXd X_0;  // the initial guesses (as columns): if empty, the unit vectors of the (collapsed subspace dimension) lowest diagonal elements are used
+
+    std::string checkpoint_filename;  // if not empty, the state of the solver is written to this file every checkpoint_interval iterations
+    size_t checkpoint_interval = 1;
+
+    std::string restart_filename;  // if not empty, the solver is resumed from this checkpoint file instead of starting from X_0
+    bool restart_from_ritz_vectors = false;  // if true, only the locked vectors and the lowest Ritz vectors of the checkpoint are used as initial guesses: the sigma vectors aren't read, but have to be recalculated
+};
+
+
+/**
+ *  A block Davidson solver for the lowest eigenpairs of the CI eigenvalue problem related to a HamiltonianBuilder, or to a Hubbard HamiltonianBuilder and (sparse) model Hamiltonian parameters
+ *
+ *  Every iteration
+ *      1. solves the Rayleigh-Ritz problem in the current subspace
+ *      2. locks the roots whose residual is converged: they are removed from the subspace and every new correction vector is kept orthogonal to them, so they don't require any more matrix-vector products
+ *      3. calculates the diagonally preconditioned correction vectors of all unconverged roots, and orthogonalizes them against the locked roots and the subspace with (twice repeated) blocked Gram-Schmidt
+ *      4. expands the subspace with the action of the Hamiltonian on all correction vectors at once (see HamiltonianBuilder::blockMatrixVectorProduct())
+ *  If the subspace would grow beyond its maximum dimension, it is thick-restarted onto the lowest Ritz vectors
+ *
+ *  The subspace, its sigma vectors, the projected matrix and the locked roots can be checkpointed periodically (see DavidsonCheckpoint), so that a later solve can resume from them
+ */
+class BlockDavidsonSolver {
+private:
+    size_t dim;  // the dimension of the Fock space
+    std::function<Eigen::VectorXd ()> calculateDiagonal;  // calculates the diagonal of the Hamiltonian matrix
+    std::function<Eigen::MatrixXd (const Eigen::MatrixXd&, const Eigen::VectorXd&)> blockMatrixVectorProduct;  // calculates the action of the Hamiltonian on a block of vectors (as columns), given its diagonal
+    std::function<uint64_t (const Eigen::VectorXd&)> calculateHamiltonianFingerprint;  // calculates the fingerprint of the Hamiltonian, given its diagonal (see DavidsonCheckpoint::calculateHamiltonianFingerprint())
+    BlockDavidsonSolverOptions options;
+
+    bool is_converged = false;
+    size_t number_of_iterations = 0;
+    size_t number_of_matrix_vector_products = 0;
+    std::vector<numopt::eigenproblem::Eigenpair> eigenpairs;  // eigenvalues and -vectors, in increasing order of the eigenvalues
+
+
+    // PRIVATE METHODS
+    /**
+     *  Orthogonalize the columns of T against the orthonormal columns of Q (in place), with two passes of blocked classical Gram-Schmidt
+     *
+     *  @param Q        the orthonormal vectors
+     *  @param T        the vectors that should be orthogonalized
+     */
+    static void orthogonalizeAgainst(const Eigen::MatrixXd& Q, Eigen::MatrixXd& T);
+
+    /**
+     *  Fill in the default subspace dimensions and check the options against the dimension of the Fock space
+     */
+    void initializeOptions();
+
+    /**
+     *  Orthonormalize the columns of T among themselves (in place) with modified Gram-Schmidt, dropping the columns whose norm drops below the correction threshold
+     *
+     *  @param T        the vectors that should be orthonormalized
+     */
+    void orthonormalize(Eigen::MatrixXd& T) const;
+
+
+public:
+    // CONSTRUCTORS
+    /**
+     *  @param hamiltonian_builder      the HamiltonianBuilder for which the CI eigenvalue problem should be solved
+     *  @param hamiltonian_parameters   the Hamiltonian parameters in an orthonormal basis
+     *  @param options                  the options for the block Davidson solver
+     */
+    BlockDavidsonSolver(HamiltonianBuilder& hamiltonian_builder, const HamiltonianParameters& hamiltonian_parameters, const BlockDavidsonSolverOptions& options = BlockDavidsonSolverOptions());
+
+    /**
+     *  @param hubbard                  the Hubbard HamiltonianBuilder for which the CI eigenvalue problem should be solved
+     *  @param model_parameters         the (sparse) model Hamiltonian parameters, which are used directly, i.e. without constructing the (K^4) two-electron integrals
+     *  @param options                  the options for the block Davidson solver
+     */
+    BlockDavidsonSolver(Hubbard& hubbard, const ModelHamiltonianParameters& model_parameters, const BlockDavidsonSolverOptions& options = BlockDavidsonSolverOptions());
+
+
+    // GETTERS
+    bool converged() const { return this->is_converged; }
+    size_t get_number_of_iterations() const { return this->number_of_iterations; }
+    size_t get_number_of_matrix_vector_products() const { return this->number_of_matrix_vector_products; }
+    const std::vector<numopt::eigenproblem::Eigenpair>& get_eigenpairs() const { return this->eigenpairs; }
+    const numopt::eigenproblem::Eigenpair& get_eigenpair(size_t index = 0) const { return this->eigenpairs[index]; }
+
+
+    // PUBLIC METHODS
+    /**
+     *  Solve the CI eigenvalue problem for the lowest eigenpairs
+     *
+     *  Throws if the requested eigenpairs are not converged within the maximum number of iterations
+     */
+    void solve();
+};
+
+
+}  // namespace GQCP
+
+
+#endif  // GQCP_BLOCKDAVIDSONSOLVER_HPP
@@ -0,0 +1,122 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2018  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#ifndef GQCP_CIPSI_HPP
+#define GQCP_CIPSI_HPP
+
+
+#include "CISolver/ExcitationGenerator.hpp"
+#include "FockSpace/SelectedFockSpace.hpp"
+#include "HamiltonianParameters/HamiltonianParameters.hpp"
+#include "WaveFunction/WaveFunction.hpp"
+
+
+namespace GQCP {
+
+
+/**
+ *  A struct that holds options for a CIPSI calculation
+ */
+struct CIPSIOptions {
+    double growth_fraction = 1.0;  // in every iteration, the dimension of the selected space grows by (at least one and) this fraction of its current dimension
+    size_t maximum_dimension = 1000000;  // the selected space does not grow beyond this dimension
+    size_t maximum_number_of_iterations = 32;
+
+    double energy_convergence_threshold = 1.0e-08;  // the calculation is converged if the variational energy changes less than this threshold between two iterations
+    double pt2_convergence_threshold = 1.0e-08;  // the calculation is converged if the (absolute value of the) perturbative correction is smaller than this threshold
+
+    size_t dense_dimension_threshold = 1000;  // selected spaces up to this dimension are diagonalized with a dense solver, larger ones with Davidson
+
+    double heat_bath_threshold = 0.0;  // if positive, the double excitations of a selected configuration I are only generated if |c_I| times the magnitude of their two-electron integrals is at least this threshold (see HeatBathScreening)
+};
+
+
+/**
+ *  A class that performs an iterative selected CI calculation in the spirit of CIPSI (configuration interaction using a perturbative selection done iteratively)
+ *
+ *  Every iteration
+ *      1. diagonalizes the Hamiltonian in the current selected space, giving the variational energy E and the coefficients c_I
+ *      2. generates all external configurations |a> (outside of the selected space) that are singly or doubly excited with respect to a selected configuration. Optionally, the double excitations are screened in heat-bath order.
+ *      3. scores every external configuration with its Epstein-Nesbet perturbative contribution e_a = |<a|H|Psi>|^2 / (E - <a|H|a>), whose sum is the PT2 correction to E (see EpsteinNesbetPT2)
+ *      4. adds the externals with the largest |e_a| to the selected space
+ *  until the energy or the PT2 criterion is met, or until the maximum dimension or number of iterations is reached
+ */
+class CIPSI {
+private:
+    HamiltonianParameters hamiltonian_parameters;
+    SelectedFockSpace fock_space;  // the current selected space
+    CIPSIOptions options;
+    ExcitationGenerator excitation_generator;  // generates the external configurations, with heat-bath screening if options.heat_bath_threshold is positive
+
+    bool is_converged = false;
+    size_t number_of_iterations = 0;
+    double energy = 0.0;  // the variational energy in the current selected space
+    double pt2_energy = 0.0;  // the Epstein-Nesbet PT2 correction to the variational energy
+    Eigen::VectorXd coefficients;  // the ground state coefficients in the current selected space
+
+
+    // PRIVATE METHODS
+    /**
+     *  Diagonalize the Hamiltonian in the current selected space, and update the energy, coefficients and (canonically ordered) selected space
+     */
+    void diagonalize();
+
+    /**
+     *  Generate and score the external configurations, and update the PT2 correction
+     *
+     *  @param externals            the external configurations that are found
+     *  @param contributions        the perturbative contributions of the external configurations
+     */
+    void scoreExternalConfigurations(SelectedFockSpace& externals, std::vector<double>& contributions);
+
+
+public:
+    // CONSTRUCTORS
+    /**
+     *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+     *  @param initial_fock_space           the initial selected space, e.g. only the Hartree-Fock configuration
+     *  @param options                      the options for the CIPSI calculation
+     */
+    CIPSI(const HamiltonianParameters& hamiltonian_parameters, const SelectedFockSpace& initial_fock_space, const CIPSIOptions& options = CIPSIOptions());
+
+
+    // GETTERS
+    const SelectedFockSpace& get_fock_space() const { return this->fock_space; }
+    const Eigen::VectorXd& get_coefficients() const { return this->coefficients; }
+    double get_energy() const { return this->energy; }
+    double get_pt2_energy() const { return this->pt2_energy; }
+    size_t get_number_of_iterations() const { return this->number_of_iterations; }
+    bool converged() const { return this->is_converged; }
+
+
+    // PUBLIC METHODS
+    /**
+     *  Grow the selected space until one of the convergence criteria is met, or until the maximum dimension or number of iterations is reached
+     */
+    void solve();
+
+    /**
+     *  @return the ground state wave function in the current selected space
+     */
+    WaveFunction get_wavefunction();
+};
+
+
+}  // namespace GQCP
+
+
+#endif  // GQCP_CIPSI_HPP
@@ -20,23 +20,32 @@
 
 
 
+#include "CISolver/BlockDavidsonSolver.hpp"
 #include "HamiltonianBuilder/HamiltonianBuilder.hpp"
+#include "HamiltonianBuilder/Hubbard.hpp"
 #include "HamiltonianParameters/HamiltonianParameters.hpp"
+#include "HamiltonianParameters/ModelHamiltonianParameters.hpp"
 #include "WaveFunction/WaveFunction.hpp"
 
 #include <numopt.hpp>
 
+#include <functional>
+
 
 namespace GQCP {
 
 
 /**
- *  A class which solves the CI eigenvalue problem related to a HamiltonianBuilder
+ *  A class which solves the CI eigenvalue problem related to a HamiltonianBuilder, or to a Hubbard HamiltonianBuilder and (sparse) model Hamiltonian parameters
  */
 class CISolver {
 private:
     HamiltonianBuilder* hamiltonian_builder;
-    HamiltonianParameters hamiltonian_parameters;
+
+    std::function<Eigen::MatrixXd ()> constructHamiltonian;  // constructs the Hamiltonian matrix
+    std::function<Eigen::VectorXd ()> calculateDiagonal;  // calculates the diagonal of the Hamiltonian matrix
+    std::function<Eigen::VectorXd (const Eigen::VectorXd&, const Eigen::VectorXd&)> matrixVectorProduct;  // calculates the action of the Hamiltonian on a vector, given its diagonal
+    std::function<BlockDavidsonSolver (const BlockDavidsonSolverOptions&)> createBlockDavidsonSolver;  // creates a BlockDavidsonSolver for the Hamiltonian with the given options
 
     std::vector<numopt::eigenproblem::Eigenpair> eigenpairs;  // eigenvalues and -vectors
 
@@ -48,6 +57,12 @@ public:
      */
     CISolver(HamiltonianBuilder& hamiltonian_builder, const HamiltonianParameters& hamiltonian_parameters);
 
+    /**
+     *  @param hubbard                  the Hubbard HamiltonianBuilder for which the CI eigenvalue problem should be solved
+     *  @param model_parameters         the (sparse) model Hamiltonian parameters, which are used directly, i.e. without constructing the (K^4) two-electron integrals
+     */
+    CISolver(Hubbard& hubbard, const ModelHamiltonianParameters& model_parameters);
+
 
     // GETTERS
     const std::vector<numopt::eigenproblem::Eigenpair>& get_eigenpairs() const { return this->eigenpairs; }
@@ -62,6 +77,13 @@ public:
      */
     void solve(numopt::eigenproblem::BaseSolverOptions& solver_options);
 
+    /**
+     *  @param block_davidson_options       the options for a block Davidson solver
+     *
+     *  Solve the CI eigenvalue problem with the native BlockDavidsonSolver and set the eigenpairs internally. Long solves can be checkpointed and resumed through the options.
+     */
+    void solve(const BlockDavidsonSolverOptions& block_davidson_options);
+
     /**
      *  @param index        the index of the index-th excited state
      *
@@ -0,0 +1,165 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2018  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#ifndef GQCP_DAVIDSONCHECKPOINT_HPP
+#define GQCP_DAVIDSONCHECKPOINT_HPP
+
+
+#include "common.hpp"
+#include "HamiltonianParameters/HamiltonianParameters.hpp"
+#include "HamiltonianParameters/ModelHamiltonianParameters.hpp"
+
+#include <Eigen/Dense>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+
+namespace GQCP {
+
+
+/**
+ *  The header of the binary checkpoint format of the BlockDavidsonSolver
+ *
+ *  A checkpoint file consists of this (72-byte) header, followed by the column-major doubles of the subspace vectors, their sigma vectors, the projected (subspace) matrix, the locked vectors and the locked eigenvalues. All values are stored in the byte order of the machine that wrote the file.
+ *
+ *  The checksums are running 64-bit FNV-1a-style hashes (see updateFNVChecksum()) over the bit patterns of the stored doubles, in the order of the file: one over the sigma vectors and one over all the other data, so that a restart from Ritz vectors can skip the sigma vectors
+ */
+struct DavidsonCheckpointHeader {
+    static constexpr uint32_t current_version = 1;
+    static constexpr uint64_t initial_checksum = fnv_offset_basis;
+
+    char magic[8];  // "GQCPDAV" followed by a null character
+    uint32_t version;  // the version of the format
+    uint32_t number_of_requested_eigenpairs;
+    uint64_t dimension;  // the dimension of the Fock space
+    uint64_t subspace_dimension;  // the number of subspace vectors
+    uint64_t number_of_locked_vectors;
+    uint32_t number_of_iterations;  // the number of iterations after which the checkpoint was written
+    uint32_t number_of_matrix_vector_products;  // the number of matrix-vector products after which the checkpoint was written
+    uint64_t checksum;  // the checksum over all data except the sigma vectors
+    uint64_t sigma_checksum;  // the checksum over the sigma vectors
+    uint64_t hamiltonian_fingerprint;  // the fingerprint of the Hamiltonian whose eigenproblem was being solved (see DavidsonCheckpoint::calculateHamiltonianFingerprint())
+
+
+    // PUBLIC METHODS
+    /**
+     *  @return if the header starts with the magic characters of the format
+     */
+    bool hasValidMagic() const;
+};
+
+
+static_assert(sizeof(DavidsonCheckpointHeader) == 72, "The header of the Davidson checkpoint format should occupy 72 bytes.");
+
+
+/**
+ *  The state of a BlockDavidsonSolver, which can be written to and read from a binary checkpoint file (see DavidsonCheckpointHeader)
+ */
+class DavidsonCheckpoint {
+private:
+    size_t number_of_requested_eigenpairs;
+    uint64_t hamiltonian_fingerprint;
+    size_t number_of_iterations;
+    size_t number_of_matrix_vector_products;
+
+    Eigen::MatrixXd V;  // the orthonormal subspace vectors (as columns)
+    Eigen::MatrixXd AV;  // the sigma vectors (the action of the Hamiltonian on the subspace vectors), empty if they weren't read
+    Eigen::MatrixXd S;  // the projected matrix V^T A V
+    Eigen::MatrixXd X_locked;  // the locked (converged) eigenvectors (as columns)
+    Eigen::VectorXd locked_eigenvalues;
+
+
+public:
+    // CONSTRUCTORS
+    /**
+     *  @param number_of_requested_eigenpairs       the number of eigenpairs that the solver was asked for
+     *  @param hamiltonian_fingerprint              the fingerprint of the Hamiltonian whose eigenproblem is being solved
+     *  @param number_of_iterations                 the number of iterations that have been performed
+     *  @param number_of_matrix_vector_products     the number of matrix-vector products that have been performed
+     *  @param V                                    the orthonormal subspace vectors (as columns)
+     *  @param AV                                   the sigma vectors (as columns), which may be empty
+     *  @param S                                    the projected matrix V^T A V
+     *  @param X_locked                             the locked eigenvectors (as columns)
+     *  @param locked_eigenvalues                   the locked eigenvalues
+     */
+    DavidsonCheckpoint(size_t number_of_requested_eigenpairs, uint64_t hamiltonian_fingerprint, size_t number_of_iterations, size_t number_of_matrix_vector_products, const Eigen::MatrixXd& V, const Eigen::MatrixXd& AV, const Eigen::MatrixXd& S, const Eigen::MatrixXd& X_locked, const Eigen::VectorXd& locked_eigenvalues);
+
+
+    // GETTERS
+    size_t get_number_of_requested_eigenpairs() const { return this->number_of_requested_eigenpairs; }
+    uint64_t get_hamiltonian_fingerprint() const { return this->hamiltonian_fingerprint; }
+    size_t get_number_of_iterations() const { return this->number_of_iterations; }
+    size_t get_number_of_matrix_vector_products() const { return this->number_of_matrix_vector_products; }
+    size_t get_dimension() const { return this->V.rows(); }
+    const Eigen::MatrixXd& get_subspace_vectors() const { return this->V; }
+    const Eigen::MatrixXd& get_sigma_vectors() const { return this->AV; }
+    const Eigen::MatrixXd& get_projected_matrix() const { return this->S; }
+    const Eigen::MatrixXd& get_locked_vectors() const { return this->X_locked; }
+    const Eigen::VectorXd& get_locked_eigenvalues() const { return this->locked_eigenvalues; }
+
+
+    // PUBLIC METHODS
+    /**
+     *  @param number_of_ritz_vectors       the number of lowest Ritz vectors
+     *
+     *  @return the lowest Ritz vectors of the projected matrix in the checkpointed subspace, which don't require the sigma vectors
+     */
+    Eigen::MatrixXd calculateRitzVectors(size_t number_of_ritz_vectors) const;
+
+    /**
+     *  Write the checkpoint to a binary file
+     *
+     *  @param filename     the name of the checkpoint file that is (over)written
+     *
+     *  The checkpoint is first written to a temporary file, which then replaces the given one: a job that is interrupted while writing leaves the previous checkpoint intact
+     */
+    void writeToFile(const std::string& filename) const;
+
+
+    // STATIC PUBLIC METHODS
+    /**
+     *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+     *  @param diagonal                     the diagonal of the Hamiltonian matrix in the Fock space of the HamiltonianBuilder
+     *
+     *  @return a fingerprint of the Hamiltonian: a checksum over the bit patterns of the one- and two-electron integrals and of the diagonal, which also distinguishes between HamiltonianBuilders of the same dimension
+     */
+    static uint64_t calculateHamiltonianFingerprint(const HamiltonianParameters& hamiltonian_parameters, const Eigen::VectorXd& diagonal);
+
+    /**
+     *  @param model_parameters     the (sparse) model Hamiltonian parameters
+     *  @param diagonal             the diagonal of the Hamiltonian matrix in the Fock space of the HamiltonianBuilder
+     *
+     *  @return a fingerprint of the Hamiltonian: a checksum over the positions and bit patterns of the non-zero hoppings and inter-site repulsions, over the on-site repulsions and over the diagonal
+     */
+    static uint64_t calculateHamiltonianFingerprint(const ModelHamiltonianParameters& model_parameters, const Eigen::VectorXd& diagonal);
+
+    /**
+     *  @param filename                 the name of the checkpoint file
+     *  @param read_sigma_vectors       if the sigma vectors should be read: they aren't needed to restart from Ritz vectors
+     *
+     *  @return the checkpoint that is stored in the given file
+     */
+    static DavidsonCheckpoint readFromFile(const std::string& filename, bool read_sigma_vectors = true);
+};
+
+
+}  // namespace GQCP
+
+
+#endif  // GQCP_DAVIDSONCHECKPOINT_HPP
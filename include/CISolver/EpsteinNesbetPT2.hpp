@@ -0,0 +1,143 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2018  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#ifndef GQCP_EPSTEINNESBETPT2_HPP
+#define GQCP_EPSTEINNESBETPT2_HPP
+
+
+#include "CISolver/ExcitationGenerator.hpp"
+#include "FockSpace/SelectedFockSpace.hpp"
+#include "HamiltonianParameters/HamiltonianParameters.hpp"
+
+#include <vector>
+
+
+namespace GQCP {
+
+
+/**
+ *  A struct that holds options for a semistochastic PT2 calculation
+ */
+struct SemistochasticPT2Options {
+    size_t deterministic_dimension = 0;  // the number of selected configurations (with the largest |c_I|) whose contributions are treated deterministically
+    size_t number_of_batches = 1;  // the number of batches in which the external space of the deterministic part is partitioned
+
+    size_t number_of_samples = 100;  // the number of selected configurations that are drawn (with replacement, with a probability proportional to |c_I|) for every stochastic estimate
+    size_t number_of_sample_sets = 20;  // the number of independent stochastic estimates that are averaged
+    unsigned seed = 0;  // the seed of the random number generator
+};
+
+
+/**
+ *  A struct that holds a (stochastic) estimate of the PT2 correction and its standard error
+ */
+struct PT2Estimate {
+    double energy;
+    double error;
+};
+
+
+/**
+ *  A class that calculates the Epstein-Nesbet second-order perturbative (EN-PT2) correction
+ *      E_PT2 = sum_a |<a|H|Psi>|^2 / (E - <a|H|a>)
+ *  to the energy E of a selected CI wave function Psi = sum_I c_I |I>, in which the sum runs over all external configurations |a> that are coupled to Psi
+ *
+ *  The numerators <a|H|Psi> = sum_I <a|H|I> c_I are accumulated in a hashed set of external configurations. To bound the memory requirements, the external space can be partitioned into batches by the hash of its configurations: every batch is generated and summed separately.
+ *
+ *  For large selected spaces, the semistochastic estimate treats the configurations with the largest |c_I| deterministically, and samples the remainder of the correction with the unbiased estimator of Sharma et al. (J. Chem. Theory Comput. 2017, 13, 1595)
+ */
+class EpsteinNesbetPT2 {
+private:
+    HamiltonianParameters hamiltonian_parameters;
+    SelectedFockSpace fock_space;  // the selected space
+    Eigen::VectorXd coefficients;  // the coefficients of the wave function in the selected space
+    double energy;  // the variational energy of the wave function
+    ExcitationGenerator excitation_generator;
+
+
+    // PRIVATE METHODS
+    /**
+     *  Accumulate the numerators <a|H|Psi> for the external configurations of one batch
+     *
+     *  @param coefficients         the coefficients of the wave function Psi, which can be a part of the full wave function
+     *  @param batch_index          the index of the batch of external configurations
+     *  @param number_of_batches    the number of batches in which the external space is partitioned
+     *  @param externals            the external configurations of the batch
+     *  @param numerators           the numerators <a|H|Psi> of the external configurations
+     */
+    void accumulateNumerators(const Eigen::VectorXd& coefficients, size_t batch_index, size_t number_of_batches, SelectedFockSpace& externals, std::vector<double>& numerators) const;
+
+    /**
+     *  @param coefficients         the coefficients of the wave function Psi, which can be a part of the full wave function
+     *  @param number_of_batches    the number of batches in which the external space is partitioned
+     *
+     *  @return the EN-PT2 correction for the given wave function
+     */
+    double calculateDeterministic(const Eigen::VectorXd& coefficients, size_t number_of_batches) const;
+
+
+public:
+    // CONSTRUCTORS
+    /**
+     *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+     *  @param fock_space                   the selected space
+     *  @param coefficients                 the coefficients of the wave function in the selected space
+     *  @param energy                       the variational energy of the wave function
+     */
+    EpsteinNesbetPT2(const HamiltonianParameters& hamiltonian_parameters, const SelectedFockSpace& fock_space, const Eigen::VectorXd& coefficients, double energy);
+
+    /**
+     *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+     *  @param fock_space                   the selected space
+     *  @param coefficients                 the coefficients of the wave function in the selected space
+     *  @param energy                       the variational energy of the wave function
+     *  @param excitation_generator         the generator of the external configurations, e.g. with heat-bath screening
+     */
+    EpsteinNesbetPT2(const HamiltonianParameters& hamiltonian_parameters, const SelectedFockSpace& fock_space, const Eigen::VectorXd& coefficients, double energy, const ExcitationGenerator& excitation_generator);
+
+
+    // PUBLIC METHODS
+    /**
+     *  Calculate the contributions e_a = |<a|H|Psi>|^2 / (E - <a|H|a>) of the external configurations of one batch
+     *
+     *  @param externals            the external configurations of the batch
+     *  @param contributions        the contributions of the external configurations
+     *  @param batch_index          the index of the batch of external configurations
+     *  @param number_of_batches    the number of batches in which the external space is partitioned
+     */
+    void calculateContributions(SelectedFockSpace& externals, std::vector<double>& contributions, size_t batch_index = 0, size_t number_of_batches = 1) const;
+
+    /**
+     *  @param number_of_batches    the number of batches in which the external space is partitioned: only the external configurations of one batch are kept in memory at the same time
+     *
+     *  @return the deterministic EN-PT2 correction
+     */
+    double calculateDeterministic(size_t number_of_batches = 1) const;
+
+    /**
+     *  @param options      the options for the semistochastic calculation
+     *
+     *  @return the semistochastic EN-PT2 correction and its standard error
+     */
+    PT2Estimate calculateSemistochastic(const SemistochasticPT2Options& options) const;
+};
+
+
+}  // namespace GQCP
+
+
+#endif  // GQCP_EPSTEINNESBETPT2_HPP
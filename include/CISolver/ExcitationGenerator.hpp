@@ -0,0 +1,129 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2018  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#ifndef GQCP_EXCITATIONGENERATOR_HPP
+#define GQCP_EXCITATIONGENERATOR_HPP
+
+
+#include "CISolver/HeatBathScreening.hpp"
+#include "FockSpace/Configuration.hpp"
+#include "HamiltonianParameters/HamiltonianParameters.hpp"
+
+#include <cmath>
+#include <limits>
+#include <memory>
+
+
+namespace GQCP {
+
+
+/**
+ *  A class that generates all configurations that are singly or doubly excited with respect to a given configuration, which is the basis of selected CI and of perturbative corrections to it
+ *
+ *  Optionally, the double excitations are screened in heat-bath order (see HeatBathScreening): those of a configuration I are then only generated if |c_I g| is at least a threshold epsilon
+ */
+class ExcitationGenerator {
+private:
+    size_t K;  // the number of orbitals
+    size_t all_orbitals;  // the representation in which all orbitals are occupied
+
+    double heat_bath_threshold;  // the heat-bath parameter epsilon, only used if heat_bath_screening is set
+    std::shared_ptr<HeatBathScreening> heat_bath_screening;  // shared between copies, since it holds K^4 sorted targets
+
+
+public:
+    // CONSTRUCTORS
+    /**
+     *  @param K        the number of orbitals
+     *
+     *  All single and double excitations are generated
+     */
+    explicit ExcitationGenerator(size_t K);
+
+    /**
+     *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+     *  @param heat_bath_threshold          the heat-bath parameter epsilon: if positive, the double excitations of a configuration I are only generated if |c_I g| is at least epsilon
+     */
+    ExcitationGenerator(const HamiltonianParameters& hamiltonian_parameters, double heat_bath_threshold);
+
+
+    // GETTERS
+    size_t get_K() const { return this->K; }
+    bool uses_heat_bath_screening() const { return static_cast<bool>(this->heat_bath_screening); }
+
+
+    // PUBLIC METHODS
+    /**
+     *  Call the callback for every configuration that is singly or doubly excited with respect to the given configuration
+     *
+     *  @tparam Callback            a callable with signature void(size_t alpha_representation, size_t beta_representation)
+     *
+     *  @param configuration        the configuration that is excited
+     *  @param coefficient          the coefficient of the configuration, which is used for the heat-bath screening of the double excitations
+     *  @param callback             the callable that is called for every excited configuration
+     */
+    template <typename Callback>
+    void forEachExcitation(const Configuration& configuration, double coefficient, const Callback& callback) const;
+};
+
+
+
+/*
+ *  TEMPLATE IMPLEMENTATIONS
+ */
+
+/**
+ *  Call the callback for every configuration that is singly or doubly excited with respect to the given configuration
+ *
+ *  @tparam Callback            a callable with signature void(size_t alpha_representation, size_t beta_representation)
+ *
+ *  @param configuration        the configuration that is excited
+ *  @param coefficient          the coefficient of the configuration, which is used for the heat-bath screening of the double excitations
+ *  @param callback             the callable that is called for every excited configuration
+ */
+template <typename Callback>
+void ExcitationGenerator::forEachExcitation(const Configuration& configuration, double coefficient, const Callback& callback) const {
+
+    size_t alpha = configuration.onv_alpha.get_unsigned_representation();
+    size_t beta = configuration.onv_beta.get_unsigned_representation();
+
+    // Single excitations are never screened, since there are only N(K-N) of them
+    ONV::forEachSingleExcitation(alpha, this->all_orbitals, [&] (size_t excited_alpha) { callback(excited_alpha, beta); });
+    ONV::forEachSingleExcitation(beta, this->all_orbitals, [&] (size_t excited_beta) { callback(alpha, excited_beta); });
+
+    // Double excitations in heat-bath order: only those with |c_I g| >= epsilon
+    if (this->heat_bath_screening) {
+        double threshold = (coefficient != 0.0) ? this->heat_bath_threshold / std::abs(coefficient) : std::numeric_limits<double>::infinity();
+        this->heat_bath_screening->forEachDoubleExcitation(configuration, threshold, callback);
+        return;
+    }
+
+    // Pure alpha and pure beta double excitations
+    ONV::forEachDoubleExcitation(alpha, this->all_orbitals, [&] (size_t excited_alpha) { callback(excited_alpha, beta); });
+    ONV::forEachDoubleExcitation(beta, this->all_orbitals, [&] (size_t excited_beta) { callback(alpha, excited_beta); });
+
+    // Mixed alpha-beta double excitations
+    ONV::forEachSingleExcitation(alpha, this->all_orbitals, [&] (size_t excited_alpha) {
+        ONV::forEachSingleExcitation(beta, this->all_orbitals, [&] (size_t excited_beta) { callback(excited_alpha, excited_beta); });
+    });
+}
+
+
+}  // namespace GQCP
+
+
+#endif  // GQCP_EXCITATIONGENERATOR_HPP
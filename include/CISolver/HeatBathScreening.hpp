@@ -0,0 +1,176 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2018  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#ifndef GQCP_HEATBATHSCREENING_HPP
+#define GQCP_HEATBATHSCREENING_HPP
+
+
+#include "FockSpace/Configuration.hpp"
+#include "HamiltonianParameters/HamiltonianParameters.hpp"
+
+#include <vector>
+
+
+namespace GQCP {
+
+
+/**
+ *  A class that generates the double excitations of a configuration in heat-bath order: for every pair of occupied orbitals (i,j), the pairs of target orbitals (a,b) are sorted by the magnitude of the corresponding two-electron integrals
+ *
+ *  Since the magnitude of the Hamiltonian matrix element of a double excitation only depends on the integrals, the generation of the double excitations for a pair (i,j) can stop as soon as the magnitude drops below a threshold. The cost of generating the important double excitations then depends on the threshold rather than on K^4.
+ */
+class HeatBathScreening {
+private:
+    /**
+     *  A small struct that holds a pair of target orbitals (a,b) for a pair of occupied orbitals and the magnitude of the corresponding Hamiltonian matrix element
+     */
+    struct Target {
+        double magnitude;
+        size_t a;
+        size_t b;
+    };
+
+    size_t K;  // the number of orbitals
+
+    // For every pair of occupied orbitals (i,j), at index i*K + j, the targets (a,b) sorted by decreasing magnitude
+    std::vector<std::vector<Target>> same_spin_targets;  // only i<j and a<b, with magnitude |g_aibj - g_ajbi|
+    std::vector<std::vector<Target>> opposite_spin_targets;  // i (alpha) -> a (alpha), j (beta) -> b (beta), with magnitude |g_aibj|
+
+
+    // PRIVATE METHODS
+    /**
+     *  Call the callback for every same-spin double excitation of the given spin string whose magnitude is at least the threshold
+     *
+     *  @tparam Callback            a callable with signature void(size_t excited_representation)
+     *
+     *  @param representation       the representation of the spin string
+     *  @param threshold            the threshold on the magnitude of the two-electron integrals
+     *  @param callback             the callable that is called for every excited spin string
+     */
+    template <typename Callback>
+    void forEachSameSpinDoubleExcitation(size_t representation, double threshold, const Callback& callback) const;
+
+
+public:
+    // CONSTRUCTORS
+    /**
+     *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+     */
+    explicit HeatBathScreening(const HamiltonianParameters& hamiltonian_parameters);
+
+
+    // GETTERS
+    size_t get_K() const { return this->K; }
+
+
+    // PUBLIC METHODS
+    /**
+     *  Call the callback for every double excitation (alpha-alpha, beta-beta and alpha-beta) of the given configuration whose Hamiltonian matrix element has a magnitude of at least the threshold
+     *
+     *  @tparam Callback            a callable with signature void(size_t alpha_representation, size_t beta_representation)
+     *
+     *  @param configuration        the configuration that is excited
+     *  @param threshold            the threshold on the magnitude of the two-electron integrals, e.g. epsilon/|c_I| for a heat-bath selection with parameter epsilon
+     *  @param callback             the callable that is called for every excited configuration
+     */
+    template <typename Callback>
+    void forEachDoubleExcitation(const Configuration& configuration, double threshold, const Callback& callback) const;
+};
+
+
+
+/*
+ *  TEMPLATE IMPLEMENTATIONS
+ */
+
+/**
+ *  Call the callback for every same-spin double excitation of the given spin string whose magnitude is at least the threshold
+ *
+ *  @tparam Callback            a callable with signature void(size_t excited_representation)
+ *
+ *  @param representation       the representation of the spin string
+ *  @param threshold            the threshold on the magnitude of the two-electron integrals
+ *  @param callback             the callable that is called for every excited spin string
+ */
+template <typename Callback>
+void HeatBathScreening::forEachSameSpinDoubleExcitation(size_t representation, double threshold, const Callback& callback) const {
+
+    for (size_t occupied_i = representation; occupied_i != 0; occupied_i &= occupied_i - 1) {
+        size_t i = __builtin_ctzl(occupied_i);
+
+        for (size_t occupied_j = occupied_i & (occupied_i - 1); occupied_j != 0; occupied_j &= occupied_j - 1) {
+            size_t j = __builtin_ctzl(occupied_j);
+
+            for (const auto& target : this->same_spin_targets[i*this->K + j]) {
+                if (target.magnitude < threshold) {
+                    break;  // all following targets are smaller
+                }
+
+                size_t target_orbitals = (1UL << target.a) | (1UL << target.b);
+                if ((representation & target_orbitals) == 0) {
+                    callback(representation ^ (1UL << i) ^ (1UL << j) ^ target_orbitals);
+                }
+            }
+        }
+    }
+}
+
+
+/**
+ *  Call the callback for every double excitation (alpha-alpha, beta-beta and alpha-beta) of the given configuration whose Hamiltonian matrix element has a magnitude of at least the threshold
+ *
+ *  @tparam Callback            a callable with signature void(size_t alpha_representation, size_t beta_representation)
+ *
+ *  @param configuration        the configuration that is excited
+ *  @param threshold            the threshold on the magnitude of the two-electron integrals, e.g. epsilon/|c_I| for a heat-bath selection with parameter epsilon
+ *  @param callback             the callable that is called for every excited configuration
+ */
+template <typename Callback>
+void HeatBathScreening::forEachDoubleExcitation(const Configuration& configuration, double threshold, const Callback& callback) const {
+
+    size_t alpha = configuration.onv_alpha.get_unsigned_representation();
+    size_t beta = configuration.onv_beta.get_unsigned_representation();
+
+    // Same-spin double excitations
+    this->forEachSameSpinDoubleExcitation(alpha, threshold, [&] (size_t excited_alpha) { callback(excited_alpha, beta); });
+    this->forEachSameSpinDoubleExcitation(beta, threshold, [&] (size_t excited_beta) { callback(alpha, excited_beta); });
+
+    // Opposite-spin double excitations
+    for (size_t occupied_i = alpha; occupied_i != 0; occupied_i &= occupied_i - 1) {
+        size_t i = __builtin_ctzl(occupied_i);
+
+        for (size_t occupied_j = beta; occupied_j != 0; occupied_j &= occupied_j - 1) {
+            size_t j = __builtin_ctzl(occupied_j);
+
+            for (const auto& target : this->opposite_spin_targets[i*this->K + j]) {
+                if (target.magnitude < threshold) {
+                    break;  // all following targets are smaller
+                }
+
+                if (!(alpha & (1UL << target.a)) && !(beta & (1UL << target.b))) {
+                    callback(alpha ^ (1UL << i) ^ (1UL << target.a), beta ^ (1UL << j) ^ (1UL << target.b));
+                }
+            }
+        }
+    }
+}
+
+
+}  // namespace GQCP
+
+
+#endif  // GQCP_HEATBATHSCREENING_HPP
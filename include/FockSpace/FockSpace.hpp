@@ -24,6 +24,8 @@
 #include <boost/numeric/conversion/converter.hpp>
 #include <boost/math/special_functions.hpp>
 
+#include <memory>
+
 
 namespace GQCP {
 
@@ -38,6 +40,10 @@ class FockSpace: public GQCP::BaseFockSpace {
 private:
     const size_t N;  // number of electrons
     Matrixu vertex_weights;  // vertex_weights of the addressing scheme
+    std::vector<size_t> chunk_weights;  // the summed vertex weights for every chunk of bits_per_chunk orbitals, indexed by (chunk, number of electrons in the preceding chunks, value of the chunk)
+
+    std::shared_ptr<const std::vector<size_t>> representation_table;  // the unsigned representations of all ONVs, ordered by address (only if the string table is materialized)
+    std::shared_ptr<const std::vector<uint8_t>> occupation_table;  // the packed occupation indices of all ONVs: N per ONV, ordered by address (only if the string table is materialized)
 
 
     // PRIVATE METHODS
@@ -50,16 +56,36 @@ private:
      *          011 -> 101
      *          101 -> 110
      */
-    size_t ulongNextPermutation(size_t representation);
+    size_t ulongNextPermutation(size_t representation) const;
 
+    /**
+     *  @return the summed vertex weights for every chunk of bits_per_chunk orbitals, for every number of electrons in the preceding chunks and for every value of the chunk
+     */
+    std::vector<size_t> calculateChunkWeights() const;
 
-public:
-    // CONSTRUCTORS
     /**
      *  @param K        the number of orbitals
      *  @param N        the number of electrons
+     *
+     *  @return the vertex weights of the addressing scheme for a Fock space of N electrons in K orbitals
+     */
+    static Matrixu calculateVertexWeights(size_t K, size_t N);
+
+
+public:
+    static constexpr size_t bits_per_chunk = 8;  // the number of orbitals that are addressed at once
+    static constexpr size_t values_per_chunk = 1 << bits_per_chunk;
+
+
+    // CONSTRUCTORS
+    /**
+     *  @param K                            the number of orbitals
+     *  @param N                            the number of electrons
+     *  @param materialize_string_table     if the representations and occupation indices of all ONVs should be calculated and stored at construction
+     *
+     *  The string table is shared by all copies of this Fock space (e.g. the ones that are stored in the Hamiltonian and RDM builders)
      */
-    FockSpace(size_t K, size_t N);
+    FockSpace(size_t K, size_t N, bool materialize_string_table = false);
 
 
     // DESTRUCTORS
@@ -71,6 +97,9 @@ public:
     const Matrixu& get_vertex_weights() const { return this->vertex_weights; }
     size_t get_N() const { return this->N; }
     FockSpaceType get_type() const override { return FockSpaceType::FockSpace; }
+    bool hasStringTable() const { return this->representation_table != nullptr; }
+    size_t get_representation(size_t address) const { return (*this->representation_table)[address]; }
+    const uint8_t* get_occupation_indices(size_t address) const { return this->occupation_table->data() + address * this->N; }
 
 
     // STATIC PUBLIC METHODS
@@ -89,7 +118,7 @@ public:
      *
      *  @return the ONV with the corresponding address
      */
-    ONV get_ONV(size_t address);
+    ONV get_ONV(size_t address) const;
 
 
     /**
@@ -97,17 +126,202 @@ public:
      *
      *  @param onv      the current ONV
      */
-    void setNext(ONV& onv);
+    void setNext(ONV& onv) const;
+
+    /**
+     *  Set the current ONV to the next ONV: if the string table is materialized, the next ONV is read from it, otherwise setNext(onv) is called
+     *
+     *  @param onv          the current ONV
+     *  @param address      the address of the current ONV
+     */
+    void setNext(ONV& onv, size_t address) const;
 
     /**
      *  @param onv      the ONV
      *
-     *  @return the address (i.e. the ordering number) of the given ONV
+     *  @return the address (i.e. the ordering number) of the given ONV, calculated by adding one precomputed weight per chunk of bits_per_chunk orbitals
      */
-    size_t getAddress(const ONV& onv);
+    size_t getAddress(const ONV& onv) const;
+
+
+    // PUBLIC TEMPLATE METHODS
+    /**
+     *  Visit all ONVs a^\dagger_q a_p |onv> (including p == q) that couple to the given ONV through a one-electron operator
+     *
+     *  @tparam Callback        the type of the callback: a (lambda) function object with signature void(size_t J, int sign, size_t p, size_t q), in which J is the address of the coupling ONV and sign is the sign of a^\dagger_q a_p
+     *
+     *  @param onv              the ONV
+     *  @param callback         the function that is called for every coupling ONV
+     */
+    template <typename Callback>
+    void forEachOneElectronCoupling(const ONV& onv, const Callback& callback) const;
+
+    /**
+     *  Visit all ONVs a^\dagger_q a_p |onv> (including p == q) that couple to the given ONV through a one-electron operator, skipping the pairs (p,q) that are screened away
+     *
+     *  @tparam Screen          the type of the screening function: a (lambda) function object with signature bool(size_t p, size_t q) that returns if the pair (p,q) should be visited
+     *  @tparam Callback        the type of the callback: a (lambda) function object with signature void(size_t J, int sign, size_t p, size_t q)
+     *
+     *  @param onv              the ONV
+     *  @param screen           the screening function, which is evaluated before the address of the coupling ONV is calculated
+     *  @param callback         the function that is called for every coupling ONV
+     */
+    template <typename Screen, typename Callback>
+    void forEachOneElectronCoupling(const ONV& onv, const Screen& screen, const Callback& callback) const;
+
+    /**
+     *  Visit all ONVs a^\dagger_s a_r a^\dagger_q a_p |onv> that couple to the given ONV through a product of two one-electron operators
+     *
+     *  @tparam Callback        the type of the callback: a (lambda) function object with signature void(size_t J, int sign, size_t p, size_t q, size_t r, size_t s), in which J is the address of the coupling ONV and sign is the sign of a^\dagger_s a_r a^\dagger_q a_p
+     *
+     *  @param onv              the ONV
+     *  @param callback         the function that is called for every coupling ONV
+     */
+    template <typename Callback>
+    void forEachTwoElectronCoupling(const ONV& onv, const Callback& callback) const;
+
+    /**
+     *  Visit all ONVs a^\dagger_s a_r a^\dagger_q a_p |onv> that couple to the given ONV through a product of two one-electron operators, skipping the quadruples (p,q,r,s) that are screened away
+     *
+     *  @tparam Screen          the type of the screening function: a (lambda) function object with signature bool(size_t p, size_t q, size_t r, size_t s) that returns if the quadruple (p,q,r,s) should be visited
+     *  @tparam Callback        the type of the callback: a (lambda) function object with signature void(size_t J, int sign, size_t p, size_t q, size_t r, size_t s)
+     *
+     *  @param onv              the ONV
+     *  @param screen           the screening function, which is evaluated before the address of the coupling ONV is calculated
+     *  @param callback         the function that is called for every coupling ONV
+     */
+    template <typename Screen, typename Callback>
+    void forEachTwoElectronCoupling(const ONV& onv, const Screen& screen, const Callback& callback) const;
 };
 
 
+
+/*
+ *  PUBLIC TEMPLATE METHODS
+ */
+
+/**
+ *  Visit all ONVs a^\dagger_q a_p |onv> (including p == q) that couple to the given ONV through a one-electron operator
+ *
+ *  @tparam Callback        the type of the callback: a (lambda) function object with signature void(size_t J, int sign, size_t p, size_t q), in which J is the address of the coupling ONV and sign is the sign of a^\dagger_q a_p
+ *
+ *  @param onv              the ONV
+ *  @param callback         the function that is called for every coupling ONV
+ */
+template <typename Callback>
+void FockSpace::forEachOneElectronCoupling(const ONV& onv, const Callback& callback) const {
+    this->forEachOneElectronCoupling(onv, [] (size_t /*p*/, size_t /*q*/) { return true; }, callback);
+}
+
+
+/**
+ *  Visit all ONVs a^\dagger_q a_p |onv> (including p == q) that couple to the given ONV through a one-electron operator, skipping the pairs (p,q) that are screened away
+ *
+ *  @tparam Screen          the type of the screening function: a (lambda) function object with signature bool(size_t p, size_t q) that returns if the pair (p,q) should be visited
+ *  @tparam Callback        the type of the callback: a (lambda) function object with signature void(size_t J, int sign, size_t p, size_t q)
+ *
+ *  @param onv              the ONV
+ *  @param screen           the screening function, which is evaluated before the address of the coupling ONV is calculated
+ *  @param callback         the function that is called for every coupling ONV
+ */
+template <typename Screen, typename Callback>
+void FockSpace::forEachOneElectronCoupling(const ONV& onv, const Screen& screen, const Callback& callback) const {
+
+    ONV target = onv;  // the ONV on which the operators act: it is restored after every excitation
+
+    for (size_t e1 = 0; e1 < this->N; e1++) {  // e1 (electron 1) loops over the (number of) electrons
+        size_t p = onv.get_occupied_index(e1);
+
+        int sign_p = 1;  // sign of the operator a_p
+        target.annihilate_unchecked(p, sign_p);
+
+        for (size_t q = 0; q < this->K; q++) {  // q loops over SOs
+            if (!screen(p, q)) {
+                continue;
+            }
+
+            int sign_pq = sign_p;  // sign of the operator a^dagger_q a_p
+            if (target.create_unchecked(q, sign_pq)) {
+                callback(this->getAddress(target), sign_pq, p, q);
+
+                target.annihilate_unchecked(q);  // undo the previous creation
+            }
+        }  // q loop
+
+        target.create_unchecked(p);  // undo the previous annihilation
+    }  // p or e1 loop
+}
+
+
+/**
+ *  Visit all ONVs a^\dagger_s a_r a^\dagger_q a_p |onv> that couple to the given ONV through a product of two one-electron operators
+ *
+ *  @tparam Callback        the type of the callback: a (lambda) function object with signature void(size_t J, int sign, size_t p, size_t q, size_t r, size_t s), in which J is the address of the coupling ONV and sign is the sign of a^\dagger_s a_r a^\dagger_q a_p
+ *
+ *  @param onv              the ONV
+ *  @param callback         the function that is called for every coupling ONV
+ */
+template <typename Callback>
+void FockSpace::forEachTwoElectronCoupling(const ONV& onv, const Callback& callback) const {
+    this->forEachTwoElectronCoupling(onv, [] (size_t /*p*/, size_t /*q*/, size_t /*r*/, size_t /*s*/) { return true; }, callback);
+}
+
+
+/**
+ *  Visit all ONVs a^\dagger_s a_r a^\dagger_q a_p |onv> that couple to the given ONV through a product of two one-electron operators, skipping the quadruples (p,q,r,s) that are screened away
+ *
+ *  @tparam Screen          the type of the screening function: a (lambda) function object with signature bool(size_t p, size_t q, size_t r, size_t s) that returns if the quadruple (p,q,r,s) should be visited
+ *  @tparam Callback        the type of the callback: a (lambda) function object with signature void(size_t J, int sign, size_t p, size_t q, size_t r, size_t s)
+ *
+ *  @param onv              the ONV
+ *  @param screen           the screening function, which is evaluated before the address of the coupling ONV is calculated
+ *  @param callback         the function that is called for every coupling ONV
+ */
+template <typename Screen, typename Callback>
+void FockSpace::forEachTwoElectronCoupling(const ONV& onv, const Screen& screen, const Callback& callback) const {
+
+    ONV target = onv;  // the ONV on which the operators act: it is restored after every excitation
+
+    for (size_t e1 = 0; e1 < this->N; e1++) {  // e1 (electron 1) loops over the (number of) electrons
+        size_t p = onv.get_occupied_index(e1);
+
+        int sign_p = 1;  // sign of the operator a_p
+        target.annihilate_unchecked(p, sign_p);
+
+        for (size_t q = 0; q < this->K; q++) {  // q loops over SOs
+            int sign_pq = sign_p;  // sign of the operator a^dagger_q a_p
+            if (target.create_unchecked(q, sign_pq)) {
+
+                for (size_t r = 0; r < this->K; r++) {  // r loops over SOs
+                    int sign_pqr = sign_pq;  // sign of the operator a_r a^dagger_q a_p
+                    if (target.annihilate_unchecked(r, sign_pqr)) {
+
+                        for (size_t s = 0; s < this->K; s++) {  // s loops over SOs
+                            if (!screen(p, q, r, s)) {
+                                continue;
+                            }
+
+                            int sign_pqrs = sign_pqr;  // sign of the operator a^dagger_s a_r a^dagger_q a_p
+                            if (target.create_unchecked(s, sign_pqrs)) {
+                                callback(this->getAddress(target), sign_pqrs, p, q, r, s);
+
+                                target.annihilate_unchecked(s);  // undo the previous creation
+                            }
+                        }  // s loop
+
+                        target.create_unchecked(r);  // undo the previous annihilation
+                    }
+                }  // r loop
+
+                target.annihilate_unchecked(q);  // undo the previous creation
+            }
+        }  // q loop
+
+        target.create_unchecked(p);  // undo the previous annihilation
+    }  // p or e1 loop
+}
+
+
 }  // namespace GQCP
 
 
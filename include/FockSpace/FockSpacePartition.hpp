@@ -0,0 +1,290 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2018  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#ifndef GQCP_FOCKSPACEPARTITION_HPP
+#define GQCP_FOCKSPACEPARTITION_HPP
+
+
+#include "FockSpace/FockSpace.hpp"
+#include "FockSpace/ProductFockSpace.hpp"
+
+#include <algorithm>
+#include <vector>
+
+
+namespace GQCP {
+
+
+/**
+ *  A contiguous range [start, end) of addresses in a Fock space
+ */
+struct AddressRange {
+    size_t start;  // the first address in the range
+    size_t end;  // one past the last address in the range
+};
+
+
+/**
+ *  A class that enumerates the ONVs of a contiguous range of addresses in a FockSpace, starting from an arbitrary address
+ *
+ *  IMPORTANT: the iterator refers to the given Fock space, so the Fock space should outlive the iterator
+ */
+class FockSpaceIterator {
+private:
+    const FockSpace* fock_space;  // the Fock space whose ONVs are enumerated
+    size_t address;  // the address of the current ONV
+    size_t end;  // one past the last address that should be enumerated
+    ONV onv;  // the current ONV
+
+
+public:
+    // CONSTRUCTORS
+    /**
+     *  @param fock_space       the Fock space whose ONVs should be enumerated
+     *  @param range            the range of addresses that should be enumerated
+     */
+    FockSpaceIterator(const FockSpace& fock_space, const AddressRange& range);
+
+
+    // GETTERS
+    size_t get_address() const { return this->address; }
+    const ONV& get_ONV() const { return this->onv; }
+    AddressRange get_range() const { return AddressRange {this->address, this->end}; }
+
+
+    // PUBLIC METHODS
+    /**
+     *  @return if all the ONVs in the range have been enumerated
+     */
+    bool isFinished() const { return this->address >= this->end; }
+
+    /**
+     *  Move to the next ONV in the range
+     */
+    void increment();
+};
+
+
+/**
+ *  A class that enumerates the (alpha, beta) ONV pairs of a contiguous range of addresses in a ProductFockSpace (in which the alpha addresses are major), starting from an arbitrary address
+ *
+ *  IMPORTANT: the iterator refers to the given Fock space, so the Fock space should outlive the iterator
+ */
+class ProductFockSpaceIterator {
+private:
+    const FockSpace* fock_space_alpha;  // the alpha Fock space whose ONVs are enumerated
+    const FockSpace* fock_space_beta;  // the beta Fock space whose ONVs are enumerated
+    size_t address;  // the address of the current pair of ONVs, i.e. address_alpha * dim_beta + address_beta
+    size_t end;  // one past the last address that should be enumerated
+    size_t address_alpha;  // the address of the current alpha ONV
+    size_t address_beta;  // the address of the current beta ONV
+    ONV onv_alpha;  // the current alpha ONV
+    ONV onv_beta;  // the current beta ONV
+
+
+public:
+    // CONSTRUCTORS
+    /**
+     *  @param fock_space       the product Fock space whose ONVs should be enumerated
+     *  @param range            the range of addresses that should be enumerated
+     */
+    ProductFockSpaceIterator(const ProductFockSpace& fock_space, const AddressRange& range);
+
+
+    // GETTERS
+    size_t get_address() const { return this->address; }
+    size_t get_address_alpha() const { return this->address_alpha; }
+    size_t get_address_beta() const { return this->address_beta; }
+    const ONV& get_ONV_alpha() const { return this->onv_alpha; }
+    const ONV& get_ONV_beta() const { return this->onv_beta; }
+    AddressRange get_range() const { return AddressRange {this->address, this->end}; }
+
+
+    // PUBLIC METHODS
+    /**
+     *  @return if all the ONVs in the range have been enumerated
+     */
+    bool isFinished() const { return this->address >= this->end; }
+
+    /**
+     *  Move to the next pair of ONVs in the range: the beta ONV is moved to the next one, and when all beta ONVs are exhausted, the alpha ONV is moved to the next one
+     */
+    void increment();
+};
+
+
+
+/*
+ *  PARTITIONING
+ */
+
+/**
+ *  @param dim                  the number of addresses
+ *  @param number_of_ranges     the number of ranges in which the addresses should be split
+ *
+ *  @return number_of_ranges contiguous ranges (of which some may be empty) that cover [0, dim) and contain (almost) equally many addresses
+ */
+std::vector<AddressRange> partitionAddresses(size_t dim, size_t number_of_ranges);
+
+/**
+ *  @tparam Cost                the type of the cost function: a (lambda) function object with signature double(size_t I)
+ *
+ *  @param dim                  the number of addresses
+ *  @param number_of_ranges     the number of ranges in which the addresses should be split
+ *  @param cost                 the (estimated) cost of handling address I, e.g. its number of couplings
+ *
+ *  @return number_of_ranges contiguous ranges (of which some may be empty) that cover [0, dim) and have (almost) equal total costs
+ */
+template <typename Cost>
+std::vector<AddressRange> partitionAddresses(size_t dim, size_t number_of_ranges, const Cost& cost);
+
+/**
+ *  @param fock_space           the Fock space whose addresses should be partitioned
+ *  @param number_of_ranges     the number of ranges in which the addresses should be split
+ *
+ *  @return iterators that are positioned at the start of each of number_of_ranges balanced, contiguous ranges of addresses. Since every ONV of a FockSpace couples to equally many other ONVs, the ranges contain (almost) equally many addresses
+ */
+std::vector<FockSpaceIterator> partition(const FockSpace& fock_space, size_t number_of_ranges);
+
+/**
+ *  @param fock_space           the product Fock space whose addresses should be partitioned
+ *  @param number_of_ranges     the number of ranges in which the addresses should be split
+ *
+ *  @return iterators that are positioned at the start of each of number_of_ranges balanced, contiguous ranges of addresses. Since every pair of ONVs of a ProductFockSpace couples to equally many other pairs, the ranges contain (almost) equally many addresses
+ */
+std::vector<ProductFockSpaceIterator> partition(const ProductFockSpace& fock_space, size_t number_of_ranges);
+
+/**
+ *  @tparam Cost                the type of the cost function: a (lambda) function object with signature double(size_t I)
+ *
+ *  @param fock_space           the Fock space whose addresses should be partitioned
+ *  @param number_of_ranges     the number of ranges in which the addresses should be split
+ *  @param cost                 the (estimated) cost of handling address I
+ *
+ *  @return iterators that are positioned at the start of each of number_of_ranges contiguous ranges of addresses with (almost) equal total costs
+ */
+template <typename Cost>
+std::vector<FockSpaceIterator> partition(const FockSpace& fock_space, size_t number_of_ranges, const Cost& cost);
+
+/**
+ *  @tparam Cost                the type of the cost function: a (lambda) function object with signature double(size_t I)
+ *
+ *  @param fock_space           the product Fock space whose addresses should be partitioned
+ *  @param number_of_ranges     the number of ranges in which the addresses should be split
+ *  @param cost                 the (estimated) cost of handling address I
+ *
+ *  @return iterators that are positioned at the start of each of number_of_ranges contiguous ranges of addresses with (almost) equal total costs
+ */
+template <typename Cost>
+std::vector<ProductFockSpaceIterator> partition(const ProductFockSpace& fock_space, size_t number_of_ranges, const Cost& cost);
+
+
+
+/*
+ *  TEMPLATE IMPLEMENTATIONS
+ */
+
+/**
+ *  @tparam Cost                the type of the cost function: a (lambda) function object with signature double(size_t I)
+ *
+ *  @param dim                  the number of addresses
+ *  @param number_of_ranges     the number of ranges in which the addresses should be split
+ *  @param cost                 the (estimated) cost of handling address I, e.g. its number of couplings
+ *
+ *  @return number_of_ranges contiguous ranges (of which some may be empty) that cover [0, dim) and have (almost) equal total costs
+ */
+template <typename Cost>
+std::vector<AddressRange> partitionAddresses(size_t dim, size_t number_of_ranges, const Cost& cost) {
+
+    if (number_of_ranges == 0) {
+        throw std::invalid_argument("The number of ranges should be at least 1.");
+    }
+
+    // Calculate the cumulative costs, so that cumulative_costs[I] is the total cost of the addresses [0, I)
+    std::vector<double> cumulative_costs (dim + 1, 0.0);
+    for (size_t I = 0; I < dim; I++) {
+        cumulative_costs[I + 1] = cumulative_costs[I] + cost(I);
+    }
+    double total_cost = cumulative_costs[dim];
+
+    // The range t ends at the first address at which the cumulative cost reaches (t+1)/number_of_ranges of the total cost
+    std::vector<AddressRange> ranges (number_of_ranges);
+    size_t start = 0;
+    for (size_t t = 0; t < number_of_ranges; t++) {
+        size_t end = dim;
+        if (t < number_of_ranges - 1) {
+            double target = (total_cost * (t + 1)) / number_of_ranges;
+            end = std::lower_bound(cumulative_costs.begin() + start, cumulative_costs.end(), target) - cumulative_costs.begin();
+            end = std::min(end, dim);
+        }
+
+        ranges[t] = AddressRange {start, end};
+        start = end;
+    }
+
+    return ranges;
+}
+
+
+/**
+ *  @tparam Cost                the type of the cost function: a (lambda) function object with signature double(size_t I)
+ *
+ *  @param fock_space           the Fock space whose addresses should be partitioned
+ *  @param number_of_ranges     the number of ranges in which the addresses should be split
+ *  @param cost                 the (estimated) cost of handling address I
+ *
+ *  @return iterators that are positioned at the start of each of number_of_ranges contiguous ranges of addresses with (almost) equal total costs
+ */
+template <typename Cost>
+std::vector<FockSpaceIterator> partition(const FockSpace& fock_space, size_t number_of_ranges, const Cost& cost) {
+
+    std::vector<FockSpaceIterator> iterators;
+    iterators.reserve(number_of_ranges);
+    for (const auto& range : partitionAddresses(fock_space.get_dimension(), number_of_ranges, cost)) {
+        iterators.emplace_back(fock_space, range);
+    }
+
+    return iterators;
+}
+
+
+/**
+ *  @tparam Cost                the type of the cost function: a (lambda) function object with signature double(size_t I)
+ *
+ *  @param fock_space           the product Fock space whose addresses should be partitioned
+ *  @param number_of_ranges     the number of ranges in which the addresses should be split
+ *  @param cost                 the (estimated) cost of handling address I
+ *
+ *  @return iterators that are positioned at the start of each of number_of_ranges contiguous ranges of addresses with (almost) equal total costs
+ */
+template <typename Cost>
+std::vector<ProductFockSpaceIterator> partition(const ProductFockSpace& fock_space, size_t number_of_ranges, const Cost& cost) {
+
+    std::vector<ProductFockSpaceIterator> iterators;
+    iterators.reserve(number_of_ranges);
+    for (const auto& range : partitionAddresses(fock_space.get_dimension(), number_of_ranges, cost)) {
+        iterators.emplace_back(fock_space, range);
+    }
+
+    return iterators;
+}
+
+
+}  // namespace GQCP
+
+
+#endif  // GQCP_FOCKSPACEPARTITION_HPP
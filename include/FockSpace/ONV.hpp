@@ -23,6 +23,10 @@
 
 #include "common.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
 
 
 namespace GQCP {
@@ -38,15 +42,22 @@ namespace GQCP {
  *  In this code bitstrings are read from right to left. This means that the least significant bit relates to the first orbital.
  *  Using this notation is how normally bits are read, leading to more efficient code.
  *  As is also usual, the least significant bit has index 0. The previous example is then represented by the bit string "0111" (7).
+ *
+ *  The occupation indices are stored inline (i.e. without heap allocations), so copying an ONV or moving it to the next ONV never allocates
+ *  Next to the checked methods (that throw for invalid orbital indices), the *_unchecked methods are noexcept and can be used in hot loops in which the orbital indices are known to be valid
  */
 class ONV {
+public:
+    static constexpr size_t max_number_of_orbitals = 64;  // the number of bits in the unsigned representation
+
+
 private:
     size_t K;  // number of spatial orbitals
     size_t N;  // number of electrons
     size_t unsigned_representation;  // unsigned representation
-    VectorXs occupation_indices;  // the occupied orbital electron indexes
-                                  // it is a vector of N elements in which occupation_indices[j]
-                                  // gives the occupied orbital index for electron j
+    std::array<uint8_t, max_number_of_orbitals> occupation_indices;  // the occupied orbital electron indexes
+                                                                      // the first N elements are used, in which occupation_indices[j]
+                                                                      // gives the occupied orbital index for electron j
 
 
 public:
@@ -100,18 +111,67 @@ public:
      */
     void set_representation(size_t unsigned_representation);
 
+    /**
+     *  @param unsigned_representation      the new representation as an unsigned integer, which should have N set bits
+     *
+     *  Set the representation of an ONV to a new representation and update the occupation indices accordingly, without checking the number of electrons
+     */
+    void set_representation_unchecked(size_t unsigned_representation) noexcept {
+        this->unsigned_representation = unsigned_representation;
+        this->updateOccupationIndices_unchecked();
+    }
+
+    /**
+     *  @param unsigned_representation      the new representation as an unsigned integer, which should have N set bits
+     *  @param occupation_indices           the N (precomputed) occupied orbital indices that correspond to the new representation
+     *
+     *  Set the representation of an ONV to a new representation and copy the given occupation indices, without checking the number of electrons
+     */
+    void set_representation_unchecked(size_t unsigned_representation, const uint8_t* occupation_indices) noexcept {
+        this->unsigned_representation = unsigned_representation;
+        std::copy(occupation_indices, occupation_indices + this->N, this->occupation_indices.begin());
+    }
+
 
     // GETTERS
+    size_t get_K() const { return K; }
+    size_t get_N() const { return N; }
     size_t get_unsigned_representation() const { return unsigned_representation; }
-    const VectorXs& get_occupation_indices() const { return occupation_indices; }
+    VectorXs get_occupation_indices() const;
 
     /**
      *  @param electron_index       the index of the electron
      *
      *  @return the index of the orbital that the electron occupies
      */
-    size_t get_occupied_index(size_t electron_index) const { return occupation_indices(electron_index); }
+    size_t get_occupied_index(size_t electron_index) const { return occupation_indices[electron_index]; }
+
+
+
+    // STATIC PUBLIC METHODS
+    /**
+     *  Call the callback for every single excitation i->a of the given spin string
+     *
+     *  @tparam Callback            a callable with signature void(size_t excited_representation)
+     *
+     *  @param representation       the representation of the spin string
+     *  @param all_orbitals         the representation in which all orbitals are occupied
+     *  @param callback             the callable that is called for every excited spin string
+     */
+    template <typename Callback>
+    static void forEachSingleExcitation(size_t representation, size_t all_orbitals, const Callback& callback);
 
+    /**
+     *  Call the callback for every double excitation i,j->a,b (i<j, a<b) of the given spin string
+     *
+     *  @tparam Callback            a callable with signature void(size_t excited_representation)
+     *
+     *  @param representation       the representation of the spin string
+     *  @param all_orbitals         the representation in which all orbitals are occupied
+     *  @param callback             the callable that is called for every excited spin string
+     */
+    template <typename Callback>
+    static void forEachDoubleExcitation(size_t representation, size_t all_orbitals, const Callback& callback);
 
     // PUBLIC METHODS
     /**
@@ -119,6 +179,19 @@ public:
      */
     void updateOccupationIndices();
 
+    /**
+     *  Extracts the positions of the set bits from the this->unsigned_representation and places them in the this->occupation_indices, without checking the number of electrons
+     */
+    void updateOccupationIndices_unchecked() noexcept {
+        size_t l = this->unsigned_representation;
+        size_t electron = 0;
+        while (l != 0) {
+            this->occupation_indices[electron] = static_cast<uint8_t>(__builtin_ctzl(l));  // retrieves occupation index
+            electron++;
+            l ^= (l & -l);  // flip the least significant bit
+        }
+    }
+
     /**
      *  @param p    the orbital index starting from 0, counted from right to left
      *
@@ -172,6 +245,86 @@ public:
      */
     int operatorPhaseFactor(size_t p) const;
 
+
+    // UNCHECKED PUBLIC METHODS
+    /**
+     *  @param p    the orbital index starting from 0, counted from right to left, which should be smaller than K
+     *
+     *  @return if the p-th spatial orbital is occupied
+     */
+    bool isOccupied_unchecked(size_t p) const noexcept { return this->unsigned_representation & (1UL << p); }
+
+    /**
+     *  @param p    the orbital index starting from 0, counted from right to left, which should be smaller than K
+     *
+     *  @return if we can apply the annihilation operator (i.e. 1->0) for the p-th spatial orbital. Subsequently perform an in-place annihilation on the orbital p
+     *
+     *  IMPORTANT: does not update the occupation indices for performance reasons, if required call updateOccupationIndices()!
+     */
+    bool annihilate_unchecked(size_t p) noexcept {
+        if (this->isOccupied_unchecked(p)) {
+            this->unsigned_representation ^= (1UL << p);
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     *  @param p        the orbital index starting from 0, counted from right to left, which should be smaller than K
+     *  @param sign     the current sign of the operator string
+     *
+     *  @return if we can apply the annihilation operator (i.e. 1->0) for the p-th spatial orbital. Subsequently perform an in-place annihilation on the orbital p. Furthermore, update the sign according to the sign change (+1 or -1) of the spin string after annihilation.
+     *
+     *  IMPORTANT: does not update the occupation indices for performance reasons, if required call updateOccupationIndices()!
+     */
+    bool annihilate_unchecked(size_t p, int& sign) noexcept {
+        if (this->annihilate_unchecked(p)) {
+            sign *= this->operatorPhaseFactor_unchecked(p);
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     *  @param p    the orbital index starting from 0, counted from right to left, which should be smaller than K
+     *
+     *  @return if we can apply the creation operator (i.e. 0->1) for the p-th spatial orbital. Subsequently perform an in-place creation on the orbital p
+     *
+     *  IMPORTANT: does not update the occupation indices for performance reasons, if required call updateOccupationIndices()!
+     */
+    bool create_unchecked(size_t p) noexcept {
+        if (!this->isOccupied_unchecked(p)) {
+            this->unsigned_representation ^= (1UL << p);
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     *  @param p        the orbital index starting from 0, counted from right to left, which should be smaller than K
+     *  @param sign     the current sign of the operator string
+     *
+     *  @return if we can apply the creation operator (i.e. 0->1) for the p-th spatial orbital. Subsequently perform an in-place creation on the orbital p. Furthermore, update the sign according to the sign change (+1 or -1) of the spin string after creation.
+     *
+     *  IMPORTANT: does not update the occupation indices for performance reasons, if required call updateOccupationIndices()!
+     */
+    bool create_unchecked(size_t p, int& sign) noexcept {
+        if (this->create_unchecked(p)) {
+            sign *= this->operatorPhaseFactor_unchecked(p);
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     *  @param p        the orbital index starting from 0, counted from right to left, which should be smaller than K
+     *
+     *  @return the phase factor (+1 or -1) that arises by applying an annihilation or creation operator on orbital p, calculated with a single masked popcount of the orbitals up to p (not included)
+     */
+    int operatorPhaseFactor_unchecked(size_t p) const noexcept {
+        return (__builtin_popcountl(this->unsigned_representation & ((1UL << p) - 1)) % 2 == 0) ? 1 : -1;
+    }
+
     /**
      *  @param index_start      the starting index (included), read from right to left
      *  @param index_end        the ending index (not included), read from right to left
@@ -211,6 +364,64 @@ public:
 };
 
 
+/*
+ *  TEMPLATE IMPLEMENTATIONS
+ */
+
+/**
+ *  Call the callback for every single excitation i->a of the given spin string
+ *
+ *  @tparam Callback            a callable with signature void(size_t excited_representation)
+ *
+ *  @param representation       the representation of the spin string
+ *  @param all_orbitals         the representation in which all orbitals are occupied
+ *  @param callback             the callable that is called for every excited spin string
+ */
+template <typename Callback>
+void ONV::forEachSingleExcitation(size_t representation, size_t all_orbitals, const Callback& callback) {
+
+    for (size_t occupied = representation; occupied != 0; occupied &= occupied - 1) {
+        size_t i = __builtin_ctzl(occupied);
+
+        for (size_t unoccupied = ~representation & all_orbitals; unoccupied != 0; unoccupied &= unoccupied - 1) {
+            size_t a = __builtin_ctzl(unoccupied);
+            callback(representation ^ (1UL << i) ^ (1UL << a));
+        }
+    }
+}
+
+
+/**
+ *  Call the callback for every double excitation i,j->a,b (i<j, a<b) of the given spin string
+ *
+ *  @tparam Callback            a callable with signature void(size_t excited_representation)
+ *
+ *  @param representation       the representation of the spin string
+ *  @param all_orbitals         the representation in which all orbitals are occupied
+ *  @param callback             the callable that is called for every excited spin string
+ */
+template <typename Callback>
+void ONV::forEachDoubleExcitation(size_t representation, size_t all_orbitals, const Callback& callback) {
+
+    for (size_t occupied_i = representation; occupied_i != 0; occupied_i &= occupied_i - 1) {
+        size_t i = __builtin_ctzl(occupied_i);
+
+        for (size_t occupied_j = occupied_i & (occupied_i - 1); occupied_j != 0; occupied_j &= occupied_j - 1) {
+            size_t j = __builtin_ctzl(occupied_j);
+
+            for (size_t unoccupied_a = ~representation & all_orbitals; unoccupied_a != 0; unoccupied_a &= unoccupied_a - 1) {
+                size_t a = __builtin_ctzl(unoccupied_a);
+
+                for (size_t unoccupied_b = unoccupied_a & (unoccupied_a - 1); unoccupied_b != 0; unoccupied_b &= unoccupied_b - 1) {
+                    size_t b = __builtin_ctzl(unoccupied_b);
+                    callback(representation ^ (1UL << i) ^ (1UL << j) ^ (1UL << a) ^ (1UL << b));
+                }
+            }
+        }
+    }
+}
+
+
 }  // namespace GQCP
 
 #endif  // GQCP_ONV_HPP
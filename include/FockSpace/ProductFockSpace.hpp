@@ -44,11 +44,14 @@ private:
 public:
     // CONSTRUCTORS
     /**
-     *  @param K            the number of orbitals (equal for alpha and beta)
-     *  @param N_alpha      the number of alpha electrons
-     *  @param N_beta       the number of beta electrons
+     *  @param K                            the number of orbitals (equal for alpha and beta)
+     *  @param N_alpha                      the number of alpha electrons
+     *  @param N_beta                       the number of beta electrons
+     *  @param materialize_string_tables    if the string tables of the alpha and beta Fock spaces should be materialized (see FockSpace)
+     *
+     *  If N_alpha == N_beta, the alpha and beta Fock space share one string table
      */
-    ProductFockSpace(size_t K, size_t N_alpha, size_t N_beta);
+    ProductFockSpace(size_t K, size_t N_alpha, size_t N_beta, bool materialize_string_tables = false);
 
 
     // DESTRUCTORS
@@ -20,12 +20,17 @@
 
 
 #include "FockSpace/BaseFockSpace.hpp"
+#include "FockSpace/FockSpacePartition.hpp"
 #include "FockSpace/ProductFockSpace.hpp"
 #include "Configuration.hpp"
 
 #include <boost/numeric/conversion/converter.hpp>
 #include <boost/math/special_functions.hpp>
 
+#include <algorithm>
+#include <limits>
+#include <vector>
+
 
 namespace GQCP {
 
@@ -34,6 +39,10 @@ namespace GQCP {
  *  A class that represents a Fock space that is flexible in the number of states that span it
  *
  *  Configurations are represented as a Configuration: a combination of an alpha and a beta ONV
+ *
+ *  The position of every configuration is kept in an open-addressing (linear probing) hash index keyed on the representations of its alpha and beta ONV, so that a configuration can be looked up in constant time
+ *
+ *  Optionally, the configurations can be brought in a canonical layout (see canonicalize()): sorted by alpha and then by beta string, with tables of the unique alpha and beta strings, the range of configurations that share an alpha string and the (sorted) list of configurations that share a beta string
  */
 class SelectedFockSpace : public GQCP::BaseFockSpace {
 private:
@@ -42,6 +51,51 @@ private:
 
     std::vector<GQCP::Configuration> configurations;
 
+    std::vector<size_t> index_slots;  // the hash index: every slot holds (position + 1) of a configuration, or 0 if the slot is empty; its size is always a power of two
+    size_t number_of_indexed_configurations = 0;  // the number of occupied slots in the hash index
+
+    bool is_canonical = false;  // if the configurations are in the canonical layout, and the following string tables are valid
+    std::vector<size_t> alpha_strings;  // the sorted unique alpha string representations
+    std::vector<size_t> beta_strings;  // the sorted unique beta string representations
+    std::vector<size_t> alpha_string_indices;  // the index in this->alpha_strings of the alpha string of every configuration
+    std::vector<size_t> beta_string_indices;  // the index in this->beta_strings of the beta string of every configuration
+    std::vector<size_t> alpha_offsets;  // the configurations with alpha string a are at positions [alpha_offsets[a], alpha_offsets[a+1])
+    std::vector<size_t> beta_offsets;  // the configurations with beta string b are at beta_configurations[beta_offsets[b]] until beta_configurations[beta_offsets[b+1]]
+    std::vector<size_t> beta_configurations;  // the positions of the configurations, grouped by beta string and sorted within every group
+
+
+    // PRIVATE METHODS
+    /**
+     *  Rebuild the hash index with the given number of slots and insert all current configurations
+     *
+     *  @param number_of_slots      the new number of slots, which should be a power of two
+     */
+    void rehash(size_t number_of_slots);
+
+    /**
+     *  Insert the configuration at the given position into the hash index, if an identical configuration isn't indexed yet
+     *
+     *  @param position     the position of the configuration in this Fock space
+     */
+    void insertIntoIndex(size_t position);
+
+    /**
+     *  Invalidate the canonical layout, after the configurations have been changed
+     */
+    void invalidateCanonicalLayout();
+
+    /**
+     *  Throw if the configurations are not in the canonical layout
+     */
+    void checkCanonical() const;
+
+    /**
+     *  Check if the given configuration is compatible with this Fock space, and throw if it isn't
+     *
+     *  @param configuration        the configuration that should be checked
+     */
+    void checkCompatibility(const Configuration& configuration) const;
+
     /**
      *  @param onv1     the alpha ONV as a string representation read from right to left
      *  @param onv2     the beta ONV as a string representation read from right to left
@@ -52,7 +106,18 @@ private:
      */
     Configuration makeConfiguration(const std::string& onv1, const std::string& onv2);
 
+    /**
+     *  @param strings              a sorted table of unique string representations
+     *  @param representation       the representation of a string
+     *
+     *  @return the index of the string in the table, or SelectedFockSpace::npos if it isn't in it
+     */
+    static size_t findString(const std::vector<size_t>& strings, size_t representation);
+
 public:
+    static constexpr size_t npos = std::numeric_limits<size_t>::max();  // the index that is returned for configurations that aren't in the Fock space
+
+
     // CONSTRUCTORS
     SelectedFockSpace() = default;
 
@@ -84,9 +149,20 @@ public:
     size_t get_N_alpha() const { return this->N_alpha; }
     size_t get_N_beta() const { return this->N_beta; }
     const Configuration& get_configuration(size_t index) const { return this->configurations[index]; }
+    bool isCanonical() const { return this->is_canonical; }
     FockSpaceType get_type() const override { return FockSpaceType::SelectedFockSpace; }
 
 
+    // STATIC PUBLIC METHODS
+    /**
+     *  @param alpha_representation     the unsigned representation of an alpha ONV
+     *  @param beta_representation      the unsigned representation of a beta ONV
+     *
+     *  @return the hash of the corresponding configuration, which is also used for the hash index
+     */
+    static size_t hash(size_t alpha_representation, size_t beta_representation);
+
+
     // PUBLIC METHODS
     /**
      *  Make a configuration (see makeConfiguration()) and add it to this Fock space
@@ -103,9 +179,327 @@ public:
      *  @param onv2s     the beta ONVs as string representations read from right to left
      */
     void addConfiguration(const std::vector<std::string>& onv1s, const std::vector<std::string>& onv2s);
+
+    /**
+     *  Add a configuration to this Fock space
+     *
+     *  @param onv_alpha        the alpha ONV
+     *  @param onv_beta         the beta ONV
+     */
+    void addConfiguration(const ONV& onv_alpha, const ONV& onv_beta);
+
+    /**
+     *  Add a number of configurations to this Fock space, rebuilding the hash index at most once
+     *
+     *  @param configurations       the configurations that should be added
+     */
+    void addConfigurations(const std::vector<Configuration>& configurations);
+
+    /**
+     *  Reserve memory for the given total number of configurations, so that adding configurations doesn't trigger a reallocation or a rebuild of the hash index
+     *
+     *  @param number_of_configurations     the total number of configurations this Fock space is expected to hold
+     */
+    void reserve(size_t number_of_configurations);
+
+    /**
+     *  @param alpha_representation     the unsigned representation of the alpha ONV
+     *  @param beta_representation      the unsigned representation of the beta ONV
+     *
+     *  @return the index of the (first added) corresponding configuration in this Fock space, or SelectedFockSpace::npos if it isn't present
+     */
+    size_t getIndex(size_t alpha_representation, size_t beta_representation) const;
+
+    /**
+     *  @param onv_alpha        the alpha ONV
+     *  @param onv_beta         the beta ONV
+     *
+     *  @return the index of the (first added) corresponding configuration in this Fock space, or SelectedFockSpace::npos if it isn't present
+     */
+    size_t getIndex(const ONV& onv_alpha, const ONV& onv_beta) const { return this->getIndex(onv_alpha.get_unsigned_representation(), onv_beta.get_unsigned_representation()); }
+
+    /**
+     *  @param onv_alpha        the alpha ONV
+     *  @param onv_beta         the beta ONV
+     *
+     *  @return if the corresponding configuration is present in this Fock space
+     */
+    bool contains(const ONV& onv_alpha, const ONV& onv_beta) const { return this->getIndex(onv_alpha, onv_beta) != SelectedFockSpace::npos; }
+
+    /**
+     *  Bring the configurations in the canonical layout: sort them by alpha string and then by beta string, and build the unique string tables, the alpha string -> configuration range index and the beta string -> configuration lists
+     *
+     *  @return the previous positions of the configurations, i.e. the configuration at position I in the canonical layout was at position permutation[I] before
+     *
+     *  Adding configurations afterwards invalidates the canonical layout
+     */
+    std::vector<size_t> canonicalize();
+
+
+    // PUBLIC METHODS FOR THE CANONICAL LAYOUT: these throw if the configurations are not in the canonical layout
+    /**
+     *  @return the number of unique alpha strings
+     */
+    size_t get_number_of_alpha_strings() const;
+
+    /**
+     *  @return the number of unique beta strings
+     */
+    size_t get_number_of_beta_strings() const;
+
+    /**
+     *  @param a        the index of a unique alpha string
+     *
+     *  @return the representation of the alpha string
+     */
+    size_t get_alpha_string(size_t a) const;
+
+    /**
+     *  @param b        the index of a unique beta string
+     *
+     *  @return the representation of the beta string
+     */
+    size_t get_beta_string(size_t b) const;
+
+    /**
+     *  @param index        the index of a configuration
+     *
+     *  @return the index of the unique alpha string of the configuration
+     */
+    size_t get_alpha_string_index(size_t index) const;
+
+    /**
+     *  @param index        the index of a configuration
+     *
+     *  @return the index of the unique beta string of the configuration
+     */
+    size_t get_beta_string_index(size_t index) const;
+
+    /**
+     *  @param a        the index of a unique alpha string
+     *
+     *  @return the contiguous range of the configurations that have the given alpha string, sorted by beta string
+     */
+    AddressRange get_alpha_range(size_t a) const;
+
+    /**
+     *  @param b        the index of a unique beta string
+     *
+     *  @return the range in the beta configuration list (see get_beta_configuration()) of the configurations that have the given beta string
+     */
+    AddressRange get_beta_range(size_t b) const;
+
+    /**
+     *  @param k        a position in the beta configuration list, see get_beta_range()
+     *
+     *  @return the index of the configuration at the given position in the beta configuration list, in which configurations that share a beta string are sorted by index (and thus by alpha string)
+     */
+    size_t get_beta_configuration(size_t k) const;
+
+    /**
+     *  @param alpha_representation     the representation of an alpha string
+     *
+     *  @return the index of the unique alpha string, or SelectedFockSpace::npos if no configuration has it
+     */
+    size_t findAlphaString(size_t alpha_representation) const;
+
+    /**
+     *  @param beta_representation      the representation of a beta string
+     *
+     *  @return the index of the unique beta string, or SelectedFockSpace::npos if no configuration has it
+     */
+    size_t findBetaString(size_t beta_representation) const;
+
+    /**
+     *  Call the callback for every configuration J != I that is coupled to the configuration I by a single or double excitation
+     *
+     *  @tparam Callback        a callable with signature void(size_t J)
+     *
+     *  @param I            the index of the configuration
+     *  @param callback     the callable that is called for every coupled configuration
+     *
+     *  The Fock space should be in the canonical layout. The pure alpha (beta) excitations are found either by scanning the configurations that share the beta (alpha) string of I, or by looking up every single and double alpha (beta) excitation of I in the hash index, whichever takes the fewest steps. The mixed excitations are found by looking up the N_alpha(K-N_alpha) single alpha excitations in the alpha string table, and then either scanning the configurations with that alpha string or looking up the N_beta(K-N_beta) single beta excitations.
+     */
+    template <typename Callback>
+    void forEachCoupledConfiguration(size_t I, const Callback& callback) const;
 };
 
 
+/*
+ *  TEMPLATE IMPLEMENTATIONS
+ */
+
+/**
+ *  Call the callback for every configuration J != I that is coupled to the configuration I by a single or double excitation
+ *
+ *  @tparam Callback        a callable with signature void(size_t J)
+ *
+ *  @param I            the index of the configuration
+ *  @param callback     the callable that is called for every coupled configuration
+ *
+ *  The Fock space should be in the canonical layout. The pure alpha (beta) excitations are found either by scanning the configurations that share the beta (alpha) string of I, or by looking up every single and double alpha (beta) excitation of I in the hash index, whichever takes the fewest steps. The mixed excitations are found by looking up the N_alpha(K-N_alpha) single alpha excitations in the alpha string table, and then either scanning the configurations with that alpha string or looking up the N_beta(K-N_beta) single beta excitations.
+ */
+template <typename Callback>
+void SelectedFockSpace::forEachCoupledConfiguration(size_t I, const Callback& callback) const {
+
+    this->checkCanonical();  // the string tables are accessed directly in the following
+
+    size_t K = this->get_K();
+    size_t all_orbitals = (K == 64) ? ~0UL : ((1UL << K) - 1);
+    const auto& configuration_I = this->configurations[I];
+    size_t alpha_I = configuration_I.onv_alpha.get_unsigned_representation();
+    size_t beta_I = configuration_I.onv_beta.get_unsigned_representation();
+
+    // The number of single and double excitations of an alpha and a beta string
+    size_t alpha_singles = this->N_alpha * (K - this->N_alpha);
+    size_t alpha_doubles = (this->N_alpha * (this->N_alpha - 1) / 2) * ((K - this->N_alpha) * (K - this->N_alpha - 1) / 2);
+    size_t beta_singles = this->N_beta * (K - this->N_beta);
+    size_t beta_doubles = (this->N_beta * (this->N_beta - 1) / 2) * ((K - this->N_beta) * (K - this->N_beta - 1) / 2);
+
+
+    // Pure beta excitations: the configurations with the same alpha string form a contiguous range
+    size_t a_I = this->alpha_string_indices[I];
+    size_t alpha_start = this->alpha_offsets[a_I];
+    size_t alpha_end = this->alpha_offsets[a_I + 1];
+    if (alpha_end - alpha_start <= beta_singles + beta_doubles) {
+        for (size_t J = alpha_start; J < alpha_end; J++) {
+            size_t beta_differences = __builtin_popcountl(beta_I ^ this->configurations[J].onv_beta.get_unsigned_representation());
+            if ((beta_differences == 2) || (beta_differences == 4)) {
+                callback(J);
+            }
+        }
+    } else {
+        auto look_up = [&] (size_t beta_J) {
+            size_t J = this->getIndex(alpha_I, beta_J);
+            if (J != SelectedFockSpace::npos) {
+                callback(J);
+            }
+        };
+        ONV::forEachSingleExcitation(beta_I, all_orbitals, look_up);
+        ONV::forEachDoubleExcitation(beta_I, all_orbitals, look_up);
+    }
+
+
+    // Pure alpha excitations: the configurations with the same beta string are kept in a list
+    size_t b_I = this->beta_string_indices[I];
+    size_t beta_start = this->beta_offsets[b_I];
+    size_t beta_end = this->beta_offsets[b_I + 1];
+    if (beta_end - beta_start <= alpha_singles + alpha_doubles) {
+        for (size_t k = beta_start; k < beta_end; k++) {
+            size_t J = this->beta_configurations[k];
+            size_t alpha_differences = __builtin_popcountl(alpha_I ^ this->configurations[J].onv_alpha.get_unsigned_representation());
+            if ((alpha_differences == 2) || (alpha_differences == 4)) {
+                callback(J);
+            }
+        }
+    } else {
+        auto look_up = [&] (size_t alpha_J) {
+            size_t J = this->getIndex(alpha_J, beta_I);
+            if (J != SelectedFockSpace::npos) {
+                callback(J);
+            }
+        };
+        ONV::forEachSingleExcitation(alpha_I, all_orbitals, look_up);
+        ONV::forEachDoubleExcitation(alpha_I, all_orbitals, look_up);
+    }
+
+
+    // Mixed alpha-beta excitations: look up every single alpha excitation of the alpha string of I, and look for single beta excitations among the configurations with that alpha string
+    ONV::forEachSingleExcitation(alpha_I, all_orbitals, [&] (size_t alpha_J) {
+        size_t a_J = SelectedFockSpace::findString(this->alpha_strings, alpha_J);
+        if (a_J == SelectedFockSpace::npos) {
+            return;
+        }
+
+        size_t excited_alpha_start = this->alpha_offsets[a_J];
+        size_t excited_alpha_end = this->alpha_offsets[a_J + 1];
+        if (excited_alpha_end - excited_alpha_start <= beta_singles) {
+            for (size_t J = excited_alpha_start; J < excited_alpha_end; J++) {
+                if (__builtin_popcountl(beta_I ^ this->configurations[J].onv_beta.get_unsigned_representation()) == 2) {
+                    callback(J);
+                }
+            }
+        } else {
+            ONV::forEachSingleExcitation(beta_I, all_orbitals, [&] (size_t beta_J) {
+                size_t J = this->getIndex(alpha_J, beta_J);
+                if (J != SelectedFockSpace::npos) {
+                    callback(J);
+                }
+            });
+        }
+    });
+}
+
+
+
+/*
+ *  INLINE IMPLEMENTATIONS
+ */
+
+/**
+ *  @param strings              a sorted table of unique string representations
+ *  @param representation       the representation of a string
+ *
+ *  @return the index of the string in the table, or SelectedFockSpace::npos if it isn't in it
+ */
+inline size_t SelectedFockSpace::findString(const std::vector<size_t>& strings, size_t representation) {
+
+    auto it = std::lower_bound(strings.begin(), strings.end(), representation);
+    if ((it == strings.end()) || (*it != representation)) {
+        return SelectedFockSpace::npos;
+    }
+    return it - strings.begin();
+}
+
+
+/**
+ *  @param a        the index of a unique alpha string
+ *
+ *  @return the contiguous range of the configurations that have the given alpha string, sorted by beta string
+ */
+inline AddressRange SelectedFockSpace::get_alpha_range(size_t a) const {
+
+    this->checkCanonical();
+    return AddressRange {this->alpha_offsets[a], this->alpha_offsets[a + 1]};
+}
+
+
+/**
+ *  @param k        a position in the beta configuration list, see get_beta_range()
+ *
+ *  @return the index of the configuration at the given position in the beta configuration list, in which configurations that share a beta string are sorted by index (and thus by alpha string)
+ */
+inline size_t SelectedFockSpace::get_beta_configuration(size_t k) const {
+
+    this->checkCanonical();
+    return this->beta_configurations[k];
+}
+
+
+/**
+ *  @param alpha_representation     the representation of an alpha string
+ *
+ *  @return the index of the unique alpha string, or SelectedFockSpace::npos if no configuration has it
+ */
+inline size_t SelectedFockSpace::findAlphaString(size_t alpha_representation) const {
+
+    this->checkCanonical();
+    return SelectedFockSpace::findString(this->alpha_strings, alpha_representation);
+}
+
+
+/**
+ *  @param beta_representation      the representation of a beta string
+ *
+ *  @return the index of the unique beta string, or SelectedFockSpace::npos if no configuration has it
+ */
+inline size_t SelectedFockSpace::findBetaString(size_t beta_representation) const {
+
+    this->checkCanonical();
+    return SelectedFockSpace::findString(this->beta_strings, beta_representation);
+}
+
+
 }  // namespace GQCP
 
 
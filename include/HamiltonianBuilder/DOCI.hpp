@@ -20,7 +20,11 @@
 
 
 #include "HamiltonianBuilder.hpp"
+#include "HamiltonianBuilder/DiagonalEngine.hpp"
 #include "FockSpace/FockSpace.hpp"
+#include "FockSpace/FockSpacePartition.hpp"
+
+#include <Eigen/Sparse>
 
 #include <memory>
 
@@ -31,24 +35,60 @@ namespace GQCP {
 
 /**
  *  A HamiltonianBuilder for DOCI: it builds the matrix representation of the DOCI Hamiltonian, in a Fock space where orbitals are either doubly occupied or unoccupied.
+ *
+ *  The DOCI Hamiltonian is very sparse: every row only has N(K-N) off-diagonal elements. Optionally, the full Hamiltonian (including its diagonal) can be stored as a row-major (CSR) sparse matrix, after which every matrix-vector product is a single sparse matrix-vector product.
  */
 class DOCI : public GQCP::HamiltonianBuilder {
 private:
     FockSpace fock_space;  // both the alpha and beta Fock space
 
+    bool use_sparse_hamiltonian;  // if the sparse Hamiltonian should be stored and used for matrix-vector products
+    Eigen::SparseMatrix<double, Eigen::RowMajor> sparse_hamiltonian;  // the stored DOCI Hamiltonian in CSR format (only used if use_sparse_hamiltonian is true)
+    Eigen::MatrixXd sparse_hamiltonian_integrals;  // the integrals from which the stored sparse Hamiltonian was built (see extractPairIntegrals())
+
+
+    // PRIVATE METHODS
+    /**
+     *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+     *
+     *  @return a DiagonalEngine that calculates the diagonal elements of the DOCI Hamiltonian, i.e.
+     *      E(S) = sum_{p in S} (2 h_pp + g_pppp) + sum_{p>q in S} 2 (2 g_ppqq - g_pqqp)
+     */
+    DiagonalEngine constructDiagonalEngine(const HamiltonianParameters& hamiltonian_parameters) const;
+
+    /**
+     *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+     *
+     *  @return the only integrals that the DOCI Hamiltonian depends on, as a K x (3K+1) matrix: the column h_pp, followed by the blocks g_ppqq, g_pqqp and g_pqpq
+     */
+    Eigen::MatrixXd extractPairIntegrals(const HamiltonianParameters& hamiltonian_parameters) const;
+
+    /**
+     *  (Re)build the stored sparse Hamiltonian if none has been stored yet, or if it was built from other Hamiltonian parameters
+     *
+     *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+     */
+    void updateSparseHamiltonian(const HamiltonianParameters& hamiltonian_parameters);
+
 
 public:
     // CONSTRUCTORS
     /**
-     *  @param fock_space       the full Fock space, identical for alpha and beta
+     *  @param fock_space                   the full Fock space, identical for alpha and beta
+     *  @param use_sparse_hamiltonian       if the DOCI Hamiltonian should be stored as a sparse matrix and be used in matrixVectorProduct()
      */
-    explicit DOCI(const FockSpace& fock_space);
+    explicit DOCI(const FockSpace& fock_space, bool use_sparse_hamiltonian = false);
 
 
     // DESTRUCTOR
     ~DOCI() = default;
 
 
+    // GETTERS
+    bool uses_sparse_hamiltonian() const { return this->use_sparse_hamiltonian; }
+    const Eigen::SparseMatrix<double, Eigen::RowMajor>& get_sparse_hamiltonian() const { return this->sparse_hamiltonian; }
+
+
     // OVERRIDDEN GETTERS
     BaseFockSpace* get_fock_space() override { return &fock_space; }
 
@@ -58,6 +98,8 @@ public:
      *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
      *
      *  @return the DOCI Hamiltonian matrix
+     *
+     *  If the sparse Hamiltonian is used, it is (re)built and stored for the given Hamiltonian parameters if needed
      */
     Eigen::MatrixXd constructHamiltonian(const HamiltonianParameters& hamiltonian_parameters) override;
 
@@ -67,6 +109,9 @@ public:
      *  @param diagonal                     the diagonal of the DOCI Hamiltonian matrix
      *
      *  @return the action of the DOCI Hamiltonian on the coefficient vector
+     *
+     *  If the sparse Hamiltonian is used, the stored sparse Hamiltonian is multiplied with x: it is (re)built if it doesn't correspond to the given Hamiltonian parameters, and since it already contains the diagonal, the given diagonal isn't used.
+     *  Otherwise, the off-diagonal contributions are gathered row by row: the addresses are split over the available (OpenMP) threads, and every thread only writes to its own range of the matrix-vector product.
      */
     Eigen::VectorXd matrixVectorProduct(const HamiltonianParameters& hamiltonian_parameters, const Eigen::VectorXd& x, const Eigen::VectorXd& diagonal) override;
 
@@ -74,8 +119,20 @@ public:
      *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
      *
      *  @return the diagonal of the matrix representation of the DOCI Hamiltonian
+     *
+     *  If the sparse Hamiltonian is used, it is (re)built and stored for the given Hamiltonian parameters if needed, and its diagonal is returned
+     *  Otherwise, the addresses are split over the available (OpenMP) threads, and every diagonal element is updated from the previous one in that thread's range
      */
     Eigen::VectorXd calculateDiagonal(const HamiltonianParameters& hamiltonian_parameters) override;
+
+
+    // PUBLIC METHODS
+    /**
+     *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+     *
+     *  @return the DOCI Hamiltonian (including its diagonal) as a row-major (CSR) sparse matrix
+     */
+    Eigen::SparseMatrix<double, Eigen::RowMajor> constructSparseHamiltonian(const HamiltonianParameters& hamiltonian_parameters);
 };
 
 
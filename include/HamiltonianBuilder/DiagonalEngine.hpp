@@ -0,0 +1,92 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2018  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#ifndef GQCP_DIAGONALENGINE_HPP
+#define GQCP_DIAGONALENGINE_HPP
+
+
+#include "FockSpace/ONV.hpp"
+
+#include <Eigen/Dense>
+
+
+
+namespace GQCP {
+
+
+/**
+ *  A class that calculates diagonal Hamiltonian elements for a succession of ONVs (e.g. generated by FockSpace::setNext()) of the form
+ *      E(S) = sum_{p in S} a_p + sum_{p<q in S} b_pq
+ *
+ *  in which S is the set of occupied orbitals, a are the one-electron terms and b are the (symmetric) pair terms
+ *
+ *  Instead of recalculating every element from scratch (which is O(N^2)), the element for the next ONV is updated from the element of the previous ONV, using only the orbitals whose occupation changed (which is O(N) per changed orbital)
+ */
+class DiagonalEngine {
+private:
+    Eigen::VectorXd one_electron_terms;  // a_p
+    Eigen::MatrixXd pair_terms;  // b_pq, symmetric and with a zero diagonal
+
+    bool has_previous = false;  // if there is a previous ONV that the next element can be updated from
+    size_t previous_representation = 0;  // the representation of the previous ONV
+    double previous_value = 0.0;  // the diagonal element of the previous ONV
+
+
+public:
+    // CONSTRUCTORS
+    /**
+     *  @param one_electron_terms       the one-electron terms a_p
+     *  @param pair_terms               the pair terms b_pq, of which only the strict lower triangle (p>q) is used
+     */
+    DiagonalEngine(const Eigen::VectorXd& one_electron_terms, const Eigen::MatrixXd& pair_terms);
+
+
+    // SETTERS
+    /**
+     *  @param one_electron_terms       the new one-electron terms a_p
+     *
+     *  Replace the one-electron terms, after which the next element is calculated from scratch
+     */
+    void set_one_electron_terms(const Eigen::VectorXd& one_electron_terms);
+
+
+    // PUBLIC METHODS
+    /**
+     *  Forget the previous ONV, so that the next element is calculated from scratch (e.g. at the start of a new partition of addresses)
+     */
+    void reset() { this->has_previous = false; }
+
+    /**
+     *  @param unsigned_representation      the representation of an ONV
+     *
+     *  @return the diagonal element E(S), calculated from scratch
+     */
+    double calculateFull(size_t unsigned_representation) const;
+
+    /**
+     *  @param onv      the ONV
+     *
+     *  @return the diagonal element E(S), updated from the previous ONV if there is one
+     */
+    double calculate(const ONV& onv);
+};
+
+
+}  // namespace GQCP
+
+
+#endif  // GQCP_DIAGONALENGINE_HPP
@@ -20,6 +20,8 @@
 
 
 #include "HamiltonianBuilder/HamiltonianBuilder.hpp"
+#include "HamiltonianBuilder/DiagonalEngine.hpp"
+#include "FockSpace/FockSpacePartition.hpp"
 #include "FockSpace/ProductFockSpace.hpp"
 
 
@@ -65,6 +67,21 @@ private:
     std::vector<std::vector<OneElectronCoupling>> beta_one_electron_couplings;
 
 
+    // PRIVATE METHODS
+    /**
+     *  Enumerate the string couplings of the FCI Hamiltonian and pass every contribution to the given sink, which defines to what and how the contributions will be added
+     *
+     *  The contributions of a pair of addresses (I, J) sum to the matrix element H_IJ, including the diagonal
+     *
+     *  @tparam Sink                        the type of the sink: a (lambda) function object with signature void(size_t I, size_t J, double value). Since the sink is a template parameter, it is inlined into the innermost loop
+     *
+     *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+     *  @param sink                         the function object that receives the contributions, e.g. for matrixVectorProduct() or blockMatrixVectorProduct()
+     */
+    template <typename Sink>
+    void forEachContribution(const HamiltonianParameters& hamiltonian_parameters, const Sink& sink) const;
+
+
 public:
 
     // CONSTRUCTORS
@@ -103,11 +120,152 @@ public:
      *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
      *
      *  @return the diagonal of the matrix representation of the Hamiltonian
+     *
+     *  The diagonal elements are updated incrementally (using a DiagonalEngine) while the alpha and beta spin strings are enumerated
      */
     Eigen::VectorXd calculateDiagonal(const HamiltonianParameters& hamiltonian_parameters) override;
+
+    /**
+     *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+     *  @param X                            the vectors (as columns) upon which the FCI Hamiltonian acts
+     *  @param diagonal                     the diagonal of the FCI Hamiltonian matrix
+     *
+     *  @return the action of the FCI Hamiltonian on every column of X
+     *
+     *  The string couplings are enumerated only once for the whole block, and every contribution acts on a (contiguous) row of X, read through its transpose
+     */
+    Eigen::MatrixXd blockMatrixVectorProduct(const HamiltonianParameters& hamiltonian_parameters, const Eigen::MatrixXd& X, const Eigen::VectorXd& diagonal) override;
 };
 
 
+
+/*
+ *  PRIVATE TEMPLATE METHODS
+ */
+
+/**
+ *  Enumerate the string couplings of the FCI Hamiltonian and pass every contribution to the given sink, which defines to what and how the contributions will be added
+ *
+ *  The contributions of a pair of addresses (I, J) sum to the matrix element H_IJ, including the diagonal
+ *
+ *  @tparam Sink                        the type of the sink: a (lambda) function object with signature void(size_t I, size_t J, double value). Since the sink is a template parameter, it is inlined into the innermost loop
+ *
+ *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+ *  @param sink                         the function object that receives the contributions, e.g. for matrixVectorProduct() or blockMatrixVectorProduct()
+ */
+template <typename Sink>
+void FCI::forEachContribution(const HamiltonianParameters& hamiltonian_parameters, const Sink& sink) const {
+
+    auto K = hamiltonian_parameters.get_h().get_dim();
+
+    FockSpace fock_space_alpha = fock_space.get_fock_space_alpha();
+    FockSpace fock_space_beta = fock_space.get_fock_space_beta();
+
+    auto dim_alpha = fock_space_alpha.get_dimension();
+    auto dim_beta = fock_space_beta.get_dimension();
+
+    // Calculate the effective one-electron integrals
+    // TODO: move this to libwint
+    Eigen::MatrixXd k_SO = hamiltonian_parameters.get_h().get_matrix_representation();
+    for (size_t p = 0; p < K; p++) {
+        for (size_t q = 0; q < K; q++) {
+            for (size_t r = 0; r < K; r++) {
+                k_SO(p,q) -= 0.5 * hamiltonian_parameters.get_g()(p, r, r, q);
+            }
+        }
+    }
+
+
+    // ALPHA-ALPHA
+    ONV spin_string_alpha_aa = fock_space_alpha.get_ONV(0);  // spin string with address 0
+    for (size_t I_alpha = 0; I_alpha < dim_alpha; I_alpha++) {  // I_alpha loops over all the addresses of the alpha spin strings
+        if (I_alpha > 0) {
+            fock_space_alpha.setNext(spin_string_alpha_aa, I_alpha - 1);
+        }
+
+        // Find all strings J_alpha that couple to I_alpha
+        fock_space_alpha.forEachOneElectronCoupling(spin_string_alpha_aa, [&] (size_t J_alpha, int sign_pq, size_t p, size_t q) {
+            for (size_t I_beta = 0; I_beta < dim_beta; I_beta++) {  // I_beta loops over all addresses of the beta spin strings
+                sink(I_alpha*dim_beta + I_beta, J_alpha*dim_beta + I_beta, k_SO(p,q) * sign_pq);  // alpha addresses are major
+            }
+        });
+    }  // I_alpha loop
+
+
+    // BETA-BETA
+    ONV spin_string_beta_bb = fock_space_beta.get_ONV(0);  // spin string with address 0
+    for (size_t I_beta = 0; I_beta < dim_beta; I_beta++) {  // I_beta loops over all the addresses of the beta spin strings
+        if (I_beta > 0) {
+            fock_space_beta.setNext(spin_string_beta_bb, I_beta - 1);
+        }
+
+        // Find all strings J_beta that couple to I_beta
+        fock_space_beta.forEachOneElectronCoupling(spin_string_beta_bb, [&] (size_t J_beta, int sign_pq, size_t p, size_t q) {
+            for (size_t I_alpha = 0; I_alpha < dim_alpha; I_alpha++) {  // I_alpha loops over all addresses of the alpha spin strings
+                sink(I_alpha*dim_beta + I_beta, I_alpha*dim_beta + J_beta, k_SO(p,q) * sign_pq);  // alpha addresses are major
+            }
+        });
+    }  // I_beta loop
+
+
+    // ALPHA-ALPHA-ALPHA-ALPHA
+    ONV spin_string_alpha_aaaa = fock_space_alpha.get_ONV(0);  // spin string with address 0
+    for (size_t I_alpha = 0; I_alpha < dim_alpha; I_alpha++) {  // I_alpha loops over all addresses of alpha spin strings
+        if (I_alpha > 0) {
+            fock_space_alpha.setNext(spin_string_alpha_aaaa, I_alpha - 1);
+        }
+
+        // Find all strings J_alpha that couple to I_alpha through a^dagger_s_alpha a_r_alpha a^dagger_q_alpha a_p_alpha
+        fock_space_alpha.forEachTwoElectronCoupling(spin_string_alpha_aaaa, [&] (size_t J_alpha, int sign_pqrs, size_t p, size_t q, size_t r, size_t s) {
+            for (size_t I_beta = 0; I_beta < dim_beta; I_beta++) {  // I_beta loops over all beta addresses
+                sink(I_alpha*dim_beta + I_beta, J_alpha*dim_beta + I_beta, 0.5 * hamiltonian_parameters.get_g()(p, q, r, s) * sign_pqrs);
+            }
+        });
+    }  // loop over I_alpha
+
+
+    // ALPHA-ALPHA-BETA-BETA (and BETA-BETA-ALPHA-ALPHA)
+    ONV spin_string_alpha_aabb = fock_space_alpha.get_ONV(0);  // spin string with address 0
+    for (size_t I_alpha = 0; I_alpha < dim_alpha; I_alpha++) {  // I_alpha loops over all addresses of alpha spin strings
+        if (I_alpha > 0) {
+            fock_space_alpha.setNext(spin_string_alpha_aabb, I_alpha - 1);
+        }
+
+        // Find all strings J_alpha that couple to I_alpha through a^dagger_q_alpha a_p_alpha
+        fock_space_alpha.forEachOneElectronCoupling(spin_string_alpha_aabb, [&] (size_t J_alpha, int sign_pq, size_t p, size_t q) {
+
+            ONV spin_string_beta_aabb = fock_space_beta.get_ONV(0);  // spin string with address 0
+            for (size_t I_beta = 0; I_beta < dim_beta; I_beta++) {  // I_beta loops over all addresses of beta spin strings
+                if (I_beta > 0) {
+                    fock_space_beta.setNext(spin_string_beta_aabb, I_beta - 1);
+                }
+
+                // Find all strings J_beta that couple to I_beta through a^dagger_s_beta a_r_beta
+                fock_space_beta.forEachOneElectronCoupling(spin_string_beta_aabb, [&] (size_t J_beta, int sign_rs, size_t r, size_t s) {
+                    sink(I_alpha*dim_beta + I_beta, J_alpha*dim_beta + J_beta, hamiltonian_parameters.get_g()(p, q, r, s) * sign_pq * sign_rs);  // alpha addresses are major
+                });
+            }  // I_beta loop
+        });
+    }  // loop over I_alpha
+
+
+    // BETA-BETA-BETA-BETA
+    ONV spin_string_beta_bbbb = fock_space_beta.get_ONV(0);  // spin string with address 0
+    for (size_t I_beta = 0; I_beta < dim_beta; I_beta++) {  // I_beta loops over all addresses of beta spin strings
+        if (I_beta > 0) {
+            fock_space_beta.setNext(spin_string_beta_bbbb, I_beta - 1);
+        }
+
+        // Find all strings J_beta that couple to I_beta through a^dagger_s_beta a_r_beta a^dagger_q_beta a_p_beta
+        fock_space_beta.forEachTwoElectronCoupling(spin_string_beta_bbbb, [&] (size_t J_beta, int sign_pqrs, size_t p, size_t q, size_t r, size_t s) {
+            for (size_t I_alpha = 0; I_alpha < dim_alpha; I_alpha++) {  // I_alpha loops over all alpha addresses
+                sink(I_alpha*dim_beta + I_beta, I_alpha*dim_beta + J_beta, 0.5 * hamiltonian_parameters.get_g()(p, q, r, s) * sign_pqrs);
+            }
+        });
+    }  // loop over I_beta
+}
+
+
 }  // namespace GQCP
 
 
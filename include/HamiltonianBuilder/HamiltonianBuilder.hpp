@@ -37,6 +37,8 @@ namespace GQCP {
  *      - constructHamiltonian() which constructs the full Hamiltonian matrix in the given Fock space
  *      - matrixVectorProduct() which gives the result of the action of the Hamiltonian on a given coefficient vector
  *      - calculateDiagonal() which gives the diagonal of the Hamiltonian matrix
+ *
+ *  Optionally, they can override blockMatrixVectorProduct(), which gives the action of the Hamiltonian on a block of coefficient vectors
  */
 class HamiltonianBuilder {
 public:
@@ -78,6 +80,19 @@ public:
      *  @return the diagonal of the matrix representation of the Hamiltonian
      */
     virtual Eigen::VectorXd calculateDiagonal(const HamiltonianParameters& hamiltonian_parameters) = 0;
+
+
+    // PUBLIC METHODS
+    /**
+     *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+     *  @param X                            the vectors (as columns) upon which the Hamiltonian acts
+     *  @param diagonal                     the diagonal of the Hamiltonian matrix
+     *
+     *  @return the action of the Hamiltonian on every column of X
+     *
+     *  By default, the matrix-vector products are calculated one by one. Derived classes can override this to evaluate every Hamiltonian matrix element only once for the whole block.
+     */
+    virtual Eigen::MatrixXd blockMatrixVectorProduct(const HamiltonianParameters& hamiltonian_parameters, const Eigen::MatrixXd& X, const Eigen::VectorXd& diagonal);
 };
 
 
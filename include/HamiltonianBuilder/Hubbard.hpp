@@ -21,14 +21,19 @@
 
 #include "HamiltonianBuilder/HamiltonianBuilder.hpp"
 #include "FockSpace/ProductFockSpace.hpp"
+#include "HamiltonianParameters/ModelHamiltonianParameters.hpp"
+
+#include <Eigen/Sparse>
+
+#include <vector>
 
 
 
 namespace GQCP {
 
 
-// Typedef for a function that will be passed to the evaluation, it defines to what and how the evaluated results will be added.
-using PassToMethod = std::function<void (size_t I, size_t J, double value)>;
+// Typedef for the adjacency lists of a lattice: for every site p, the neighbouring sites q>p together with the hopping h_pq
+using HoppingList = std::vector<std::vector<std::pair<size_t, double>>>;
 
 
 /**
@@ -45,15 +50,20 @@ private:
     
     // PRIVATE METHODS
     /**
-     *  Evaluate the one-electron operators for alpha or beta and store the result in a matrix-vector product or a matrix, depending on the method passed
+     *  Evaluate the one-electron operators for alpha or beta and pass every matrix element to the given sink, which defines to what and how the evaluated elements will be added
+     *
+     *  Only the hoppings between neighbouring sites (i.e. with a non-zero one-electron integral) are visited, so the work per ONV scales with the coordination number of the lattice rather than with K
+     *
+     *  @tparam Sink                    the type of the sink: a (lambda) function object with signature void(size_t I, size_t J, double value). Since the sink is a template parameter, it is inlined into the innermost loop
      *
      *  @param fock_space_target        the Fock space that is used as a target, i.e. that is evaluated
      *  @param fock_space_fixed         the Fock space that is not evaluated
      *  @param target_is_major          whether or not the evaluated component is the major index
-     *  @param hamiltonian_parameters   the Hubbard Hamiltonian parameters
-     *  @param method                   the used method: constructHamiltonian() or matrixVectorProduct()
+     *  @param hoppings                 the adjacency lists of the lattice, together with the hopping parameters (cfr. generateHoppingList())
+     *  @param sink                     the function object that receives the matrix elements, e.g. for constructHamiltonian() or matrixVectorProduct()
      */
-    void oneOperatorModule(FockSpace& fock_space_target, FockSpace& fock_space_fixed, bool target_is_major, const HamiltonianParameters& hamiltonian_parameters, const PassToMethod& method);
+    template <typename Sink>
+    void oneOperatorModule(const FockSpace& fock_space_target, const FockSpace& fock_space_fixed, bool target_is_major, const HoppingList& hoppings, const Sink& sink) const;
 
 
 public:
@@ -96,6 +106,65 @@ public:
      *  @return the diagonal of the matrix representation of the Hubbard Hamiltonian
      */
     Eigen::VectorXd calculateDiagonal(const HamiltonianParameters& hamiltonian_parameters) override;
+
+    /**
+     *  @param hamiltonian_parameters       the Hubbard Hamiltonian parameters in an orthonormal orbital basis
+     *  @param X                            the block of vectors (as columns) upon which the Hubbard Hamiltonian acts
+     *  @param diagonal                     the diagonal of the Hubbard Hamiltonian matrix
+     *
+     *  @return the action of the Hubbard Hamiltonian on every column of X, generating every matrix element only once for the whole block (cfr. matrixMatrixProduct())
+     */
+    Eigen::MatrixXd blockMatrixVectorProduct(const HamiltonianParameters& hamiltonian_parameters, const Eigen::MatrixXd& X, const Eigen::VectorXd& diagonal) override;
+
+
+    // PUBLIC METHODS
+    /**
+     *  @param hamiltonian_parameters       the Hubbard Hamiltonian parameters in an orthonormal orbital basis
+     *
+     *  @return the Hubbard Hamiltonian (including its diagonal) as a sparse matrix
+     */
+    Eigen::SparseMatrix<double> constructSparseHamiltonian(const HamiltonianParameters& hamiltonian_parameters);
+
+    /**
+     *  @param hamiltonian_parameters       the Hubbard Hamiltonian parameters in an orthonormal orbital basis
+     *  @param X                            the block of vectors (as columns) upon which the Hubbard Hamiltonian acts
+     *  @param diagonal                     the diagonal of the Hubbard Hamiltonian matrix
+     *
+     *  @return the action of the Hubbard Hamiltonian on every column of X, generating every matrix element only once for the whole block
+     */
+    Eigen::MatrixXd matrixMatrixProduct(const HamiltonianParameters& hamiltonian_parameters, const Eigen::MatrixXd& X, const Eigen::VectorXd& diagonal);
+
+    /**
+     *  @param model_parameters     the (sparse) model Hamiltonian parameters
+     *
+     *  @return the Hubbard Hamiltonian matrix
+     */
+    Eigen::MatrixXd constructHamiltonian(const ModelHamiltonianParameters& model_parameters);
+
+    /**
+     *  @param model_parameters     the (sparse) model Hamiltonian parameters
+     *  @param x                    the vector upon which the Hubbard Hamiltonian acts
+     *  @param diagonal             the diagonal of the Hubbard Hamiltonian matrix
+     *
+     *  @return the action of the Hubbard Hamiltonian on the coefficient vector
+     */
+    Eigen::VectorXd matrixVectorProduct(const ModelHamiltonianParameters& model_parameters, const Eigen::VectorXd& x, const Eigen::VectorXd& diagonal);
+
+    /**
+     *  @param model_parameters     the (sparse) model Hamiltonian parameters
+     *  @param X                    the block of vectors (as columns) upon which the Hubbard Hamiltonian acts
+     *  @param diagonal             the diagonal of the Hubbard Hamiltonian matrix
+     *
+     *  @return the action of the Hubbard Hamiltonian on every column of X, generating every matrix element only once for the whole block
+     */
+    Eigen::MatrixXd blockMatrixVectorProduct(const ModelHamiltonianParameters& model_parameters, const Eigen::MatrixXd& X, const Eigen::VectorXd& diagonal);
+
+    /**
+     *  @param model_parameters     the (sparse) model Hamiltonian parameters
+     *
+     *  @return the diagonal of the matrix representation of the Hubbard Hamiltonian, including the on-site energies and the inter-site repulsions
+     */
+    Eigen::VectorXd calculateDiagonal(const ModelHamiltonianParameters& model_parameters);
 };
 
 
@@ -114,6 +183,116 @@ public:
  */
 Eigen::VectorXd generateUpperTriagonal(Eigen::MatrixXd A, double t, double U);
 
+/**
+ *  @param h        the one-electron integrals (i.e. the hopping matrix) of a Hubbard lattice
+ *
+ *  @return the adjacency lists of the lattice, together with the hopping parameters: for every site p, the (ascending) sites q>p that have a non-zero hopping h_pq with p
+ */
+HoppingList generateHoppingList(const OneElectronOperator& h);
+
+/**
+ *  @param h        the (sparse) hopping matrix of a Hubbard lattice
+ *
+ *  @return the adjacency lists of the lattice, together with the hopping parameters: for every site p, the (ascending) sites q>p that have a non-zero hopping h_pq with p
+ */
+HoppingList generateHoppingList(const Eigen::SparseMatrix<double>& h);
+
+
+
+/*
+ *  PRIVATE TEMPLATE METHODS
+ */
+
+/**
+ *  Evaluate the one-electron operators for alpha or beta and pass every matrix element to the given sink, which defines to what and how the evaluated elements will be added
+ *
+ *  Only the hoppings between neighbouring sites (i.e. with a non-zero one-electron integral) are visited, so the work per ONV scales with the coordination number of the lattice rather than with K
+ *
+ *  @tparam Sink                    the type of the sink: a (lambda) function object with signature void(size_t I, size_t J, double value). Since the sink is a template parameter, it is inlined into the innermost loop
+ *
+ *  @param fock_space_target        the Fock space that is used as a target, i.e. that is evaluated
+ *  @param fock_space_fixed         the Fock space that is not evaluated
+ *  @param target_is_major          whether or not the evaluated component is the major index
+ *  @param hoppings                 the adjacency lists of the lattice, together with the hopping parameters (cfr. generateHoppingList())
+ *  @param sink                     the function object that receives the matrix elements, e.g. for constructHamiltonian() or matrixVectorProduct()
+ */
+template <typename Sink>
+void Hubbard::oneOperatorModule(const FockSpace& fock_space_target, const FockSpace& fock_space_fixed, bool target_is_major, const HoppingList& hoppings, const Sink& sink) const {
+
+    size_t N = fock_space_target.get_N();
+    size_t dim = fock_space_target.get_dimension();
+    size_t dim_fixed = fock_space_fixed.get_dimension();
+
+    size_t fixed_intervals;
+    size_t target_interval;
+
+    // If the target is major, then the interval for the non-target (or fixed component) is 1
+    // while the the target (major) intervals after each fixed (minor) iteration, thus at the dimension of the fixed component.
+    if (target_is_major) {
+        fixed_intervals = 1;
+        target_interval = dim_fixed;
+
+    // vice versa, if the target is not major, its own interval is 1,
+    // and the fixed component intervals at the targets dimension.
+    } else {
+        fixed_intervals = dim;
+        target_interval = 1;
+    }
+
+    // shifts[e] is the total change in address when the electrons 0, ..., e all move down one electron index (i.e. when an electron before them is annihilated)
+    // Since the address of every moved electron decreases, we rely on unsigned wrap-around, just like in the address arithmetic below
+    std::vector<size_t> shifts (N);
+
+    ONV onv = fock_space_target.get_ONV(0);  // onv with address 0
+    for (size_t I = 0; I < dim; I++) {  // I loops over all the addresses of the onv
+
+        size_t representation = onv.get_unsigned_representation();
+        size_t shift = 0;
+        for (size_t e = 0; e < N; e++) {
+            // The weight of electron e changes from the one at (its orbital, e+1) to the one at (its orbital, e)
+            size_t r = onv.get_occupied_index(e);
+            shift += fock_space_target.get_vertex_weights(r, e) - fock_space_target.get_vertex_weights(r, e + 1);
+            shifts[e] = shift;
+        }
+
+        for (size_t e1 = 0; e1 < N; e1++) {  // e1 (electron 1) loops over the (number of) electrons
+            size_t p = onv.get_occupied_index(e1);  // retrieve the index of a given electron
+
+            // remove the weight from the initial address I, because we annihilate
+            size_t address = I - fock_space_target.get_vertex_weights(p, e1 + 1);
+
+            // We only consider greater orbital indices q>p (and thus greater addresses than the initial one) because of symmetry
+            for (const auto& hopping : hoppings[p]) {
+                size_t q = hopping.first;
+                if (onv.isOccupied_unchecked(q)) {
+                    continue;
+                }
+
+                // The electrons e1+1, ..., e2-1 lie between p and q: they move down one electron index, and skipping over them causes a phase change
+                // The created electron then becomes electron e2-1 (i.e. it is at electron count e2)
+                size_t e2 = __builtin_popcountl(representation & ((1UL << q) - 1));  // the number of electrons in orbitals < q
+                int sign_e2 = ((e2 - 1 - e1) % 2 == 0) ? 1 : -1;
+
+                size_t J = address + (shifts[e2 - 1] - shifts[e1]) + fock_space_target.get_vertex_weights(q, e2);
+
+                // address has been calculated, update accordingly and at all instances of the fixed component
+                for (size_t I_fixed = 0; I_fixed < dim_fixed; I_fixed++){
+                    double val = sign_e2 * hopping.second;
+                    sink(I * target_interval + I_fixed * fixed_intervals, J * target_interval + I_fixed * fixed_intervals, val);
+                    sink(J * target_interval + I_fixed * fixed_intervals, I * target_interval + I_fixed * fixed_intervals, val);
+                }
+            }  //  (creation)
+
+        } // e1 loop (annihilation)
+
+        // Prevent last permutation
+        if (I < dim - 1) {
+            fock_space_target.setNext(onv, I);
+        }
+    }
+
+}
+
 
 }  // namespace GQCP
 
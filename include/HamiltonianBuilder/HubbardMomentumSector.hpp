@@ -0,0 +1,222 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2018  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#ifndef GQCP_HUBBARDMOMENTUMSECTOR_HPP
+#define GQCP_HUBBARDMOMENTUMSECTOR_HPP
+
+
+#include "HamiltonianParameters/HamiltonianParameters.hpp"
+#include "FockSpace/ProductFockSpace.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <utility>
+#include <vector>
+
+
+
+namespace GQCP {
+
+
+/**
+ *  A class that represents the Hubbard Hamiltonian of a periodic ring in one sector of total crystal momentum
+ *
+ *  If the hopping matrix of a ring of K sites is invariant under the translation T: p -> p+1 (mod K) and the on-site repulsion is equal for every site, the Hamiltonian commutes with T and is block-diagonal in the total crystal momentum 2 pi k / K (k = 0, ..., K-1)
+ *  The sector with momentum quantum number k is spanned by the momentum states
+ *      |r(k)> = 1/sqrt(P_r) sum_{j=0}^{P_r-1} exp(-2 pi i k j / K) T^j |r>
+ *
+ *  in which |r> is the representative (i.e. the smallest (alpha, beta) pair of representations) of a translation orbit with period P_r. Orbits for which this sum vanishes (because of the fermionic sign that T^P_r picks up) do not contribute to the sector
+ *
+ *  Since every orbit contains (at most) K ONVs, the dimension of a sector is roughly the dimension of the product Fock space divided by K
+ */
+class HubbardMomentumSector {
+private:
+    ProductFockSpace fock_space;  // the full alpha and beta product Fock space
+    size_t k;  // the momentum quantum number
+
+    std::vector<std::pair<size_t, size_t>> representatives;  // the (alpha, beta) representations of the orbit representatives, sorted
+    std::vector<size_t> periods;  // the period of every representative's orbit under translation
+    std::vector<std::complex<double>> phases;  // exp(2 pi i k d / K) for d = 0, ..., K-1
+
+
+    // PRIVATE METHODS
+    /**
+     *  @param representation       the representation of a spin string
+     *  @param sign                 the sign that is updated with the fermionic phase factor of the translation
+     *
+     *  @return the representation of the spin string that is translated over one site, i.e. T|representation> = sign |result>
+     */
+    size_t translate(size_t representation, int& sign) const;
+
+    /**
+     *  @param alpha            the representation of the alpha spin string of an ONV |s>
+     *  @param beta             the representation of the beta spin string of an ONV |s>
+     *  @param index            the index of the representative |r> of the orbit of |s>
+     *  @param distance         the number of translations d that maps the representative onto |s>
+     *  @param sign             the fermionic sign of that translation, i.e. T^d |r> = sign |s>
+     *
+     *  @return if the orbit of |s> contributes to this momentum sector
+     */
+    bool findRepresentative(size_t alpha, size_t beta, size_t& index, size_t& distance, int& sign) const;
+
+    /**
+     *  @param hamiltonian_parameters       the Hubbard Hamiltonian parameters in an orthonormal orbital basis
+     *
+     *  Throw if the Hamiltonian parameters are not compatible with the Fock space or are not invariant under translation
+     */
+    void checkHamiltonianParameters(const HamiltonianParameters& hamiltonian_parameters) const;
+
+    /**
+     *  Evaluate all the matrix elements of the Hubbard Hamiltonian in this momentum sector and pass them to the given sink
+     *
+     *  @tparam Sink                        the type of the sink: a (lambda) function object with signature void(size_t I, size_t J, std::complex<double> value)
+     *
+     *  @param hamiltonian_parameters       the Hubbard Hamiltonian parameters in an orthonormal orbital basis
+     *  @param sink                         the function object that receives the matrix elements
+     */
+    template <typename Sink>
+    void evaluate(const HamiltonianParameters& hamiltonian_parameters, const Sink& sink) const;
+
+
+public:
+    // CONSTRUCTORS
+    /**
+     *  @param fock_space       the full alpha and beta product Fock space, of which the orbitals are the sites of the ring
+     *  @param k                the momentum quantum number: the crystal momentum is 2 pi k / K
+     */
+    HubbardMomentumSector(const ProductFockSpace& fock_space, size_t k);
+
+
+    // GETTERS
+    size_t get_dimension() const { return this->representatives.size(); }
+    size_t get_k() const { return this->k; }
+    const std::vector<std::pair<size_t, size_t>>& get_representatives() const { return this->representatives; }
+    const std::vector<size_t>& get_periods() const { return this->periods; }
+
+
+    // PUBLIC METHODS
+    /**
+     *  @param hamiltonian_parameters       the Hubbard Hamiltonian parameters in an orthonormal orbital basis
+     *
+     *  @return the (Hermitian) Hubbard Hamiltonian matrix in this momentum sector
+     */
+    Eigen::MatrixXcd constructHamiltonian(const HamiltonianParameters& hamiltonian_parameters) const;
+
+    /**
+     *  @param hamiltonian_parameters       the Hubbard Hamiltonian parameters in an orthonormal orbital basis
+     *  @param x                            the vector upon which the Hubbard Hamiltonian acts
+     *
+     *  @return the action of the Hubbard Hamiltonian in this momentum sector on the coefficient vector
+     */
+    Eigen::VectorXcd matrixVectorProduct(const HamiltonianParameters& hamiltonian_parameters, const Eigen::VectorXcd& x) const;
+
+    /**
+     *  @param hamiltonian_parameters       the Hubbard Hamiltonian parameters in an orthonormal orbital basis
+     *
+     *  @return the (ascending) eigenvalues of the Hubbard Hamiltonian in this momentum sector
+     */
+    Eigen::VectorXd calculateEigenvalues(const HamiltonianParameters& hamiltonian_parameters) const;
+};
+
+
+
+/*
+ *  PRIVATE TEMPLATE METHODS
+ */
+
+/**
+ *  Evaluate all the matrix elements of the Hubbard Hamiltonian in this momentum sector and pass them to the given sink
+ *
+ *  @tparam Sink                        the type of the sink: a (lambda) function object with signature void(size_t I, size_t J, std::complex<double> value)
+ *
+ *  @param hamiltonian_parameters       the Hubbard Hamiltonian parameters in an orthonormal orbital basis
+ *  @param sink                         the function object that receives the matrix elements
+ */
+template <typename Sink>
+void HubbardMomentumSector::evaluate(const HamiltonianParameters& hamiltonian_parameters, const Sink& sink) const {
+
+    this->checkHamiltonianParameters(hamiltonian_parameters);
+
+    size_t K = this->fock_space.get_K();
+    const auto& h = hamiltonian_parameters.get_h();
+    const auto& g = hamiltonian_parameters.get_g();
+
+    // Since H commutes with T, H|r(k)> = sum_s <s|H|r> exp(2 pi i k d / K) sign sqrt(P_r / P_rho) |rho(k)>, in which T^d |rho> = sign |s>
+    // (Every representative is a column J, and the representatives rho that are reached are the rows I)
+    auto pass = [this, &sink] (size_t alpha, size_t beta, size_t J, double value) {
+        size_t I;
+        size_t distance;
+        int sign = 1;
+        if (this->findRepresentative(alpha, beta, I, distance, sign)) {
+            double normalization = std::sqrt(static_cast<double>(this->periods[J]) / this->periods[I]);
+            sink(I, J, static_cast<double>(sign) * value * normalization * this->phases[distance]);
+        }
+    };
+
+    for (size_t J = 0; J < this->representatives.size(); J++) {
+        size_t alpha = this->representatives[J].first;
+        size_t beta = this->representatives[J].second;
+
+        // Diagonal contributions: on-site orbital energies and repulsions
+        double diagonal_value = 0.0;
+        for (size_t p = 0; p < K; p++) {
+            bool alpha_occupied = alpha & (1UL << p);
+            bool beta_occupied = beta & (1UL << p);
+
+            if (alpha_occupied) {
+                diagonal_value += h(p,p);
+            }
+            if (beta_occupied) {
+                diagonal_value += h(p,p);
+            }
+            if (alpha_occupied && beta_occupied) {
+                diagonal_value += g(p,p,p,p);
+            }
+        }
+        pass(alpha, beta, J, diagonal_value);
+
+        // One-electron hopping contributions a^dagger_p a_q, for both spin strings
+        for (size_t q = 0; q < K; q++) {
+            for (size_t p = 0; p < K; p++) {
+                if ((p == q) || (h(p,q) == 0.0)) {
+                    continue;
+                }
+
+                // The sign is determined by the number of electrons between p and q
+                size_t between = ((1UL << std::max(p, q)) - 1) & ~((1UL << (std::min(p, q) + 1)) - 1);
+                size_t hop = (1UL << p) | (1UL << q);
+
+                if ((alpha & (1UL << q)) && !(alpha & (1UL << p))) {
+                    int sign = (__builtin_popcountl(alpha & between) % 2 == 0) ? 1 : -1;
+                    pass(alpha ^ hop, beta, J, sign * h(p,q));
+                }
+
+                if ((beta & (1UL << q)) && !(beta & (1UL << p))) {
+                    int sign = (__builtin_popcountl(beta & between) % 2 == 0) ? 1 : -1;
+                    pass(alpha, beta ^ hop, J, sign * h(p,q));
+                }
+            }
+        }
+    }  // representative (J) loop
+}
+
+
+}  // namespace GQCP
+
+
+#endif  // GQCP_HUBBARDMOMENTUMSECTOR_HPP
@@ -0,0 +1,163 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2018  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#ifndef GQCP_SELECTEDCI_HPP
+#define GQCP_SELECTEDCI_HPP
+
+
+#include "HamiltonianBuilder/HamiltonianBuilder.hpp"
+#include "FockSpace/SelectedFockSpace.hpp"
+
+#include <Eigen/Sparse>
+
+
+
+namespace GQCP {
+
+
+/**
+ *  A HamiltonianBuilder for selected CI: it builds the matrix representation of the Hamiltonian in a Fock space that is spanned by an arbitrary set of configurations
+ *
+ *  The coefficient vectors follow the ordering of the configurations in the given Fock space. Internally, the builder keeps a copy of the Fock space in the canonical layout (see SelectedFockSpace::canonicalize()), in which the configurations that are coupled to a configuration I are found without comparing all pairs:
+ *      - beta excitations: among the configurations that share the alpha string of I (a contiguous range)
+ *      - alpha excitations: among the configurations that share the beta string of I (a sorted list)
+ *      - mixed alpha-beta excitations: among the configurations whose alpha string is a single excitation of the alpha string of I, and that are found by looking up every single alpha excitation in the alpha string table
+ *
+ *  Optionally, the full Hamiltonian (including its diagonal) can be stored as a row-major (CSR) sparse matrix, after which every matrix-vector product is a single sparse matrix-vector product.
+ */
+class SelectedCI : public GQCP::HamiltonianBuilder {
+private:
+    SelectedFockSpace fock_space;  // the selected configurations, in the caller's ordering
+    SelectedFockSpace canonical_fock_space;  // the selected configurations, in the canonical layout
+    std::vector<size_t> addresses;  // the address in fock_space of every configuration in canonical_fock_space
+
+    bool use_sparse_hamiltonian;  // if the sparse Hamiltonian should be stored and used for matrix-vector products
+    Eigen::SparseMatrix<double, Eigen::RowMajor> sparse_hamiltonian;  // the stored Hamiltonian in CSR format (only used if use_sparse_hamiltonian is true)
+    Eigen::MatrixXd sparse_hamiltonian_h;  // the one-electron integrals from which the stored sparse Hamiltonian was built
+    Eigen::Tensor<double, 4> sparse_hamiltonian_g;  // the two-electron integrals from which the stored sparse Hamiltonian was built
+
+
+    // PRIVATE METHODS
+    /**
+     *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+     *
+     *  Throw if the Hamiltonian parameters are incompatible with the Fock space
+     */
+    void checkCompatibility(const HamiltonianParameters& hamiltonian_parameters) const;
+
+    /**
+     *  (Re)build the stored sparse Hamiltonian if none has been stored yet, or if it was built from other Hamiltonian parameters
+     *
+     *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+     */
+    void updateSparseHamiltonian(const HamiltonianParameters& hamiltonian_parameters);
+
+
+public:
+    // CONSTRUCTORS
+    /**
+     *  @param fock_space                   the Fock space spanned by the selected configurations, whose ordering is followed by all coefficient vectors
+     *  @param use_sparse_hamiltonian       if the Hamiltonian should be stored as a sparse matrix and be used in matrixVectorProduct()
+     */
+    explicit SelectedCI(const SelectedFockSpace& fock_space, bool use_sparse_hamiltonian = false);
+
+
+    // DESTRUCTOR
+    ~SelectedCI() = default;
+
+
+    // GETTERS
+    bool uses_sparse_hamiltonian() const { return this->use_sparse_hamiltonian; }
+    const Eigen::SparseMatrix<double, Eigen::RowMajor>& get_sparse_hamiltonian() const { return this->sparse_hamiltonian; }
+
+
+    // OVERRIDDEN GETTERS
+    BaseFockSpace* get_fock_space() override { return &fock_space; }
+
+
+    // OVERRIDDEN PUBLIC METHODS
+    /**
+     *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+     *
+     *  @return the selected CI Hamiltonian matrix
+     *
+     *  If the sparse Hamiltonian is used, it is (re)built and stored if it doesn't correspond to the given Hamiltonian parameters
+     */
+    Eigen::MatrixXd constructHamiltonian(const HamiltonianParameters& hamiltonian_parameters) override;
+
+    /**
+     *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+     *  @param x                            the vector upon which the selected CI Hamiltonian acts
+     *  @param diagonal                     the diagonal of the selected CI Hamiltonian matrix
+     *
+     *  @return the action of the selected CI Hamiltonian on the coefficient vector
+     *
+     *  If the sparse Hamiltonian is used, the stored sparse Hamiltonian (which already contains the diagonal) is multiplied with x. It is (re)built if none has been stored yet, or if it was built from other Hamiltonian parameters.
+     *  Otherwise, the off-diagonal contributions are gathered row by row: the configurations are split over the available (OpenMP) threads, and every thread only writes to its own range of the matrix-vector product.
+     */
+    Eigen::VectorXd matrixVectorProduct(const HamiltonianParameters& hamiltonian_parameters, const Eigen::VectorXd& x, const Eigen::VectorXd& diagonal) override;
+
+    /**
+     *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+     *
+     *  @return the diagonal of the matrix representation of the selected CI Hamiltonian
+     */
+    Eigen::VectorXd calculateDiagonal(const HamiltonianParameters& hamiltonian_parameters) override;
+
+    /**
+     *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+     *  @param X                            the vectors (as columns) upon which the selected CI Hamiltonian acts
+     *  @param diagonal                     the diagonal of the selected CI Hamiltonian matrix
+     *
+     *  @return the action of the selected CI Hamiltonian on every column of X
+     *
+     *  If the sparse Hamiltonian is used, it is handled as in matrixVectorProduct(). Otherwise, every coupling (and its matrix element) is found only once for the whole block: the rows are gathered as in matrixVectorProduct(), reading X through its (contiguous) transpose.
+     */
+    Eigen::MatrixXd blockMatrixVectorProduct(const HamiltonianParameters& hamiltonian_parameters, const Eigen::MatrixXd& X, const Eigen::VectorXd& diagonal) override;
+
+
+    // PUBLIC METHODS
+    /**
+     *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+     *
+     *  @return the selected CI Hamiltonian (including its diagonal) as a row-major (CSR) sparse matrix
+     */
+    Eigen::SparseMatrix<double, Eigen::RowMajor> constructSparseHamiltonian(const HamiltonianParameters& hamiltonian_parameters);
+
+    /**
+     *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+     *  @param configuration                the configuration
+     *
+     *  @return the diagonal element of the Hamiltonian for the given configuration
+     */
+    static double calculateDiagonalElement(const HamiltonianParameters& hamiltonian_parameters, const Configuration& configuration);
+
+    /**
+     *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+     *  @param configuration_I              the configuration of the bra
+     *  @param configuration_J              the configuration of the ket, which should differ in one or two electron excitations from the bra
+     *
+     *  @return the Hamiltonian matrix element <I|H|J>, calculated with the Slater-Condon rules
+     */
+    static double calculateOffDiagonalElement(const HamiltonianParameters& hamiltonian_parameters, const Configuration& configuration_I, const Configuration& configuration_J);
+};
+
+
+}  // namespace GQCP
+
+
+#endif  // GQCP_SELECTEDCI_HPP
@@ -24,6 +24,7 @@
 
 #include "AOBasis.hpp"
 #include "HamiltonianParameters.hpp"
+#include "HamiltonianParameters/ModelHamiltonianParameters.hpp"
 
 
 
@@ -67,6 +68,15 @@ GQCP::HamiltonianParameters readFCIDUMPFile(const std::string& fcidump_file);
 GQCP::HamiltonianParameters constructHubbardParameters(const Eigen::VectorXd& upper_triagonal);
 
 
+/**
+ *  @param upper_triagonal      an upper triagonal representation of the Hubbard hopping matrix
+ *  @param V                    the inter-site repulsion between neighbouring sites, i.e. sites with a non-zero hopping
+ *
+ *  @return (sparse) model Hamiltonian parameters generated from the Hubbard hopping matrix
+ */
+GQCP::ModelHamiltonianParameters constructHubbardModelParameters(const Eigen::VectorXd& upper_triagonal, double V = 0.0);
+
+
 }  // namespace GQCP
 
 
@@ -0,0 +1,87 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2018  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#ifndef GQCP_MODELHAMILTONIANPARAMETERS_HPP
+#define GQCP_MODELHAMILTONIANPARAMETERS_HPP
+
+
+#include "HamiltonianParameters/BaseHamiltonianParameters.hpp"
+#include "HamiltonianParameters/HamiltonianParameters.hpp"
+
+#include <Eigen/Sparse>
+
+
+
+namespace GQCP {
+
+
+/**
+ *  A class for representing the parameters of a lattice model Hamiltonian
+ *      H = sum_{pq,sigma} h_pq a^dagger_{p sigma} a_{q sigma} + sum_p U_p n_{p alpha} n_{p beta} + sum_{p<q} V_pq n_p n_q
+ *
+ *  Instead of storing the full (K^4) two-electron integrals, the hopping is stored as a sparse matrix, the on-site repulsion as a vector and the (optional) inter-site repulsion as a sparse matrix, so that the memory requirements scale with the number of interactions
+ */
+class ModelHamiltonianParameters : public BaseHamiltonianParameters {
+private:
+    size_t K;  // the number of sites
+
+    Eigen::SparseMatrix<double> h;  // the (symmetric) hopping matrix, whose diagonal contains the on-site energies
+    Eigen::VectorXd U;  // the on-site repulsions
+    Eigen::SparseMatrix<double> V;  // the (symmetric) inter-site repulsions, with a zero diagonal
+
+
+public:
+    // CONSTRUCTORS
+    /**
+     *  @param h            the (symmetric) hopping matrix, whose diagonal contains the on-site energies
+     *  @param U            the on-site repulsions
+     */
+    ModelHamiltonianParameters(const Eigen::SparseMatrix<double>& h, const Eigen::VectorXd& U);
+
+    /**
+     *  @param h            the (symmetric) hopping matrix, whose diagonal contains the on-site energies
+     *  @param U            the on-site repulsions
+     *  @param V            the (symmetric) inter-site repulsions, with a zero diagonal
+     */
+    ModelHamiltonianParameters(const Eigen::SparseMatrix<double>& h, const Eigen::VectorXd& U, const Eigen::SparseMatrix<double>& V);
+
+
+    // DESTRUCTORS
+    ~ModelHamiltonianParameters() override = default;
+
+
+    // GETTERS
+    size_t get_K() const { return this->K; }
+    const Eigen::SparseMatrix<double>& get_h() const { return this->h; }
+    const Eigen::VectorXd& get_U() const { return this->U; }
+    const Eigen::SparseMatrix<double>& get_V() const { return this->V; }
+
+
+    // PUBLIC METHODS
+    /**
+     *  @return the equivalent (dense) Hamiltonian parameters in the orthonormal site basis
+     *
+     *  Note that the two-electron integrals require K^4 doubles, so this should only be used for small lattices
+     */
+    HamiltonianParameters constructHamiltonianParameters() const;
+};
+
+
+}  // namespace GQCP
+
+
+#endif  // GQCP_MODELHAMILTONIANPARAMETERS_HPP
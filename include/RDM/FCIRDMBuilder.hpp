@@ -61,6 +61,17 @@ public:
      *  @return all 2-RDMs given a coefficient vector
      */
     TwoRDMs calculate2RDMs(const Eigen::VectorXd& x) override;
+
+
+    // PUBLIC METHODS
+    /**
+     *  @param x        the coefficient vector representing the FCI wave function
+     *
+     *  @return the K x K matrix of the (spin-summed) 2-RDM elements d_ppqq = <n_p n_q> - delta_pq <n_p>, which is all the energy of a model Hamiltonian with on-site and inter-site repulsions requires
+     *
+     *  Since the occupation number operators are diagonal in the ONV basis, only the weights |x_I|^2 contribute, and the K^4 2-RDM is never constructed
+     */
+    Eigen::MatrixXd calculateDensityDensity2RDM(const Eigen::VectorXd& x) const;
 };
 
 
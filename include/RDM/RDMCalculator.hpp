@@ -22,6 +22,7 @@
 #include "FockSpace/FockSpace.hpp"
 #include "FockSpace/ProductFockSpace.hpp"
 #include "FockSpace/SelectedFockSpace.hpp"
+#include "WaveFunction/SparseWaveFunction.hpp"
 
 #include <memory>
 
@@ -36,6 +37,16 @@ class RDMCalculator {
 private:
     std::shared_ptr<GQCP::BaseRDMBuilder> rdm_builder;
 
+
+    // PRIVATE METHODS
+    /**
+     *  Throw if the given sparse wave function doesn't live in a Fock space of the same type and dimension as the one of this RDMCalculator
+     *
+     *  @param wave_function        the sparse wave function
+     */
+    void checkCompatibility(const SparseWaveFunction& wave_function);
+
+
 public:
     // CONSTRUCTOR
     /**
@@ -81,6 +92,20 @@ public:
      *  @return all 2-RDMs given a coefficient vector
      */
     TwoRDMs calculate2RDMs(const Eigen::VectorXd& x);
+
+    /**
+     *  @param wave_function        the sparse wave function, which should live in the Fock space of this RDMCalculator
+     *
+     *  @return all 1-RDMs of the sparse wave function, in which only the retained configurations contribute
+     */
+    OneRDMs calculate1RDMs(const SparseWaveFunction& wave_function);
+
+    /**
+     *  @param wave_function        the sparse wave function, which should live in the Fock space of this RDMCalculator
+     *
+     *  @return all 2-RDMs of the sparse wave function, in which only the retained configurations contribute
+     */
+    TwoRDMs calculate2RDMs(const SparseWaveFunction& wave_function);
 };
 
 
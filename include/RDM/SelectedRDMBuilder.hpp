@@ -29,9 +29,13 @@ namespace GQCP {
 
 /**
  *  A class capable of calculating 1- and 2-RDMs from wave functions expanded in a selected Fock space
+ *
+ *  Only the pairs of configurations that are coupled by a single or double excitation contribute to the off-diagonal RDM elements: these are enumerated through the canonical layout of (a copy of) the selected Fock space, so that the cost scales with the dimension times the connectivity instead of with the square of the dimension
  */
 class SelectedRDMBuilder : public BaseRDMBuilder {
     SelectedFockSpace fock_space;  // Fock space containing the selected configurations
+    SelectedFockSpace canonical_fock_space;  // the selected configurations in the canonical layout
+    std::vector<size_t> addresses;  // the address in fock_space of every configuration in canonical_fock_space, i.e. of every coefficient that is used
 
 
 public:
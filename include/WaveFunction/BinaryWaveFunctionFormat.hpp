@@ -0,0 +1,85 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2018  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#ifndef GQCP_BINARYWAVEFUNCTIONFORMAT_HPP
+#define GQCP_BINARYWAVEFUNCTIONFORMAT_HPP
+
+
+#include "common.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace GQCP {
+
+
+/**
+ *  The header of the binary format for 'selected' wave function expansions
+ *
+ *  A binary wave function file consists of this (64-byte) header, followed by one record per configuration: the packed 64-bit words of the alpha string, those of the beta string and the coefficient as a double. All values are stored in the byte order of the machine that wrote the file.
+ *
+ *  The checksums are running 64-bit FNV-1a-style hashes (see updateFNVChecksum()) over the configuration words and over the coefficients, in the order of the records
+ */
+struct BinaryWaveFunctionHeader {
+    static constexpr uint32_t current_version = 1;
+    static constexpr uint64_t initial_checksum = fnv_offset_basis;
+
+    char magic[8];  // "GQCPWFN" followed by a null character
+    uint32_t version;  // the version of the format
+    uint32_t words_per_string;  // the number of 64-bit words that are used for every alpha or beta string
+    uint64_t K;  // the number of orbitals
+    uint64_t N_alpha;  // the number of alpha electrons
+    uint64_t N_beta;  // the number of beta electrons
+    uint64_t number_of_configurations;
+    uint64_t configuration_checksum;
+    uint64_t coefficient_checksum;
+
+
+    // CONSTRUCTORS
+    BinaryWaveFunctionHeader() = default;
+
+    /**
+     *  @param K            the number of orbitals
+     *  @param N_alpha      the number of alpha electrons
+     *  @param N_beta       the number of beta electrons
+     *
+     *  Construct the header of a file that doesn't contain any configurations yet
+     */
+    BinaryWaveFunctionHeader(size_t K, size_t N_alpha, size_t N_beta);
+
+
+    // PUBLIC METHODS
+    /**
+     *  @return if the header starts with the magic characters of the format
+     */
+    bool hasValidMagic() const;
+
+    /**
+     *  @return the size (in bytes) of the record of one configuration
+     */
+    size_t get_record_size() const { return (2 * this->words_per_string + 1) * sizeof(uint64_t); }
+};
+
+
+static_assert(sizeof(BinaryWaveFunctionHeader) == 64, "The header of the binary wave function format should occupy 64 bytes.");
+
+
+}  // namespace GQCP
+
+
+#endif  // GQCP_BINARYWAVEFUNCTIONFORMAT_HPP
@@ -0,0 +1,62 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2018  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#ifndef GQCP_BINARYWAVEFUNCTIONREADER_HPP
+#define GQCP_BINARYWAVEFUNCTIONREADER_HPP
+
+
+#include "FockSpace/SelectedFockSpace.hpp"
+#include "WaveFunction/BinaryWaveFunctionFormat.hpp"
+#include "WaveFunction/WaveFunction.hpp"
+
+#include <string>
+
+
+namespace GQCP {
+
+
+/**
+ *  A class that reads and stores a 'selected' wave function expansion from a file in the binary format (see BinaryWaveFunctionHeader)
+ *
+ *  The file is memory-mapped and read in a single sequential pass, and its version, size and checksums are validated
+ */
+class BinaryWaveFunctionReader {
+private:
+    GQCP::SelectedFockSpace fock_space;
+    Eigen::VectorXd coefficients;
+    GQCP::WaveFunction wave_function;
+
+
+public:
+    // CONSTRUCTORS
+    /**
+     *  @param filename     the name of the binary file that contains the 'selected' wave function expansion
+     */
+    explicit BinaryWaveFunctionReader(const std::string& filename);
+
+
+    // GETTERS
+    const SelectedFockSpace& get_fock_space() const { return this->fock_space; }
+    const Eigen::VectorXd& get_coefficients() const { return this->coefficients; }
+    const WaveFunction& get_wave_function() const { return this->wave_function; }
+};
+
+
+}  // namespace GQCP
+
+
+#endif  // GQCP_BINARYWAVEFUNCTIONREADER_HPP
@@ -0,0 +1,94 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2018  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#ifndef GQCP_BINARYWAVEFUNCTIONWRITER_HPP
+#define GQCP_BINARYWAVEFUNCTIONWRITER_HPP
+
+
+#include "FockSpace/SelectedFockSpace.hpp"
+#include "WaveFunction/BinaryWaveFunctionFormat.hpp"
+
+#include <fstream>
+#include <string>
+
+
+namespace GQCP {
+
+
+/**
+ *  A class that writes a 'selected' wave function expansion to a file in the binary format (see BinaryWaveFunctionHeader)
+ *
+ *  The configurations are streamed to the file one by one, so that the expansion doesn't have to be held in memory: the header (with the number of configurations and the checksums) is completed when the writer is closed
+ */
+class BinaryWaveFunctionWriter {
+private:
+    std::ofstream output_file_stream;
+    BinaryWaveFunctionHeader header;
+    bool is_open;
+
+
+public:
+    // CONSTRUCTORS
+    /**
+     *  @param filename     the name of the binary file that is (over)written
+     *  @param K            the number of orbitals
+     *  @param N_alpha      the number of alpha electrons
+     *  @param N_beta       the number of beta electrons
+     */
+    BinaryWaveFunctionWriter(const std::string& filename, size_t K, size_t N_alpha, size_t N_beta);
+
+
+    // DESTRUCTOR
+    /**
+     *  Close the writer if that hasn't happened yet
+     */
+    ~BinaryWaveFunctionWriter();
+
+
+    // GETTERS
+    size_t get_number_of_configurations() const { return this->header.number_of_configurations; }
+
+
+    // PUBLIC METHODS
+    /**
+     *  Append a configuration and its coefficient to the file
+     *
+     *  @param configuration        the configuration
+     *  @param coefficient          the expansion coefficient of the configuration
+     */
+    void write(const Configuration& configuration, double coefficient);
+
+    /**
+     *  Complete the header and close the file
+     */
+    void close();
+
+
+    // STATIC PUBLIC METHODS
+    /**
+     *  @param filename         the name of the binary file that is (over)written
+     *  @param fock_space       the selected Fock space
+     *  @param coefficients     the expansion coefficients in the selected Fock space
+     */
+    static void writeToFile(const std::string& filename, const SelectedFockSpace& fock_space, const Eigen::VectorXd& coefficients);
+};
+
+
+}  // namespace GQCP
+
+
+#endif  // GQCP_BINARYWAVEFUNCTIONWRITER_HPP
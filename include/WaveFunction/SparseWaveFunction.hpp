@@ -0,0 +1,92 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2018  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#ifndef GQCP_SPARSEWAVEFUNCTION_HPP
+#define GQCP_SPARSEWAVEFUNCTION_HPP
+
+
+#include "FockSpace/SelectedFockSpace.hpp"
+#include "WaveFunction/WaveFunction.hpp"
+
+#include "common.hpp"
+
+#include <vector>
+
+
+namespace GQCP {
+
+
+/**
+ *  A class that represents a wave function by the addresses and coefficients of its non-negligible configurations only
+ *
+ *  When it is created from a dense wave function, the (squared) weight of the discarded coefficients is kept, so that the quality of the truncation can be assessed
+ */
+class SparseWaveFunction {
+private:
+    BaseFockSpace* fock_space;
+    std::vector<size_t> addresses;  // the addresses of the retained configurations in the Fock space, in increasing order
+    Eigen::VectorXd coefficients;  // the coefficients of the retained configurations
+    double discarded_weight;  // the sum of the squares of the discarded coefficients
+
+
+public:
+    // CONSTRUCTORS
+    /**
+     *  @param base_fock_space      the Fock space in which the wave function 'lives'
+     *  @param addresses            the addresses of the configurations, in increasing order
+     *  @param coefficients         the expansion coefficients of the configurations
+     */
+    SparseWaveFunction(BaseFockSpace& base_fock_space, const std::vector<size_t>& addresses, const Eigen::VectorXd& coefficients);
+
+    /**
+     *  @param wave_function        the dense wave function
+     *  @param threshold            only the coefficients that are at least this threshold (in absolute value) are retained
+     */
+    SparseWaveFunction(const WaveFunction& wave_function, double threshold);
+
+
+    // GETTERS
+    BaseFockSpace& get_fock_space() const { return *fock_space; }
+    const std::vector<size_t>& get_addresses() const { return this->addresses; }
+    const Eigen::VectorXd& get_coefficients() const { return this->coefficients; }
+    size_t get_number_of_configurations() const { return this->addresses.size(); }
+    double get_discarded_weight() const { return this->discarded_weight; }
+    double get_retained_weight() const { return this->coefficients.squaredNorm(); }
+
+
+    // PUBLIC METHODS
+    /**
+     *  Normalize the retained coefficients
+     */
+    void normalize();
+
+    /**
+     *  @return the coefficients in the full Fock space, in which the discarded coefficients are zero
+     */
+    Eigen::VectorXd calculateDenseCoefficients() const;
+
+    /**
+     *  @return the selected Fock space that is spanned by the retained configurations, in the order of their addresses
+     */
+    SelectedFockSpace constructSelectedFockSpace() const;
+};
+
+
+}  // namespace GQCP
+
+
+#endif  // GQCP_SPARSEWAVEFUNCTION_HPP
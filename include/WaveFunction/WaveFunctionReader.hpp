@@ -28,6 +28,8 @@ namespace GQCP {
 
 /**
  *  A class that reads and stores a 'selected' wave function expansion
+ *
+ *  The GAMESS file is read in a single, buffered pass: the bit strings are parsed directly into the representations of the ONVs, and the Fock space and coefficients grow as the configurations are read
  */
 class WaveFunctionReader {
 private:
@@ -36,11 +38,26 @@ private:
     GQCP::WaveFunction wave_function;
 
 
+    // STATIC PRIVATE METHODS
+    /**
+     *  Parse a GAMESS bit string, in which the first character corresponds to the first orbital, skipping leading whitespace
+     *
+     *  @param line                 the line that contains the bit string
+     *  @param position             the position in the line at which parsing starts, which is updated to the position right after the bit string
+     *  @param number_of_orbitals   the number of characters of the bit string
+     *
+     *  @return the unsigned representation of the bit string
+     */
+    static size_t parseBitString(const std::string& line, size_t& position, size_t& number_of_orbitals);
+
+
 public:
+    // CONSTRUCTORS
     /**
-     *  @param GAMESS_filename      the name of the GAMESS file that contains the 'selected' wave function expansion
+     *  @param GAMESS_filename          the name of the GAMESS file that contains the 'selected' wave function expansion
+     *  @param coefficient_threshold    only the configurations whose coefficient is at least this threshold (in absolute value) are kept
      */
-    explicit WaveFunctionReader(const std::string& GAMESS_filename);
+    explicit WaveFunctionReader(const std::string& GAMESS_filename, double coefficient_threshold = 0.0);
 
 
     // GETTERS
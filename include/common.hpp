@@ -19,6 +19,7 @@
 #define GQCP_COMMON_HPP
 
 
+#include <cstdint>
 #include <cstdlib>
 #include <vector>
 
@@ -33,6 +34,21 @@ typedef std::vector<Vectoru> Matrixu;
 using VectorXs = Eigen::Matrix<size_t, Eigen::Dynamic, 1>;
 
 
+/*
+ *  The running 64-bit FNV-1a-style checksums of the binary file formats: a checksum starts at the offset basis and is updated with one 64-bit word at a time
+ */
+constexpr uint64_t fnv_offset_basis = 14695981039346656037ULL;
+constexpr uint64_t fnv_prime = 1099511628211ULL;
+
+/**
+ *  @param checksum     the current value of the checksum
+ *  @param word         the word that is added to the checksum
+ *
+ *  @return the updated checksum
+ */
+inline uint64_t updateFNVChecksum(uint64_t checksum, uint64_t word) { return (checksum ^ word) * fnv_prime; }
+
+
 }  // namespace GQCP
 
 
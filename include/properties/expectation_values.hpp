@@ -21,6 +21,7 @@
 #include "RDM/OneRDM.hpp"
 #include "RDM/TwoRDM.hpp"
 #include "HamiltonianParameters/HamiltonianParameters.hpp"
+#include "HamiltonianParameters/ModelHamiltonianParameters.hpp"
 
 
 namespace GQCP {
@@ -87,6 +88,24 @@ double calculateExpectationValue(const GQCP::TwoElectronOperator& two_op, const
  */
 double calculateExpectationValue(const GQCP::HamiltonianParameters& ham_par, const GQCP::OneRDM& one_rdm, const GQCP::TwoRDM& two_rdm);
 
+/**
+ *  @param model_parameters     the (sparse) model Hamiltonian parameters
+ *  @param one_rdm              the 1-RDM
+ *  @param two_rdm              the 2-RDM
+ *
+ *  @return the expectation value of the model Hamiltonian, which only requires the elements of the 2-RDM that belong to on-site and inter-site repulsions
+ */
+double calculateExpectationValue(const GQCP::ModelHamiltonianParameters& model_parameters, const GQCP::OneRDM& one_rdm, const GQCP::TwoRDM& two_rdm);
+
+/**
+ *  @param model_parameters                 the (sparse) model Hamiltonian parameters
+ *  @param one_rdm                          the 1-RDM
+ *  @param density_density_two_rdm          the K x K matrix of the 2-RDM elements d_ppqq (see e.g. FCIRDMBuilder::calculateDensityDensity2RDM())
+ *
+ *  @return the expectation value of the model Hamiltonian, without requiring the K^4 2-RDM
+ */
+double calculateExpectationValue(const GQCP::ModelHamiltonianParameters& model_parameters, const GQCP::OneRDM& one_rdm, const Eigen::MatrixXd& density_density_two_rdm);
+
 
 }  // namespace GQCP
 
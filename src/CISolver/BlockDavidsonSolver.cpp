@@ -0,0 +1,389 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2018  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#include "CISolver/BlockDavidsonSolver.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+
+namespace GQCP {
+
+
+/*
+ *  CONSTRUCTORS
+ */
+
+/**
+ *  @param hamiltonian_builder      the HamiltonianBuilder for which the CI eigenvalue problem should be solved
+ *  @param hamiltonian_parameters   the Hamiltonian parameters in an orthonormal basis
+ *  @param options                  the options for the block Davidson solver
+ */
+BlockDavidsonSolver::BlockDavidsonSolver(HamiltonianBuilder& hamiltonian_builder, const HamiltonianParameters& hamiltonian_parameters, const BlockDavidsonSolverOptions& options) :
+    dim (hamiltonian_builder.get_fock_space()->get_dimension()),
+    options (options)
+{
+    auto K = hamiltonian_parameters.get_h().get_dim();
+    if (K != hamiltonian_builder.get_fock_space()->get_K()) {
+        throw std::invalid_argument("Basis functions of the Fock space and hamiltonian_parameters are incompatible.");
+    }
+
+    // The Hamiltonian parameters are shared by the function objects, rather than copied into each of them
+    HamiltonianBuilder* builder = &hamiltonian_builder;
+    auto parameters = std::make_shared<const HamiltonianParameters>(hamiltonian_parameters);
+
+    this->calculateDiagonal = [builder, parameters] () { return builder->calculateDiagonal(*parameters); };
+    this->blockMatrixVectorProduct = [builder, parameters] (const Eigen::MatrixXd& X, const Eigen::VectorXd& diagonal) { return builder->blockMatrixVectorProduct(*parameters, X, diagonal); };
+    this->calculateHamiltonianFingerprint = [parameters] (const Eigen::VectorXd& diagonal) { return DavidsonCheckpoint::calculateHamiltonianFingerprint(*parameters, diagonal); };
+
+    this->initializeOptions();
+}
+
+
+/**
+ *  @param hubbard                  the Hubbard HamiltonianBuilder for which the CI eigenvalue problem should be solved
+ *  @param model_parameters         the (sparse) model Hamiltonian parameters, which are used directly, i.e. without constructing the (K^4) two-electron integrals
+ *  @param options                  the options for the block Davidson solver
+ */
+BlockDavidsonSolver::BlockDavidsonSolver(Hubbard& hubbard, const ModelHamiltonianParameters& model_parameters, const BlockDavidsonSolverOptions& options) :
+    dim (hubbard.get_fock_space()->get_dimension()),
+    options (options)
+{
+    if (model_parameters.get_K() != hubbard.get_fock_space()->get_K()) {
+        throw std::invalid_argument("The number of sites of the Fock space and model_parameters are incompatible.");
+    }
+
+    // The model parameters are shared by the function objects, rather than copied into each of them
+    Hubbard* builder = &hubbard;
+    auto parameters = std::make_shared<const ModelHamiltonianParameters>(model_parameters);
+
+    this->calculateDiagonal = [builder, parameters] () { return builder->calculateDiagonal(*parameters); };
+    this->blockMatrixVectorProduct = [builder, parameters] (const Eigen::MatrixXd& X, const Eigen::VectorXd& diagonal) { return builder->blockMatrixVectorProduct(*parameters, X, diagonal); };
+    this->calculateHamiltonianFingerprint = [parameters] (const Eigen::VectorXd& diagonal) { return DavidsonCheckpoint::calculateHamiltonianFingerprint(*parameters, diagonal); };
+
+    this->initializeOptions();
+}
+
+
+
+/*
+ *  PRIVATE METHODS
+ */
+
+/**
+ *  Orthogonalize the columns of T against the orthonormal columns of Q (in place), with two passes of blocked classical Gram-Schmidt
+ *
+ *  @param Q        the orthonormal vectors
+ *  @param T        the vectors that should be orthogonalized
+ */
+void BlockDavidsonSolver::orthogonalizeAgainst(const Eigen::MatrixXd& Q, Eigen::MatrixXd& T) {
+
+    if ((Q.cols() == 0) || (T.cols() == 0)) {
+        return;
+    }
+
+    // A second pass restores the orthogonality that is lost in the first one due to round-off
+    for (size_t pass = 0; pass < 2; pass++) {
+        T.noalias() -= Q * (Q.transpose() * T);
+    }
+}
+
+
+/**
+ *  Fill in the default subspace dimensions and check the options against the dimension of the Fock space
+ */
+void BlockDavidsonSolver::initializeOptions() {
+
+    size_t number_of_roots = this->options.number_of_requested_eigenpairs;
+    if ((number_of_roots == 0) || (number_of_roots > this->dim)) {
+        throw std::invalid_argument("The number of requested eigenpairs should be positive and not larger than the dimension of the Fock space.");
+    }
+
+    if (this->options.collapsed_subspace_dimension == 0) {
+        this->options.collapsed_subspace_dimension = 2 * number_of_roots;
+    }
+    if (this->options.maximum_subspace_dimension == 0) {
+        this->options.maximum_subspace_dimension = std::max<size_t>(8 * number_of_roots, 16);
+    }
+
+    if (this->options.collapsed_subspace_dimension < number_of_roots) {
+        throw std::invalid_argument("The collapsed subspace dimension cannot be smaller than the number of requested eigenpairs.");
+    }
+    if (this->options.maximum_subspace_dimension < this->options.collapsed_subspace_dimension + number_of_roots) {
+        throw std::invalid_argument("The maximum subspace dimension should leave room for a block of correction vectors after collapsing.");
+    }
+
+    if (this->options.checkpoint_interval == 0) {
+        throw std::invalid_argument("The checkpoint interval should be positive.");
+    }
+    if ((this->options.X_0.size() > 0) && !this->options.restart_filename.empty()) {
+        throw std::invalid_argument("Either initial guesses or a restart file can be given, not both.");
+    }
+
+    if (this->options.X_0.size() > 0) {
+        if (static_cast<size_t>(this->options.X_0.rows()) != this->dim) {
+            throw std::invalid_argument("The initial guesses are incompatible with the dimension of the Fock space.");
+        }
+        if (static_cast<size_t>(this->options.X_0.cols()) < number_of_roots) {
+            throw std::invalid_argument("At least as many initial guesses as requested eigenpairs should be supplied.");
+        }
+    }
+}
+
+
+/**
+ *  Orthonormalize the columns of T among themselves (in place) with modified Gram-Schmidt, dropping the columns whose norm drops below the correction threshold
+ *
+ *  @param T        the vectors that should be orthonormalized
+ */
+void BlockDavidsonSolver::orthonormalize(Eigen::MatrixXd& T) const {
+
+    size_t number_of_kept_vectors = 0;
+    for (size_t j = 0; j < static_cast<size_t>(T.cols()); j++) {
+
+        for (size_t pass = 0; pass < 2; pass++) {
+            for (size_t i = 0; i < number_of_kept_vectors; i++) {
+                T.col(j) -= T.col(i).dot(T.col(j)) * T.col(i);
+            }
+        }
+
+        double norm = T.col(j).norm();
+        if (norm > this->options.correction_threshold) {
+            T.col(number_of_kept_vectors) = T.col(j) / norm;
+            number_of_kept_vectors++;
+        }
+    }
+
+    T.conservativeResize(Eigen::NoChange, number_of_kept_vectors);
+}
+
+
+
+/*
+ *  PUBLIC METHODS
+ */
+
+/**
+ *  Solve the CI eigenvalue problem for the lowest eigenpairs
+ *
+ *  Throws if the requested eigenpairs are not converged within the maximum number of iterations
+ */
+void BlockDavidsonSolver::solve() {
+
+    size_t dim = this->dim;
+    size_t number_of_roots = this->options.number_of_requested_eigenpairs;
+    Eigen::VectorXd diagonal = this->calculateDiagonal();
+    uint64_t hamiltonian_fingerprint = this->calculateHamiltonianFingerprint(diagonal);
+
+    this->is_converged = false;
+    this->number_of_iterations = 0;
+    this->number_of_matrix_vector_products = 0;
+    this->eigenpairs.clear();
+
+
+    // The converged (locked) roots are removed from the subspace and don't require any further matrix-vector products
+    Eigen::MatrixXd X_locked (dim, 0);
+    std::vector<double> locked_eigenvalues;
+
+    // Set up the initial subspace (V), its sigma vectors (AV) and the projected matrix (S)
+    Eigen::MatrixXd V;
+    Eigen::MatrixXd AV;
+    Eigen::MatrixXd S;
+    if (!this->options.restart_filename.empty()) {
+        auto checkpoint = DavidsonCheckpoint::readFromFile(this->options.restart_filename, !this->options.restart_from_ritz_vectors);
+        if (checkpoint.get_dimension() != dim) {
+            throw std::invalid_argument("BlockDavidsonSolver::solve(): The checkpoint file is incompatible with the dimension of the Fock space.");
+        }
+        if (checkpoint.get_hamiltonian_fingerprint() != hamiltonian_fingerprint) {
+            throw std::invalid_argument("BlockDavidsonSolver::solve(): The checkpoint file was written for another Hamiltonian.");
+        }
+        if (checkpoint.get_number_of_requested_eigenpairs() != number_of_roots) {
+            throw std::invalid_argument("BlockDavidsonSolver::solve(): The checkpoint file was written for another number of requested eigenpairs.");
+        }
+
+        X_locked = checkpoint.get_locked_vectors();
+        const auto& checkpointed_eigenvalues = checkpoint.get_locked_eigenvalues();
+        locked_eigenvalues.assign(checkpointed_eigenvalues.data(), checkpointed_eigenvalues.data() + checkpointed_eigenvalues.size());
+
+        if (this->options.restart_from_ritz_vectors) {
+            size_t number_of_ritz_vectors = std::min<size_t>(this->options.collapsed_subspace_dimension, checkpoint.get_subspace_vectors().cols());
+            V = checkpoint.calculateRitzVectors(number_of_ritz_vectors);
+        } else {
+            V = checkpoint.get_subspace_vectors();
+            AV = checkpoint.get_sigma_vectors();
+            S = checkpoint.get_projected_matrix();
+            this->number_of_iterations = checkpoint.get_number_of_iterations();
+            this->number_of_matrix_vector_products = checkpoint.get_number_of_matrix_vector_products();
+        }
+
+    } else if (this->options.X_0.size() > 0) {
+        V = this->options.X_0;
+
+    } else {
+        // Taking as many guesses as the collapsed subspace dimension makes it less likely that a root of another symmetry than the lowest configurations is missed
+        size_t number_of_guesses = std::min(this->options.collapsed_subspace_dimension, dim);
+
+        std::vector<size_t> indices (dim);
+        std::iota(indices.begin(), indices.end(), 0);
+        std::partial_sort(indices.begin(), indices.begin() + number_of_guesses, indices.end(), [&diagonal](size_t i, size_t j) { return diagonal(i) < diagonal(j); });
+
+        V = Eigen::MatrixXd::Zero(dim, number_of_guesses);
+        for (size_t k = 0; k < number_of_guesses; k++) {
+            V(indices[k], k) = 1.0;
+        }
+    }
+
+    if (AV.size() == 0) {  // the sigma vectors have to be calculated
+        BlockDavidsonSolver::orthogonalizeAgainst(X_locked, V);
+        this->orthonormalize(V);
+        if (static_cast<size_t>(V.cols()) < number_of_roots - locked_eigenvalues.size()) {
+            throw std::invalid_argument("BlockDavidsonSolver::solve(): The initial guesses should span at least as many dimensions as the number of requested eigenpairs.");
+        }
+
+        AV = this->blockMatrixVectorProduct(V, diagonal);
+        this->number_of_matrix_vector_products += V.cols();
+        S = V.transpose() * AV;
+    }
+
+
+    size_t number_of_iterations_at_start = this->number_of_iterations;
+    while (this->number_of_iterations - number_of_iterations_at_start < this->options.maximum_number_of_iterations) {
+        this->number_of_iterations++;
+        size_t number_of_active_roots = number_of_roots - locked_eigenvalues.size();
+
+
+        // Solve the Rayleigh-Ritz problem in the current subspace
+        Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> subspace_solver (0.5 * (S + S.transpose()));
+        const Eigen::VectorXd& theta = subspace_solver.eigenvalues();
+        const Eigen::MatrixXd& Y = subspace_solver.eigenvectors();
+
+        Eigen::MatrixXd X = V * Y.leftCols(number_of_active_roots);
+        Eigen::MatrixXd R = AV * Y.leftCols(number_of_active_roots) - X * theta.head(number_of_active_roots).asDiagonal();
+
+
+        // Lock the converged roots and determine the Ritz vectors that span the remaining subspace
+        std::vector<size_t> unconverged_roots;
+        for (size_t k = 0; k < number_of_active_roots; k++) {
+            if (R.col(k).norm() < this->options.residue_tolerance) {
+                X_locked.conservativeResize(Eigen::NoChange, X_locked.cols() + 1);
+                X_locked.col(X_locked.cols() - 1) = X.col(k);
+                locked_eigenvalues.push_back(theta(k));
+            } else {
+                unconverged_roots.push_back(k);
+            }
+        }
+
+        if (locked_eigenvalues.size() == number_of_roots) {
+            this->is_converged = true;
+            break;
+        }
+
+        std::vector<size_t> kept_ritz_vectors = unconverged_roots;
+        for (size_t k = number_of_active_roots; k < static_cast<size_t>(V.cols()); k++) {
+            kept_ritz_vectors.push_back(k);
+        }
+
+
+        // Calculate the diagonally preconditioned correction vectors for the unconverged roots
+        Eigen::MatrixXd T (dim, unconverged_roots.size());
+        for (size_t c = 0; c < unconverged_roots.size(); c++) {
+            size_t k = unconverged_roots[c];
+            for (size_t i = 0; i < dim; i++) {
+                double denominator = theta(k) - diagonal(i);
+                if (std::abs(denominator) < this->options.correction_threshold) {
+                    denominator = (denominator < 0.0) ? -this->options.correction_threshold : this->options.correction_threshold;
+                }
+                T(i, c) = R(i, k) / denominator;
+            }
+        }
+
+
+        // Thick restart onto the lowest Ritz vectors if the subspace would grow too large
+        if (kept_ritz_vectors.size() + T.cols() > this->options.maximum_subspace_dimension) {
+            kept_ritz_vectors.resize(std::min(kept_ritz_vectors.size(), this->options.collapsed_subspace_dimension));
+        }
+
+        // Rotate the subspace onto the kept Ritz vectors (this removes the locked ones), which doesn't require any matrix-vector products: the projected matrix becomes diagonal
+        if (kept_ritz_vectors.size() < static_cast<size_t>(V.cols())) {
+            Eigen::MatrixXd Y_kept (Y.rows(), kept_ritz_vectors.size());
+            Eigen::VectorXd theta_kept (kept_ritz_vectors.size());
+            for (size_t c = 0; c < kept_ritz_vectors.size(); c++) {
+                Y_kept.col(c) = Y.col(kept_ritz_vectors[c]);
+                theta_kept(c) = theta(kept_ritz_vectors[c]);
+            }
+
+            Eigen::MatrixXd V_kept = V * Y_kept;
+            Eigen::MatrixXd AV_kept = AV * Y_kept;
+            V = V_kept;
+            AV = AV_kept;
+            S = theta_kept.asDiagonal();
+        }
+
+
+        // Expand the subspace with the block of orthonormalized correction vectors
+        BlockDavidsonSolver::orthogonalizeAgainst(X_locked, T);
+        BlockDavidsonSolver::orthogonalizeAgainst(V, T);
+        this->orthonormalize(T);
+
+        if (T.cols() == 0) {
+            break;  // the subspace can't be expanded any further
+        }
+
+        Eigen::MatrixXd AT = this->blockMatrixVectorProduct(T, diagonal);
+        this->number_of_matrix_vector_products += T.cols();
+
+        // Only the new blocks of the projected matrix have to be calculated
+        size_t m = V.cols();
+        size_t t = T.cols();
+        Eigen::MatrixXd VT_AT = V.transpose() * AT;
+        Eigen::MatrixXd TT_AT = T.transpose() * AT;
+
+        S.conservativeResize(m + t, m + t);
+        S.topRightCorner(m, t) = VT_AT;
+        S.bottomLeftCorner(t, m) = VT_AT.transpose();
+        S.bottomRightCorner(t, t) = 0.5 * (TT_AT + TT_AT.transpose());
+
+        V.conservativeResize(Eigen::NoChange, m + t);
+        V.rightCols(t) = T;
+        AV.conservativeResize(Eigen::NoChange, m + t);
+        AV.rightCols(t) = AT;
+
+
+        // Checkpoint the state of the solver
+        if (!this->options.checkpoint_filename.empty() && (this->number_of_iterations % this->options.checkpoint_interval == 0)) {
+            Eigen::VectorXd locked_eigenvalues_vector = Eigen::Map<Eigen::VectorXd>(locked_eigenvalues.data(), locked_eigenvalues.size());
+            DavidsonCheckpoint(number_of_roots, hamiltonian_fingerprint, this->number_of_iterations, this->number_of_matrix_vector_products, V, AV, S, X_locked, locked_eigenvalues_vector).writeToFile(this->options.checkpoint_filename);
+        }
+    }
+
+    if (!this->is_converged) {
+        throw std::runtime_error("BlockDavidsonSolver.solve(): The block Davidson procedure failed to converge in the maximum number of allowed iterations.");
+    }
+
+
+    // Store the eigenpairs in increasing order of the eigenvalues
+    std::vector<size_t> order (number_of_roots);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&locked_eigenvalues](size_t i, size_t j) { return locked_eigenvalues[i] < locked_eigenvalues[j]; });
+
+    for (size_t k : order) {
+        this->eigenpairs.emplace_back(locked_eigenvalues[k], X_locked.col(k));
+    }
+}
+
+
+}  // namespace GQCP
@@ -0,0 +1,182 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2018  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#include "CISolver/CIPSI.hpp"
+
+#include "CISolver/CISolver.hpp"
+#include "CISolver/EpsteinNesbetPT2.hpp"
+#include "HamiltonianBuilder/SelectedCI.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+
+namespace GQCP {
+
+
+/*
+ *  PRIVATE METHODS
+ */
+
+/**
+ *  Diagonalize the Hamiltonian in the current selected space, and update the energy, coefficients and (canonically ordered) selected space
+ */
+void CIPSI::diagonalize() {
+
+    // Bring the selected space in the canonical layout: the selected CI builder then doesn't have to reorder the coefficients
+    std::vector<size_t> previous_addresses = this->fock_space.canonicalize();
+    size_t dim = this->fock_space.get_dimension();
+
+    SelectedCI selected_ci (this->fock_space);
+    CISolver ci_solver (selected_ci, this->hamiltonian_parameters);
+    if (dim <= this->options.dense_dimension_threshold) {
+        numopt::eigenproblem::DenseSolverOptions solver_options;
+        ci_solver.solve(solver_options);
+
+    } else {
+
+        // Use the previous ground state (in the new, canonical ordering) as the initial guess
+        Eigen::VectorXd initial_guess = Eigen::VectorXd::Zero(dim);
+        for (size_t I = 0; I < dim; I++) {
+            if (previous_addresses[I] < static_cast<size_t>(this->coefficients.size())) {
+                initial_guess(I) = this->coefficients(previous_addresses[I]);
+            }
+        }
+        if (initial_guess.norm() == 0.0) {  // there is no previous ground state
+            Eigen::VectorXd diagonal = selected_ci.calculateDiagonal(this->hamiltonian_parameters);
+            Eigen::VectorXd::Index lowest;
+            diagonal.minCoeff(&lowest);
+            initial_guess(lowest) = 1.0;
+        }
+
+        numopt::eigenproblem::DavidsonSolverOptions solver_options (initial_guess.normalized());
+        ci_solver.solve(solver_options);
+    }
+
+    this->energy = ci_solver.get_eigenpair().get_eigenvalue();
+    this->coefficients = ci_solver.get_eigenpair().get_eigenvector();
+}
+
+
+/**
+ *  Generate and score the external configurations, and update the PT2 correction
+ *
+ *  @param externals            the external configurations that are found
+ *  @param contributions        the perturbative contributions of the external configurations
+ */
+void CIPSI::scoreExternalConfigurations(SelectedFockSpace& externals, std::vector<double>& contributions) {
+
+    EpsteinNesbetPT2 epstein_nesbet_pt2 (this->hamiltonian_parameters, this->fock_space, this->coefficients, this->energy, this->excitation_generator);
+    epstein_nesbet_pt2.calculateContributions(externals, contributions);
+
+    this->pt2_energy = std::accumulate(contributions.begin(), contributions.end(), 0.0);
+}
+
+
+
+/*
+ *  CONSTRUCTORS
+ */
+
+/**
+ *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+ *  @param initial_fock_space           the initial selected space, e.g. only the Hartree-Fock configuration
+ *  @param options                      the options for the CIPSI calculation
+ */
+CIPSI::CIPSI(const HamiltonianParameters& hamiltonian_parameters, const SelectedFockSpace& initial_fock_space, const CIPSIOptions& options) :
+    hamiltonian_parameters (hamiltonian_parameters),
+    fock_space (initial_fock_space),
+    options (options),
+    excitation_generator (hamiltonian_parameters, options.heat_bath_threshold)
+{
+    auto K = hamiltonian_parameters.get_h().get_dim();
+    if (K != this->fock_space.get_K()) {
+        throw std::invalid_argument("Basis functions of the Fock space and hamiltonian_parameters are incompatible.");
+    }
+
+    if (this->fock_space.get_dimension() == 0) {
+        throw std::invalid_argument("The initial selected space should contain at least one configuration.");
+    }
+}
+
+
+
+/*
+ *  PUBLIC METHODS
+ */
+
+/**
+ *  Grow the selected space until one of the convergence criteria is met, or until the maximum dimension or number of iterations is reached
+ */
+void CIPSI::solve() {
+
+    this->is_converged = false;
+    double previous_energy = 0.0;
+
+    for (this->number_of_iterations = 1; this->number_of_iterations <= this->options.maximum_number_of_iterations; this->number_of_iterations++) {
+
+        this->diagonalize();
+
+        SelectedFockSpace externals (this->fock_space.get_K(), this->fock_space.get_N_alpha(), this->fock_space.get_N_beta());
+        std::vector<double> contributions;
+        this->scoreExternalConfigurations(externals, contributions);
+
+        // Check for convergence
+        bool energy_converged = (this->number_of_iterations > 1) && (std::abs(this->energy - previous_energy) < this->options.energy_convergence_threshold);
+        bool pt2_converged = std::abs(this->pt2_energy) < this->options.pt2_convergence_threshold;
+        if (energy_converged || pt2_converged || (externals.get_dimension() == 0)) {
+            this->is_converged = true;
+            break;
+        }
+
+        size_t dim = this->fock_space.get_dimension();
+        if ((dim >= this->options.maximum_dimension) || (this->number_of_iterations == this->options.maximum_number_of_iterations)) {
+            break;
+        }
+        previous_energy = this->energy;
+
+
+        // Grow the selected space with the externals that have the largest contributions
+        size_t number_of_additions = std::max<size_t>(1, static_cast<size_t>(std::ceil(this->options.growth_fraction * dim)));
+        number_of_additions = std::min({number_of_additions, this->options.maximum_dimension - dim, externals.get_dimension()});
+
+        std::vector<size_t> order (externals.get_dimension());
+        std::iota(order.begin(), order.end(), 0);
+        std::partial_sort(order.begin(), order.begin() + number_of_additions, order.end(), [&contributions] (size_t a, size_t b) { return std::abs(contributions[a]) > std::abs(contributions[b]); });
+
+        std::vector<Configuration> additions;
+        additions.reserve(number_of_additions);
+        for (size_t k = 0; k < number_of_additions; k++) {
+            additions.push_back(externals.get_configuration(order[k]));
+        }
+
+        // The current coefficients are kept as the initial guess for the next iteration: the new configurations are appended
+        this->fock_space.addConfigurations(additions);
+    }
+}
+
+
+/**
+ *  @return the ground state wave function in the current selected space
+ */
+WaveFunction CIPSI::get_wavefunction() {
+    return WaveFunction(this->fock_space, this->coefficients);
+}
+
+
+}  // namespace GQCP
@@ -17,6 +17,8 @@
 // 
 #include "CISolver/CISolver.hpp"
 
+#include <memory>
+
 
 namespace GQCP {
 
@@ -30,13 +32,43 @@ namespace GQCP {
  *  @param hamiltonian_parameters   the Hamiltonian parameters in an orthonormal basis
  */
 CISolver::CISolver(HamiltonianBuilder& hamiltonian_builder, const HamiltonianParameters& hamiltonian_parameters) :
-    hamiltonian_builder (&hamiltonian_builder),
-    hamiltonian_parameters (hamiltonian_parameters)
+    hamiltonian_builder (&hamiltonian_builder)
 {
     auto K = hamiltonian_parameters.get_h().get_dim();
     if (K != this->hamiltonian_builder->get_fock_space()->get_K()) {
         throw std::invalid_argument("Basis functions of the Fock space and hamiltonian_parameters are incompatible.");
     }
+
+    // The Hamiltonian parameters are shared by the function objects, rather than copied into each of them
+    HamiltonianBuilder* builder = this->hamiltonian_builder;
+    auto parameters = std::make_shared<const HamiltonianParameters>(hamiltonian_parameters);
+
+    this->constructHamiltonian = [builder, parameters] () { return builder->constructHamiltonian(*parameters); };
+    this->calculateDiagonal = [builder, parameters] () { return builder->calculateDiagonal(*parameters); };
+    this->matrixVectorProduct = [builder, parameters] (const Eigen::VectorXd& x, const Eigen::VectorXd& diagonal) { return builder->matrixVectorProduct(*parameters, x, diagonal); };
+    this->createBlockDavidsonSolver = [builder, parameters] (const BlockDavidsonSolverOptions& options) { return BlockDavidsonSolver(*builder, *parameters, options); };
+}
+
+
+/**
+ *  @param hubbard                  the Hubbard HamiltonianBuilder for which the CI eigenvalue problem should be solved
+ *  @param model_parameters         the (sparse) model Hamiltonian parameters, which are used directly, i.e. without constructing the (K^4) two-electron integrals
+ */
+CISolver::CISolver(Hubbard& hubbard, const ModelHamiltonianParameters& model_parameters) :
+    hamiltonian_builder (&hubbard)
+{
+    if (model_parameters.get_K() != hubbard.get_fock_space()->get_K()) {
+        throw std::invalid_argument("The number of sites of the Fock space and model_parameters are incompatible.");
+    }
+
+    // The model parameters are shared by the function objects, rather than copied into each of them
+    Hubbard* builder = &hubbard;
+    auto parameters = std::make_shared<const ModelHamiltonianParameters>(model_parameters);
+
+    this->constructHamiltonian = [builder, parameters] () { return builder->constructHamiltonian(*parameters); };
+    this->calculateDiagonal = [builder, parameters] () { return builder->calculateDiagonal(*parameters); };
+    this->matrixVectorProduct = [builder, parameters] (const Eigen::VectorXd& x, const Eigen::VectorXd& diagonal) { return builder->matrixVectorProduct(*parameters, x, diagonal); };
+    this->createBlockDavidsonSolver = [builder, parameters] (const BlockDavidsonSolverOptions& options) { return BlockDavidsonSolver(*builder, *parameters, options); };
 }
 
 
@@ -56,7 +88,7 @@ void CISolver::solve(numopt::eigenproblem::BaseSolverOptions& solver_options) {
 
         case numopt::eigenproblem::SolverType::DENSE: {
 
-            Eigen::MatrixXd matrix = this->hamiltonian_builder->constructHamiltonian(this->hamiltonian_parameters);
+            Eigen::MatrixXd matrix = this->constructHamiltonian();
 
             numopt::eigenproblem::DenseSolver solver = numopt::eigenproblem::DenseSolver(matrix, dynamic_cast<numopt::eigenproblem::DenseSolverOptions&>(solver_options));
 
@@ -68,8 +100,8 @@ void CISolver::solve(numopt::eigenproblem::BaseSolverOptions& solver_options) {
 
         case numopt::eigenproblem::SolverType::DAVIDSON: {
 
-            Eigen::VectorXd diagonal = this->hamiltonian_builder->calculateDiagonal(this->hamiltonian_parameters);
-            numopt::VectorFunction matrixVectorProduct = [this, &diagonal](const Eigen::VectorXd& x) { return hamiltonian_builder->matrixVectorProduct(hamiltonian_parameters, x, diagonal); };
+            Eigen::VectorXd diagonal = this->calculateDiagonal();
+            numopt::VectorFunction matrixVectorProduct = [this, &diagonal](const Eigen::VectorXd& x) { return this->matrixVectorProduct(x, diagonal); };
 
             numopt::eigenproblem::DavidsonSolver solver = numopt::eigenproblem::DavidsonSolver(matrixVectorProduct, diagonal, dynamic_cast<numopt::eigenproblem::DavidsonSolverOptions&>(solver_options));
 
@@ -87,6 +119,20 @@ void CISolver::solve(numopt::eigenproblem::BaseSolverOptions& solver_options) {
 }
 
 
+/**
+ *  @param block_davidson_options       the options for a block Davidson solver
+ *
+ *  Solve the CI eigenvalue problem with the native BlockDavidsonSolver and set the eigenpairs internally. Long solves can be checkpointed and resumed through the options.
+ */
+void CISolver::solve(const BlockDavidsonSolverOptions& block_davidson_options) {
+
+    BlockDavidsonSolver solver = this->createBlockDavidsonSolver(block_davidson_options);
+
+    solver.solve();
+    this->eigenpairs = solver.get_eigenpairs();
+}
+
+
 /**
  *  @param index        the index of the index-th excited state
  *
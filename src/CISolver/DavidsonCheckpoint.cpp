@@ -0,0 +1,317 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2018  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#include "CISolver/DavidsonCheckpoint.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <initializer_list>
+
+
+namespace GQCP {
+
+
+constexpr uint32_t DavidsonCheckpointHeader::current_version;
+constexpr uint64_t DavidsonCheckpointHeader::initial_checksum;
+
+
+/*
+ *  DAVIDSONCHECKPOINTHEADER PUBLIC METHODS
+ */
+
+/**
+ *  @return if the header starts with the magic characters of the format
+ */
+bool DavidsonCheckpointHeader::hasValidMagic() const {
+    return std::memcmp(this->magic, "GQCPDAV", sizeof(this->magic)) == 0;
+}
+
+
+
+/*
+ *  CONSTRUCTORS
+ */
+
+/**
+ *  @param number_of_requested_eigenpairs       the number of eigenpairs that the solver was asked for
+ *  @param hamiltonian_fingerprint              the fingerprint of the Hamiltonian whose eigenproblem is being solved
+ *  @param number_of_iterations                 the number of iterations that have been performed
+ *  @param number_of_matrix_vector_products     the number of matrix-vector products that have been performed
+ *  @param V                                    the orthonormal subspace vectors (as columns)
+ *  @param AV                                   the sigma vectors (as columns), which may be empty
+ *  @param S                                    the projected matrix V^T A V
+ *  @param X_locked                             the locked eigenvectors (as columns)
+ *  @param locked_eigenvalues                   the locked eigenvalues
+ */
+DavidsonCheckpoint::DavidsonCheckpoint(size_t number_of_requested_eigenpairs, uint64_t hamiltonian_fingerprint, size_t number_of_iterations, size_t number_of_matrix_vector_products, const Eigen::MatrixXd& V, const Eigen::MatrixXd& AV, const Eigen::MatrixXd& S, const Eigen::MatrixXd& X_locked, const Eigen::VectorXd& locked_eigenvalues) :
+    number_of_requested_eigenpairs (number_of_requested_eigenpairs),
+    hamiltonian_fingerprint (hamiltonian_fingerprint),
+    number_of_iterations (number_of_iterations),
+    number_of_matrix_vector_products (number_of_matrix_vector_products),
+    V (V),
+    AV (AV),
+    S (S),
+    X_locked (X_locked),
+    locked_eigenvalues (locked_eigenvalues)
+{
+    if ((S.rows() != V.cols()) || (S.cols() != V.cols())) {
+        throw std::invalid_argument("DavidsonCheckpoint(): The projected matrix is incompatible with the subspace vectors.");
+    }
+
+    if ((AV.size() > 0) && ((AV.rows() != V.rows()) || (AV.cols() != V.cols()))) {
+        throw std::invalid_argument("DavidsonCheckpoint(): The sigma vectors are incompatible with the subspace vectors.");
+    }
+
+    if (((X_locked.cols() > 0) && (X_locked.rows() != V.rows())) || (locked_eigenvalues.size() != X_locked.cols())) {
+        throw std::invalid_argument("DavidsonCheckpoint(): The locked eigenpairs are incompatible with the subspace vectors.");
+    }
+
+    if (static_cast<size_t>(X_locked.cols()) >= number_of_requested_eigenpairs) {
+        throw std::invalid_argument("DavidsonCheckpoint(): A checkpoint should have at least one unconverged eigenpair.");
+    }
+}
+
+
+
+/*
+ *  PUBLIC METHODS
+ */
+
+/**
+ *  @param number_of_ritz_vectors       the number of lowest Ritz vectors
+ *
+ *  @return the lowest Ritz vectors of the projected matrix in the checkpointed subspace, which don't require the sigma vectors
+ */
+Eigen::MatrixXd DavidsonCheckpoint::calculateRitzVectors(size_t number_of_ritz_vectors) const {
+
+    if (number_of_ritz_vectors > static_cast<size_t>(this->V.cols())) {
+        throw std::invalid_argument("DavidsonCheckpoint::calculateRitzVectors(): The subspace doesn't contain this many Ritz vectors.");
+    }
+
+    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> subspace_solver (0.5 * (this->S + this->S.transpose()));
+    return this->V * subspace_solver.eigenvectors().leftCols(number_of_ritz_vectors);
+}
+
+
+/**
+ *  Write the checkpoint to a binary file
+ *
+ *  @param filename     the name of the checkpoint file that is (over)written
+ *
+ *  The checkpoint is first written to a temporary file, which then replaces the given one: a job that is interrupted while writing leaves the previous checkpoint intact
+ */
+void DavidsonCheckpoint::writeToFile(const std::string& filename) const {
+
+    if (this->AV.size() != this->V.size()) {
+        throw std::logic_error("DavidsonCheckpoint::writeToFile(): A checkpoint without sigma vectors can't be written.");
+    }
+
+    // Prepare the header
+    DavidsonCheckpointHeader header;
+    std::memcpy(header.magic, "GQCPDAV", sizeof(header.magic));
+    header.version = DavidsonCheckpointHeader::current_version;
+    header.number_of_requested_eigenpairs = static_cast<uint32_t>(this->number_of_requested_eigenpairs);
+    header.dimension = this->V.rows();
+    header.subspace_dimension = this->V.cols();
+    header.number_of_locked_vectors = this->X_locked.cols();
+    header.number_of_iterations = static_cast<uint32_t>(this->number_of_iterations);
+    header.number_of_matrix_vector_products = static_cast<uint32_t>(this->number_of_matrix_vector_products);
+    header.checksum = DavidsonCheckpointHeader::initial_checksum;
+    header.sigma_checksum = DavidsonCheckpointHeader::initial_checksum;
+    header.hamiltonian_fingerprint = this->hamiltonian_fingerprint;
+
+    const double* blocks[] = {this->V.data(), this->AV.data(), this->S.data(), this->X_locked.data(), this->locked_eigenvalues.data()};
+    const size_t block_sizes[] = {static_cast<size_t>(this->V.size()), static_cast<size_t>(this->AV.size()), static_cast<size_t>(this->S.size()), static_cast<size_t>(this->X_locked.size()), static_cast<size_t>(this->locked_eigenvalues.size())};
+
+    for (size_t b = 0; b < 5; b++) {
+        uint64_t& checksum = (b == 1) ? header.sigma_checksum : header.checksum;  // the sigma vectors are the second block
+        for (size_t i = 0; i < block_sizes[b]; i++) {
+            uint64_t word;
+            std::memcpy(&word, blocks[b] + i, sizeof(word));
+            checksum = updateFNVChecksum(checksum, word);
+        }
+    }
+
+
+    // Write to a temporary file and replace the given file only when that has succeeded
+    std::string temporary_filename = filename + ".tmp";
+    std::ofstream output_file_stream (temporary_filename, std::ios::binary | std::ios::trunc);
+    if (!output_file_stream.good()) {
+        throw std::runtime_error("DavidsonCheckpoint::writeToFile(): The provided file can't be opened for writing. Maybe you specified a wrong path?");
+    }
+
+    output_file_stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (size_t b = 0; b < 5; b++) {
+        output_file_stream.write(reinterpret_cast<const char*>(blocks[b]), block_sizes[b] * sizeof(double));
+    }
+    output_file_stream.close();
+
+    if (output_file_stream.fail()) {
+        throw std::runtime_error("DavidsonCheckpoint::writeToFile(): The checkpoint file could not be written.");
+    }
+
+    if (std::rename(temporary_filename.c_str(), filename.c_str()) != 0) {
+        throw std::runtime_error("DavidsonCheckpoint::writeToFile(): The checkpoint file could not be replaced.");
+    }
+}
+
+
+
+/*
+ *  STATIC PUBLIC METHODS
+ */
+
+/**
+ *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+ *  @param diagonal                     the diagonal of the Hamiltonian matrix in the Fock space of the HamiltonianBuilder
+ *
+ *  @return a fingerprint of the Hamiltonian: a checksum over the bit patterns of the one- and two-electron integrals and of the diagonal, which also distinguishes between HamiltonianBuilders of the same dimension
+ */
+uint64_t DavidsonCheckpoint::calculateHamiltonianFingerprint(const HamiltonianParameters& hamiltonian_parameters, const Eigen::VectorXd& diagonal) {
+
+    const auto& h = hamiltonian_parameters.get_h().get_matrix_representation();
+    const auto& g = hamiltonian_parameters.get_g().get_matrix_representation();
+
+    const double* blocks[] = {h.data(), g.data(), diagonal.data()};
+    const size_t block_sizes[] = {static_cast<size_t>(h.size()), static_cast<size_t>(g.size()), static_cast<size_t>(diagonal.size())};
+
+    uint64_t fingerprint = DavidsonCheckpointHeader::initial_checksum;
+    for (size_t b = 0; b < 3; b++) {
+        for (size_t i = 0; i < block_sizes[b]; i++) {
+            uint64_t word;
+            std::memcpy(&word, blocks[b] + i, sizeof(word));
+            fingerprint = updateFNVChecksum(fingerprint, word);
+        }
+    }
+
+    return fingerprint;
+}
+
+
+/**
+ *  @param model_parameters     the (sparse) model Hamiltonian parameters
+ *  @param diagonal             the diagonal of the Hamiltonian matrix in the Fock space of the HamiltonianBuilder
+ *
+ *  @return a fingerprint of the Hamiltonian: a checksum over the positions and bit patterns of the non-zero hoppings and inter-site repulsions, over the on-site repulsions and over the diagonal
+ */
+uint64_t DavidsonCheckpoint::calculateHamiltonianFingerprint(const ModelHamiltonianParameters& model_parameters, const Eigen::VectorXd& diagonal) {
+
+    uint64_t fingerprint = DavidsonCheckpointHeader::initial_checksum;
+
+    // Both the position and the value of every non-zero element enter the fingerprint, so that lattices with the same parameters but a different connectivity are distinguished
+    for (const Eigen::SparseMatrix<double>* sparse_matrix : {&model_parameters.get_h(), &model_parameters.get_V()}) {
+        for (Eigen::Index k = 0; k < sparse_matrix->outerSize(); k++) {
+            for (Eigen::SparseMatrix<double>::InnerIterator it (*sparse_matrix, k); it; ++it) {
+                double value = it.value();
+                uint64_t word;
+                std::memcpy(&word, &value, sizeof(word));
+
+                fingerprint = updateFNVChecksum(fingerprint, static_cast<uint64_t>(it.row()));
+                fingerprint = updateFNVChecksum(fingerprint, static_cast<uint64_t>(it.col()));
+                fingerprint = updateFNVChecksum(fingerprint, word);
+            }
+        }
+    }
+
+    for (const Eigen::VectorXd* vector : {&model_parameters.get_U(), &diagonal}) {
+        for (Eigen::Index i = 0; i < vector->size(); i++) {
+            uint64_t word;
+            std::memcpy(&word, vector->data() + i, sizeof(word));
+            fingerprint = updateFNVChecksum(fingerprint, word);
+        }
+    }
+
+    return fingerprint;
+}
+
+
+/**
+ *  @param filename                 the name of the checkpoint file
+ *  @param read_sigma_vectors       if the sigma vectors should be read: they aren't needed to restart from Ritz vectors
+ *
+ *  @return the checkpoint that is stored in the given file
+ */
+DavidsonCheckpoint DavidsonCheckpoint::readFromFile(const std::string& filename, bool read_sigma_vectors) {
+
+    std::ifstream input_file_stream (filename, std::ios::binary);
+    if (!input_file_stream.good()) {
+        throw std::runtime_error("DavidsonCheckpoint::readFromFile(): The provided file can't be opened. Maybe you specified a wrong path?");
+    }
+
+    DavidsonCheckpointHeader header;
+    input_file_stream.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!input_file_stream || !header.hasValidMagic()) {
+        throw std::invalid_argument("DavidsonCheckpoint::readFromFile(): The provided file is not a Davidson checkpoint file.");
+    }
+    if (header.version != DavidsonCheckpointHeader::current_version) {
+        throw std::invalid_argument("DavidsonCheckpoint::readFromFile(): The version of the checkpoint file is not supported.");
+    }
+
+    size_t dim = header.dimension;
+    size_t m = header.subspace_dimension;
+    size_t l = header.number_of_locked_vectors;
+
+    // Check the size of the file before any memory is allocated
+    size_t expected_file_size = sizeof(header) + (2 * dim * m + m * m + dim * l + l) * sizeof(double);
+    input_file_stream.seekg(0, std::ios::end);
+    if (static_cast<size_t>(input_file_stream.tellg()) != expected_file_size) {
+        throw std::invalid_argument("DavidsonCheckpoint::readFromFile(): The size of the checkpoint file doesn't match its header.");
+    }
+    input_file_stream.seekg(sizeof(header));
+
+    Eigen::MatrixXd V (dim, m);
+    Eigen::MatrixXd AV;
+    Eigen::MatrixXd S (m, m);
+    Eigen::MatrixXd X_locked (dim, l);
+    Eigen::VectorXd locked_eigenvalues (l);
+
+    // Read a block of doubles and update the given checksum
+    uint64_t checksum = DavidsonCheckpointHeader::initial_checksum;
+    uint64_t sigma_checksum = DavidsonCheckpointHeader::initial_checksum;
+    auto read_block = [&input_file_stream] (double* block, size_t size, uint64_t& block_checksum) {
+        input_file_stream.read(reinterpret_cast<char*>(block), size * sizeof(double));
+        for (size_t i = 0; i < size; i++) {
+            uint64_t word;
+            std::memcpy(&word, block + i, sizeof(word));
+            block_checksum = updateFNVChecksum(block_checksum, word);
+        }
+    };
+
+    read_block(V.data(), V.size(), checksum);
+    if (read_sigma_vectors) {
+        AV = Eigen::MatrixXd(dim, m);
+        read_block(AV.data(), AV.size(), sigma_checksum);
+    } else {
+        input_file_stream.seekg(dim * m * sizeof(double), std::ios::cur);
+    }
+    read_block(S.data(), S.size(), checksum);
+    read_block(X_locked.data(), X_locked.size(), checksum);
+    read_block(locked_eigenvalues.data(), locked_eigenvalues.size(), checksum);
+
+    if (!input_file_stream) {
+        throw std::runtime_error("DavidsonCheckpoint::readFromFile(): The checkpoint file could not be read.");
+    }
+    if ((checksum != header.checksum) || (read_sigma_vectors && (sigma_checksum != header.sigma_checksum))) {
+        throw std::invalid_argument("DavidsonCheckpoint::readFromFile(): The checksums of the checkpoint file don't match its contents.");
+    }
+
+    return DavidsonCheckpoint(header.number_of_requested_eigenpairs, header.hamiltonian_fingerprint, header.number_of_iterations, header.number_of_matrix_vector_products, V, AV, S, X_locked, locked_eigenvalues);
+}
+
+
+}  // namespace GQCP
@@ -0,0 +1,308 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2018  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#include "CISolver/EpsteinNesbetPT2.hpp"
+
+#include "HamiltonianBuilder/SelectedCI.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+
+
+namespace GQCP {
+
+
+/*
+ *  PRIVATE METHODS
+ */
+
+/**
+ *  Accumulate the numerators <a|H|Psi> for the external configurations of one batch
+ *
+ *  @param coefficients         the coefficients of the wave function Psi, which can be a part of the full wave function
+ *  @param batch_index          the index of the batch of external configurations
+ *  @param number_of_batches    the number of batches in which the external space is partitioned
+ *  @param externals            the external configurations of the batch
+ *  @param numerators           the numerators <a|H|Psi> of the external configurations
+ */
+void EpsteinNesbetPT2::accumulateNumerators(const Eigen::VectorXd& coefficients, size_t batch_index, size_t number_of_batches, SelectedFockSpace& externals, std::vector<double>& numerators) const {
+
+    size_t K = this->fock_space.get_K();
+    size_t N_alpha = this->fock_space.get_N_alpha();
+    size_t N_beta = this->fock_space.get_N_beta();
+
+    for (size_t I = 0; I < this->fock_space.get_dimension(); I++) {
+        double c_I = coefficients(I);
+        if (c_I == 0.0) {
+            continue;
+        }
+        const auto& configuration_I = this->fock_space.get_configuration(I);
+
+        this->excitation_generator.forEachExcitation(configuration_I, c_I, [&] (size_t alpha_representation, size_t beta_representation) {
+
+            // The batches are formed by the upper bits of the hash, since the lower bits determine the slot in the hash index of the externals
+            if ((number_of_batches > 1) && ((SelectedFockSpace::hash(alpha_representation, beta_representation) >> 32) % number_of_batches != batch_index)) {
+                return;
+            }
+
+            if (this->fock_space.getIndex(alpha_representation, beta_representation) != SelectedFockSpace::npos) {
+                return;  // the configuration is not external
+            }
+
+            Configuration external {ONV(K, N_alpha, alpha_representation), ONV(K, N_beta, beta_representation)};
+            double value = SelectedCI::calculateOffDiagonalElement(this->hamiltonian_parameters, external, configuration_I) * c_I;
+
+            size_t index = externals.getIndex(alpha_representation, beta_representation);
+            if (index == SelectedFockSpace::npos) {
+                externals.addConfiguration(external.onv_alpha, external.onv_beta);
+                numerators.push_back(value);
+            } else {
+                numerators[index] += value;
+            }
+        });
+    }
+}
+
+
+/**
+ *  @param coefficients         the coefficients of the wave function Psi, which can be a part of the full wave function
+ *  @param number_of_batches    the number of batches in which the external space is partitioned
+ *
+ *  @return the EN-PT2 correction for the given wave function
+ */
+double EpsteinNesbetPT2::calculateDeterministic(const Eigen::VectorXd& coefficients, size_t number_of_batches) const {
+
+    if (number_of_batches == 0) {
+        throw std::invalid_argument("The number of batches should be at least 1.");
+    }
+
+    double pt2_energy = 0.0;
+    for (size_t batch_index = 0; batch_index < number_of_batches; batch_index++) {
+        SelectedFockSpace externals (this->fock_space.get_K(), this->fock_space.get_N_alpha(), this->fock_space.get_N_beta());
+        std::vector<double> numerators;
+        this->accumulateNumerators(coefficients, batch_index, number_of_batches, externals, numerators);
+
+        for (size_t a = 0; a < numerators.size(); a++) {
+            double diagonal_element = SelectedCI::calculateDiagonalElement(this->hamiltonian_parameters, externals.get_configuration(a));
+            pt2_energy += numerators[a] * numerators[a] / (this->energy - diagonal_element);
+        }
+    }
+
+    return pt2_energy;
+}
+
+
+
+/*
+ *  CONSTRUCTORS
+ */
+
+/**
+ *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+ *  @param fock_space                   the selected space
+ *  @param coefficients                 the coefficients of the wave function in the selected space
+ *  @param energy                       the variational energy of the wave function
+ */
+EpsteinNesbetPT2::EpsteinNesbetPT2(const HamiltonianParameters& hamiltonian_parameters, const SelectedFockSpace& fock_space, const Eigen::VectorXd& coefficients, double energy) :
+    EpsteinNesbetPT2(hamiltonian_parameters, fock_space, coefficients, energy, ExcitationGenerator(fock_space.get_K()))
+{}
+
+
+/**
+ *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+ *  @param fock_space                   the selected space
+ *  @param coefficients                 the coefficients of the wave function in the selected space
+ *  @param energy                       the variational energy of the wave function
+ *  @param excitation_generator         the generator of the external configurations, e.g. with heat-bath screening
+ */
+EpsteinNesbetPT2::EpsteinNesbetPT2(const HamiltonianParameters& hamiltonian_parameters, const SelectedFockSpace& fock_space, const Eigen::VectorXd& coefficients, double energy, const ExcitationGenerator& excitation_generator) :
+    hamiltonian_parameters (hamiltonian_parameters),
+    fock_space (fock_space),
+    coefficients (coefficients),
+    energy (energy),
+    excitation_generator (excitation_generator)
+{
+    auto K = hamiltonian_parameters.get_h().get_dim();
+    if ((K != this->fock_space.get_K()) || (K != this->excitation_generator.get_K())) {
+        throw std::invalid_argument("Basis functions of the Fock space and hamiltonian_parameters are incompatible.");
+    }
+
+    if (static_cast<size_t>(coefficients.size()) != this->fock_space.get_dimension()) {
+        throw std::invalid_argument("The number of coefficients does not match the dimension of the Fock space.");
+    }
+}
+
+
+
+/*
+ *  PUBLIC METHODS
+ */
+
+/**
+ *  Calculate the contributions e_a = |<a|H|Psi>|^2 / (E - <a|H|a>) of the external configurations of one batch
+ *
+ *  @param externals            the external configurations of the batch
+ *  @param contributions        the contributions of the external configurations
+ *  @param batch_index          the index of the batch of external configurations
+ *  @param number_of_batches    the number of batches in which the external space is partitioned
+ */
+void EpsteinNesbetPT2::calculateContributions(SelectedFockSpace& externals, std::vector<double>& contributions, size_t batch_index, size_t number_of_batches) const {
+
+    std::vector<double> numerators;
+    this->accumulateNumerators(this->coefficients, batch_index, number_of_batches, externals, numerators);
+
+    contributions.resize(numerators.size());
+    for (size_t a = 0; a < numerators.size(); a++) {
+        double diagonal_element = SelectedCI::calculateDiagonalElement(this->hamiltonian_parameters, externals.get_configuration(a));
+        contributions[a] = numerators[a] * numerators[a] / (this->energy - diagonal_element);
+    }
+}
+
+
+/**
+ *  @param number_of_batches    the number of batches in which the external space is partitioned: only the external configurations of one batch are kept in memory at the same time
+ *
+ *  @return the deterministic EN-PT2 correction
+ */
+double EpsteinNesbetPT2::calculateDeterministic(size_t number_of_batches) const {
+    return this->calculateDeterministic(this->coefficients, number_of_batches);
+}
+
+
+/**
+ *  @param options      the options for the semistochastic calculation
+ *
+ *  @return the semistochastic EN-PT2 correction and its standard error
+ */
+PT2Estimate EpsteinNesbetPT2::calculateSemistochastic(const SemistochasticPT2Options& options) const {
+
+    size_t dim = this->fock_space.get_dimension();
+    size_t N_s = options.number_of_samples;
+    if ((N_s < 2) || (options.number_of_sample_sets < 2)) {
+        throw std::invalid_argument("At least two samples and two sample sets are needed for a stochastic estimate.");
+    }
+
+
+    // The deterministic part Psi_D consists of the configurations with the largest |c_I|
+    size_t deterministic_dimension = std::min(options.deterministic_dimension, dim);
+    std::vector<size_t> order (dim);
+    std::iota(order.begin(), order.end(), 0);
+    std::partial_sort(order.begin(), order.begin() + deterministic_dimension, order.end(), [this] (size_t I, size_t J) { return std::abs(this->coefficients(I)) > std::abs(this->coefficients(J)); });
+
+    std::vector<bool> is_deterministic (dim, false);
+    Eigen::VectorXd deterministic_coefficients = Eigen::VectorXd::Zero(dim);
+    for (size_t k = 0; k < deterministic_dimension; k++) {
+        is_deterministic[order[k]] = true;
+        deterministic_coefficients(order[k]) = this->coefficients(order[k]);
+    }
+
+    double deterministic_pt2_energy = this->calculateDeterministic(deterministic_coefficients, options.number_of_batches);
+    if (deterministic_dimension == dim) {
+        return PT2Estimate {deterministic_pt2_energy, 0.0};
+    }
+
+
+    // The remainder E_PT2[Psi] - E_PT2[Psi_D] is estimated stochastically: both terms are estimated with the same samples, so that their errors largely cancel
+    //      E_PT2 ~ 1/(N_s(N_s-1)) sum_a 1/(E - H_aa) [ (sum_I w_I x_aI / p_I)^2 + sum_I (w_I (N_s-1) / p_I - w_I^2 / p_I^2) x_aI^2 ]
+    // in which x_aI = <a|H|I> c_I, and w_I is the number of times I was drawn with probability p_I. This estimator is unbiased.
+    Eigen::VectorXd probabilities = this->coefficients.cwiseAbs() / this->coefficients.lpNorm<1>();
+    std::discrete_distribution<size_t> distribution (probabilities.data(), probabilities.data() + dim);
+    std::mt19937_64 generator (options.seed);
+
+    size_t K = this->fock_space.get_K();
+    size_t N_alpha = this->fock_space.get_N_alpha();
+    size_t N_beta = this->fock_space.get_N_beta();
+
+    std::vector<double> estimates (options.number_of_sample_sets);
+    for (size_t set = 0; set < options.number_of_sample_sets; set++) {
+
+        // Draw the samples and count how many times every configuration was drawn
+        std::vector<size_t> samples (N_s);
+        for (auto& sample : samples) {
+            sample = distribution(generator);
+        }
+        std::sort(samples.begin(), samples.end());
+
+        // For every external configuration: the linear and quadratic sums, for the full and for the deterministic wave function
+        SelectedFockSpace externals (K, N_alpha, N_beta);
+        std::vector<double> linear, quadratic, deterministic_linear, deterministic_quadratic;
+
+        for (auto it = samples.begin(); it != samples.end(); ) {
+            size_t I = *it;
+            auto next = std::upper_bound(it, samples.end(), I);
+            double w_I = static_cast<double>(next - it);
+            it = next;
+
+            double c_I = this->coefficients(I);
+            double p_I = probabilities(I);
+            const auto& configuration_I = this->fock_space.get_configuration(I);
+
+            this->excitation_generator.forEachExcitation(configuration_I, c_I, [&] (size_t alpha_representation, size_t beta_representation) {
+                if (this->fock_space.getIndex(alpha_representation, beta_representation) != SelectedFockSpace::npos) {
+                    return;  // the configuration is not external
+                }
+
+                Configuration external {ONV(K, N_alpha, alpha_representation), ONV(K, N_beta, beta_representation)};
+                double x = SelectedCI::calculateOffDiagonalElement(this->hamiltonian_parameters, external, configuration_I) * c_I;
+
+                size_t index = externals.getIndex(alpha_representation, beta_representation);
+                if (index == SelectedFockSpace::npos) {
+                    externals.addConfiguration(external.onv_alpha, external.onv_beta);
+                    index = linear.size();
+                    linear.push_back(0.0);
+                    quadratic.push_back(0.0);
+                    deterministic_linear.push_back(0.0);
+                    deterministic_quadratic.push_back(0.0);
+                }
+
+                double linear_term = w_I * x / p_I;
+                double quadratic_term = (w_I * (N_s - 1) / p_I - w_I * w_I / (p_I * p_I)) * x * x;
+                linear[index] += linear_term;
+                quadratic[index] += quadratic_term;
+                if (is_deterministic[I]) {
+                    deterministic_linear[index] += linear_term;
+                    deterministic_quadratic[index] += quadratic_term;
+                }
+            });
+        }
+
+        double estimate = 0.0;
+        for (size_t a = 0; a < linear.size(); a++) {
+            double diagonal_element = SelectedCI::calculateDiagonalElement(this->hamiltonian_parameters, externals.get_configuration(a));
+            double numerator = (linear[a] * linear[a] + quadratic[a]) - (deterministic_linear[a] * deterministic_linear[a] + deterministic_quadratic[a]);
+            estimate += numerator / (this->energy - diagonal_element);
+        }
+        estimates[set] = estimate / (N_s * (N_s - 1));
+    }
+
+
+    // Average the stochastic estimates, and use their spread for the standard error
+    size_t number_of_sets = estimates.size();
+    double mean = std::accumulate(estimates.begin(), estimates.end(), 0.0) / number_of_sets;
+    double variance = 0.0;
+    for (double estimate : estimates) {
+        variance += (estimate - mean) * (estimate - mean);
+    }
+    variance /= (number_of_sets - 1);
+
+    return PT2Estimate {deterministic_pt2_energy + mean, std::sqrt(variance / number_of_sets)};
+}
+
+
+}  // namespace GQCP
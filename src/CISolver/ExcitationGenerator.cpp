@@ -0,0 +1,54 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2018  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#include "CISolver/ExcitationGenerator.hpp"
+
+
+namespace GQCP {
+
+
+/*
+ *  CONSTRUCTORS
+ */
+
+/**
+ *  @param K        the number of orbitals
+ *
+ *  All single and double excitations are generated
+ */
+ExcitationGenerator::ExcitationGenerator(size_t K) :
+    K (K),
+    all_orbitals ((K == 64) ? ~0UL : ((1UL << K) - 1)),
+    heat_bath_threshold (0.0)
+{}
+
+
+/**
+ *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+ *  @param heat_bath_threshold          the heat-bath parameter epsilon: if positive, the double excitations of a configuration I are only generated if |c_I g| is at least epsilon
+ */
+ExcitationGenerator::ExcitationGenerator(const HamiltonianParameters& hamiltonian_parameters, double heat_bath_threshold) :
+    ExcitationGenerator(hamiltonian_parameters.get_h().get_dim())
+{
+    this->heat_bath_threshold = heat_bath_threshold;
+    if (heat_bath_threshold > 0.0) {
+        this->heat_bath_screening = std::make_shared<HeatBathScreening>(hamiltonian_parameters);
+    }
+}
+
+
+}  // namespace GQCP
@@ -0,0 +1,84 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2018  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#include "CISolver/HeatBathScreening.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace GQCP {
+
+
+/*
+ *  CONSTRUCTORS
+ */
+
+/**
+ *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+ */
+HeatBathScreening::HeatBathScreening(const HamiltonianParameters& hamiltonian_parameters) :
+    K (hamiltonian_parameters.get_h().get_dim()),
+    same_spin_targets (K * K),
+    opposite_spin_targets (K * K)
+{
+    const auto& g = hamiltonian_parameters.get_g();
+
+    auto by_decreasing_magnitude = [] (const Target& lhs, const Target& rhs) { return lhs.magnitude > rhs.magnitude; };
+
+    for (size_t i = 0; i < this->K; i++) {
+        for (size_t j = 0; j < this->K; j++) {
+
+            // Same-spin targets: a<b, both different from i and j
+            if (i < j) {
+                auto& targets = this->same_spin_targets[i*this->K + j];
+                for (size_t a = 0; a < this->K; a++) {
+                    for (size_t b = a+1; b < this->K; b++) {
+                        if ((a == i) || (a == j) || (b == i) || (b == j)) {
+                            continue;
+                        }
+
+                        double magnitude = std::abs(g(a,i,b,j) - g(a,j,b,i));
+                        if (magnitude > 0.0) {
+                            targets.push_back(Target {magnitude, a, b});
+                        }
+                    }
+                }
+                std::sort(targets.begin(), targets.end(), by_decreasing_magnitude);
+            }
+
+            // Opposite-spin targets: i -> a (alpha) and j -> b (beta)
+            auto& targets = this->opposite_spin_targets[i*this->K + j];
+            for (size_t a = 0; a < this->K; a++) {
+                for (size_t b = 0; b < this->K; b++) {
+                    if ((a == i) || (b == j)) {
+                        continue;
+                    }
+
+                    double magnitude = std::abs(g(a,i,b,j));
+                    if (magnitude > 0.0) {
+                        targets.push_back(Target {magnitude, a, b});
+                    }
+                }
+            }
+            std::sort(targets.begin(), targets.end(), by_decreasing_magnitude);
+        }
+    }
+}
+
+
+}  // namespace GQCP
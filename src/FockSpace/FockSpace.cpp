@@ -34,7 +34,7 @@ namespace GQCP {
  *          011 -> 101
  *          101 -> 110
  */
-size_t FockSpace::ulongNextPermutation(size_t representation) {
+size_t FockSpace::ulongNextPermutation(size_t representation) const {
 
     // t gets this->representation's least significant 0 bits set to 1
     unsigned long t = representation | (representation - 1UL);
@@ -45,21 +45,52 @@ size_t FockSpace::ulongNextPermutation(size_t representation) {
 }
 
 
-
-/*
- *  CONSTRUCTORS
+/**
+ *  @return the summed vertex weights for every chunk of bits_per_chunk orbitals, for every number of electrons in the preceding chunks and for every value of the chunk
  */
+std::vector<size_t> FockSpace::calculateChunkWeights() const {
+
+    size_t number_of_chunks = (this->K + bits_per_chunk - 1) / bits_per_chunk;
+    std::vector<size_t> chunk_weights (number_of_chunks * (this->N + 1) * values_per_chunk, 0);
+
+    for (size_t c = 0; c < number_of_chunks; c++) {
+        for (size_t m = 0; m < this->N + 1; m++) {  // m is the number of electrons in the preceding chunks
+            for (size_t value = 0; value < values_per_chunk; value++) {
+
+                // Add the vertex weights of the electrons in this chunk, as getAddress() would do one electron at a time
+                size_t weight = 0;
+                size_t electron_count = m;
+                size_t bits = value;
+                while (bits != 0) {
+                    size_t p = c * bits_per_chunk + __builtin_ctzl(bits);
+                    electron_count++;
+                    if ((p >= this->K) || (electron_count > this->N)) {  // this chunk value can't occur in a valid ONV
+                        weight = 0;
+                        break;
+                    }
+                    weight += this->get_vertex_weights(p, electron_count);
+                    bits ^= bits & -bits;  // flip the least significant bit
+                }
+
+                chunk_weights[(c * (this->N + 1) + m) * values_per_chunk + value] = weight;
+            }
+        }
+    }
+
+    return chunk_weights;
+}
+
 
 /**
  *  @param K        the number of orbitals
  *  @param N        the number of electrons
+ *
+ *  @return the vertex weights of the addressing scheme for a Fock space of N electrons in K orbitals
  */
-FockSpace::FockSpace(size_t K, size_t N) :
-        BaseFockSpace(K, FockSpace::calculateDimension(K, N)),
-        N (N)
-{
+Matrixu FockSpace::calculateVertexWeights(size_t K, size_t N) {
+
     // Create a zero matrix of dimensions (K+1)x(N+1)
-    this->vertex_weights = GQCP::Matrixu(this->K + 1, GQCP::Vectoru(this->N + 1, 0));
+    GQCP::Matrixu vertex_weights (K + 1, GQCP::Vectoru(N + 1, 0));
 
     // K=5   N=2
     // [ 0 0 0 ]
@@ -75,8 +106,8 @@ FockSpace::FockSpace(size_t K, size_t N) :
     //      Therefore, the largest reverse lexical string is the one where the first (K-N) orbitals are unoccupied.
     //      This means that there should be (K-N) vertical moves from (0,0).
     // Therefore, we may only set the weights of first (K-N+1) vertices of the first column to 1.
-    for (size_t p = 0; p < this->K - this->N + 1; p++) {
-        this->vertex_weights[p][0] = 1;
+    for (size_t p = 0; p < K - N + 1; p++) {
+        vertex_weights[p][0] = 1;
     }
 
     // K=5   N=2
@@ -92,9 +123,9 @@ FockSpace::FockSpace(size_t K, size_t N) :
     //      Every element is the sum of the values of the element vertically above and the element left diagonally above.
     //      W(p,m) = W(p-1,m) + W(p-1,m-1)
 
-    for (size_t m = 1; m < this->N + 1; m++) {
-        for (size_t p = m; p < (this->K - this->N + m) + 1; p++) {
-            this->vertex_weights[p][m] = this->vertex_weights[p - 1][m] + this->vertex_weights[p - 1][m - 1];
+    for (size_t m = 1; m < N + 1; m++) {
+        for (size_t p = m; p < (K - N + m) + 1; p++) {
+            vertex_weights[p][m] = vertex_weights[p - 1][m] + vertex_weights[p - 1][m - 1];
         }
     }
 
@@ -105,6 +136,53 @@ FockSpace::FockSpace(size_t K, size_t N) :
     // [ 1 3 3 ]
     // [ 0 4 6 ]
     // [ 0 0 10]
+
+    return vertex_weights;
+}
+
+
+
+/*
+ *  CONSTRUCTORS
+ */
+
+/**
+ *  @param K                            the number of orbitals
+ *  @param N                            the number of electrons
+ *  @param materialize_string_table     if the representations and occupation indices of all ONVs should be calculated and stored at construction
+ *
+ *  The string table is shared by all copies of this Fock space (e.g. the ones that are stored in the Hamiltonian and RDM builders)
+ */
+FockSpace::FockSpace(size_t K, size_t N, bool materialize_string_table) :
+        BaseFockSpace(K, FockSpace::calculateDimension(K, N)),
+        N (N),
+        vertex_weights (FockSpace::calculateVertexWeights(K, N))
+{
+    if (K > ONV::max_number_of_orbitals) {
+        throw std::invalid_argument("A FockSpace can have at most 64 orbitals.");
+    }
+
+    this->chunk_weights = this->calculateChunkWeights();
+
+    if (materialize_string_table) {
+        auto representations = std::make_shared<std::vector<size_t>>(this->dim);
+        auto occupations = std::make_shared<std::vector<uint8_t>>(this->dim * this->N);
+
+        ONV onv = this->get_ONV(0);
+        for (size_t I = 0; I < this->dim; I++) {
+            (*representations)[I] = onv.get_unsigned_representation();
+            for (size_t e = 0; e < this->N; e++) {
+                (*occupations)[I * this->N + e] = static_cast<uint8_t>(onv.get_occupied_index(e));
+            }
+
+            if (I < this->dim - 1) {  // prevent the last permutation to occur
+                this->setNext(onv);
+            }
+        }
+
+        this->representation_table = representations;
+        this->occupation_table = occupations;
+    }
 }
 
 
@@ -125,7 +203,6 @@ size_t FockSpace::calculateDimension(size_t K, size_t N) {
 }
 
 
-
 /*
  *  PUBLIC METHODS
  */
@@ -135,7 +212,7 @@ size_t FockSpace::calculateDimension(size_t K, size_t N) {
  *
  *  @return the ONV with the corresponding address
  */
-ONV FockSpace::get_ONV(size_t address) {
+ONV FockSpace::get_ONV(size_t address) const {
     size_t representation;
     if (this->N == 0) {
         representation = 0;
@@ -150,7 +227,7 @@ ONV FockSpace::get_ONV(size_t address) {
 
             if (weight <= address) {  // the algorithm can move diagonally, so we found an occupied orbital
                 address -= weight;
-                representation |= ((1) << (p - 1));  // set the (p-1)th bit: see (https://stackoverflow.com/a/47990)
+                representation |= (1UL << (p - 1));  // set the (p-1)th bit: see (https://stackoverflow.com/a/47990)
 
                 m--;  // since we found an occupied orbital, we have one electron less
                 if (m == 0) {
@@ -168,27 +245,46 @@ ONV FockSpace::get_ONV(size_t address) {
  *
  *  @param onv      the current ONV
  */
-void FockSpace::setNext(ONV& onv) {
-    onv.set_representation(ulongNextPermutation(onv.get_unsigned_representation()));
+void FockSpace::setNext(ONV& onv) const {
+    onv.set_representation_unchecked(ulongNextPermutation(onv.get_unsigned_representation()));
+}
+
+
+/**
+ *  Set the current ONV to the next ONV: if the string table is materialized, the next ONV is read from it, otherwise setNext(onv) is called
+ *
+ *  @param onv          the current ONV
+ *  @param address      the address of the current ONV
+ */
+void FockSpace::setNext(ONV& onv, size_t address) const {
+
+    if (this->hasStringTable()) {
+        onv.set_representation_unchecked(this->get_representation(address + 1), this->get_occupation_indices(address + 1));
+    } else {
+        this->setNext(onv);
+    }
 }
 
 
 /**
  *  @param onv      the ONV
  *
- *  @return the address (i.e. the ordering number) of the given ONV
+ *  @return the address (i.e. the ordering number) of the given ONV, calculated by adding one precomputed weight per chunk of bits_per_chunk orbitals
  */
-size_t FockSpace::getAddress(const ONV& onv) {
-    // An implementation of the formula in Helgaker, starting the addressing count from zero
+size_t FockSpace::getAddress(const ONV& onv) const {
+    // An implementation of the formula in Helgaker, starting the addressing count from zero, in which the vertex weights of all electrons in a chunk are summed beforehand
     size_t address = 0;
-    size_t electron_count = 0;  // counts the number of electrons in the spin string up to orbital p
-    unsigned long unsigned_onv = onv.get_unsigned_representation();  // copy the unsigned_representation of the onv
-
-    while(unsigned_onv != 0) {  // we will remove the least significant bit each loop, we are finished when no bits are left
-        size_t p = __builtin_ctzl(unsigned_onv);  // p is the orbital index counter (starting from 1)
-        electron_count++;  // each bit is an electron hence we add it up to the electron count
-        address += get_vertex_weights(p , electron_count);
-        unsigned_onv ^= unsigned_onv & -unsigned_onv;  // flip the least significant bit
+    size_t electron_count = 0;  // counts the number of electrons in the preceding chunks
+    size_t unsigned_onv = onv.get_unsigned_representation();  // copy the unsigned_representation of the onv
+
+    const size_t* weights = this->chunk_weights.data();
+    while (unsigned_onv != 0) {  // we will remove a chunk each loop, we are finished when no bits are left
+        size_t value = unsigned_onv & (values_per_chunk - 1);
+        address += weights[electron_count * values_per_chunk + value];
+        electron_count += __builtin_popcountl(value);
+
+        unsigned_onv >>= bits_per_chunk;
+        weights += (this->N + 1) * values_per_chunk;  // move to the weights of the next chunk
     }
     return address;
 }
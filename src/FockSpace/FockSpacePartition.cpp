@@ -0,0 +1,175 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2018  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#include "FockSpace/FockSpacePartition.hpp"
+
+
+namespace GQCP {
+
+
+/*
+ *  FOCKSPACEITERATOR
+ */
+
+/**
+ *  @param fock_space       the Fock space whose ONVs should be enumerated
+ *  @param range            the range of addresses that should be enumerated
+ */
+FockSpaceIterator::FockSpaceIterator(const FockSpace& fock_space, const AddressRange& range) :
+    fock_space (&fock_space),
+    address (range.start),
+    end (range.end)
+{
+    if (range.end > fock_space.get_dimension()) {
+        throw std::invalid_argument("The given range of addresses does not fit in the given Fock space.");
+    }
+
+    if (!this->isFinished()) {
+        this->onv = fock_space.get_ONV(range.start);  // unrank the first address of the range
+    }
+}
+
+
+/**
+ *  Move to the next ONV in the range
+ */
+void FockSpaceIterator::increment() {
+
+    if (this->address + 1 < this->end) {  // prevent the last permutation to occur
+        this->fock_space->setNext(this->onv, this->address);
+    }
+    this->address++;
+}
+
+
+
+/*
+ *  PRODUCTFOCKSPACEITERATOR
+ */
+
+/**
+ *  @param fock_space       the product Fock space whose ONVs should be enumerated
+ *  @param range            the range of addresses that should be enumerated
+ */
+ProductFockSpaceIterator::ProductFockSpaceIterator(const ProductFockSpace& fock_space, const AddressRange& range) :
+    fock_space_alpha (&fock_space.get_fock_space_alpha()),
+    fock_space_beta (&fock_space.get_fock_space_beta()),
+    address (range.start),
+    end (range.end)
+{
+    if (range.end > fock_space.get_dimension()) {
+        throw std::invalid_argument("The given range of addresses does not fit in the given Fock space.");
+    }
+
+    // Unrank the first address of the range: the alpha addresses are major
+    size_t dim_beta = this->fock_space_beta->get_dimension();
+    this->address_alpha = range.start / dim_beta;
+    this->address_beta = range.start % dim_beta;
+
+    if (!this->isFinished()) {
+        this->onv_alpha = this->fock_space_alpha->get_ONV(this->address_alpha);
+        this->onv_beta = this->fock_space_beta->get_ONV(this->address_beta);
+    }
+}
+
+
+/**
+ *  Move to the next pair of ONVs in the range: the beta ONV is moved to the next one, and when all beta ONVs are exhausted, the alpha ONV is moved to the next one
+ */
+void ProductFockSpaceIterator::increment() {
+
+    this->address++;
+    if (this->isFinished()) {  // prevent the last permutation to occur
+        return;
+    }
+
+    if (this->address_beta + 1 < this->fock_space_beta->get_dimension()) {
+        this->fock_space_beta->setNext(this->onv_beta, this->address_beta);
+        this->address_beta++;
+    } else {
+        this->fock_space_alpha->setNext(this->onv_alpha, this->address_alpha);
+        this->address_alpha++;
+
+        this->onv_beta = this->fock_space_beta->get_ONV(0);
+        this->address_beta = 0;
+    }
+}
+
+
+
+/*
+ *  PARTITIONING
+ */
+
+/**
+ *  @param dim                  the number of addresses
+ *  @param number_of_ranges     the number of ranges in which the addresses should be split
+ *
+ *  @return number_of_ranges contiguous ranges (of which some may be empty) that cover [0, dim) and contain (almost) equally many addresses
+ */
+std::vector<AddressRange> partitionAddresses(size_t dim, size_t number_of_ranges) {
+
+    if (number_of_ranges == 0) {
+        throw std::invalid_argument("The number of ranges should be at least 1.");
+    }
+
+    std::vector<AddressRange> ranges (number_of_ranges);
+    for (size_t t = 0; t < number_of_ranges; t++) {
+        ranges[t] = AddressRange {(t * dim) / number_of_ranges, ((t + 1) * dim) / number_of_ranges};
+    }
+
+    return ranges;
+}
+
+
+/**
+ *  @param fock_space           the Fock space whose addresses should be partitioned
+ *  @param number_of_ranges     the number of ranges in which the addresses should be split
+ *
+ *  @return iterators that are positioned at the start of each of number_of_ranges balanced, contiguous ranges of addresses. Since every ONV of a FockSpace couples to equally many other ONVs, the ranges contain (almost) equally many addresses
+ */
+std::vector<FockSpaceIterator> partition(const FockSpace& fock_space, size_t number_of_ranges) {
+
+    std::vector<FockSpaceIterator> iterators;
+    iterators.reserve(number_of_ranges);
+    for (const auto& range : partitionAddresses(fock_space.get_dimension(), number_of_ranges)) {
+        iterators.emplace_back(fock_space, range);
+    }
+
+    return iterators;
+}
+
+
+/**
+ *  @param fock_space           the product Fock space whose addresses should be partitioned
+ *  @param number_of_ranges     the number of ranges in which the addresses should be split
+ *
+ *  @return iterators that are positioned at the start of each of number_of_ranges balanced, contiguous ranges of addresses. Since every pair of ONVs of a ProductFockSpace couples to equally many other pairs, the ranges contain (almost) equally many addresses
+ */
+std::vector<ProductFockSpaceIterator> partition(const ProductFockSpace& fock_space, size_t number_of_ranges) {
+
+    std::vector<ProductFockSpaceIterator> iterators;
+    iterators.reserve(number_of_ranges);
+    for (const auto& range : partitionAddresses(fock_space.get_dimension(), number_of_ranges)) {
+        iterators.emplace_back(fock_space, range);
+    }
+
+    return iterators;
+}
+
+
+}  // namespace GQCP
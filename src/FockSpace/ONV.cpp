@@ -35,9 +35,13 @@ namespace GQCP {
 ONV::ONV(size_t K, size_t N, size_t unsigned_representation):
     K (K),
     N (N),
-    unsigned_representation (unsigned_representation)
+    unsigned_representation (unsigned_representation),
+    occupation_indices {}
 {
-    occupation_indices = VectorXs::Zero(N);
+    if (K > ONV::max_number_of_orbitals) {
+        throw std::invalid_argument("An ONV can have at most 64 orbitals.");
+    }
+
     this->updateOccupationIndices();  // throws error if the representation and N are not compatible
 }
 
@@ -47,10 +51,7 @@ ONV::ONV(size_t K, size_t N, size_t unsigned_representation):
  */
 ONV::ONV(size_t K, size_t representation):
     ONV(K, __builtin_popcountl(representation), representation)
-{
-    occupation_indices = VectorXs::Zero(N);
-    this->updateOccupationIndices();  // throws error if the representation and N are not compatible
-}
+{}
 
 
 
@@ -108,6 +109,25 @@ void ONV::set_representation(size_t unsigned_representation) {
 
 
 
+/*
+ *  GETTERS
+ */
+
+/**
+ *  @return the occupied orbital indices, in which the j-th element gives the occupied orbital index for electron j
+ */
+VectorXs ONV::get_occupation_indices() const {
+
+    VectorXs occupation_indices (this->N);
+    for (size_t e = 0; e < this->N; e++) {
+        occupation_indices(e) = this->occupation_indices[e];
+    }
+
+    return occupation_indices;
+}
+
+
+
 /*
  *  PUBLIC METHODS
  */
@@ -116,16 +136,12 @@ void ONV::set_representation(size_t unsigned_representation) {
  *  Extracts the positions of the set bits from the this->unsigned_representation and places them in the this->occupation_indices
  */
 void ONV::updateOccupationIndices() {
-    size_t l = this->unsigned_representation;
-    int representation_electron = 0;
-    while (l != 0) {
-        this->occupation_indices(representation_electron) = __builtin_ctzl(l);  // retrieves occupation index
-        representation_electron++;
-        l ^= (l & -l);  // flip the least significant bit
-    }
-    if (representation_electron != this->N) {
+
+    if (__builtin_popcountl(this->unsigned_representation) != this->N) {
         throw std::invalid_argument("The current representation and electron count are not compatible");
     }
+
+    this->updateOccupationIndices_unchecked();
 }
 
 
@@ -139,8 +155,7 @@ bool ONV::isOccupied(size_t p) const {
     if (p > this->K-1) {
         throw std::invalid_argument("The index is out of the bitset bounds");
     }
-    size_t operator_string = 1U << p;
-    return this->unsigned_representation & operator_string;
+    return this->isOccupied_unchecked(p);
 }
 
 
@@ -153,13 +168,10 @@ bool ONV::isOccupied(size_t p) const {
  */
 bool ONV::annihilate(size_t p) {
 
-    if (this->isOccupied(p)) {
-        size_t operator_string = 1U << p;
-        this->unsigned_representation &= ~operator_string;
-        return true;
-    } else {
-        return false;
+    if (p > this->K-1) {
+        throw std::invalid_argument("The index is out of the bitset bounds");
     }
+    return this->annihilate_unchecked(p);
 }
 
 
@@ -190,13 +202,10 @@ bool ONV::annihilate(size_t p, int& sign) {
  */
 bool ONV::create(size_t p) {
 
-    if (!this->isOccupied(p)) {
-        size_t operator_string = 1U << p;
-        this->unsigned_representation ^= operator_string;
-        return true;
-    } else {
-        return false;
+    if (p > this->K-1) {
+        throw std::invalid_argument("The index is out of the bitset bounds");
     }
+    return this->create_unchecked(p);
 }
 
 
@@ -228,16 +237,10 @@ bool ONV::create(size_t p, int& sign) {
  */
 int ONV::operatorPhaseFactor(size_t p) const {
 
-    if (p == 0) {  // we can't give this to this->slice(0, 0)
-        return 1;
-    }
-    size_t m = __builtin_popcountl(this->slice(0, p));  // count the number of set bits in the slice [0,p-1]
-
-    if ( m % 2 == 0 ) {  // even number of electrons: phase factor (+1)
-        return 1;
-    } else {  // odd number of electrons: phase factor (-1)
-        return -1;
+    if (p > this->K-1) {
+        throw std::invalid_argument("The index is out of the bitset bounds");
     }
+    return this->operatorPhaseFactor_unchecked(p);
 }
 
 
@@ -270,7 +273,7 @@ size_t ONV::slice(size_t index_start, size_t index_end) const {
 
     // Create the correct mask
     size_t mask_length = index_end - index_start;
-    size_t mask = ((1U) << mask_length) - 1;
+    size_t mask = (mask_length == 64) ? ~0UL : ((1UL << mask_length) - 1);
 
 
     // Use the mask
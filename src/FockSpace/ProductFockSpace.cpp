@@ -26,14 +26,17 @@ namespace GQCP {
  */
 
 /**
- *  @param K            the number of orbitals (equal for alpha and beta)
- *  @param N_alpha      the number of alpha electrons
- *  @param N_beta       the number of beta electrons
+ *  @param K                            the number of orbitals (equal for alpha and beta)
+ *  @param N_alpha                      the number of alpha electrons
+ *  @param N_beta                       the number of beta electrons
+ *  @param materialize_string_tables    if the string tables of the alpha and beta Fock spaces should be materialized (see FockSpace)
+ *
+ *  If N_alpha == N_beta, the alpha and beta Fock space share one string table
  */
-ProductFockSpace::ProductFockSpace(size_t K, size_t N_alpha, size_t N_beta) :
+ProductFockSpace::ProductFockSpace(size_t K, size_t N_alpha, size_t N_beta, bool materialize_string_tables) :
         BaseFockSpace(K, ProductFockSpace::calculateDimension(K, N_alpha, N_beta)),
-        fock_space_alpha (FockSpace(K, N_alpha)),
-        fock_space_beta (FockSpace(K, N_beta)),
+        fock_space_alpha (FockSpace(K, N_alpha, materialize_string_tables)),
+        fock_space_beta ((N_alpha == N_beta) ? fock_space_alpha : FockSpace(K, N_beta, materialize_string_tables)),
         N_alpha (N_alpha),
         N_beta (N_beta)
 {}
@@ -20,14 +20,121 @@
 
 #include "boost/dynamic_bitset.hpp"
 
+#include <algorithm>
+#include <numeric>
+
 
 namespace GQCP {
 
 
+constexpr size_t SelectedFockSpace::npos;
+
+
+
 /*
  *  PRIVATE METHODS
  */
 
+/**
+ *  Rebuild the hash index with the given number of slots and insert all current configurations
+ *
+ *  @param number_of_slots      the new number of slots, which should be a power of two
+ */
+void SelectedFockSpace::rehash(size_t number_of_slots) {
+
+    this->index_slots.assign(number_of_slots, 0);
+    this->number_of_indexed_configurations = 0;
+
+    for (size_t position = 0; position < this->configurations.size(); position++) {
+        this->insertIntoIndex(position);
+    }
+}
+
+
+/**
+ *  Insert the configuration at the given position into the hash index, if an identical configuration isn't indexed yet
+ *
+ *  @param position     the position of the configuration in this Fock space
+ */
+void SelectedFockSpace::insertIntoIndex(size_t position) {
+
+    // Keep the load factor of the index at most 1/2, so that probe sequences stay short
+    if (2 * (this->number_of_indexed_configurations + 1) > this->index_slots.size()) {
+        size_t number_of_slots = std::max<size_t>(16, this->index_slots.size());
+        while (2 * (this->number_of_indexed_configurations + 1) > number_of_slots) {
+            number_of_slots *= 2;
+        }
+        this->rehash(number_of_slots);  // this also indexes the configuration at the given position
+        return;
+    }
+
+    const auto& configuration = this->configurations[position];
+    size_t alpha_representation = configuration.onv_alpha.get_unsigned_representation();
+    size_t beta_representation = configuration.onv_beta.get_unsigned_representation();
+
+    size_t mask = this->index_slots.size() - 1;
+    size_t slot = SelectedFockSpace::hash(alpha_representation, beta_representation) & mask;
+    while (this->index_slots[slot] != 0) {
+        const auto& occupant = this->configurations[this->index_slots[slot] - 1];
+        if ((occupant.onv_alpha.get_unsigned_representation() == alpha_representation) && (occupant.onv_beta.get_unsigned_representation() == beta_representation)) {
+            return;  // the index keeps referring to the first added configuration
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    this->index_slots[slot] = position + 1;
+    this->number_of_indexed_configurations++;
+}
+
+
+/**
+ *  Invalidate the canonical layout, after the configurations have been changed
+ */
+void SelectedFockSpace::invalidateCanonicalLayout() {
+
+    if (!this->is_canonical) {
+        return;
+    }
+
+    this->is_canonical = false;
+    this->alpha_strings.clear();
+    this->beta_strings.clear();
+    this->alpha_string_indices.clear();
+    this->beta_string_indices.clear();
+    this->alpha_offsets.clear();
+    this->beta_offsets.clear();
+    this->beta_configurations.clear();
+}
+
+
+/**
+ *  Throw if the configurations are not in the canonical layout
+ */
+void SelectedFockSpace::checkCanonical() const {
+
+    if (!this->is_canonical) {
+        throw std::invalid_argument("The configurations of the Fock space are not in the canonical layout: call canonicalize() first");
+    }
+}
+
+
+/**
+ *  Check if the given configuration is compatible with this Fock space, and throw if it isn't
+ *
+ *  @param configuration        the configuration that should be checked
+ */
+void SelectedFockSpace::checkCompatibility(const Configuration& configuration) const {
+
+    if ((configuration.onv_alpha.get_K() != this->K) || (configuration.onv_beta.get_K() != this->K)) {
+        throw std::invalid_argument("Given ONVs are not compatible with the number of orbitals of the Fock space");
+    }
+
+    if ((configuration.onv_alpha.get_N() != this->N_alpha) || (configuration.onv_beta.get_N() != this->N_beta)) {
+        throw std::invalid_argument("Given ONVs are not compatible with the number of electrons of the Fock space");
+    }
+}
+
+
 /**
  *  @param onv1     the alpha ONV as a string representation read from right to left
  *  @param onv2     the beta ONV as a string representation read from right to left
@@ -88,6 +195,7 @@ SelectedFockSpace::SelectedFockSpace(const ProductFockSpace& fock_space) :
 {
 
     std::vector<Configuration> configurations;
+    configurations.reserve(fock_space.get_dimension());
 
     FockSpace fock_space_alpha = fock_space.get_fock_space_alpha();
     FockSpace fock_space_beta = fock_space.get_fock_space_beta();
@@ -111,9 +219,7 @@ SelectedFockSpace::SelectedFockSpace(const ProductFockSpace& fock_space) :
             fock_space_alpha.setNext(alpha);
         }
     }
-    this->dim = fock_space.get_dimension();
-    this->configurations = configurations;
-
+    this->addConfigurations(configurations);
 }
 
 
@@ -127,6 +233,7 @@ SelectedFockSpace::SelectedFockSpace(const FockSpace& fock_space)  :
 {
 
     std::vector<Configuration> configurations;
+    configurations.reserve(fock_space.get_dimension());
 
     // Current workaround to call non-const functions
     FockSpace fock_space_single = fock_space;
@@ -146,12 +253,31 @@ SelectedFockSpace::SelectedFockSpace(const FockSpace& fock_space)  :
 
     }
 
-    this->dim = dim;
-    this->configurations = configurations;
+    this->addConfigurations(configurations);
+}
+
+
+/*
+ *  STATIC PUBLIC METHODS
+ */
+
+/**
+ *  @param alpha_representation     the unsigned representation of an alpha ONV
+ *  @param beta_representation      the unsigned representation of a beta ONV
+ *
+ *  @return the hash of the corresponding configuration, which is also used for the hash index
+ */
+size_t SelectedFockSpace::hash(size_t alpha_representation, size_t beta_representation) {
 
+    // Combine both representations and scramble the bits (the finalizer of the splitmix64 generator), so that neighbouring representations don't end up in neighbouring slots
+    size_t x = alpha_representation ^ (beta_representation * 0x9e3779b97f4a7c15UL);
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9UL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebUL;
+    return x ^ (x >> 31);
 }
 
 
+
 /*
  *  PUBLIC METHODS
  */
@@ -164,10 +290,8 @@ SelectedFockSpace::SelectedFockSpace(const FockSpace& fock_space)  :
  */
 void SelectedFockSpace::addConfiguration(const std::string& onv1, const std::string& onv2) {
 
-    this->dim++;
-
     Configuration configuration = makeConfiguration(onv1, onv2);
-    configurations.push_back(configuration);
+    this->addConfiguration(configuration.onv_alpha, configuration.onv_beta);
 }
 
 
@@ -189,4 +313,261 @@ void SelectedFockSpace::addConfiguration(const std::vector<std::string>& onv1s,
 }
 
 
+/**
+ *  Add a configuration to this Fock space
+ *
+ *  @param onv_alpha        the alpha ONV
+ *  @param onv_beta         the beta ONV
+ */
+void SelectedFockSpace::addConfiguration(const ONV& onv_alpha, const ONV& onv_beta) {
+
+    Configuration configuration {onv_alpha, onv_beta};
+    this->checkCompatibility(configuration);
+
+    this->invalidateCanonicalLayout();
+
+    this->configurations.push_back(configuration);
+    this->dim++;
+    this->insertIntoIndex(this->dim - 1);
+}
+
+
+/**
+ *  Add a number of configurations to this Fock space, rebuilding the hash index at most once
+ *
+ *  @param configurations       the configurations that should be added
+ */
+void SelectedFockSpace::addConfigurations(const std::vector<Configuration>& configurations) {
+
+    for (const auto& configuration : configurations) {
+        this->checkCompatibility(configuration);
+    }
+
+    this->invalidateCanonicalLayout();
+    this->reserve(this->configurations.size() + configurations.size());
+
+    size_t start = this->configurations.size();
+    this->configurations.insert(this->configurations.end(), configurations.begin(), configurations.end());
+    this->dim = this->configurations.size();
+
+    for (size_t position = start; position < this->dim; position++) {
+        this->insertIntoIndex(position);
+    }
+}
+
+
+/**
+ *  Reserve memory for the given total number of configurations, so that adding configurations doesn't trigger a reallocation or a rebuild of the hash index
+ *
+ *  @param number_of_configurations     the total number of configurations this Fock space is expected to hold
+ */
+void SelectedFockSpace::reserve(size_t number_of_configurations) {
+
+    this->configurations.reserve(number_of_configurations);
+
+    size_t number_of_slots = std::max<size_t>(16, this->index_slots.size());
+    while (2 * number_of_configurations > number_of_slots) {
+        number_of_slots *= 2;
+    }
+
+    if (number_of_slots > this->index_slots.size()) {
+        this->rehash(number_of_slots);
+    }
+}
+
+
+/**
+ *  @param alpha_representation     the unsigned representation of the alpha ONV
+ *  @param beta_representation      the unsigned representation of the beta ONV
+ *
+ *  @return the index of the (first added) corresponding configuration in this Fock space, or SelectedFockSpace::npos if it isn't present
+ */
+size_t SelectedFockSpace::getIndex(size_t alpha_representation, size_t beta_representation) const {
+
+    if (this->index_slots.empty()) {
+        return SelectedFockSpace::npos;
+    }
+
+    size_t mask = this->index_slots.size() - 1;
+    size_t slot = SelectedFockSpace::hash(alpha_representation, beta_representation) & mask;
+    while (this->index_slots[slot] != 0) {
+        size_t position = this->index_slots[slot] - 1;
+        const auto& configuration = this->configurations[position];
+        if ((configuration.onv_alpha.get_unsigned_representation() == alpha_representation) && (configuration.onv_beta.get_unsigned_representation() == beta_representation)) {
+            return position;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    return SelectedFockSpace::npos;
+}
+
+
+/**
+ *  Bring the configurations in the canonical layout: sort them by alpha string and then by beta string, and build the unique string tables, the alpha string -> configuration range index and the beta string -> configuration lists
+ *
+ *  @return the previous positions of the configurations, i.e. the configuration at position I in the canonical layout was at position permutation[I] before
+ *
+ *  Adding configurations afterwards invalidates the canonical layout
+ */
+std::vector<size_t> SelectedFockSpace::canonicalize() {
+
+    // Sort the configurations by alpha and then by beta string, keeping the relative order of duplicates
+    std::vector<size_t> permutation (this->dim);
+    std::iota(permutation.begin(), permutation.end(), 0);
+    std::stable_sort(permutation.begin(), permutation.end(), [this] (size_t lhs, size_t rhs) {
+        size_t lhs_alpha = this->configurations[lhs].onv_alpha.get_unsigned_representation();
+        size_t rhs_alpha = this->configurations[rhs].onv_alpha.get_unsigned_representation();
+        if (lhs_alpha != rhs_alpha) {
+            return lhs_alpha < rhs_alpha;
+        }
+        return this->configurations[lhs].onv_beta.get_unsigned_representation() < this->configurations[rhs].onv_beta.get_unsigned_representation();
+    });
+
+    std::vector<Configuration> sorted_configurations;
+    sorted_configurations.reserve(this->dim);
+    for (size_t I : permutation) {
+        sorted_configurations.push_back(this->configurations[I]);
+    }
+    this->configurations = std::move(sorted_configurations);
+
+    // The positions have changed, so the hash index has to be rebuilt
+    this->rehash(std::max<size_t>(16, this->index_slots.size()));
+
+
+    // Since the configurations are sorted by alpha string, the unique alpha strings and their ranges follow from a single pass
+    this->alpha_strings.clear();
+    this->alpha_offsets.clear();
+    this->alpha_string_indices.resize(this->dim);
+    for (size_t I = 0; I < this->dim; I++) {
+        size_t alpha_representation = this->configurations[I].onv_alpha.get_unsigned_representation();
+        if (this->alpha_strings.empty() || (this->alpha_strings.back() != alpha_representation)) {
+            this->alpha_strings.push_back(alpha_representation);
+            this->alpha_offsets.push_back(I);
+        }
+        this->alpha_string_indices[I] = this->alpha_strings.size() - 1;
+    }
+    this->alpha_offsets.push_back(this->dim);
+
+
+    // The unique beta strings have to be sorted separately
+    this->beta_strings.resize(this->dim);
+    for (size_t I = 0; I < this->dim; I++) {
+        this->beta_strings[I] = this->configurations[I].onv_beta.get_unsigned_representation();
+    }
+    std::sort(this->beta_strings.begin(), this->beta_strings.end());
+    this->beta_strings.erase(std::unique(this->beta_strings.begin(), this->beta_strings.end()), this->beta_strings.end());
+
+    this->beta_string_indices.resize(this->dim);
+    for (size_t I = 0; I < this->dim; I++) {
+        size_t beta_representation = this->configurations[I].onv_beta.get_unsigned_representation();
+        this->beta_string_indices[I] = std::lower_bound(this->beta_strings.begin(), this->beta_strings.end(), beta_representation) - this->beta_strings.begin();
+    }
+
+
+    // Group the configurations by beta string (a counting sort), which keeps them sorted by position within every group
+    this->beta_offsets.assign(this->beta_strings.size() + 1, 0);
+    for (size_t I = 0; I < this->dim; I++) {
+        this->beta_offsets[this->beta_string_indices[I] + 1]++;
+    }
+    for (size_t b = 0; b < this->beta_strings.size(); b++) {
+        this->beta_offsets[b + 1] += this->beta_offsets[b];
+    }
+
+    this->beta_configurations.resize(this->dim);
+    std::vector<size_t> next = this->beta_offsets;
+    for (size_t I = 0; I < this->dim; I++) {
+        this->beta_configurations[next[this->beta_string_indices[I]]++] = I;
+    }
+
+    this->is_canonical = true;
+    return permutation;
+}
+
+
+
+/*
+ *  PUBLIC METHODS FOR THE CANONICAL LAYOUT
+ */
+
+/**
+ *  @return the number of unique alpha strings
+ */
+size_t SelectedFockSpace::get_number_of_alpha_strings() const {
+
+    this->checkCanonical();
+    return this->alpha_strings.size();
+}
+
+
+/**
+ *  @return the number of unique beta strings
+ */
+size_t SelectedFockSpace::get_number_of_beta_strings() const {
+
+    this->checkCanonical();
+    return this->beta_strings.size();
+}
+
+
+/**
+ *  @param a        the index of a unique alpha string
+ *
+ *  @return the representation of the alpha string
+ */
+size_t SelectedFockSpace::get_alpha_string(size_t a) const {
+
+    this->checkCanonical();
+    return this->alpha_strings[a];
+}
+
+
+/**
+ *  @param b        the index of a unique beta string
+ *
+ *  @return the representation of the beta string
+ */
+size_t SelectedFockSpace::get_beta_string(size_t b) const {
+
+    this->checkCanonical();
+    return this->beta_strings[b];
+}
+
+
+/**
+ *  @param index        the index of a configuration
+ *
+ *  @return the index of the unique alpha string of the configuration
+ */
+size_t SelectedFockSpace::get_alpha_string_index(size_t index) const {
+
+    this->checkCanonical();
+    return this->alpha_string_indices[index];
+}
+
+
+/**
+ *  @param index        the index of a configuration
+ *
+ *  @return the index of the unique beta string of the configuration
+ */
+size_t SelectedFockSpace::get_beta_string_index(size_t index) const {
+
+    this->checkCanonical();
+    return this->beta_string_indices[index];
+}
+
+
+/**
+ *  @param b        the index of a unique beta string
+ *
+ *  @return the range in the beta configuration list (see get_beta_configuration()) of the configurations that have the given beta string
+ */
+AddressRange SelectedFockSpace::get_beta_range(size_t b) const {
+
+    this->checkCanonical();
+    return AddressRange {this->beta_offsets[b], this->beta_offsets[b + 1]};
+}
+
+
 }  // namespace GQCP
@@ -17,80 +17,124 @@
 // 
 #include "HamiltonianBuilder/DOCI.hpp"
 
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 
 namespace GQCP {
 
 
 /*
- *  CONSTRUCTORS
+ *  PRIVATE METHODS
  */
 
 /**
- *  @param fock_space       the full Fock space, identical for alpha and beta
+ *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+ *
+ *  @return a DiagonalEngine that calculates the diagonal elements of the DOCI Hamiltonian, i.e.
+ *      E(S) = sum_{p in S} (2 h_pp + g_pppp) + sum_{p>q in S} 2 (2 g_ppqq - g_pqqp)
  */
-DOCI::DOCI(const FockSpace& fock_space) :
-    HamiltonianBuilder(),
-    fock_space (fock_space)
-{}
+DiagonalEngine DOCI::constructDiagonalEngine(const HamiltonianParameters& hamiltonian_parameters) const {
 
+    auto K = this->fock_space.get_K();
 
+    Eigen::VectorXd one_electron_terms (K);
+    Eigen::MatrixXd pair_terms = Eigen::MatrixXd::Zero(K, K);
+    for (size_t p = 0; p < K; p++) {
+        one_electron_terms(p) = 2 * hamiltonian_parameters.get_h()(p,p) + hamiltonian_parameters.get_g()(p,p,p,p);
+
+        for (size_t q = 0; q < p; q++) {
+            // Since we are doing a restricted summation q<p, we should multiply by 2 since the summand argument is symmetric.
+            pair_terms(p,q) = 2 * (2*hamiltonian_parameters.get_g()(p,p,q,q) - hamiltonian_parameters.get_g()(p,q,q,p));
+        }
+    }
+
+    return DiagonalEngine(one_electron_terms, pair_terms);
+}
 
-/*
- *  OVERRIDDEN PUBLIC METHODS
- */
 
 /**
  *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
  *
- *  @return the DOCI Hamiltonian matrix
+ *  @return the only integrals that the DOCI Hamiltonian depends on, as a K x (3K+1) matrix: the column h_pp, followed by the blocks g_ppqq, g_pqqp and g_pqpq
  */
-Eigen::MatrixXd DOCI::constructHamiltonian(const HamiltonianParameters& hamiltonian_parameters) {
-    
+Eigen::MatrixXd DOCI::extractPairIntegrals(const HamiltonianParameters& hamiltonian_parameters) const {
+
     auto K = hamiltonian_parameters.get_h().get_dim();
-    if (K != this->fock_space.get_K()) {
-        throw std::invalid_argument("Basis functions of the Fock space and hamiltonian_parameters are incompatible.");
+
+    Eigen::MatrixXd pair_integrals (K, 3*K + 1);
+    for (size_t p = 0; p < K; p++) {
+        pair_integrals(p, 0) = hamiltonian_parameters.get_h()(p,p);
+
+        for (size_t q = 0; q < K; q++) {
+            pair_integrals(p, 1 + q) = hamiltonian_parameters.get_g()(p,p,q,q);
+            pair_integrals(p, 1 + K + q) = hamiltonian_parameters.get_g()(p,q,q,p);
+            pair_integrals(p, 1 + 2*K + q) = hamiltonian_parameters.get_g()(p,q,p,q);
+        }
     }
-    size_t dim = this->fock_space.get_dimension();
-    Eigen::VectorXd diagonal = calculateDiagonal(hamiltonian_parameters);
-    Eigen::MatrixXd result_matrix = Eigen::MatrixXd::Zero(dim, dim);
-    // Create the first spin string. Since in DOCI, alpha == beta, we can just treat them as one
-    // And multiply all contributions by 2
-    ONV onv = this->fock_space.get_ONV(0);  // spin string with address 0
 
-    for (size_t I = 0; I < dim; I++) {  // I loops over all the addresses of the spin strings
-        // Diagonal contribution
-        result_matrix(I, I) += diagonal(I);
+    return pair_integrals;
+}
 
-        // Off-diagonal contribution
-        for (size_t e1 = 0; e1 < this->fock_space.get_N(); e1++) {  // e1 (electron 1) loops over the (number of) electrons
-            size_t p = onv.get_occupied_index(e1);  // retrieve the index of the orbital the electron occupies
-            for (size_t q = 0; q < p; q++) {  // q loops over SOs
-                if (!onv.isOccupied(q)) {  // if q not in I
-                    onv.annihilate(p);
-                    onv.create(q);
 
-                    size_t J = this->fock_space.getAddress(onv);  // J is the address of a string that couples to I
+/**
+ *  (Re)build the stored sparse Hamiltonian if none has been stored yet, or if it was built from other Hamiltonian parameters
+ *
+ *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+ */
+void DOCI::updateSparseHamiltonian(const HamiltonianParameters& hamiltonian_parameters) {
 
-                    // The loops are p->K and q<p. So, we should normally multiply by a factor 2 (since the summand is symmetric)
-                    // However, we are setting both of the symmetric indices of Hamiltonian, so no factor 2 is required
-                    result_matrix(I, J) += hamiltonian_parameters.get_g()(p, q, p, q);
-                    result_matrix(J, I) += hamiltonian_parameters.get_g()(p, q, p, q);
+    // Comparing the O(K^2) integrals that the DOCI Hamiltonian depends on is negligible compared to a sparse matrix-vector product
+    Eigen::MatrixXd pair_integrals = this->extractPairIntegrals(hamiltonian_parameters);
+    bool is_stored = (static_cast<size_t>(this->sparse_hamiltonian.rows()) == this->fock_space.get_dimension());
+    if (is_stored && (pair_integrals.rows() == this->sparse_hamiltonian_integrals.rows()) && (pair_integrals == this->sparse_hamiltonian_integrals)) {
+        return;
+    }
 
-                    onv.annihilate(q);  // reset the spin string after previous creation
-                    onv.create(p);  // reset the spin string after previous annihilation
+    this->sparse_hamiltonian = this->constructSparseHamiltonian(hamiltonian_parameters);
+    this->sparse_hamiltonian_integrals = pair_integrals;
+}
 
-                }  // q < p loop
-            }
-        }  // p or e1 loop
 
-        // Skip the last permutation
-        if (I < dim-1) {
-            this->fock_space.setNext(onv);
-        }
 
-    }  // address (I) loop
+/*
+ *  CONSTRUCTORS
+ */
+
+/**
+ *  @param fock_space                   the full Fock space, identical for alpha and beta
+ *  @param use_sparse_hamiltonian       if the DOCI Hamiltonian should be stored as a sparse matrix and be used in matrixVectorProduct()
+ */
+DOCI::DOCI(const FockSpace& fock_space, bool use_sparse_hamiltonian) :
+    HamiltonianBuilder(),
+    fock_space (fock_space),
+    use_sparse_hamiltonian (use_sparse_hamiltonian)
+{}
+
+
+
+/*
+ *  OVERRIDDEN PUBLIC METHODS
+ */
 
-    return result_matrix;
+/**
+ *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+ *
+ *  @return the DOCI Hamiltonian matrix
+ *
+ *  If the sparse Hamiltonian is used, it is (re)built and stored for the given Hamiltonian parameters if needed
+ */
+Eigen::MatrixXd DOCI::constructHamiltonian(const HamiltonianParameters& hamiltonian_parameters) {
+
+    if (this->use_sparse_hamiltonian) {
+        this->updateSparseHamiltonian(hamiltonian_parameters);
+        return Eigen::MatrixXd(this->sparse_hamiltonian);
+    }
+
+    return Eigen::MatrixXd(this->constructSparseHamiltonian(hamiltonian_parameters));
 }
 
 
@@ -100,6 +144,8 @@ Eigen::MatrixXd DOCI::constructHamiltonian(const HamiltonianParameters& hamilton
  *  @param diagonal                     the diagonal of the DOCI Hamiltonian matrix
  *
  *  @return the action of the DOCI Hamiltonian on the coefficient vector
+ *
+ *  If the sparse Hamiltonian is used, the stored sparse Hamiltonian is multiplied with x: it is (re)built if it doesn't correspond to the given Hamiltonian parameters, and since it already contains the diagonal, the given diagonal isn't used.
  */
 Eigen::VectorXd DOCI::matrixVectorProduct(const HamiltonianParameters& hamiltonian_parameters, const Eigen::VectorXd& x, const Eigen::VectorXd& diagonal) {
     auto K = hamiltonian_parameters.get_h().get_dim();
@@ -107,82 +153,160 @@ Eigen::VectorXd DOCI::matrixVectorProduct(const HamiltonianParameters& hamiltoni
         throw std::invalid_argument("Basis functions of the Fock space and hamiltonian_parameters are incompatible.");
     }
     size_t dim = this->fock_space.get_dimension();
-    // Create the first spin string. Since in DOCI, alpha == beta, we can just treat them as one
-    // And multiply all contributions by 2
-    ONV onv = this->fock_space.get_ONV(0);  // spin string with address
+
+    if (this->use_sparse_hamiltonian) {
+        this->updateSparseHamiltonian(hamiltonian_parameters);
+        return this->sparse_hamiltonian * x;
+    }
+
 
     // Diagonal contributions
     Eigen::VectorXd matvec = diagonal.cwiseProduct(x);
 
 
     // Off-diagonal contributions
-    for (size_t I = 0; I < dim; I++) {  // I loops over all the addresses of the spin strings
-        for (size_t e1 = 0; e1 < this->fock_space.get_N(); e1++) {  // e1 (electron 1) loops over the (number of) electrons
-            size_t p = onv.get_occupied_index(e1);  // retrieve the index of the orbital the electron occupies
-            for (size_t q = 0; q < p; q++) {  // q loops over SOs
-                if (!onv.isOccupied(q)) {  // if q not in I
+    // Every thread gathers all the contributions for a contiguous range of addresses I, so no two threads write to the same element of matvec
+    #pragma omp parallel
+    {
+        size_t number_of_threads = 1;
+        size_t thread_index = 0;
+        #ifdef _OPENMP
+        number_of_threads = omp_get_num_threads();
+        thread_index = omp_get_thread_num();
+        #endif
+
+        // Since every DOCI string couples to exactly N(K-N) other strings, equal ranges of addresses also represent equal amounts of work
+        FockSpaceIterator iterator (this->fock_space, partitionAddresses(dim, number_of_threads)[thread_index]);  // positioned at the first spin string of this thread's range. Since in DOCI, alpha == beta, we can just treat them as one
+
+        for (; !iterator.isFinished(); iterator.increment()) {  // loops over this thread's addresses I of the spin strings
+            size_t I = iterator.get_address();
+            double value = 0.0;  // the off-diagonal contributions to matvec(I)
+
+            // All pair excitations p->q, in which q is not occupied in I
+            this->fock_space.forEachOneElectronCoupling(iterator.get_ONV(), [] (size_t p, size_t q) { return p != q; }, [&] (size_t J, int /*sign*/, size_t p, size_t q) {
+
+                // Always use the integral with the largest orbital index first, so that the (implicit) Hamiltonian is symmetric
+                size_t r = std::max(p, q);
+                size_t s = std::min(p, q);
+                value += hamiltonian_parameters.get_g()(r, s, r, s) * x(J);  // a pair excitation has no sign
+            });
+
+            matvec(I) += value;
+        }  // address (I) loop
+    }  // parallel region
 
-                    onv.annihilate(p);
-                    onv.create(q);
+    return matvec;
+}
 
-                    size_t J = this->fock_space.getAddress(onv);  // J is the address of a string that couples to I
 
-                    // The loops are p->K and q<p. So, we should normally multiply by a factor 2 (since the summand is symmetric)
-                    // However, we are setting both of the symmetric indices of Hamiltonian, so no factor 2 is required
-                    matvec(I) += hamiltonian_parameters.get_g()(p, q, p, q) * x(J);
-                    matvec(J) += hamiltonian_parameters.get_g()(p, q, p, q) * x(I);
+/**
+ *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+ *
+ *  @return the diagonal of the matrix representation of the Hamiltonian given @param hamiltonian_parameters
+ *
+ *  If the sparse Hamiltonian is used, it is (re)built and stored for the given Hamiltonian parameters if needed, and its diagonal is returned
+ *  Otherwise, the addresses are split over the available (OpenMP) threads, and every diagonal element is updated from the previous one in that thread's range
+ */
+Eigen::VectorXd DOCI::calculateDiagonal(const HamiltonianParameters& hamiltonian_parameters) {
 
-                    onv.annihilate(q);  // reset the spin string after previous creation
-                    onv.create(p);  // reset the spin string after previous annihilation
+    if (this->use_sparse_hamiltonian) {
+        this->updateSparseHamiltonian(hamiltonian_parameters);
+        return this->sparse_hamiltonian.diagonal();
+    }
 
-                }  // q < p loop
-            }
-        }  // p or e1 loop
+    auto K = hamiltonian_parameters.get_h().get_dim();
+    if (K != this->fock_space.get_K()) {
+        throw std::invalid_argument("Basis functions of the Fock space and hamiltonian_parameters are incompatible.");
+    }
+    size_t dim = this->fock_space.get_dimension();
+    Eigen::VectorXd diagonal = Eigen::VectorXd::Zero(dim);
 
-        // Skip the last permutation
-        if (I < dim-1) {
-            this->fock_space.setNext(onv);
-        }
+    // Every thread calculates the diagonal for a contiguous range of addresses: only the first element of every range is calculated from scratch, the others are updated from their predecessor
+    #pragma omp parallel
+    {
+        size_t number_of_threads = 1;
+        size_t thread_index = 0;
+        #ifdef _OPENMP
+        number_of_threads = omp_get_num_threads();
+        thread_index = omp_get_thread_num();
+        #endif
 
-    }  // address (I) loop
+        FockSpaceIterator iterator (this->fock_space, partitionAddresses(dim, number_of_threads)[thread_index]);  // positioned at the first spin string of this thread's range. Since in DOCI, alpha == beta, we can just treat them as one
+        DiagonalEngine diagonal_engine = this->constructDiagonalEngine(hamiltonian_parameters);
 
-    return matvec;
+        for (; !iterator.isFinished(); iterator.increment()) {  // loops over this thread's addresses I of the spin strings
+            diagonal(iterator.get_address()) = diagonal_engine.calculate(iterator.get_ONV());
+        }  // address (I) loop
+    }  // parallel region
+
+    return diagonal;
 }
 
 
+
+/*
+ *  PUBLIC METHODS
+ */
+
 /**
  *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
  *
- *  @return the diagonal of the matrix representation of the Hamiltonian given @param hamiltonian_parameters
+ *  @return the DOCI Hamiltonian (including its diagonal) as a row-major (CSR) sparse matrix
  */
-Eigen::VectorXd DOCI::calculateDiagonal(const HamiltonianParameters& hamiltonian_parameters) {
+Eigen::SparseMatrix<double, Eigen::RowMajor> DOCI::constructSparseHamiltonian(const HamiltonianParameters& hamiltonian_parameters) {
+
+    auto K = hamiltonian_parameters.get_h().get_dim();
+    if (K != this->fock_space.get_K()) {
+        throw std::invalid_argument("Basis functions of the Fock space and hamiltonian_parameters are incompatible.");
+    }
+    size_t N = this->fock_space.get_N();
     size_t dim = this->fock_space.get_dimension();
-    Eigen::VectorXd diagonal = Eigen::VectorXd::Zero(dim);
+
+    // Every row has one diagonal element and N(K-N) off-diagonal elements: one for every pair excitation p->q
+    size_t entries_per_row = 1 + N * (K - N);
+    Eigen::SparseMatrix<double, Eigen::RowMajor> sparse_matrix (dim, dim);
+    sparse_matrix.reserve(dim * entries_per_row);
+
+    // The row is gathered as (column, value) pairs, and sorted on the column index before it is appended to the CSR structure
+    std::vector<std::pair<size_t, double>> row_entries;
+    row_entries.reserve(entries_per_row);
+
+    DiagonalEngine diagonal_engine = this->constructDiagonalEngine(hamiltonian_parameters);
+
     // Create the first spin string. Since in DOCI, alpha == beta, we can just treat them as one
-    // And multiply all contributions by 2
-    ONV onv = this->fock_space.get_ONV(0);  // onv with address 0
+    ONV onv = this->fock_space.get_ONV(0);  // spin string with address 0
 
-    for (size_t I = 0; I < dim; I++) {  // I loops over addresses of spin strings
-        for (size_t e1 = 0; e1 < this->fock_space.get_N(); e1++) {  // e1 (electron 1) loops over the (number of) electrons
-            size_t p = onv.get_occupied_index(e1);  // retrieve the index of the orbital the electron occupies
+    for (size_t I = 0; I < dim; I++) {  // I loops over all the addresses of the spin strings (i.e. the rows)
+        row_entries.clear();
 
-            diagonal(I) += 2 * hamiltonian_parameters.get_h()(p,p) + hamiltonian_parameters.get_g()(p,p,p,p);
-            for (size_t e2 = 0; e2 < e1; e2++) {  // e2 (electron 2) loops over the (number of) electrons
-                // Since we are doing a restricted summation q<p (and thus e2<e1), we should multiply by 2 since the summand argument is symmetric.
-                size_t q = onv.get_occupied_index(e2);  // retrieve the index of the orbital the electron occupies
-                diagonal(I) += 2 * (2*hamiltonian_parameters.get_g()(p,p,q,q) - hamiltonian_parameters.get_g()(p,q,q,p));
-            }  // q or e2 loop
-        } // p or e1 loop
+        // Diagonal contribution
+        row_entries.emplace_back(I, diagonal_engine.calculate(onv));
+
+        // Off-diagonal contributions: all pair excitations p->q, in which q is not occupied in I
+        this->fock_space.forEachOneElectronCoupling(onv, [] (size_t p, size_t q) { return p != q; }, [&] (size_t J, int /*sign*/, size_t p, size_t q) {
+
+            // Always use the integral with the largest orbital index first, so that the sparse Hamiltonian is symmetric
+            size_t r = std::max(p, q);
+            size_t s = std::min(p, q);
+            row_entries.emplace_back(J, hamiltonian_parameters.get_g()(r, s, r, s));  // a pair excitation has no sign
+        });
+
+        // Append the row to the CSR structure
+        std::sort(row_entries.begin(), row_entries.end());
+        sparse_matrix.startVec(I);
+        for (const auto& entry : row_entries) {
+            sparse_matrix.insertBack(I, entry.first) = entry.second;
+        }
 
         // Skip the last permutation
         if (I < dim-1) {
-            this->fock_space.setNext(onv);
+            this->fock_space.setNext(onv, I);
         }
-
     }  // address (I) loop
-    return diagonal;
-}
 
+    sparse_matrix.finalize();
+    return sparse_matrix;
+}
 
 
 }  // namespace GQCP
@@ -0,0 +1,160 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2018  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#include "HamiltonianBuilder/DiagonalEngine.hpp"
+
+
+namespace GQCP {
+
+
+/*
+ *  CONSTRUCTORS
+ */
+
+/**
+ *  @param one_electron_terms       the one-electron terms a_p
+ *  @param pair_terms               the pair terms b_pq, of which only the strict lower triangle (p>q) is used
+ */
+DiagonalEngine::DiagonalEngine(const Eigen::VectorXd& one_electron_terms, const Eigen::MatrixXd& pair_terms) :
+    one_electron_terms (one_electron_terms),
+    pair_terms (Eigen::MatrixXd::Zero(pair_terms.rows(), pair_terms.cols()))
+{
+    size_t K = static_cast<size_t>(one_electron_terms.size());
+    if ((static_cast<size_t>(pair_terms.rows()) != K) || (static_cast<size_t>(pair_terms.cols()) != K)) {
+        throw std::invalid_argument("The dimensions of the one-electron terms and the pair terms are incompatible.");
+    }
+
+    // Symmetrize the pair terms, so that the update formulas don't have to care about the order of the orbital indices
+    for (size_t p = 0; p < K; p++) {
+        for (size_t q = 0; q < p; q++) {
+            this->pair_terms(p,q) = pair_terms(p,q);
+            this->pair_terms(q,p) = pair_terms(p,q);
+        }
+    }
+}
+
+
+
+/*
+ *  SETTERS
+ */
+
+/**
+ *  @param one_electron_terms       the new one-electron terms a_p
+ *
+ *  Replace the one-electron terms, after which the next element is calculated from scratch
+ */
+void DiagonalEngine::set_one_electron_terms(const Eigen::VectorXd& one_electron_terms) {
+
+    if (one_electron_terms.size() != this->one_electron_terms.size()) {
+        throw std::invalid_argument("The dimensions of the given one-electron terms are incompatible.");
+    }
+
+    this->one_electron_terms = one_electron_terms;
+    this->reset();
+}
+
+
+
+/*
+ *  PUBLIC METHODS
+ */
+
+/**
+ *  @param unsigned_representation      the representation of an ONV
+ *
+ *  @return the diagonal element E(S), calculated from scratch
+ */
+double DiagonalEngine::calculateFull(size_t unsigned_representation) const {
+
+    double value = 0.0;
+    while (unsigned_representation != 0) {  // we will remove the least significant bit each loop
+        size_t p = __builtin_ctzl(unsigned_representation);
+        unsigned_representation ^= unsigned_representation & -unsigned_representation;  // flip the least significant bit
+
+        value += this->one_electron_terms(p);
+
+        size_t others = unsigned_representation;  // the occupied orbitals q > p
+        while (others != 0) {
+            size_t q = __builtin_ctzl(others);
+            others ^= others & -others;
+
+            value += this->pair_terms(p,q);
+        }
+    }
+
+    return value;
+}
+
+
+/**
+ *  @param onv      the ONV
+ *
+ *  @return the diagonal element E(S), updated from the previous ONV if there is one
+ */
+double DiagonalEngine::calculate(const ONV& onv) {
+
+    size_t representation = onv.get_unsigned_representation();
+
+    if (!this->has_previous) {
+        this->previous_value = this->calculateFull(representation);
+
+    } else {
+
+        size_t current = this->previous_representation;
+        size_t annihilated = current & ~representation;  // the orbitals that are no longer occupied
+        size_t created = representation & ~current;  // the orbitals that have become occupied
+
+        // Remove the annihilated orbitals one by one: their contribution is a_p + sum_{q in S, q != p} b_pq
+        while (annihilated != 0) {
+            size_t p = __builtin_ctzl(annihilated);
+            annihilated ^= annihilated & -annihilated;
+            current ^= (1UL << p);
+
+            this->previous_value -= this->one_electron_terms(p);
+            size_t occupied = current;
+            while (occupied != 0) {
+                size_t q = __builtin_ctzl(occupied);
+                occupied ^= occupied & -occupied;
+                this->previous_value -= this->pair_terms(p,q);
+            }
+        }
+
+        // Add the created orbitals one by one
+        while (created != 0) {
+            size_t p = __builtin_ctzl(created);
+            created ^= created & -created;
+
+            this->previous_value += this->one_electron_terms(p);
+            size_t occupied = current;
+            while (occupied != 0) {
+                size_t q = __builtin_ctzl(occupied);
+                occupied ^= occupied & -occupied;
+                this->previous_value += this->pair_terms(p,q);
+            }
+
+            current ^= (1UL << p);
+        }
+    }
+
+    this->has_previous = true;
+    this->previous_representation = representation;
+    return this->previous_value;
+}
+
+
+}  // namespace GQCP
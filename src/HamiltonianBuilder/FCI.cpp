@@ -17,6 +17,10 @@
 // 
 #include "HamiltonianBuilder/FCI.hpp"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 
 namespace GQCP {
 
@@ -74,12 +78,12 @@ Eigen::MatrixXd FCI::constructHamiltonian(const HamiltonianParameters& hamiltoni
         for (size_t p = 0; p < K; p++) {  // p loops over SOs
             int sign_p = 1;  // sign for the annihilation operator (a_p)
 
-            if (spin_string_alpha.annihilate(p, sign_p)) {
+            if (spin_string_alpha.annihilate_unchecked(p, sign_p)) {
                 for (size_t q = 0; q < K; q++) {  // q loops over SOs
 
                     // one-electron contributions for alpha, i.e. one electron excitation
                     int sign_pq = sign_p;  // sign for the total excitation operator (a^\dagger_q a_p)
-                    if (spin_string_alpha.create(q, sign_pq)) {
+                    if (spin_string_alpha.create_unchecked(q, sign_pq)) {
 
                         size_t J_alpha = fock_space_alpha.getAddress(spin_string_alpha);
 
@@ -95,7 +99,7 @@ Eigen::MatrixXd FCI::constructHamiltonian(const HamiltonianParameters& hamiltoni
                         // We will store it, since these strings are also needed in the alpha-beta part
                         this->alpha_one_electron_couplings[I_alpha][coupling_address_index] = OneElectronCoupling{sign_pq, p, q, J_alpha};
                         coupling_address_index++;
-                        spin_string_alpha.annihilate(q);  // undo the previous creation on q
+                        spin_string_alpha.annihilate_unchecked(q);  // undo the previous creation on q
                     }  // create on q (alpha)
 
 
@@ -103,16 +107,16 @@ Eigen::MatrixXd FCI::constructHamiltonian(const HamiltonianParameters& hamiltoni
                     sign_pq = sign_p;  // sign for the total excitation operator (a^\dagger_q a_p)
                     // we have to reset this because we changed this in the previous if-statement
 
-                    if (spin_string_alpha.annihilate(q, sign_pq)) {
+                    if (spin_string_alpha.annihilate_unchecked(q, sign_pq)) {
 
                         for (size_t r = 0; r < K; r++) {
                             int sign_pqr = sign_pq;  // sign for total operator (a^\dagger_r a_q a_p)
 
-                            if (spin_string_alpha.create(r, sign_pqr)) {
+                            if (spin_string_alpha.create_unchecked(r, sign_pqr)) {
                                 for (size_t s = 0; s < K; s++) {
 
                                     int sign_pqrs = sign_pqr;  // sign for total operator (a^dagger_s a^\dagger_r a_q a_p)
-                                    if (spin_string_alpha.create(s, sign_pqrs)) {
+                                    if (spin_string_alpha.create_unchecked(s, sign_pqrs)) {
 
                                         size_t Ja = fock_space_alpha.getAddress(spin_string_alpha);
 
@@ -125,25 +129,25 @@ Eigen::MatrixXd FCI::constructHamiltonian(const HamiltonianParameters& hamiltoni
                                             result_matrix(I_alpha * dim_beta + Ib, Ja * dim_beta + Ib) += value;
                                         }
 
-                                        spin_string_alpha.annihilate(s);  // undo the previous creation on s
+                                        spin_string_alpha.annihilate_unchecked(s);  // undo the previous creation on s
                                     }  // create on s (alpha)
                                 }  // loop over s
 
-                                spin_string_alpha.annihilate(r);  // undo the previous creation on r
+                                spin_string_alpha.annihilate_unchecked(r);  // undo the previous creation on r
                             }  // create on r (alpha)
                         }  // loop over r
 
-                        spin_string_alpha.create(q);  // undo the previous annihilation on q
+                        spin_string_alpha.create_unchecked(q);  // undo the previous annihilation on q
                     }  // annihilate on q (alpha)
                 }  // loop over q
 
-                spin_string_alpha.create(p);  // undo the previous annihilation on p
+                spin_string_alpha.create_unchecked(p);  // undo the previous annihilation on p
             }  // annihilate p (alpha)
         }  // loop over p
 
 
         if (I_alpha < dim_alpha - 1) {  // prevent the last permutation to occur
-            fock_space_alpha.setNext(spin_string_alpha);
+            fock_space_alpha.setNext(spin_string_alpha, I_alpha);
         }
     }  // loop over alpha addresses (I_alpha)
 
@@ -159,12 +163,12 @@ Eigen::MatrixXd FCI::constructHamiltonian(const HamiltonianParameters& hamiltoni
         for (size_t p = 0; p < K; p++) {  // p loops over SOs
             int sign_p = 1;
 
-            if (spin_string_beta.annihilate(p, sign_p)) {
+            if (spin_string_beta.annihilate_unchecked(p, sign_p)) {
                 for (size_t q = 0; q < K; q++) {  // q loops over SOs
 
                     // one-electron contributions for beta, i.e. one electron excitation
                     int sign_pq = sign_p;  // sign for the total excitation operator (a^\dagger_q a_p)
-                    if (spin_string_beta.create(q, sign_pq)) {
+                    if (spin_string_beta.create_unchecked(q, sign_pq)) {
 
                         size_t J_beta = fock_space_beta.getAddress(spin_string_beta);
 
@@ -181,7 +185,7 @@ Eigen::MatrixXd FCI::constructHamiltonian(const HamiltonianParameters& hamiltoni
                         // We will store it, since these strings are also needed in the alpha-beta part
                         this->beta_one_electron_couplings[I_beta][coupling_address_index] = OneElectronCoupling{sign_pq, p, q, J_beta};
                         coupling_address_index++;
-                        spin_string_beta.annihilate(q);  // undo the previous creation on q
+                        spin_string_beta.annihilate_unchecked(q);  // undo the previous creation on q
                     }  // create on q (beta)
 
 
@@ -189,16 +193,16 @@ Eigen::MatrixXd FCI::constructHamiltonian(const HamiltonianParameters& hamiltoni
                     sign_pq = sign_p;  // sign for the total excitation operator (a^\dagger_q a_p)
                     // we have to reset this because we changed this in the previous if-statement
 
-                    if (spin_string_beta.annihilate(q, sign_pq)) {
+                    if (spin_string_beta.annihilate_unchecked(q, sign_pq)) {
 
                         for (size_t r = 0; r < K; r++) {  // r loops over SOs
                             int sign_pqr = sign_pq;  // sign for total operator (a^\dagger_r a_q a_p)
 
-                            if (spin_string_beta.create(r, sign_pqr)) {
+                            if (spin_string_beta.create_unchecked(r, sign_pqr)) {
                                 for (size_t s = 0; s < K; s++) {  // s loops over SOs
 
                                     int sign_pqrs = sign_pqr;  // sign for total operator (a^dagger_s a^\dagger_r a_q a_p)
-                                    if (spin_string_beta.create(s, sign_pqrs)) {
+                                    if (spin_string_beta.create_unchecked(s, sign_pqrs)) {
 
                                         size_t Jb = fock_space_beta.getAddress(spin_string_beta);
 
@@ -211,24 +215,24 @@ Eigen::MatrixXd FCI::constructHamiltonian(const HamiltonianParameters& hamiltoni
                                             result_matrix(Ia * dim_beta + I_beta, Ia * dim_beta + Jb) += value;
                                         }
 
-                                        spin_string_beta.annihilate(s);  // undo the previous creation on s
+                                        spin_string_beta.annihilate_unchecked(s);  // undo the previous creation on s
                                     }  // create on s (beta)
                                 }  // loop over s
 
-                                spin_string_beta.annihilate(r);  // undo the previous creation on r
+                                spin_string_beta.annihilate_unchecked(r);  // undo the previous creation on r
                             }  // create on r (beta)
                         }  // loop over r
 
-                        spin_string_beta.create(q);  // undo the previous annihilation on q
+                        spin_string_beta.create_unchecked(q);  // undo the previous annihilation on q
                     }  // annihilate on q (beta)
                 }  // loop over q
 
-                spin_string_beta.create(p);  // undo the previous annihilation on p
+                spin_string_beta.create_unchecked(p);  // undo the previous annihilation on p
             } // annihilate on p (beta)
         }  // loop over p
 
         if (I_beta < dim_beta - 1) {  // prevent last permutation to occur
-            fock_space_beta.setNext(spin_string_beta);
+            fock_space_beta.setNext(spin_string_beta, I_beta);
         }
     }  // loop over beta addresses (I_beta)
 
@@ -265,231 +269,11 @@ Eigen::VectorXd FCI::matrixVectorProduct(const HamiltonianParameters& hamiltonia
         throw std::invalid_argument("Basis functions of the Fock space and hamiltonian_parameters are incompatible.");
     }
 
-    FockSpace fock_space_alpha = fock_space.get_fock_space_alpha();
-    FockSpace fock_space_beta = fock_space.get_fock_space_beta();
-
-    auto dim_alpha = fock_space_alpha.get_dimension();
-    auto dim_beta = fock_space_beta.get_dimension();
-    auto dim = fock_space.get_dimension();
-
     // TODO: use diagonal
-    Eigen::VectorXd matvec =  Eigen::VectorXd::Zero(dim);
-
-    // Calculate the effective one-electron integrals
-    // TODO: move this to libwint
-    Eigen::MatrixXd k_SO = hamiltonian_parameters.get_h().get_matrix_representation();
-    for (size_t p = 0; p < K; p++) {
-        for (size_t q = 0; q < K; q++) {
-            for (size_t r = 0; r < K; r++) {
-                k_SO(p,q) -= 0.5 * hamiltonian_parameters.get_g()(p, r, r, q);
-            }
-        }
-    }
-
-
-    // ALPHA-ALPHA
-    ONV spin_string_alpha_aa = fock_space_alpha.get_ONV(0);  // spin string with address 0
-    for (size_t I_alpha = 0; I_alpha < dim_alpha; I_alpha++) {  // I_alpha loops over all the addresses of the alpha spin strings
-        if (I_alpha > 0) {
-            fock_space_alpha.setNext(spin_string_alpha_aa);
-        }
-
-        for (size_t p = 0; p < K; p++) {  // p loops over SOs
-            int sign_p = 1;  // sign of the operator a_p_alpha
-            if (spin_string_alpha_aa.annihilate(p, sign_p)) {  // if p is in I_alpha
-
-                for (size_t q = 0; q < K; q++) {  // q loops over SOs
-                    int sign_pq = sign_p;  // sign of the operator a^dagger_q_alpha a_p_alpha
-                    if (spin_string_alpha_aa.create(q, sign_pq)) {  // if q is not occupied in I_alpha
-                        size_t J_alpha = fock_space_alpha.getAddress(spin_string_alpha_aa); // find all strings J_alpha that couple to I_alpha
-
-                        for (size_t I_beta = 0; I_beta < dim_beta; I_beta++) {  // I_beta loops over all addresses of the beta spin strings
-                            matvec(I_alpha*dim_beta + I_beta) += k_SO(p,q) * sign_pq * x(J_alpha*dim_beta + I_beta);  // alpha addresses are major
-                        }
-
-                        spin_string_alpha_aa.annihilate(q);  // undo the previous creation
-                    }
-                }  // q loop
-
-                spin_string_alpha_aa.create(p);  // undo the previous annihilation
-            }
-        }  // p loop
-    }  // I_alpha loop
-
-
-    // BETA-BETA
-    ONV spin_string_beta_bb = fock_space_beta.get_ONV(0);  // spin string with address 0
-    for (size_t I_beta = 0; I_beta < dim_beta; I_beta++) {  // I_beta loops over all the addresses of the beta spin strings
-        if (I_beta > 0) {
-            fock_space_beta.setNext(spin_string_beta_bb);
-        }
-
-        for (size_t p = 0; p < K; p++) {  // p loops over SOs
-            int sign_p = 1;  // sign of the operator a_p_beta
-            if (spin_string_beta_bb.annihilate(p, sign_p)) {  // if p is in I_beta
-
-                for (size_t q = 0; q < K; q++) {  // q loops over SOs
-                    int sign_pq = sign_p;  // sign of the operator a^dagger_q_beta a_p_beta
-                    if (spin_string_beta_bb.create(q, sign_pq)) {  // if q is not occupied in I_beta
-                        size_t J_beta = fock_space_beta.getAddress(spin_string_beta_bb);  // find all strings J_beta that couple to I_beta
-
-                        for (size_t I_alpha = 0; I_alpha < dim_alpha; I_alpha++) {  // I_alpha loops over all addresses of the alpha spin strings
-                            matvec(I_alpha*dim_beta + I_beta) += k_SO(p,q) * sign_pq * x(I_alpha*dim_beta + J_beta);  // alpha addresses are major
-                        }
-
-                        spin_string_beta_bb.annihilate(q);  // undo the previous creation
-                    }
-                }  // q loop
-
-                spin_string_beta_bb.create(p);  // undo the previous annihilation
-            }
-        }  // p loop
-    }  // I_beta loop
-
-    // ALPHA-ALPHA-ALPHA-ALPHA
-    ONV spin_string_alpha_aaaa = fock_space_alpha.get_ONV(0);  // spin string with address 0
-    for (size_t I_alpha = 0; I_alpha < dim_alpha; I_alpha++) {  // I_alpha loops over all addresses of alpha spin strings
-        if (I_alpha > 0) {
-            fock_space_alpha.setNext(spin_string_alpha_aaaa);
-        }
-
-        for (size_t p = 0; p < K; p++) {  // p loops over SOs
-            int sign_p = 1;  // sign of the operator a_p_alpha
-            if (spin_string_alpha_aaaa.annihilate(p, sign_p)) {
-
-                for (size_t q = 0; q < K; q++) {  // q loops over SOs
-                    int sign_pq = sign_p;  // sign of the operator a^dagger_q_alpha a_p_alpha
-                    if (spin_string_alpha_aaaa.create(q, sign_pq)) {
-
-                        for (size_t r = 0; r < K; r++) {  // r loops over SOs
-                            int sign_pqr = sign_pq;  // sign of the operator a_r_alpha a^dagger_q_alpha a_p_alpha
-                            if (spin_string_alpha_aaaa.annihilate(r, sign_pqr)) {
-
-                                for (size_t s = 0; s < K; s++) {  // s loops over SOs
-                                    int sign_pqrs = sign_pqr;  // sign of the operator a^dagger_s_alpha a_r_alpha a^dagger_q_alpha a_p_alpha
-                                    if (spin_string_alpha_aaaa.create(s, sign_pqrs)) {
-                                        size_t J_alpha = fock_space_alpha.getAddress(spin_string_alpha_aaaa);  // the address of the string J_alpha that couples to I_alpha
-
-                                        for (size_t I_beta = 0; I_beta < dim_beta; I_beta++) {  // I_beta loops over all beta addresses
-                                            matvec(I_alpha*dim_beta + I_beta) += 0.5 * hamiltonian_parameters.get_g()(p, q, r, s) * sign_pqrs * x(J_alpha*dim_beta + I_beta);
-                                        }
-
-                                        spin_string_alpha_aaaa.annihilate(s);  // undo the previous creation
-                                    }
-                                }  // loop over s
-
-                                spin_string_alpha_aaaa.create(r);  // undo the previous annihilation
-                            }
-                        }  // loop over r
-
-                        spin_string_alpha_aaaa.annihilate(q);  // undo the previous creation
-                    }
-                }  // loop over q
-
-                spin_string_alpha_aaaa.create(p);  // undo the previous creation
-            }
-        }  // loop over p
-    }  // loop over I_alpha
-
-
-    // ALPHA-ALPHA-BETA-BETA (and BETA-BETA-ALPHA-ALPHA)
-    ONV spin_string_alpha_aabb = fock_space_alpha.get_ONV(0);  // spin string with address 0
-    for (size_t I_alpha = 0; I_alpha < dim_alpha; I_alpha++) {  // I_alpha loops over all addresses of alpha spin strings
-        if (I_alpha > 0) {
-            fock_space_alpha.setNext(spin_string_alpha_aabb);
-        }
-
-        for (size_t p = 0; p < K; p++) {  // p loops over SOs
-            int sign_p = 1;  // sign of the operator a_p_alpha
-            if (spin_string_alpha_aabb.annihilate(p, sign_p)) {
-
-                for (size_t q = 0; q < K; q++) {
-                    int sign_pq = sign_p;  // sign of the operator a^dagger_q_alpha a_p_alpha
-                    if (spin_string_alpha_aabb.create(q, sign_pq)) {
-                        size_t J_alpha = fock_space_alpha.getAddress(spin_string_alpha_aabb);  // the address of the spin string that couples to I_alpha
-
-                        ONV spin_string_beta_aabb = fock_space_beta.get_ONV (0); // spin string with address 0
-                        for (size_t I_beta = 0; I_beta < dim_beta; I_beta++) {  // I_beta loops over all addresses of beta spin strings
-                            if (I_beta > 0) {
-                                fock_space_beta.setNext(spin_string_beta_aabb);
-                            }
-
-                            for (size_t r = 0; r < K; r++) {  // r loops over SOs
-                                int sign_r = 1;  // sign of the operator a_r_beta
-                                if (spin_string_beta_aabb.annihilate(r, sign_r)) {
-
-                                    for (size_t s = 0; s < K; s++) {  // s loops over SOs
-                                        int sign_rs = sign_r;  // sign of the operato a^dagger_s_beta a_r_beta
-                                        if (spin_string_beta_aabb.create(s, sign_rs)) {
-                                            size_t J_beta = fock_space_beta.getAddress(spin_string_beta_aabb);  // the address of the spin string that couples to I_beta
-
-                                            matvec(I_alpha*dim_beta + I_beta) += hamiltonian_parameters.get_g()(p, q, r, s) * sign_pq * sign_rs * x(J_alpha*dim_beta + J_beta);  // alpha addresses are major
-
-                                            spin_string_beta_aabb.annihilate(s);  // undo the previous creation
-                                        }
-                                    }  // loop over r
-
-                                    spin_string_beta_aabb.create(r);  // undo the previous annihilation
-                                }
-                            }  // loop over r
-
-
-                        }  // I_beta loop
-
-                        spin_string_alpha_aabb.annihilate(q);  // undo the previous creation
-                    }
-                }  // loop over q
-
-                spin_string_alpha_aabb.create(p);  // undo the previous annihilation
-            }
-        }  // loop over p
-    }  // loop over I_alpha
-
-
-    // BETA-BETA-BETA-BETA
-    ONV spin_string_beta_bbbb = fock_space_beta.get_ONV(0);  // spin string with address 0
-    for (size_t I_beta = 0; I_beta < dim_beta; I_beta++) {  // I_beta loops over all addresses of beta spin strings
-        if (I_beta > 0) {
-            fock_space_beta.setNext(spin_string_beta_bbbb);
-        }
-
-        for (size_t p = 0; p < K; p++) {  // p loops over SOs
-            int sign_p = 1;  // sign of the operator a_p_beta
-            if (spin_string_beta_bbbb.annihilate(p, sign_p)) {
-
-                for (size_t q = 0; q < K; q++) {  // q loops over SOs
-                    int sign_pq = sign_p;  // sign of the operator a^dagger_q_beta a_p_beta
-                    if (spin_string_beta_bbbb.create(q, sign_pq)) {
-
-                        for (size_t r = 0; r < K; r++) {  // r loops over SOs
-                            int sign_pqr = sign_pq;  // sign of the operator a_r_beta a^dagger_q_beta a_p_beta
-                            if (spin_string_beta_bbbb.annihilate(r, sign_pqr)) {
-
-                                for (size_t s = 0; s < K; s++) {  // s loops over SOs
-                                    int sign_pqrs = sign_pqr;  // sign of the operator a^dagger_s_beta a_r_beta a^dagger_q_beta a_p_beta
-                                    if (spin_string_beta_bbbb.create(s, sign_pqrs)) {
-                                        size_t J_beta = fock_space_beta.getAddress(spin_string_beta_bbbb);  // the address of the string J_beta that couples to I_beta
-
-                                        for (size_t I_alpha = 0; I_alpha < dim_alpha; I_alpha++) {  // I_beta loops over all beta addresses
-                                            matvec(I_alpha*dim_beta + I_beta) += 0.5 * hamiltonian_parameters.get_g()(p,q,r,s) * sign_pqrs * x(I_alpha*dim_beta + J_beta);
-                                        }
-
-                                        spin_string_beta_bbbb.annihilate(s);  // undo the previous creation
-                                    }
-                                }  // loop over s
-
-                                spin_string_beta_bbbb.create(r);  // undo the previous annihilation
-                            }
-                        }  // loop over r
-
-                        spin_string_beta_bbbb.annihilate(q);  // undo the previous creation
-                    }
-                }  // loop over q
-
-                spin_string_beta_bbbb.create(p);  // undo the previous creation
-            }
-        }  // loop over p
-    }  // loop over I_beta
+    Eigen::VectorXd matvec = Eigen::VectorXd::Zero(this->fock_space.get_dimension());
+    this->forEachContribution(hamiltonian_parameters, [&] (size_t I, size_t J, double value) {
+        matvec(I) += value * x(J);
+    });
 
     return matvec;
 }
@@ -499,6 +283,8 @@ Eigen::VectorXd FCI::matrixVectorProduct(const HamiltonianParameters& hamiltonia
  *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
  *
  *  @return the diagonal of the matrix representation of the Hamiltonian
+ *
+ *  The addresses are split over the available (OpenMP) threads, and the diagonal elements are updated incrementally (using a DiagonalEngine) while the alpha and beta spin strings are enumerated
  */
 Eigen::VectorXd FCI::calculateDiagonal(const HamiltonianParameters& hamiltonian_parameters) {
 
@@ -511,75 +297,94 @@ Eigen::VectorXd FCI::calculateDiagonal(const HamiltonianParameters& hamiltonian_
     FockSpace fock_space_beta = fock_space.get_fock_space_beta();
 
     auto dim_alpha = fock_space_alpha.get_dimension();
-    auto dim_beta = fock_space_beta.get_dimension();
     auto dim = fock_space.get_dimension();
 
     // Diagonal contributions
     Eigen::VectorXd diagonal =  Eigen::VectorXd::Zero(dim);
 
-    // Calculate the effective one-electron integrals
-    // TODO: move this to libwint
-    Eigen::MatrixXd k_SO = hamiltonian_parameters.get_h().get_matrix_representation();
+    // The diagonal element for (Ia, Ib) is E(Ia) + E(Ib) + sum_{p in Ia} sum_{q in Ib} g_ppqq, in which the spin string energies are given by
+    //      E(S) = sum_{p in S} h_pp + sum_{p>q in S} 1/2 (g_ppqq + g_qqpp - g_pqqp - g_qppq)
+    Eigen::VectorXd one_electron_terms (K);
+    Eigen::MatrixXd pair_terms = Eigen::MatrixXd::Zero(K, K);
     for (size_t p = 0; p < K; p++) {
-        for (size_t q = 0; q < K; q++) {
-            for (size_t r = 0; r < K; r++) {
-                k_SO(p,q) -= 0.5 * hamiltonian_parameters.get_g()(p, r, r, q);
-            }
+        one_electron_terms(p) = hamiltonian_parameters.get_h()(p,p);
+
+        for (size_t q = 0; q < p; q++) {
+            pair_terms(p,q) = 0.5 * (hamiltonian_parameters.get_g()(p,p,q,q) + hamiltonian_parameters.get_g()(q,q,p,p) - hamiltonian_parameters.get_g()(p,q,q,p) - hamiltonian_parameters.get_g()(q,p,p,q));
         }
     }
 
-    ONV spin_string_alpha = fock_space_alpha.get_ONV(0);
-    for (size_t Ia = 0; Ia < dim_alpha; Ia++) {  // Ia loops over addresses of alpha spin strings
+    // Every thread calculates the diagonal for a contiguous range of addresses: successive spin strings are handled by updating the energy of the previous one
+    #pragma omp parallel
+    {
+        size_t number_of_threads = 1;
+        size_t thread_index = 0;
+        #ifdef _OPENMP
+        number_of_threads = omp_get_num_threads();
+        thread_index = omp_get_thread_num();
+        #endif
 
-        ONV spin_string_beta = fock_space_beta.get_ONV(0);
-        for (size_t Ib = 0; Ib < dim_beta; Ib++) {  // Ib loops over addresses of beta spin strings
+        ProductFockSpaceIterator iterator (this->fock_space, partitionAddresses(dim, number_of_threads)[thread_index]);  // positioned at the first pair of spin strings of this thread's range
 
-            for (size_t p = 0; p < K; p++) {  // p loops over SOs
+        DiagonalEngine alpha_engine (one_electron_terms, pair_terms);
+        DiagonalEngine beta_engine (one_electron_terms, pair_terms);
 
-                if (spin_string_alpha.isOccupied(p)) {  // p is in Ia
-                    diagonal(Ia * dim_beta + Ib) += k_SO(p, p);
+        double alpha_value = 0.0;
+        size_t current_Ia = dim_alpha;  // the alpha address for which alpha_value and the beta one-electron terms have been calculated (none at the start)
 
-                    for (size_t q = 0; q < K; q++) {  // q loops over SOs
-                        if (spin_string_alpha.isOccupied(q)) {  // q is in Ia
-                            diagonal(Ia * dim_beta + Ib) += 0.5 * hamiltonian_parameters.get_g()(p, p, q, q);
-                        } else {  // q is not in I_alpha
-                            diagonal(Ia * dim_beta + Ib) += 0.5 * hamiltonian_parameters.get_g()(p, q, q, p);
-                        }
+        for (; !iterator.isFinished(); iterator.increment()) {  // loops over this thread's addresses (Ia, Ib)
 
-                        if (spin_string_beta.isOccupied(q)) {  // q is in Ib
-                            diagonal(Ia * dim_beta + Ib) += hamiltonian_parameters.get_g()(p, p, q, q);
-                        }
-                    }  // q loop
+            if (iterator.get_address_alpha() != current_Ia) {  // a new alpha spin string
+                const ONV& spin_string_alpha = iterator.get_ONV_alpha();
+                alpha_value = alpha_engine.calculate(spin_string_alpha);
+
+                // The alpha-beta contributions are absorbed into the one-electron terms of the beta spin strings
+                Eigen::VectorXd beta_one_electron_terms = one_electron_terms;
+                for (size_t e1 = 0; e1 < fock_space_alpha.get_N(); e1++) {  // e1 (electron 1) loops over the (number of) alpha electrons
+                    size_t p = spin_string_alpha.get_occupied_index(e1);
+                    for (size_t q = 0; q < K; q++) {  // q loops over SOs
+                        beta_one_electron_terms(q) += hamiltonian_parameters.get_g()(p, p, q, q);
+                    }
                 }
+                beta_engine.set_one_electron_terms(beta_one_electron_terms);
 
+                current_Ia = iterator.get_address_alpha();
+            }
 
-                if (spin_string_beta.isOccupied(p)) {  // p is in Ib
-                    diagonal(Ia * dim_beta + Ib) += k_SO(p, p);
+            diagonal(iterator.get_address()) = alpha_value + beta_engine.calculate(iterator.get_ONV_beta());
+        }  // address loop
+    }  // parallel region
 
+    return diagonal;
+}
 
-                    for (size_t q = 0; q < K; q++) {  // q loops over SOs
-                        if (spin_string_beta.isOccupied(q)) {  // q is in Ib
-                            diagonal(Ia * dim_beta + Ib) += 0.5 * hamiltonian_parameters.get_g()(p, p, q, q);
 
-                        } else {  // q is not in I_beta
-                            diagonal(Ia * dim_beta + Ib) += 0.5 * hamiltonian_parameters.get_g()(p, q, q, p);
-                        }
-                    }  // q loop
-                }
+/**
+ *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+ *  @param X                            the vectors (as columns) upon which the FCI Hamiltonian acts
+ *  @param diagonal                     the diagonal of the FCI Hamiltonian matrix
+ *
+ *  @return the action of the FCI Hamiltonian on every column of X
+ *
+ *  The string couplings are enumerated only once for the whole block, and every contribution acts on a (contiguous) row of X, read through its transpose
+ */
+Eigen::MatrixXd FCI::blockMatrixVectorProduct(const HamiltonianParameters& hamiltonian_parameters, const Eigen::MatrixXd& X, const Eigen::VectorXd& diagonal) {
 
-            }  // p loop
+    auto K = hamiltonian_parameters.get_h().get_dim();
+    if (K != this->fock_space.get_K()) {
+        throw std::invalid_argument("Basis functions of the Fock space and hamiltonian_parameters are incompatible.");
+    }
 
-            if (Ib < dim_beta - 1) {  // prevent last permutation to occur
-                fock_space_beta.setNext(spin_string_beta);
-            }
-        }  // beta address (Ib) loop
+    // The rows of X (and of the block matrix-vector product) are strided in column-major storage, so we work with the transposes: every row is then a contiguous column
+    Eigen::MatrixXd X_transpose = X.transpose();
+    Eigen::MatrixXd block_matvec_transpose = Eigen::MatrixXd::Zero(X.cols(), X.rows());
 
-        if (Ia < dim_alpha - 1) {  // prevent last permutation to occur
-            fock_space_alpha.setNext(spin_string_alpha);
-        }
-    }  // alpha address (Ia) loop
+    // TODO: use diagonal
+    this->forEachContribution(hamiltonian_parameters, [&] (size_t I, size_t J, double value) {
+        block_matvec_transpose.col(I).noalias() += value * X_transpose.col(J);
+    });
 
-    return diagonal;
+    return block_matvec_transpose.transpose();
 }
 
 
@@ -32,4 +32,29 @@ HamiltonianBuilder::~HamiltonianBuilder() {}
 
 
 
+/*
+ *  PUBLIC METHODS
+ */
+
+/**
+ *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+ *  @param X                            the vectors (as columns) upon which the Hamiltonian acts
+ *  @param diagonal                     the diagonal of the Hamiltonian matrix
+ *
+ *  @return the action of the Hamiltonian on every column of X
+ *
+ *  By default, the matrix-vector products are calculated one by one. Derived classes can override this to evaluate every Hamiltonian matrix element only once for the whole block.
+ */
+Eigen::MatrixXd HamiltonianBuilder::blockMatrixVectorProduct(const HamiltonianParameters& hamiltonian_parameters, const Eigen::MatrixXd& X, const Eigen::VectorXd& diagonal) {
+
+    Eigen::MatrixXd block_matvec (X.rows(), X.cols());
+    for (Eigen::Index column = 0; column < X.cols(); column++) {
+        block_matvec.col(column) = this->matrixVectorProduct(hamiltonian_parameters, X.col(column), diagonal);
+    }
+
+    return block_matvec;
+}
+
+
+
 }  // namespace GQCP
@@ -20,114 +20,6 @@
 
 namespace GQCP {
 
-/*
- *  PRIVATE METHODS
- */
-
-/**
- *  Evaluate the one-electron operators for alpha or beta and store the result in a matrix-vector product or a matrix, depending on the method passed
- *
- *  @param fock_space_target        the Fock space that is used as a target, i.e. that is evaluated
- *  @param fock_space_fixed         the Fock space that is not evaluated
- *  @param target_is_major          whether or not the evaluated component is the major index
- *  @param hamiltonian_parameters   the Hubbard Hamiltonian parameters
- *  @param method                   the used method: constructHamiltonian() or matrixVectorProduct()
- */
-void Hubbard::oneOperatorModule(FockSpace& fock_space_target, FockSpace& fock_space_fixed, bool target_is_major, const HamiltonianParameters& hamiltonian_parameters, const PassToMethod& method) {
-
-    size_t K = fock_space_target.get_K();
-    size_t N = fock_space_target.get_N();
-    size_t dim = fock_space_target.get_dimension();
-    size_t dim_fixed = fock_space_fixed.get_dimension();
-
-    size_t fixed_intervals;
-    size_t target_interval;
-
-    // If the target is major, then the interval for the non-target (or fixed component) is 1
-    // while the the target (major) intervals after each fixed (minor) iteration, thus at the dimension of the fixed component.
-    if (target_is_major) {
-        fixed_intervals = 1;
-        target_interval = dim_fixed;
-
-    // vice versa, if the target is not major, its own interval is 1,
-    // and the fixed component intervals at the targets dimension.
-    } else {
-        fixed_intervals = dim;
-        target_interval = 1;
-    }
-
-    ONV onv = fock_space_target.get_ONV(0);  // onv with address 0
-    for (size_t I = 0; I < dim; I++) {  // I loops over all the addresses of the onv
-        for (size_t e1 = 0; e1 < N; e1++) {  // e1 (electron 1) loops over the (number of) electrons
-            size_t p = onv.get_occupied_index(e1);  // retrieve the index of a given electron
-
-            // remove the weight from the initial address I, because we annihilate
-            size_t address = I - fock_space_target.get_vertex_weights(p, e1 + 1);
-            // The e2 iteration counts the amount of encountered electrons for the creation operator
-            // We only consider greater addresses than the initial one (because of symmetry)
-            // Hence we are only required to start counting from the annihilated electron (e1)
-            size_t e2 = e1;
-
-            // Starting from e2, the sign is always 1
-            // Because the initial sign of the annihilation will also be evaluated for the creation
-            // 1*1 or -1*-1 is always 1.
-            int sign_e2 = 1;
-
-            // Test whether next orbital is occupied, until we reach unoccupied orbital
-            while (e2 < N - 1 && onv.get_occupied_index(e2 + 1) - onv.get_occupied_index(e2) == 1) {
-                // Shift the address for the electrons encountered after the annihilation but before the creation
-                // Their currents weights are no longer correct, the corresponding weights can be calculated
-                // initial weight can be found in the addressing scheme, on the index of the orbital (row) and electron count (column)
-                // since e2 starts at the annihilated position, the first shifted electron is at e2's position + 1, (given the while loop condition this is also (e2+1)'s position)
-                // The nature of the addressing scheme requires us the add 1 to the electron count (because we start with the 0'th electron
-                // And for the initial weight we are at an extra electron (before the annihilation) hence the difference in weight is:
-                // the new weight at (e2+1) position (row) and e2+1 (column) - the old weight at  (e2+1) position (row) and e2+2 (column)
-                address += fock_space_target.get_vertex_weights(onv.get_occupied_index(e2) + 1, e2 + 1) - fock_space_target.get_vertex_weights(onv.get_occupied_index(e2) + 1, e2 + 2);
-                e2++;  // adding occupied orbitals to the electron count
-                sign_e2 *= -1;  // skipping over non-annihilated electrons will cause a phase change
-            }
-            size_t q = onv.get_occupied_index(e2) + 1;
-            e2++;
-            while (q < K) {
-                size_t J = address + fock_space_target.get_vertex_weights(q, e2);
-
-                // address has been calculated, update accordingly and at all instances of the fixed component
-                for (size_t I_fixed = 0; I_fixed < dim_fixed; I_fixed++){
-                    double val = sign_e2 * hamiltonian_parameters.get_h()(p, q);
-                    method(I * target_interval + I_fixed * fixed_intervals, J * target_interval + I_fixed * fixed_intervals, val);
-                    method(J * target_interval + I_fixed * fixed_intervals, I * target_interval + I_fixed * fixed_intervals, val);
-                }
-
-                // go to the next orbital
-                q++;
-
-                // if we encounter an occupied orbital, perform the shift, and test whether the following orbitals are occupied (or not)
-                // then proceed to set q to the next non-occupied orbital.
-                if (e2 < N && q == onv.get_occupied_index(e2)) {
-                    address += fock_space_target.get_vertex_weights(q, e2) - fock_space_target.get_vertex_weights(q, e2 + 1);
-                    sign_e2 *= -1;
-                    while (e2 < N - 1 && onv.get_occupied_index(e2 + 1) - onv.get_occupied_index(e2) == 1) {
-                        // see previous
-                        address += fock_space_target.get_vertex_weights(onv.get_occupied_index(e2) + 1, e2 + 1) - fock_space_target.get_vertex_weights(onv.get_occupied_index(e2) + 1, e2 + 2);
-                        e2++;
-                        sign_e2 *= -1;
-                    }
-                    q = onv.get_occupied_index(e2) + 1;
-                    e2++;
-                }
-            }  //  (creation)
-
-        } // e1 loop (annihilation)
-
-        // Prevent last permutation
-        if (I < dim - 1) {
-            fock_space_target.setNext(onv);
-        }
-    }
-
-}
-
-
 /*
  *  CONSTRUCTORS
  */
@@ -166,13 +58,16 @@ Eigen::MatrixXd Hubbard::constructHamiltonian(const HamiltonianParameters& hamil
     result_matrix += this->calculateDiagonal(hamiltonian_parameters).asDiagonal();
 
     // We pass to a matrix and create the corresponding lambda function
-    PassToMethod addToMatrix = [&result_matrix](size_t I, size_t J, double value) { result_matrix(I, J) += value; };
+    auto addToMatrix = [&result_matrix](size_t I, size_t J, double value) { result_matrix(I, J) += value; };
+
+    // Only the pairs of sites with a non-zero hopping have to be visited
+    auto hoppings = generateHoppingList(hamiltonian_parameters.get_h());
 
     // perform one electron evaluations, one for the alpha component and one for the beta component.
     // In our case alpha will be major and thus when alpha is the "target" (the operators evaluated)
     // the "target_is_major" will be set to true, when beta is the target it will be set to false
-    this->oneOperatorModule(fock_space_alpha, fock_space_beta, true, hamiltonian_parameters, addToMatrix);
-    this->oneOperatorModule(fock_space_beta, fock_space_alpha, false, hamiltonian_parameters, addToMatrix);
+    this->oneOperatorModule(fock_space_alpha, fock_space_beta, true, hoppings, addToMatrix);
+    this->oneOperatorModule(fock_space_beta, fock_space_alpha, false, hoppings, addToMatrix);
 
     return result_matrix;
 }
@@ -198,13 +93,16 @@ Eigen::VectorXd Hubbard::matrixVectorProduct(const HamiltonianParameters& hamilt
     Eigen::VectorXd matvec = diagonal.cwiseProduct(x);
 
     // We pass to a the matvec and create the corresponding lambda function
-    PassToMethod addToMatvec = [&matvec, &x](size_t I, size_t J, double value) { matvec(I) += value * x(J); };
+    auto addToMatvec = [&matvec, &x](size_t I, size_t J, double value) { matvec(I) += value * x(J); };
+
+    // Only the pairs of sites with a non-zero hopping have to be visited
+    auto hoppings = generateHoppingList(hamiltonian_parameters.get_h());
 
     // perform one electron evaluations, one for the alpha component and one for the beta component.
     // In our case alpha will be major and thus when alpha is the "target" (the operators evaluated)
     // the "target_is_major" will be set to true, when beta is the target it will be set to false
-    this->oneOperatorModule(fock_space_alpha, fock_space_beta, true, hamiltonian_parameters, addToMatvec);
-    this->oneOperatorModule(fock_space_beta, fock_space_alpha, false, hamiltonian_parameters, addToMatvec);
+    this->oneOperatorModule(fock_space_alpha, fock_space_beta, true, hoppings, addToMatvec);
+    this->oneOperatorModule(fock_space_beta, fock_space_alpha, false, hoppings, addToMatvec);
 
     return matvec;
 }
@@ -243,11 +141,11 @@ Eigen::VectorXd Hubbard::calculateDiagonal(const HamiltonianParameters &hamilton
                 diagonal(address) += hamiltonian_parameters.get_g()(p,p,p,p);
             }
             if (Ib < dim_beta - 1) {  // prevent last permutation to occur
-                fock_space_beta.setNext(onv_beta);
+                fock_space_beta.setNext(onv_beta, Ib);
             }
         }  // beta address (Ib) loop
         if (Ia < dim_alpha - 1) {  // prevent last permutation to occur
-            fock_space_alpha.setNext(onv_alpha);
+            fock_space_alpha.setNext(onv_alpha, Ia);
         }
     }  // alpha address (Ia) loop
     return diagonal;
@@ -255,6 +153,259 @@ Eigen::VectorXd Hubbard::calculateDiagonal(const HamiltonianParameters &hamilton
 }
 
 
+/**
+ *  @param hamiltonian_parameters       the Hubbard Hamiltonian parameters in an orthonormal orbital basis
+ *  @param X                            the block of vectors (as columns) upon which the Hubbard Hamiltonian acts
+ *  @param diagonal                     the diagonal of the Hubbard Hamiltonian matrix
+ *
+ *  @return the action of the Hubbard Hamiltonian on every column of X, generating every matrix element only once for the whole block (cfr. matrixMatrixProduct())
+ */
+Eigen::MatrixXd Hubbard::blockMatrixVectorProduct(const HamiltonianParameters& hamiltonian_parameters, const Eigen::MatrixXd& X, const Eigen::VectorXd& diagonal) {
+    return this->matrixMatrixProduct(hamiltonian_parameters, X, diagonal);
+}
+
+
+
+/*
+ *  PUBLIC METHODS
+ */
+
+/**
+ *  @param hamiltonian_parameters       the Hubbard Hamiltonian parameters in an orthonormal orbital basis
+ *
+ *  @return the Hubbard Hamiltonian (including its diagonal) as a sparse matrix
+ */
+Eigen::SparseMatrix<double> Hubbard::constructSparseHamiltonian(const HamiltonianParameters& hamiltonian_parameters) {
+
+    auto K = hamiltonian_parameters.get_h().get_dim();
+    if (K != this->fock_space.get_K()) {
+        throw std::invalid_argument("Basis functions of the Fock space and hamiltonian_parameters are incompatible.");
+    }
+
+    FockSpace fock_space_alpha = fock_space.get_fock_space_alpha();
+    FockSpace fock_space_beta = fock_space.get_fock_space_beta();
+
+    auto dim = fock_space.get_dimension();
+    Eigen::VectorXd diagonal = this->calculateDiagonal(hamiltonian_parameters);
+
+    // Every ONV couples to at most N_alpha (K-N_alpha) + N_beta (K-N_beta) other ONVs
+    size_t N_alpha = fock_space_alpha.get_N();
+    size_t N_beta = fock_space_beta.get_N();
+    std::vector<Eigen::Triplet<double>> triplets;
+    triplets.reserve(dim * (1 + N_alpha * (K - N_alpha) + N_beta * (K - N_beta)));
+
+    for (size_t I = 0; I < dim; I++) {
+        triplets.emplace_back(I, I, diagonal(I));
+    }
+
+    auto hoppings = generateHoppingList(hamiltonian_parameters.get_h());
+
+    // We pass to a list of triplets and create the corresponding lambda function
+    auto addToTriplets = [&triplets](size_t I, size_t J, double value) { triplets.emplace_back(I, J, value); };
+
+    this->oneOperatorModule(fock_space_alpha, fock_space_beta, true, hoppings, addToTriplets);
+    this->oneOperatorModule(fock_space_beta, fock_space_alpha, false, hoppings, addToTriplets);
+
+    Eigen::SparseMatrix<double> sparse_matrix (dim, dim);
+    sparse_matrix.setFromTriplets(triplets.begin(), triplets.end());  // duplicate elements are summed
+    return sparse_matrix;
+}
+
+
+/**
+ *  @param hamiltonian_parameters       the Hubbard Hamiltonian parameters in an orthonormal orbital basis
+ *  @param X                            the block of vectors (as columns) upon which the Hubbard Hamiltonian acts
+ *  @param diagonal                     the diagonal of the Hubbard Hamiltonian matrix
+ *
+ *  @return the action of the Hubbard Hamiltonian on every column of X, generating every matrix element only once for the whole block
+ */
+Eigen::MatrixXd Hubbard::matrixMatrixProduct(const HamiltonianParameters& hamiltonian_parameters, const Eigen::MatrixXd& X, const Eigen::VectorXd& diagonal) {
+
+    auto K = hamiltonian_parameters.get_h().get_dim();
+    if (K != this->fock_space.get_K()) {
+        throw std::invalid_argument("Basis functions of the Fock space and hamiltonian_parameters are incompatible.");
+    }
+
+    FockSpace fock_space_alpha = fock_space.get_fock_space_alpha();
+    FockSpace fock_space_beta = fock_space.get_fock_space_beta();
+
+    Eigen::MatrixXd matmat = diagonal.asDiagonal() * X;
+
+    auto hoppings = generateHoppingList(hamiltonian_parameters.get_h());
+
+    // We pass to the block of matvecs and create the corresponding lambda function
+    auto addToMatmat = [&matmat, &X](size_t I, size_t J, double value) { matmat.row(I) += value * X.row(J); };
+
+    this->oneOperatorModule(fock_space_alpha, fock_space_beta, true, hoppings, addToMatmat);
+    this->oneOperatorModule(fock_space_beta, fock_space_alpha, false, hoppings, addToMatmat);
+
+    return matmat;
+}
+
+
+/**
+ *  @param model_parameters     the (sparse) model Hamiltonian parameters
+ *
+ *  @return the Hubbard Hamiltonian matrix
+ */
+Eigen::MatrixXd Hubbard::constructHamiltonian(const ModelHamiltonianParameters& model_parameters) {
+
+    if (model_parameters.get_K() != this->fock_space.get_K()) {
+        throw std::invalid_argument("The number of sites of the Fock space and model_parameters are incompatible.");
+    }
+
+    FockSpace fock_space_alpha = fock_space.get_fock_space_alpha();
+    FockSpace fock_space_beta = fock_space.get_fock_space_beta();
+
+    auto dim = fock_space.get_dimension();
+
+    Eigen::MatrixXd result_matrix = Eigen::MatrixXd::Zero(dim, dim);
+    result_matrix += this->calculateDiagonal(model_parameters).asDiagonal();
+
+    auto hoppings = generateHoppingList(model_parameters.get_h());
+
+    // We pass to a matrix and create the corresponding lambda function
+    auto addToMatrix = [&result_matrix](size_t I, size_t J, double value) { result_matrix(I, J) += value; };
+
+    this->oneOperatorModule(fock_space_alpha, fock_space_beta, true, hoppings, addToMatrix);
+    this->oneOperatorModule(fock_space_beta, fock_space_alpha, false, hoppings, addToMatrix);
+
+    return result_matrix;
+}
+
+
+/**
+ *  @param model_parameters     the (sparse) model Hamiltonian parameters
+ *  @param x                    the vector upon which the Hubbard Hamiltonian acts
+ *  @param diagonal             the diagonal of the Hubbard Hamiltonian matrix
+ *
+ *  @return the action of the Hubbard Hamiltonian on the coefficient vector
+ */
+Eigen::VectorXd Hubbard::matrixVectorProduct(const ModelHamiltonianParameters& model_parameters, const Eigen::VectorXd& x, const Eigen::VectorXd& diagonal) {
+
+    if (model_parameters.get_K() != this->fock_space.get_K()) {
+        throw std::invalid_argument("The number of sites of the Fock space and model_parameters are incompatible.");
+    }
+
+    FockSpace fock_space_alpha = fock_space.get_fock_space_alpha();
+    FockSpace fock_space_beta = fock_space.get_fock_space_beta();
+
+    Eigen::VectorXd matvec = diagonal.cwiseProduct(x);
+
+    auto hoppings = generateHoppingList(model_parameters.get_h());
+
+    // We pass to a the matvec and create the corresponding lambda function
+    auto addToMatvec = [&matvec, &x](size_t I, size_t J, double value) { matvec(I) += value * x(J); };
+
+    this->oneOperatorModule(fock_space_alpha, fock_space_beta, true, hoppings, addToMatvec);
+    this->oneOperatorModule(fock_space_beta, fock_space_alpha, false, hoppings, addToMatvec);
+
+    return matvec;
+}
+
+
+/**
+ *  @param model_parameters     the (sparse) model Hamiltonian parameters
+ *  @param X                    the block of vectors (as columns) upon which the Hubbard Hamiltonian acts
+ *  @param diagonal             the diagonal of the Hubbard Hamiltonian matrix
+ *
+ *  @return the action of the Hubbard Hamiltonian on every column of X, generating every matrix element only once for the whole block
+ */
+Eigen::MatrixXd Hubbard::blockMatrixVectorProduct(const ModelHamiltonianParameters& model_parameters, const Eigen::MatrixXd& X, const Eigen::VectorXd& diagonal) {
+
+    if (model_parameters.get_K() != this->fock_space.get_K()) {
+        throw std::invalid_argument("The number of sites of the Fock space and model_parameters are incompatible.");
+    }
+
+    FockSpace fock_space_alpha = fock_space.get_fock_space_alpha();
+    FockSpace fock_space_beta = fock_space.get_fock_space_beta();
+
+    // The rows of X (and of the block matrix-vector product) are strided in column-major storage, so we work with the transposes: every row is then a contiguous column
+    Eigen::MatrixXd X_transpose = X.transpose();
+    Eigen::MatrixXd matmat_transpose = X_transpose * diagonal.asDiagonal();
+
+    auto hoppings = generateHoppingList(model_parameters.get_h());
+
+    // We pass to the block of matvecs and create the corresponding lambda function
+    auto addToMatmat = [&matmat_transpose, &X_transpose](size_t I, size_t J, double value) { matmat_transpose.col(I).noalias() += value * X_transpose.col(J); };
+
+    this->oneOperatorModule(fock_space_alpha, fock_space_beta, true, hoppings, addToMatmat);
+    this->oneOperatorModule(fock_space_beta, fock_space_alpha, false, hoppings, addToMatmat);
+
+    return matmat_transpose.transpose();
+}
+
+
+/**
+ *  @param model_parameters     the (sparse) model Hamiltonian parameters
+ *
+ *  @return the diagonal of the matrix representation of the Hubbard Hamiltonian, including the on-site energies and the inter-site repulsions
+ */
+Eigen::VectorXd Hubbard::calculateDiagonal(const ModelHamiltonianParameters& model_parameters) {
+
+    size_t K = model_parameters.get_K();
+    if (K != this->fock_space.get_K()) {
+        throw std::invalid_argument("The number of sites of the Fock space and model_parameters are incompatible.");
+    }
+
+    FockSpace fock_space_alpha = fock_space.get_fock_space_alpha();
+    FockSpace fock_space_beta = fock_space.get_fock_space_beta();
+
+    auto dim_alpha = fock_space_alpha.get_dimension();
+    auto dim_beta = fock_space_beta.get_dimension();
+    auto dim = fock_space.get_dimension();
+
+    const auto& h = model_parameters.get_h();
+    const auto& U = model_parameters.get_U();
+    const auto& V = model_parameters.get_V();
+    Eigen::VectorXd on_site_energies = h.diagonal();
+
+    // Diagonal contributions
+    Eigen::VectorXd diagonal = Eigen::VectorXd::Zero(dim);
+
+    ONV onv_alpha = fock_space_alpha.get_ONV(0);
+    for (size_t Ia = 0; Ia < dim_alpha; Ia++) {  // Ia loops over addresses of alpha onvs
+        size_t alpha = onv_alpha.get_unsigned_representation();
+
+        ONV onv_beta = fock_space_beta.get_ONV(0);
+        for (size_t Ib = 0; Ib < dim_beta; Ib++) {  // Ib loops over addresses of beta onvs
+            size_t beta = onv_beta.get_unsigned_representation();
+            size_t address = Ia * dim_beta + Ib;
+
+            for (size_t p = 0; p < K; p++) {
+                size_t n_p = ((alpha >> p) & 1UL) + ((beta >> p) & 1UL);  // the occupation number of site p
+                if (n_p == 0) {
+                    continue;
+                }
+
+                diagonal(address) += n_p * on_site_energies(p);
+                if (n_p == 2) {
+                    diagonal(address) += U(p);
+                }
+
+                // Since V is symmetric, every pair of sites is encountered twice
+                for (Eigen::SparseMatrix<double>::InnerIterator it (V, p); it; ++it) {
+                    size_t q = it.row();
+                    size_t n_q = ((alpha >> q) & 1UL) + ((beta >> q) & 1UL);
+                    diagonal(address) += 0.5 * it.value() * n_p * n_q;
+                }
+            }
+
+            if (Ib < dim_beta - 1) {  // prevent last permutation to occur
+                fock_space_beta.setNext(onv_beta, Ib);
+            }
+        }  // beta address (Ib) loop
+
+        if (Ia < dim_alpha - 1) {  // prevent last permutation to occur
+            fock_space_alpha.setNext(onv_alpha, Ia);
+        }
+    }  // alpha address (Ia) loop
+
+    return diagonal;
+}
+
+
+
 /*
  *  HELPER METHODS
  */
@@ -295,4 +446,50 @@ Eigen::VectorXd generateUpperTriagonal(Eigen::MatrixXd A, double t, double U) {
 }
 
 
+
+/**
+ *  @param h        the one-electron integrals (i.e. the hopping matrix) of a Hubbard lattice
+ *
+ *  @return the adjacency lists of the lattice, together with the hopping parameters: for every site p, the (ascending) sites q>p that have a non-zero hopping h_pq with p
+ */
+HoppingList generateHoppingList(const OneElectronOperator& h) {
+
+    size_t K = h.get_dim();
+    HoppingList hoppings (K);
+
+    for (size_t p = 0; p < K; p++) {
+        for (size_t q = p+1; q < K; q++) {
+            if (h(p,q) != 0.0) {
+                hoppings[p].emplace_back(q, h(p,q));
+            }
+        }
+    }
+
+    return hoppings;
+}
+
+
+/**
+ *  @param h        the (sparse) hopping matrix of a Hubbard lattice
+ *
+ *  @return the adjacency lists of the lattice, together with the hopping parameters: for every site p, the (ascending) sites q>p that have a non-zero hopping h_pq with p
+ */
+HoppingList generateHoppingList(const Eigen::SparseMatrix<double>& h) {
+
+    size_t K = h.cols();
+    HoppingList hoppings (K);
+
+    // Since h is symmetric, the column-major storage of h gives the rows q of p's column in ascending order
+    for (size_t p = 0; p < K; p++) {
+        for (Eigen::SparseMatrix<double>::InnerIterator it (h, p); it; ++it) {
+            size_t q = it.row();
+            if ((q > p) && (it.value() != 0.0)) {
+                hoppings[p].emplace_back(q, it.value());
+            }
+        }
+    }
+
+    return hoppings;
+}
+
 }  // namespace GQCP
@@ -0,0 +1,272 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2018  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#include "HamiltonianBuilder/HubbardMomentumSector.hpp"
+
+
+namespace GQCP {
+
+
+/*
+ *  PRIVATE METHODS
+ */
+
+/**
+ *  @param representation       the representation of a spin string
+ *  @param sign                 the sign that is updated with the fermionic phase factor of the translation
+ *
+ *  @return the representation of the spin string that is translated over one site, i.e. T|representation> = sign |result>
+ */
+size_t HubbardMomentumSector::translate(size_t representation, int& sign) const {
+
+    size_t K = this->fock_space.get_K();
+    size_t last_site = 1UL << (K - 1);
+
+    if (representation & last_site) {
+        // The electron on the last site moves to the first site: bringing its creation operator to the front passes all N-1 other electrons
+        if ((__builtin_popcountl(representation) - 1) % 2 == 1) {
+            sign *= -1;
+        }
+        return ((representation ^ last_site) << 1) | 1UL;
+    }
+
+    return representation << 1;
+}
+
+
+/**
+ *  @param alpha            the representation of the alpha spin string of an ONV |s>
+ *  @param beta             the representation of the beta spin string of an ONV |s>
+ *  @param index            the index of the representative |r> of the orbit of |s>
+ *  @param distance         the number of translations d that maps the representative onto |s>
+ *  @param sign             the fermionic sign of that translation, i.e. T^d |r> = sign |s>
+ *
+ *  @return if the orbit of |s> contributes to this momentum sector
+ */
+bool HubbardMomentumSector::findRepresentative(size_t alpha, size_t beta, size_t& index, size_t& distance, int& sign) const {
+
+    size_t K = this->fock_space.get_K();
+
+    // Find the smallest translated ONV: T^j |s> = sign_j |t_j>
+    std::pair<size_t, size_t> smallest (alpha, beta);
+    size_t smallest_j = 0;
+    int smallest_sign = 1;
+
+    int translation_sign = 1;
+    for (size_t j = 1; j < K; j++) {
+        alpha = this->translate(alpha, translation_sign);
+        beta = this->translate(beta, translation_sign);
+
+        if (std::make_pair(alpha, beta) < smallest) {
+            smallest = std::make_pair(alpha, beta);
+            smallest_j = j;
+            smallest_sign = translation_sign;
+        }
+    }
+
+    auto it = std::lower_bound(this->representatives.begin(), this->representatives.end(), smallest);
+    if ((it == this->representatives.end()) || (*it != smallest)) {  // the orbit does not contribute to this sector
+        return false;
+    }
+
+    // Since T^K = 1, |s> = sign_j T^(K-j) |r>
+    index = static_cast<size_t>(it - this->representatives.begin());
+    distance = (K - smallest_j) % K;
+    sign *= smallest_sign;
+    return true;
+}
+
+
+/**
+ *  @param hamiltonian_parameters       the Hubbard Hamiltonian parameters in an orthonormal orbital basis
+ *
+ *  Throw if the Hamiltonian parameters are not compatible with the Fock space or are not invariant under translation
+ */
+void HubbardMomentumSector::checkHamiltonianParameters(const HamiltonianParameters& hamiltonian_parameters) const {
+
+    size_t K = hamiltonian_parameters.get_h().get_dim();
+    if (K != this->fock_space.get_K()) {
+        throw std::invalid_argument("Basis functions of the Fock space and hamiltonian_parameters are incompatible.");
+    }
+
+    const auto& h = hamiltonian_parameters.get_h();
+    const auto& g = hamiltonian_parameters.get_g();
+    for (size_t p = 0; p < K; p++) {
+        if (std::abs(g(p,p,p,p) - g(0,0,0,0)) > 1.0e-12) {
+            throw std::invalid_argument("The on-site repulsion of the given Hamiltonian parameters is not invariant under translation.");
+        }
+
+        for (size_t q = 0; q < K; q++) {
+            if (std::abs(h(p,q) - h((p+1) % K, (q+1) % K)) > 1.0e-12) {
+                throw std::invalid_argument("The hopping matrix of the given Hamiltonian parameters is not invariant under translation.");
+            }
+        }
+    }
+}
+
+
+
+/*
+ *  CONSTRUCTORS
+ */
+
+/**
+ *  @param fock_space       the full alpha and beta product Fock space, of which the orbitals are the sites of the ring
+ *  @param k                the momentum quantum number: the crystal momentum is 2 pi k / K
+ */
+HubbardMomentumSector::HubbardMomentumSector(const ProductFockSpace& fock_space, size_t k) :
+    fock_space (fock_space),
+    k (k)
+{
+    size_t K = fock_space.get_K();
+    if (k >= K) {
+        throw std::invalid_argument("The momentum quantum number should be smaller than the number of sites.");
+    }
+
+    for (size_t d = 0; d < K; d++) {
+        this->phases.push_back(std::polar(1.0, 2 * M_PI * static_cast<double>(k * d) / K));
+    }
+
+
+    // Find the representatives of all the translation orbits that are compatible with k
+    FockSpace fock_space_alpha = fock_space.get_fock_space_alpha();
+    FockSpace fock_space_beta = fock_space.get_fock_space_beta();
+
+    auto dim_alpha = fock_space_alpha.get_dimension();
+    auto dim_beta = fock_space_beta.get_dimension();
+
+    ONV onv_alpha = fock_space_alpha.get_ONV(0);
+    for (size_t Ia = 0; Ia < dim_alpha; Ia++) {  // Ia loops over addresses of alpha onvs
+
+        ONV onv_beta = fock_space_beta.get_ONV(0);
+        for (size_t Ib = 0; Ib < dim_beta; Ib++) {  // Ib loops over addresses of beta onvs
+
+            std::pair<size_t, size_t> onv (onv_alpha.get_unsigned_representation(), onv_beta.get_unsigned_representation());
+
+            // Translate until the ONV is mapped onto itself (T^P |r> = sign |r>), or until a smaller ONV is found, in which case |r> is not the representative
+            size_t alpha = onv.first;
+            size_t beta = onv.second;
+            int sign = 1;
+            bool is_representative = true;
+            size_t period = K;
+            for (size_t j = 1; j < K; j++) {
+                alpha = this->translate(alpha, sign);
+                beta = this->translate(beta, sign);
+
+                if (std::make_pair(alpha, beta) < onv) {
+                    is_representative = false;
+                    break;
+                }
+                if (std::make_pair(alpha, beta) == onv) {
+                    period = j;
+                    break;
+                }
+            }
+            if (period == K) {  // T^K = 1
+                sign = 1;
+            }
+
+            // The momentum state exists if exp(-2 pi i k P / K) sign = 1
+            if (is_representative) {
+                bool contributes = (sign == 1) ? ((k * period) % K == 0) : ((2 * k * period) % (2 * K) == K);
+                if (contributes) {
+                    this->representatives.push_back(onv);
+                    this->periods.push_back(period);
+                }
+            }
+
+            if (Ib < dim_beta - 1) {  // prevent last permutation to occur
+                fock_space_beta.setNext(onv_beta, Ib);
+            }
+        }  // beta address (Ib) loop
+
+        if (Ia < dim_alpha - 1) {  // prevent last permutation to occur
+            fock_space_alpha.setNext(onv_alpha, Ia);
+        }
+    }  // alpha address (Ia) loop
+
+
+    // Sort the representatives (together with their periods), so that they can be looked up with a binary search
+    std::vector<size_t> order (this->representatives.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [this] (size_t i, size_t j) { return this->representatives[i] < this->representatives[j]; });
+
+    std::vector<std::pair<size_t, size_t>> sorted_representatives;
+    std::vector<size_t> sorted_periods;
+    for (size_t i : order) {
+        sorted_representatives.push_back(this->representatives[i]);
+        sorted_periods.push_back(this->periods[i]);
+    }
+    this->representatives = sorted_representatives;
+    this->periods = sorted_periods;
+}
+
+
+
+/*
+ *  PUBLIC METHODS
+ */
+
+/**
+ *  @param hamiltonian_parameters       the Hubbard Hamiltonian parameters in an orthonormal orbital basis
+ *
+ *  @return the (Hermitian) Hubbard Hamiltonian matrix in this momentum sector
+ */
+Eigen::MatrixXcd HubbardMomentumSector::constructHamiltonian(const HamiltonianParameters& hamiltonian_parameters) const {
+
+    size_t dim = this->get_dimension();
+    Eigen::MatrixXcd result_matrix = Eigen::MatrixXcd::Zero(dim, dim);
+
+    auto addToMatrix = [&result_matrix] (size_t I, size_t J, std::complex<double> value) { result_matrix(I, J) += value; };
+    this->evaluate(hamiltonian_parameters, addToMatrix);
+
+    return result_matrix;
+}
+
+
+/**
+ *  @param hamiltonian_parameters       the Hubbard Hamiltonian parameters in an orthonormal orbital basis
+ *  @param x                            the vector upon which the Hubbard Hamiltonian acts
+ *
+ *  @return the action of the Hubbard Hamiltonian in this momentum sector on the coefficient vector
+ */
+Eigen::VectorXcd HubbardMomentumSector::matrixVectorProduct(const HamiltonianParameters& hamiltonian_parameters, const Eigen::VectorXcd& x) const {
+
+    Eigen::VectorXcd matvec = Eigen::VectorXcd::Zero(this->get_dimension());
+
+    auto addToMatvec = [&matvec, &x] (size_t I, size_t J, std::complex<double> value) { matvec(I) += value * x(J); };
+    this->evaluate(hamiltonian_parameters, addToMatvec);
+
+    return matvec;
+}
+
+
+/**
+ *  @param hamiltonian_parameters       the Hubbard Hamiltonian parameters in an orthonormal orbital basis
+ *
+ *  @return the (ascending) eigenvalues of the Hubbard Hamiltonian in this momentum sector
+ */
+Eigen::VectorXd HubbardMomentumSector::calculateEigenvalues(const HamiltonianParameters& hamiltonian_parameters) const {
+
+    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXcd> self_adjoint_eigensolver (this->constructHamiltonian(hamiltonian_parameters));
+    return self_adjoint_eigensolver.eigenvalues();
+}
+
+
+}  // namespace GQCP
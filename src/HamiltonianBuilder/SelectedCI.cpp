@@ -0,0 +1,438 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2018  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#include "HamiltonianBuilder/SelectedCI.hpp"
+
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+
+namespace GQCP {
+
+
+/*
+ *  PRIVATE METHODS
+ */
+
+/**
+ *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+ *
+ *  Throw if the Hamiltonian parameters are incompatible with the Fock space
+ */
+void SelectedCI::checkCompatibility(const HamiltonianParameters& hamiltonian_parameters) const {
+
+    auto K = hamiltonian_parameters.get_h().get_dim();
+    if (K != this->fock_space.get_K()) {
+        throw std::invalid_argument("Basis functions of the Fock space and hamiltonian_parameters are incompatible.");
+    }
+}
+
+
+/**
+ *  (Re)build the stored sparse Hamiltonian if none has been stored yet, or if it was built from other Hamiltonian parameters
+ *
+ *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+ */
+void SelectedCI::updateSparseHamiltonian(const HamiltonianParameters& hamiltonian_parameters) {
+
+    // Comparing the O(K^4) integrals is negligible compared to building the sparse Hamiltonian, and cheaper than a sparse matrix-vector product for all but the smallest selected spaces
+    const auto& h = hamiltonian_parameters.get_h().get_matrix_representation();
+    const auto& g = hamiltonian_parameters.get_g().get_matrix_representation();
+
+    bool is_stored = (static_cast<size_t>(this->sparse_hamiltonian.rows()) == this->fock_space.get_dimension());
+    if (is_stored && (h.size() == this->sparse_hamiltonian_h.size()) && (g.size() == this->sparse_hamiltonian_g.size())
+                  && std::equal(h.data(), h.data() + h.size(), this->sparse_hamiltonian_h.data())
+                  && std::equal(g.data(), g.data() + g.size(), this->sparse_hamiltonian_g.data())) {
+        return;
+    }
+
+    this->sparse_hamiltonian = this->constructSparseHamiltonian(hamiltonian_parameters);
+    this->sparse_hamiltonian_h = h;
+    this->sparse_hamiltonian_g = g;
+}
+
+
+
+/*
+ *  CONSTRUCTORS
+ */
+
+/**
+ *  @param fock_space                   the Fock space spanned by the selected configurations, whose ordering is followed by all coefficient vectors
+ *  @param use_sparse_hamiltonian       if the Hamiltonian should be stored as a sparse matrix and be used in matrixVectorProduct()
+ */
+SelectedCI::SelectedCI(const SelectedFockSpace& fock_space, bool use_sparse_hamiltonian) :
+    HamiltonianBuilder(),
+    fock_space (fock_space),
+    canonical_fock_space (fock_space),
+    use_sparse_hamiltonian (use_sparse_hamiltonian)
+{
+    this->addresses = this->canonical_fock_space.canonicalize();
+}
+
+
+
+/*
+ *  OVERRIDDEN PUBLIC METHODS
+ */
+
+/**
+ *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+ *
+ *  @return the selected CI Hamiltonian matrix
+ *
+ *  If the sparse Hamiltonian is used, it is (re)built and stored if it doesn't correspond to the given Hamiltonian parameters
+ */
+Eigen::MatrixXd SelectedCI::constructHamiltonian(const HamiltonianParameters& hamiltonian_parameters) {
+
+    if (this->use_sparse_hamiltonian) {
+        this->updateSparseHamiltonian(hamiltonian_parameters);
+        return Eigen::MatrixXd(this->sparse_hamiltonian);
+    }
+
+    return Eigen::MatrixXd(this->constructSparseHamiltonian(hamiltonian_parameters));
+}
+
+
+/**
+ *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+ *  @param x                            the vector upon which the selected CI Hamiltonian acts
+ *  @param diagonal                     the diagonal of the selected CI Hamiltonian matrix
+ *
+ *  @return the action of the selected CI Hamiltonian on the coefficient vector
+ *
+ *  If the sparse Hamiltonian is used, the stored sparse Hamiltonian (which already contains the diagonal) is multiplied with x. It is (re)built if none has been stored yet, or if it was built from other Hamiltonian parameters.
+ *  Otherwise, the off-diagonal contributions are gathered row by row: the configurations are split over the available (OpenMP) threads, and every thread only writes to its own range of the matrix-vector product.
+ */
+Eigen::VectorXd SelectedCI::matrixVectorProduct(const HamiltonianParameters& hamiltonian_parameters, const Eigen::VectorXd& x, const Eigen::VectorXd& diagonal) {
+
+    this->checkCompatibility(hamiltonian_parameters);
+    size_t dim = this->fock_space.get_dimension();
+
+    if (this->use_sparse_hamiltonian) {
+        this->updateSparseHamiltonian(hamiltonian_parameters);
+        return this->sparse_hamiltonian * x;
+    }
+
+
+    // Diagonal contributions
+    Eigen::VectorXd matvec = diagonal.cwiseProduct(x);
+
+
+    // Off-diagonal contributions
+    // Every thread gathers all the contributions for a contiguous range of configurations I, so no two threads write to the same element of matvec
+    #pragma omp parallel
+    {
+        size_t number_of_threads = 1;
+        size_t thread_index = 0;
+        #ifdef _OPENMP
+        number_of_threads = omp_get_num_threads();
+        thread_index = omp_get_thread_num();
+        #endif
+
+        auto range = partitionAddresses(dim, number_of_threads)[thread_index];
+        for (size_t I = range.start; I < range.end; I++) {  // I loops over the canonical addresses
+            const auto& configuration_I = this->canonical_fock_space.get_configuration(I);
+
+            double value = 0.0;  // the off-diagonal contributions to matvec(addresses[I])
+            this->canonical_fock_space.forEachCoupledConfiguration(I, [&] (size_t J) {
+                value += this->calculateOffDiagonalElement(hamiltonian_parameters, configuration_I, this->canonical_fock_space.get_configuration(J)) * x(this->addresses[J]);
+            });
+
+            matvec(this->addresses[I]) += value;
+        }  // configuration (I) loop
+    }  // parallel region
+
+    return matvec;
+}
+
+
+/**
+ *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+ *
+ *  @return the diagonal of the matrix representation of the selected CI Hamiltonian
+ */
+Eigen::VectorXd SelectedCI::calculateDiagonal(const HamiltonianParameters& hamiltonian_parameters) {
+
+    this->checkCompatibility(hamiltonian_parameters);
+    size_t dim = this->fock_space.get_dimension();
+    Eigen::VectorXd diagonal = Eigen::VectorXd::Zero(dim);
+
+    #pragma omp parallel for
+    for (size_t I = 0; I < dim; I++) {
+        diagonal(I) = this->calculateDiagonalElement(hamiltonian_parameters, this->fock_space.get_configuration(I));
+    }
+
+    return diagonal;
+}
+
+
+/**
+ *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+ *  @param X                            the vectors (as columns) upon which the selected CI Hamiltonian acts
+ *  @param diagonal                     the diagonal of the selected CI Hamiltonian matrix
+ *
+ *  @return the action of the selected CI Hamiltonian on every column of X
+ *
+ *  If the sparse Hamiltonian is used, it is handled as in matrixVectorProduct(). Otherwise, every coupling (and its matrix element) is found only once for the whole block: the rows are gathered as in matrixVectorProduct(), reading X through its (contiguous) transpose.
+ */
+Eigen::MatrixXd SelectedCI::blockMatrixVectorProduct(const HamiltonianParameters& hamiltonian_parameters, const Eigen::MatrixXd& X, const Eigen::VectorXd& diagonal) {
+
+    this->checkCompatibility(hamiltonian_parameters);
+    size_t dim = this->fock_space.get_dimension();
+
+    if (this->use_sparse_hamiltonian) {
+        this->updateSparseHamiltonian(hamiltonian_parameters);
+        return this->sparse_hamiltonian * X;
+    }
+
+
+    // The rows of X (and of the block matrix-vector product) are strided in column-major storage, so we work with the transposes: every row is then a contiguous column
+    Eigen::MatrixXd X_transpose = X.transpose();
+    Eigen::MatrixXd block_matvec_transpose (X.cols(), dim);
+
+
+    // Off-diagonal contributions, gathered row by row, and the diagonal contributions
+    #pragma omp parallel
+    {
+        size_t number_of_threads = 1;
+        size_t thread_index = 0;
+        #ifdef _OPENMP
+        number_of_threads = omp_get_num_threads();
+        thread_index = omp_get_thread_num();
+        #endif
+
+        Eigen::VectorXd values (X.cols());  // the contributions to the current row, reused for every row of this thread
+
+        auto range = partitionAddresses(dim, number_of_threads)[thread_index];
+        for (size_t I = range.start; I < range.end; I++) {  // I loops over the canonical addresses
+            const auto& configuration_I = this->canonical_fock_space.get_configuration(I);
+            size_t row = this->addresses[I];
+
+            values.noalias() = diagonal(row) * X_transpose.col(row);
+            this->canonical_fock_space.forEachCoupledConfiguration(I, [&] (size_t J) {
+                values.noalias() += this->calculateOffDiagonalElement(hamiltonian_parameters, configuration_I, this->canonical_fock_space.get_configuration(J)) * X_transpose.col(this->addresses[J]);
+            });
+
+            block_matvec_transpose.col(row) = values;
+        }  // configuration (I) loop
+    }  // parallel region
+
+    return block_matvec_transpose.transpose();
+}
+
+
+
+/*
+ *  PUBLIC METHODS
+ */
+
+/**
+ *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+ *
+ *  @return the selected CI Hamiltonian (including its diagonal) as a row-major (CSR) sparse matrix
+ */
+Eigen::SparseMatrix<double, Eigen::RowMajor> SelectedCI::constructSparseHamiltonian(const HamiltonianParameters& hamiltonian_parameters) {
+
+    this->checkCompatibility(hamiltonian_parameters);
+    size_t dim = this->fock_space.get_dimension();
+
+    Eigen::SparseMatrix<double, Eigen::RowMajor> sparse_matrix (dim, dim);
+
+    // The rows are appended in the caller's ordering, so we need the canonical address of every configuration in fock_space
+    std::vector<size_t> canonical_addresses (dim);
+    for (size_t I = 0; I < dim; I++) {
+        canonical_addresses[this->addresses[I]] = I;
+    }
+
+    // The row is gathered as (column, value) pairs, and sorted on the column index before it is appended to the CSR structure
+    std::vector<std::pair<size_t, double>> row_entries;
+
+    for (size_t row = 0; row < dim; row++) {  // row loops over all the configurations in the caller's ordering
+        size_t I = canonical_addresses[row];
+        const auto& configuration_I = this->canonical_fock_space.get_configuration(I);
+        row_entries.clear();
+
+        // Diagonal contribution
+        row_entries.emplace_back(row, this->calculateDiagonalElement(hamiltonian_parameters, configuration_I));
+
+        // Off-diagonal contributions
+        this->canonical_fock_space.forEachCoupledConfiguration(I, [&] (size_t J) {
+            row_entries.emplace_back(this->addresses[J], this->calculateOffDiagonalElement(hamiltonian_parameters, configuration_I, this->canonical_fock_space.get_configuration(J)));
+        });
+
+        // Append the row to the CSR structure
+        std::sort(row_entries.begin(), row_entries.end());
+        sparse_matrix.startVec(row);
+        for (const auto& entry : row_entries) {
+            sparse_matrix.insertBack(row, entry.first) = entry.second;
+        }
+    }  // configuration (row) loop
+
+    sparse_matrix.finalize();
+    return sparse_matrix;
+}
+
+
+/**
+ *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+ *  @param configuration                the configuration
+ *
+ *  @return the diagonal element of the Hamiltonian for the given configuration
+ */
+double SelectedCI::calculateDiagonalElement(const HamiltonianParameters& hamiltonian_parameters, const Configuration& configuration) {
+
+    const auto& h = hamiltonian_parameters.get_h();
+    const auto& g = hamiltonian_parameters.get_g();
+
+    const ONV& alpha = configuration.onv_alpha;
+    const ONV& beta = configuration.onv_beta;
+    size_t N_alpha = alpha.get_N();
+    size_t N_beta = beta.get_N();
+
+    double value = 0.0;
+
+    // Alpha contributions: sum_{p in alpha} h_pp + sum_{p>q in alpha} (g_ppqq - g_pqqp)
+    for (size_t e1 = 0; e1 < N_alpha; e1++) {
+        size_t p = alpha.get_occupied_index(e1);
+        value += h(p,p);
+
+        for (size_t e2 = 0; e2 < e1; e2++) {
+            size_t q = alpha.get_occupied_index(e2);
+            value += g(p,p,q,q) - g(p,q,q,p);
+        }
+
+        // Mixed alpha-beta contributions: sum_{p in alpha} sum_{q in beta} g_ppqq
+        for (size_t e2 = 0; e2 < N_beta; e2++) {
+            size_t q = beta.get_occupied_index(e2);
+            value += g(p,p,q,q);
+        }
+    }
+
+    // Beta contributions: sum_{p in beta} h_pp + sum_{p>q in beta} (g_ppqq - g_pqqp)
+    for (size_t e1 = 0; e1 < N_beta; e1++) {
+        size_t p = beta.get_occupied_index(e1);
+        value += h(p,p);
+
+        for (size_t e2 = 0; e2 < e1; e2++) {
+            size_t q = beta.get_occupied_index(e2);
+            value += g(p,p,q,q) - g(p,q,q,p);
+        }
+    }
+
+    return value;
+}
+
+
+/**
+ *  @param hamiltonian_parameters       the Hamiltonian parameters in an orthonormal orbital basis
+ *  @param configuration_I              the configuration of the bra
+ *  @param configuration_J              the configuration of the ket, which should differ in one or two electron excitations from the bra
+ *
+ *  @return the Hamiltonian matrix element <I|H|J>, calculated with the Slater-Condon rules
+ */
+double SelectedCI::calculateOffDiagonalElement(const HamiltonianParameters& hamiltonian_parameters, const Configuration& configuration_I, const Configuration& configuration_J) {
+
+    const auto& h = hamiltonian_parameters.get_h();
+    const auto& g = hamiltonian_parameters.get_g();
+
+    size_t alpha_I = configuration_I.onv_alpha.get_unsigned_representation();
+    size_t beta_I = configuration_I.onv_beta.get_unsigned_representation();
+    size_t alpha_J = configuration_J.onv_alpha.get_unsigned_representation();
+    size_t beta_J = configuration_J.onv_beta.get_unsigned_representation();
+
+    // The orbitals that are annihilated in (the ket) J and created in (the bra) I
+    size_t alpha_annihilated = alpha_J & ~alpha_I;
+    size_t alpha_created = alpha_I & ~alpha_J;
+    size_t beta_annihilated = beta_J & ~beta_I;
+    size_t beta_created = beta_I & ~beta_J;
+
+    size_t alpha_excitations = __builtin_popcountl(alpha_annihilated);
+    size_t beta_excitations = __builtin_popcountl(beta_annihilated);
+
+
+    // Mixed alpha-beta double excitation p->q (alpha), r->s (beta): <I|H|J> = sign g_qpsr
+    if ((alpha_excitations == 1) && (beta_excitations == 1)) {
+        size_t p = __builtin_ctzl(alpha_annihilated);
+        size_t q = __builtin_ctzl(alpha_created);
+        size_t r = __builtin_ctzl(beta_annihilated);
+        size_t s = __builtin_ctzl(beta_created);
+
+        int sign = 1;
+        ONV alpha = configuration_J.onv_alpha;
+        alpha.annihilate_unchecked(p, sign);
+        alpha.create_unchecked(q, sign);
+        ONV beta = configuration_J.onv_beta;
+        beta.annihilate_unchecked(r, sign);
+        beta.create_unchecked(s, sign);
+
+        return sign * g(q,p,s,r);
+    }
+
+
+    // Pure excitations only involve one spin component
+    bool is_alpha = (alpha_excitations != 0);
+    const ONV& ket = is_alpha ? configuration_J.onv_alpha : configuration_J.onv_beta;
+    const ONV& other = is_alpha ? configuration_J.onv_beta : configuration_J.onv_alpha;
+    size_t annihilated = is_alpha ? alpha_annihilated : beta_annihilated;
+    size_t created = is_alpha ? alpha_created : beta_created;
+
+
+    // Single excitation p->q: <I|H|J> = sign (h_qp + sum_{k in J, same spin} (g_qpkk - g_qkkp) + sum_{k in J, other spin} g_qpkk)
+    if (__builtin_popcountl(annihilated) == 1) {
+        size_t p = __builtin_ctzl(annihilated);
+        size_t q = __builtin_ctzl(created);
+
+        int sign = 1;
+        ONV onv = ket;
+        onv.annihilate_unchecked(p, sign);
+        onv.create_unchecked(q, sign);
+
+        double value = h(q,p);
+        for (size_t e = 0; e < ket.get_N(); e++) {
+            size_t k = ket.get_occupied_index(e);
+            value += g(q,p,k,k) - g(q,k,k,p);
+        }
+        for (size_t e = 0; e < other.get_N(); e++) {
+            size_t k = other.get_occupied_index(e);
+            value += g(q,p,k,k);
+        }
+
+        return sign * value;
+    }
+
+
+    // Double excitation p,r->q,s (p<r, q<s), i.e. the operator string a^dagger_s a^dagger_q a_r a_p: <I|H|J> = sign (g_spqr - g_qpsr)
+    size_t p = __builtin_ctzl(annihilated);
+    size_t r = __builtin_ctzl(annihilated & (annihilated - 1));
+    size_t q = __builtin_ctzl(created);
+    size_t s = __builtin_ctzl(created & (created - 1));
+
+    int sign = 1;
+    ONV onv = ket;
+    onv.annihilate_unchecked(p, sign);
+    onv.annihilate_unchecked(r, sign);
+    onv.create_unchecked(q, sign);
+    onv.create_unchecked(s, sign);
+
+    return sign * (g(s,p,q,r) - g(q,p,s,r));
+}
+
+}  // namespace GQCP
@@ -263,4 +263,56 @@ GQCP::HamiltonianParameters constructHubbardParameters(const Eigen::VectorXd& up
 }
 
 
+
+/**
+ *  @param upper_triagonal      an upper triagonal representation of the Hubbard hopping matrix
+ *  @param V                    the inter-site repulsion between neighbouring sites, i.e. sites with a non-zero hopping
+ *
+ *  @return (sparse) model Hamiltonian parameters generated from the Hubbard hopping matrix
+ */
+GQCP::ModelHamiltonianParameters constructHubbardModelParameters(const Eigen::VectorXd& upper_triagonal, double V) {
+
+    // The dimension of matrix K is related to the length of the triagonal vector :
+    // K (K + 1) = 2*X
+    // K = (sqrt(1+8X) - 1)/2
+
+    size_t X = upper_triagonal.rows();
+    size_t K = (static_cast<size_t>(sqrt(1 + 8*X) - 1))/2;
+
+    if (K * (K+1) != 2*X) {
+        throw std::invalid_argument("Passed vector was not the triagonal of a square matrix");
+    }
+
+    Eigen::VectorXd U = Eigen::VectorXd::Zero(K);
+    std::vector<Eigen::Triplet<double>> h_triplets;
+    std::vector<Eigen::Triplet<double>> V_triplets;
+
+    size_t triagonal_index = 0;
+    for (size_t i = 0; i < K; i++) {
+        for (size_t j = i; j < K; j++) {
+            double value = upper_triagonal(triagonal_index);
+
+            if (i == j) {
+                U(i) = value;
+            } else if (value != 0.0) {
+                h_triplets.emplace_back(i, j, value);
+                h_triplets.emplace_back(j, i, value);
+
+                if (V != 0.0) {
+                    V_triplets.emplace_back(i, j, V);
+                    V_triplets.emplace_back(j, i, V);
+                }
+            }
+            triagonal_index++;
+        }
+    }
+
+    Eigen::SparseMatrix<double> h_sparse (K, K);
+    h_sparse.setFromTriplets(h_triplets.begin(), h_triplets.end());
+    Eigen::SparseMatrix<double> V_sparse (K, K);
+    V_sparse.setFromTriplets(V_triplets.begin(), V_triplets.end());
+
+    return GQCP::ModelHamiltonianParameters(h_sparse, U, V_sparse);
+}
+
 }  // namespace GQCP
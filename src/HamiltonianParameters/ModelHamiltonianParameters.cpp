@@ -0,0 +1,102 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2018  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#include "HamiltonianParameters/ModelHamiltonianParameters.hpp"
+
+
+namespace GQCP {
+
+
+/*
+ *  CONSTRUCTORS
+ */
+
+/**
+ *  @param h            the (symmetric) hopping matrix, whose diagonal contains the on-site energies
+ *  @param U            the on-site repulsions
+ */
+ModelHamiltonianParameters::ModelHamiltonianParameters(const Eigen::SparseMatrix<double>& h, const Eigen::VectorXd& U) :
+    ModelHamiltonianParameters(h, U, Eigen::SparseMatrix<double>(h.rows(), h.cols()))
+{}
+
+
+/**
+ *  @param h            the (symmetric) hopping matrix, whose diagonal contains the on-site energies
+ *  @param U            the on-site repulsions
+ *  @param V            the (symmetric) inter-site repulsions, with a zero diagonal
+ */
+ModelHamiltonianParameters::ModelHamiltonianParameters(const Eigen::SparseMatrix<double>& h, const Eigen::VectorXd& U, const Eigen::SparseMatrix<double>& V) :
+    BaseHamiltonianParameters(nullptr),
+    K (static_cast<size_t>(U.size())),
+    h (h),
+    U (U),
+    V (V)
+{
+    // Check if the dimensions of all the parameters are compatible
+    if ((h.rows() != U.size()) || (h.cols() != U.size()) || (V.rows() != U.size()) || (V.cols() != U.size())) {
+        throw std::invalid_argument("The dimensions of the hopping matrix, the on-site and the inter-site repulsions are incompatible.");
+    }
+
+    if ((h - Eigen::SparseMatrix<double>(h.transpose())).norm() > 1.0e-12) {
+        throw std::invalid_argument("The hopping matrix should be symmetric.");
+    }
+
+    if (((V - Eigen::SparseMatrix<double>(V.transpose())).norm() > 1.0e-12) || (Eigen::VectorXd(V.diagonal()).norm() > 1.0e-12)) {
+        throw std::invalid_argument("The inter-site repulsions should be symmetric and should have a zero diagonal.");
+    }
+
+    this->h.makeCompressed();
+    this->V.makeCompressed();
+}
+
+
+
+/*
+ *  PUBLIC METHODS
+ */
+
+/**
+ *  @return the equivalent (dense) Hamiltonian parameters in the orthonormal site basis
+ *
+ *  Note that the two-electron integrals require K^4 doubles, so this should only be used for small lattices
+ */
+HamiltonianParameters ModelHamiltonianParameters::constructHamiltonianParameters() const {
+
+    // In chemist's notation, U_p n_{p alpha} n_{p beta} corresponds to g_pppp, and V_pq n_p n_q corresponds to g_ppqq = g_qqpp
+    Eigen::Tensor<double, 4> g (this->K, this->K, this->K, this->K);
+    g.setZero();
+    for (size_t p = 0; p < this->K; p++) {
+        g(p,p,p,p) = this->U(p);
+    }
+    for (int col = 0; col < this->V.outerSize(); col++) {
+        for (Eigen::SparseMatrix<double>::InnerIterator it (this->V, col); it; ++it) {
+            g(it.row(), it.row(), it.col(), it.col()) = it.value();
+        }
+    }
+
+    // Make the ingredients to construct HamiltonianParameters
+    std::shared_ptr<GQCP::AOBasis> ao_basis;  // nullptr
+    GQCP::OneElectronOperator S (Eigen::MatrixXd::Identity(this->K, this->K));
+    GQCP::OneElectronOperator H_core (Eigen::MatrixXd(this->h));
+    GQCP::TwoElectronOperator G (g);
+    Eigen::MatrixXd C = Eigen::MatrixXd::Identity(this->K, this->K);
+
+    return GQCP::HamiltonianParameters(ao_basis, S, H_core, G, C);
+}
+
+
+}  // namespace GQCP
@@ -60,7 +60,7 @@ OneRDMs DOCIRDMBuilder::calculate1RDMs(const Eigen::VectorXd& x) {
         }
         
         if (I < dim-1) {
-            this->fock_space.setNext(onv);
+            this->fock_space.setNext(onv, I);
         }
     }
 
@@ -92,7 +92,7 @@ TwoRDMs DOCIRDMBuilder::calculate2RDMs(const Eigen::VectorXd& x) {
 
     for (size_t I = 0; I < dim; I++) {  // I loops over all the addresses of the spin strings
         for (size_t p = 0; p < K; p++) {  // p loops over SOs
-            if (onv.annihilate(p)) {  // if p is occupied in I
+            if (onv.annihilate_unchecked(p)) {  // if p is occupied in I
 
                 double c_I = x(I);  // coefficient of the I-th basis vector
                 double c_I_2 = std::pow(c_I, 2);  // square of c_I
@@ -100,14 +100,14 @@ TwoRDMs DOCIRDMBuilder::calculate2RDMs(const Eigen::VectorXd& x) {
                 d_aabb(p,p,p,p) += c_I_2;
 
                 for (size_t q = 0; q < p; q++) {  // q loops over SOs with an index smaller than p
-                    if (onv.create(q)) {  // if q is not occupied in I
+                    if (onv.create_unchecked(q)) {  // if q is not occupied in I
                         size_t J = this->fock_space.getAddress(onv);  // the address of the coupling string
                         double c_J = x(J);  // coefficient of the J-th basis vector
 
                         d_aabb(p,q,p,q) += c_I * c_J;
                         d_aabb(q,p,q,p) += c_I * c_J;  // since we're looping for q < p
 
-                        onv.annihilate(q);  // reset the spin string after previous creation on q
+                        onv.annihilate_unchecked(q);  // reset the spin string after previous creation on q
                     }
 
                     else {  // if q is occupied in I
@@ -121,12 +121,12 @@ TwoRDMs DOCIRDMBuilder::calculate2RDMs(const Eigen::VectorXd& x) {
                         d_aabb(q,q,p,p) += c_I_2;  // since we're looping for q < p
                     }
                 }
-                onv.create(p);  // reset the spin string after previous annihilation on p
+                onv.create_unchecked(p);  // reset the spin string after previous annihilation on p
             }
         }
 
         if ( I < dim-1) {
-            this->fock_space.setNext(onv);
+            this->fock_space.setNext(onv, I);
         }
     }
 
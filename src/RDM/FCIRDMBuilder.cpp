@@ -55,94 +55,56 @@ OneRDMs FCIRDMBuilder::calculate1RDMs(const Eigen::VectorXd& x) {
     // ALPHA
     ONV spin_string_alpha = fock_space_alpha.get_ONV(0);  // alpha spin string with address 0
     for (size_t I_alpha = 0; I_alpha < dim_alpha; I_alpha++) {  // I_alpha loops over all the addresses of the alpha spin strings
-        for (size_t p = 0; p < K; p++) {  // p loops over SOs
-            int sign_p = 1;
-            if (spin_string_alpha.annihilate(p, sign_p)) {  // if p is in I_alpha
-                double diagonal_contribution =  0;
-
-                // Diagonal contributions for the 1-DM, i.e. D_pp
-                // We are storing the alpha addresses as 'major', i.e. the total address I_alpha I_beta = I_alpha * dim_beta + I_beta
-                for (size_t I_beta = 0; I_beta < dim_beta; I_beta++) {
-                    double c_I_alpha_I_beta = x(I_alpha*dim_beta + I_beta);
-                    diagonal_contribution += std::pow(c_I_alpha_I_beta, 2);
-                }
-                D_aa(p,p) += diagonal_contribution;
-
-                // Off-diagonal contributions for the 1-DM, i.e. D_pq (p!=q)
-                for (size_t q = 0; q < p; q++) {  // q < p loops over SOs
-                    int sign_pq = sign_p;
-                    if (spin_string_alpha.create(q, sign_pq)) {  // if q is not occupied in I_alpha
-                        size_t J_alpha = fock_space_alpha.getAddress(spin_string_alpha);  // find all strings J_alpha that couple to I_alpha
-
-                        double off_diagonal_contribution = 0;
-                        for(size_t I_beta = 0; I_beta < dim_beta; I_beta++) {
-                            double c_I_alpha_I_beta = x(I_alpha*dim_beta + I_beta);  // alpha addresses are 'major'
-                            double c_J_alpha_I_beta = x(J_alpha*dim_beta + I_beta);
-                            off_diagonal_contribution += c_I_alpha_I_beta * c_J_alpha_I_beta;
-                        }
-                        D_aa(p,q) += sign_pq * off_diagonal_contribution;
-                        D_aa(q,p) += sign_pq * off_diagonal_contribution;  // add the symmetric contribution because we are looping over q < p
-
-                        spin_string_alpha.annihilate(q);  // undo the previous creation
-                    }  // create on q
-                }  // q loop
-
-                spin_string_alpha.create(p);  // undo the previous annihilation
-            }  // annihilate on p
-        }  // p loop
+
+        // Find all strings J_alpha that couple to I_alpha, for q <= p: the diagonal contributions D_pp are found for J_alpha == I_alpha
+        fock_space_alpha.forEachOneElectronCoupling(spin_string_alpha, [] (size_t p, size_t q) { return q <= p; }, [&] (size_t J_alpha, int sign_pq, size_t p, size_t q) {
+
+            // We are storing the alpha addresses as 'major', i.e. the total address I_alpha I_beta = I_alpha * dim_beta + I_beta
+            double contribution = 0;
+            for (size_t I_beta = 0; I_beta < dim_beta; I_beta++) {
+                double c_I_alpha_I_beta = x(I_alpha*dim_beta + I_beta);
+                double c_J_alpha_I_beta = x(J_alpha*dim_beta + I_beta);
+                contribution += c_I_alpha_I_beta * c_J_alpha_I_beta;
+            }
+
+            D_aa(p,q) += sign_pq * contribution;
+            if (p != q) {
+                D_aa(q,p) += sign_pq * contribution;  // add the symmetric contribution because we are looping over q < p
+            }
+        });
 
         if (I_alpha < dim_alpha - 1) {  // prevent the last permutation to occur
-            fock_space_alpha.setNext(spin_string_alpha);
+            fock_space_alpha.setNext(spin_string_alpha, I_alpha);
         }
-        
     }  // I_alpha loop
 
 
     // BETA
     ONV spin_string_beta = fock_space_beta.get_ONV(0);  // spin string with address 0
     for (size_t I_beta = 0; I_beta < dim_beta; I_beta++) {  // I_beta loops over all the addresses of the spin strings
-        for (size_t p = 0; p < K; p++) {  // p loops over SOs
-            int sign_p = 1;
-            if (spin_string_beta.annihilate(p, sign_p)) {  // if p is in I_beta
-                double diagonal_contribution = 0;
-
-                // Diagonal contributions for the 1-DM, i.e. D_pp
-                // We are storing the alpha addresses as 'major', i.e. the total address I_alpha I_beta = I_alpha * dim_beta + I_beta
-                for (size_t I_alpha = 0; I_alpha < dim_alpha; I_alpha++) {
-                    double c_I_alpha_I_beta = x(I_alpha*dim_beta + I_beta);
-                    diagonal_contribution += std::pow(c_I_alpha_I_beta, 2);
-                }
-
-                D_bb(p,p) += diagonal_contribution;
-
-                // Off-diagonal contributions for the 1-DM
-                for (size_t q = 0; q < p; q++) {  // q < p loops over SOs
-                    int sign_pq = sign_p;
-                    if (spin_string_beta.create(q, sign_pq)) {  // if q is not in I_beta
-                        size_t J_beta = fock_space_beta.getAddress(spin_string_beta);  // find all strings J_beta that couple to I_beta
-
-                        double off_diagonal_contribution = 0;
-                        for (size_t I_alpha = 0; I_alpha<dim_alpha; I_alpha++) {
-                            double c_I_alpha_I_beta = x(I_alpha*dim_beta + I_beta);  // alpha addresses are 'major'
-                            double c_I_alpha_J_beta = x(I_alpha*dim_beta + J_beta);
-                            off_diagonal_contribution += c_I_alpha_I_beta * c_I_alpha_J_beta;
-                        }
-                        D_bb(p,q) += sign_pq * off_diagonal_contribution;
-                        D_bb(q,p) += sign_pq * off_diagonal_contribution;  // add the symmetric contribution because we are looping over q < p
-
-                        spin_string_beta.annihilate(q);  // undo the previous creation
-                    }  // create on q
-                }  // loop over q
 
-                spin_string_beta.create(p);  // undo the previous annihilation
-            }  // annihilate on p
-        }  // loop over p
+        // Find all strings J_beta that couple to I_beta, for q <= p: the diagonal contributions D_pp are found for J_beta == I_beta
+        fock_space_beta.forEachOneElectronCoupling(spin_string_beta, [] (size_t p, size_t q) { return q <= p; }, [&] (size_t J_beta, int sign_pq, size_t p, size_t q) {
+
+            // We are storing the alpha addresses as 'major', i.e. the total address I_alpha I_beta = I_alpha * dim_beta + I_beta
+            double contribution = 0;
+            for (size_t I_alpha = 0; I_alpha < dim_alpha; I_alpha++) {
+                double c_I_alpha_I_beta = x(I_alpha*dim_beta + I_beta);
+                double c_I_alpha_J_beta = x(I_alpha*dim_beta + J_beta);
+                contribution += c_I_alpha_I_beta * c_I_alpha_J_beta;
+            }
+
+            D_bb(p,q) += sign_pq * contribution;
+            if (p != q) {
+                D_bb(q,p) += sign_pq * contribution;  // add the symmetric contribution because we are looping over q < p
+            }
+        });
 
         if (I_beta < dim_beta - 1) {  // prevent the last permutation to occur
-            fock_space_beta.setNext(spin_string_beta);
+            fock_space_beta.setNext(spin_string_beta, I_beta);
         }
-
     }  // I_beta loop
+
     OneRDM one_rdm_aa (D_aa);
     OneRDM one_rdm_bb (D_bb);
     return OneRDMs (one_rdm_aa, one_rdm_bb);
@@ -185,22 +147,22 @@ TwoRDMs FCIRDMBuilder::calculate2RDMs(const Eigen::VectorXd& x) {
         for (size_t p = 0; p < K; p++) {  // p loops over SOs
             int sign_p = 1;  // sign of the operator a_p
 
-            if (spin_string_alpha_aaaa.annihilate(p, sign_p)) {  // if p is not in I_alpha
+            if (spin_string_alpha_aaaa.annihilate_unchecked(p, sign_p)) {  // if p is not in I_alpha
 
                 for (size_t r = 0; r < K; r++) {  // r loops over SOs
                     int sign_pr = sign_p;  // sign of the operator a_r a_p
 
-                    if (spin_string_alpha_aaaa.annihilate(r, sign_pr)) {  // if r is not in I_alpha
+                    if (spin_string_alpha_aaaa.annihilate_unchecked(r, sign_pr)) {  // if r is not in I_alpha
 
                         for (size_t s = 0; s < K; s++) {  // s loops over SOs
                             int sign_prs = sign_pr;  // sign of the operator a^dagger_s a_r a_p
 
-                            if (spin_string_alpha_aaaa.create(s, sign_prs)) {  // if s is in I_alpha
+                            if (spin_string_alpha_aaaa.create_unchecked(s, sign_prs)) {  // if s is in I_alpha
 
                                 for (size_t q = 0; q < K; q++) {  // q loops over SOs
                                     int sign_prsq = sign_prs;  // sign of the operator a^dagger_q a^dagger_s a_r a_p
 
-                                    if (spin_string_alpha_aaaa.create(q, sign_prsq)) {  // if q is not in I_alpha
+                                    if (spin_string_alpha_aaaa.create_unchecked(q, sign_prsq)) {  // if q is not in I_alpha
                                         size_t J_alpha = fock_space_alpha.getAddress(spin_string_alpha_aaaa);  // address of the coupling string
 
                                         double contribution = 0.0;
@@ -213,24 +175,24 @@ TwoRDMs FCIRDMBuilder::calculate2RDMs(const Eigen::VectorXd& x) {
 
                                         d_aaaa(p,q,r,s) += sign_prsq * contribution;
 
-                                        spin_string_alpha_aaaa.annihilate(q);  // undo the previous creation
+                                        spin_string_alpha_aaaa.annihilate_unchecked(q);  // undo the previous creation
                                     }
                                 }  // loop over q
 
-                                spin_string_alpha_aaaa.annihilate(s);  // undo the previous creation
+                                spin_string_alpha_aaaa.annihilate_unchecked(s);  // undo the previous creation
                             }
                         }  // loop over s
 
-                        spin_string_alpha_aaaa.create(r);  // undo the previous annihilation
+                        spin_string_alpha_aaaa.create_unchecked(r);  // undo the previous annihilation
                     }
                 }  // loop over r
 
-                spin_string_alpha_aaaa.create(p);  // undo the previous annihilation
+                spin_string_alpha_aaaa.create_unchecked(p);  // undo the previous annihilation
             }
         }  // loop over p
 
         if (I_alpha < dim_alpha - 1) {  // prevent the last permutation to occur
-            fock_space_alpha.setNext(spin_string_alpha_aaaa);
+            fock_space_alpha.setNext(spin_string_alpha_aaaa, I_alpha);
         }
 
     }  // loop over I_alpha
@@ -243,12 +205,12 @@ TwoRDMs FCIRDMBuilder::calculate2RDMs(const Eigen::VectorXd& x) {
         for (size_t p = 0; p < K; p++) {  // p loops over SOs
             int sign_p = 1;  // sign of the operator a_p_alpha
 
-            if (spin_string_alpha_aabb.annihilate(p, sign_p)) {  // if p is in I_alpha
+            if (spin_string_alpha_aabb.annihilate_unchecked(p, sign_p)) {  // if p is in I_alpha
 
                 for (size_t q = 0; q < K; q++) {  // q loops over SOs
                     int sign_pq = sign_p;  // sign of the operator a^dagger_p_alpha a_p_alpha
 
-                    if (spin_string_alpha_aabb.create(q, sign_pq)) {  // if q is not in I_alpha
+                    if (spin_string_alpha_aabb.create_unchecked(q, sign_pq)) {  // if q is not in I_alpha
                         size_t J_alpha = fock_space_alpha.getAddress(spin_string_alpha_aabb);  // the string that couples to I_alpha
 
 
@@ -258,44 +220,44 @@ TwoRDMs FCIRDMBuilder::calculate2RDMs(const Eigen::VectorXd& x) {
                             for (size_t r = 0; r < K; r++) {  // r loops over all SOs
                                 int sign_r = 1;  // sign of the operator a_r_beta
 
-                                if (spin_string_beta_aabb.annihilate(r, sign_r)) {
+                                if (spin_string_beta_aabb.annihilate_unchecked(r, sign_r)) {
 
                                     for (size_t s = 0; s < K; s++) {  // s loops over all SOs
                                         int sign_rs = sign_r;  // sign of the operator a^dagger_s_beta a_r_beta
 
-                                        if (spin_string_beta_aabb.create(s, sign_rs)) {
+                                        if (spin_string_beta_aabb.create_unchecked(s, sign_rs)) {
                                             size_t J_beta = fock_space_beta.getAddress(spin_string_beta_aabb);  // the string that couples to I_beta
 
                                             double c_I_alpha_I_beta = x(I_alpha*dim_beta + I_beta);  // alpha addresses are 'major'
                                             double c_J_alpha_J_beta = x(J_alpha*dim_beta + J_beta);
                                             d_aabb(p,q,r,s) += sign_pq * sign_rs * c_I_alpha_I_beta * c_J_alpha_J_beta;
 
-                                            spin_string_beta_aabb.annihilate(s);  // undo the previous creation
+                                            spin_string_beta_aabb.annihilate_unchecked(s);  // undo the previous creation
                                         }
                                     }  // loop over s
 
 
-                                    spin_string_beta_aabb.create(r);  // undo the previous annihilation
+                                    spin_string_beta_aabb.create_unchecked(r);  // undo the previous annihilation
                                 }
 
                             }  // loop over r
 
                             if (I_beta < dim_beta - 1) {  // prevent the last permutation to occur
-                                fock_space_beta.setNext(spin_string_beta_aabb);
+                                fock_space_beta.setNext(spin_string_beta_aabb, I_beta);
                             }
 
                         }  // loop over beta addresses
 
-                        spin_string_alpha_aabb.annihilate(q);  // undo the previous creation
+                        spin_string_alpha_aabb.annihilate_unchecked(q);  // undo the previous creation
                     }
                 }  // loop over q
 
-                spin_string_alpha_aabb.create(p);  // undo the previous annihilation
+                spin_string_alpha_aabb.create_unchecked(p);  // undo the previous annihilation
             }
         }  // loop over p
 
         if (I_alpha < dim_alpha - 1) {  // prevent the last permutation to occur
-            fock_space_alpha.setNext(spin_string_alpha_aabb);
+            fock_space_alpha.setNext(spin_string_alpha_aabb, I_alpha);
         }
 
     }  // loop over alpha addresses
@@ -314,26 +276,26 @@ TwoRDMs FCIRDMBuilder::calculate2RDMs(const Eigen::VectorXd& x) {
         for (size_t p = 0; p < K; p++) {  // p loops over SOs
             int sign_p = 1;  // sign of the operator a_p
 
-            if (spin_string_beta_bbbb.annihilate(p, sign_p)) {  // if p is not in I_beta
+            if (spin_string_beta_bbbb.annihilate_unchecked(p, sign_p)) {  // if p is not in I_beta
 
                 for (size_t r = 0; r < K; r++) {  // r loops over SOs
                     int sign_pr = sign_p;  // sign of the operator a_r a_p
 
-                    if (spin_string_beta_bbbb.annihilate(r, sign_pr)) {  // if r is not in I_beta
+                    if (spin_string_beta_bbbb.annihilate_unchecked(r, sign_pr)) {  // if r is not in I_beta
 
                         for (size_t s = 0; s < K; s++) {  // s loops over SOs
                             int sign_prs = sign_pr;  // sign of the operator a^dagger_s a_r a_p
 
-                            if (spin_string_beta_bbbb.create(s, sign_prs)) {  // if s is in I_beta
+                            if (spin_string_beta_bbbb.create_unchecked(s, sign_prs)) {  // if s is in I_beta
 
                                 for (size_t q = 0; q < K; q++) {  // q loops over SOs
                                     int sign_prsq = sign_prs;  // sign of the operator a^dagger_q a^dagger_s a_r a_p
 
-                                    if (spin_string_beta_bbbb.create(q, sign_prsq)) {  // if q is not in I_beta
+                                    if (spin_string_beta_bbbb.create_unchecked(q, sign_prsq)) {  // if q is not in I_beta
                                         size_t J_beta = fock_space_beta.getAddress(spin_string_beta_bbbb);  // address of the coupling string
 
                                         double contribution = 0.0;
-                                        for (size_t I_alpha = 0; I_alpha < dim_beta; I_alpha++) {
+                                        for (size_t I_alpha = 0; I_alpha < dim_alpha; I_alpha++) {
                                             double c_I_alpha_I_beta = x(I_alpha*dim_beta + I_beta);  // alpha addresses are 'major'
                                             double c_I_alpha_J_beta = x(I_alpha*dim_beta + J_beta);
                                             contribution += c_I_alpha_I_beta * c_I_alpha_J_beta;
@@ -342,24 +304,24 @@ TwoRDMs FCIRDMBuilder::calculate2RDMs(const Eigen::VectorXd& x) {
 
                                         d_bbbb(p,q,r,s) += sign_prsq * contribution;
 
-                                        spin_string_beta_bbbb.annihilate(q);  // undo the previous creation
+                                        spin_string_beta_bbbb.annihilate_unchecked(q);  // undo the previous creation
                                     }
                                 }  // loop over q
 
-                                spin_string_beta_bbbb.annihilate(s);  // undo the previous creation
+                                spin_string_beta_bbbb.annihilate_unchecked(s);  // undo the previous creation
                             }
                         }  // loop over s
 
-                        spin_string_beta_bbbb.create(r);  // undo the previous annihilation
+                        spin_string_beta_bbbb.create_unchecked(r);  // undo the previous annihilation
                     }
                 }  // loop over r
 
-                spin_string_beta_bbbb.create(p);  // undo the previous annihilation
+                spin_string_beta_bbbb.create_unchecked(p);  // undo the previous annihilation
             }
         }  // loop over p
 
         if (I_beta < dim_beta - 1) {  // prevent the last permutation to occur
-            fock_space_beta.setNext(spin_string_beta_bbbb);
+            fock_space_beta.setNext(spin_string_beta_bbbb, I_beta);
         }
 
     }  // loop over I_beta
@@ -372,4 +334,57 @@ TwoRDMs FCIRDMBuilder::calculate2RDMs(const Eigen::VectorXd& x) {
 }
 
 
+/*
+ *  PUBLIC METHODS
+ */
+
+/**
+ *  @param x        the coefficient vector representing the FCI wave function
+ *
+ *  @return the K x K matrix of the (spin-summed) 2-RDM elements d_ppqq = <n_p n_q> - delta_pq <n_p>, which is all the energy of a model Hamiltonian with on-site and inter-site repulsions requires
+ *
+ *  Since the occupation number operators are diagonal in the ONV basis, only the weights |x_I|^2 contribute, and the K^4 2-RDM is never constructed
+ */
+Eigen::MatrixXd FCIRDMBuilder::calculateDensityDensity2RDM(const Eigen::VectorXd& x) const {
+
+    size_t K = this->fock_space.get_K();
+    const FockSpace& fock_space_alpha = this->fock_space.get_fock_space_alpha();
+    const FockSpace& fock_space_beta = this->fock_space.get_fock_space_beta();
+    size_t dim_alpha = fock_space_alpha.get_dimension();
+    size_t dim_beta = fock_space_beta.get_dimension();
+
+    if (static_cast<size_t>(x.size()) != this->fock_space.get_dimension()) {
+        throw std::invalid_argument("FCIRDMBuilder::calculateDensityDensity2RDM(): The coefficient vector is incompatible with the Fock space.");
+    }
+
+    // The occupation numbers of all alpha and beta strings, as rows
+    Eigen::MatrixXd A = Eigen::MatrixXd::Zero(dim_alpha, K);
+    Eigen::MatrixXd B = Eigen::MatrixXd::Zero(dim_beta, K);
+    for (size_t I_alpha = 0; I_alpha < dim_alpha; I_alpha++) {
+        ONV spin_string_alpha = fock_space_alpha.get_ONV(I_alpha);
+        for (size_t p = 0; p < K; p++) {
+            A(I_alpha, p) = spin_string_alpha.isOccupied(p);
+        }
+    }
+    for (size_t I_beta = 0; I_beta < dim_beta; I_beta++) {
+        ONV spin_string_beta = fock_space_beta.get_ONV(I_beta);
+        for (size_t p = 0; p < K; p++) {
+            B(I_beta, p) = spin_string_beta.isOccupied(p);
+        }
+    }
+
+    // With the weights W(I_alpha, I_beta) = |x_I|^2 and n_p = n_p,alpha + n_p,beta, sum_I W_I n_p n_q can be written in terms of A, B and W only
+    Eigen::VectorXd weights = x.cwiseAbs2();
+    Eigen::Map<const Eigen::MatrixXd> W_transposed (weights.data(), dim_beta, dim_alpha);  // the address is I = I_alpha * dim_beta + I_beta
+    Eigen::VectorXd alpha_weights = W_transposed.colwise().sum().transpose();
+    Eigen::VectorXd beta_weights = W_transposed.rowwise().sum();
+
+    Eigen::MatrixXd AT_W_B = A.transpose() * W_transposed.transpose() * B;
+    Eigen::MatrixXd n_p_n_q = A.transpose() * alpha_weights.asDiagonal() * A + AT_W_B + AT_W_B.transpose() + B.transpose() * beta_weights.asDiagonal() * B;
+    Eigen::VectorXd n_p = A.transpose() * alpha_weights + B.transpose() * beta_weights;
+
+    return n_p_n_q - Eigen::MatrixXd(n_p.asDiagonal());
+}
+
+
 }  // namespace GQCP
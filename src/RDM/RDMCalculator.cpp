@@ -26,6 +26,25 @@
 namespace GQCP {
 
 
+/*
+ *  PRIVATE METHODS
+ */
+
+/**
+ *  Throw if the given sparse wave function doesn't live in a Fock space of the same type and dimension as the one of this RDMCalculator
+ *
+ *  @param wave_function        the sparse wave function
+ */
+void RDMCalculator::checkCompatibility(const SparseWaveFunction& wave_function) {
+
+    auto fock_space = this->rdm_builder->get_fock_space();
+    if ((wave_function.get_fock_space().get_type() != fock_space->get_type()) || (wave_function.get_fock_space().get_dimension() != fock_space->get_dimension())) {
+        throw std::invalid_argument("The sparse wave function does not live in the Fock space of this RDMCalculator.");
+    }
+}
+
+
+
 /*
  *  CONSTRUCTOR
  */
@@ -86,6 +105,10 @@ RDMCalculator::RDMCalculator(const BaseFockSpace& fock_space) {
 
             break;
         }
+
+        default: {
+            throw std::invalid_argument("There is no RDMBuilder for the given type of Fock space.");
+        }
     }
 
 }
@@ -116,4 +139,34 @@ TwoRDMs RDMCalculator::calculate2RDMs(const Eigen::VectorXd& x) {
 }
 
 
+/**
+ *  @param wave_function        the sparse wave function, which should live in the Fock space of this RDMCalculator
+ *
+ *  @return all 1-RDMs of the sparse wave function, in which only the retained configurations contribute
+ */
+OneRDMs RDMCalculator::calculate1RDMs(const SparseWaveFunction& wave_function) {
+
+    this->checkCompatibility(wave_function);
+
+    // The retained configurations span a selected Fock space, whose RDM builder only visits coupled pairs of them
+    SelectedRDMBuilder selected_rdm_builder (wave_function.constructSelectedFockSpace());
+    return selected_rdm_builder.calculate1RDMs(wave_function.get_coefficients());
+}
+
+
+/**
+ *  @param wave_function        the sparse wave function, which should live in the Fock space of this RDMCalculator
+ *
+ *  @return all 2-RDMs of the sparse wave function, in which only the retained configurations contribute
+ */
+TwoRDMs RDMCalculator::calculate2RDMs(const SparseWaveFunction& wave_function) {
+
+    this->checkCompatibility(wave_function);
+
+    // The retained configurations span a selected Fock space, whose RDM builder only visits coupled pairs of them
+    SelectedRDMBuilder selected_rdm_builder (wave_function.constructSelectedFockSpace());
+    return selected_rdm_builder.calculate2RDMs(wave_function.get_coefficients());
+}
+
+
 }  // namespace GQCP
@@ -27,8 +27,11 @@ namespace GQCP {
  *  CONSTRUCTOR
  */
 SelectedRDMBuilder::SelectedRDMBuilder(const SelectedFockSpace& fock_space) :
-    fock_space (fock_space)
-{}
+    fock_space (fock_space),
+    canonical_fock_space (fock_space)
+{
+    this->addresses = this->canonical_fock_space.canonicalize();
+}
 
 
 /*
@@ -47,47 +50,57 @@ OneRDMs SelectedRDMBuilder::calculate1RDMs(const Eigen::VectorXd& x) {
 
     Eigen::MatrixXd D_aa = Eigen::MatrixXd::Zero(K, K);
     Eigen::MatrixXd D_bb = Eigen::MatrixXd::Zero(K, K);
-    
-    
-    size_t dim = fock_space.get_dimension();
+
+
+    size_t dim = this->canonical_fock_space.get_dimension();
 
     for (size_t I = 0; I < dim; I++) {  // loop over all addresses (1)
-        Configuration configuration_I = this->fock_space.get_configuration(I);
-        ONV alpha_I = configuration_I.onv_alpha;
-        ONV beta_I = configuration_I.onv_beta;
-        
-        double c_I = x(I);
+        const Configuration& configuration_I = this->canonical_fock_space.get_configuration(I);
+        const ONV& alpha_I = configuration_I.onv_alpha;
+        const ONV& beta_I = configuration_I.onv_beta;
+        size_t alpha_I_representation = alpha_I.get_unsigned_representation();
+        size_t beta_I_representation = beta_I.get_unsigned_representation();
 
+        double c_I = x(this->addresses[I]);
 
-        // Calculate the diagonal of the 1-RDMs
-        for (size_t p = 0; p < K; p++) {
 
-            if (alpha_I.isOccupied(p)) {
-                D_aa(p,p) += std::pow(c_I, 2);
-            }
+        // Calculate the diagonal of the 1-RDMs
+        for (size_t occupied = alpha_I_representation; occupied != 0; occupied &= occupied - 1) {
+            size_t p = __builtin_ctzl(occupied);
+            D_aa(p,p) += c_I * c_I;
+        }
 
-            if (beta_I.isOccupied(p)) {
-                D_bb(p,p) += std::pow(c_I, 2);
-            }
+        for (size_t occupied = beta_I_representation; occupied != 0; occupied &= occupied - 1) {
+            size_t p = __builtin_ctzl(occupied);
+            D_bb(p,p) += c_I * c_I;
         }
 
 
-        // Calculate the off-diagonal elements, by going over all other ONVs
-        for (size_t J = I+1; J < dim; J++) {
+        // Calculate the off-diagonal elements, by going over all coupled ONVs
+        this->canonical_fock_space.forEachCoupledConfiguration(I, [&] (size_t J) {
+
+            if (J < I) {
+                return;  // every pair of configurations is handled once
+            }
+
+            const Configuration& configuration_J = this->canonical_fock_space.get_configuration(J);
+            const ONV& alpha_J = configuration_J.onv_alpha;
+            const ONV& beta_J = configuration_J.onv_beta;
+            size_t alpha_J_representation = alpha_J.get_unsigned_representation();
+            size_t beta_J_representation = beta_J.get_unsigned_representation();
 
-            Configuration configuration_J = this->fock_space.get_configuration(J);
-            ONV alpha_J = configuration_J.onv_alpha;
-            ONV beta_J = configuration_J.onv_beta;
+            double c_J = x(this->addresses[J]);
 
-            double c_J = x(J);
+            size_t alpha_differences = __builtin_popcountl(alpha_I_representation ^ alpha_J_representation);
+            size_t beta_differences = __builtin_popcountl(beta_I_representation ^ beta_J_representation);
 
 
             // 1 electron excitation in alpha (i.e. 2 differences), 0 in beta
-            if ((alpha_I.countNumberOfDifferences(alpha_J) == 2) && (beta_I.countNumberOfDifferences(beta_J) == 0)) {
+            if ((alpha_differences == 2) && (beta_differences == 0)) {
 
                 // Find the orbitals that are occupied in one string, and aren't in the other
-                size_t p = alpha_I.findDifferentOccupations(alpha_J)[0];  // we're sure that there is only 1 element in the std::vector<size_t>
-                size_t q = alpha_J.findDifferentOccupations(alpha_I)[0];  // we're sure that there is only 1 element in the std::vector<size_t>
+                size_t p = __builtin_ctzl(alpha_I_representation & ~alpha_J_representation);
+                size_t q = __builtin_ctzl(alpha_J_representation & ~alpha_I_representation);
 
                 // Calculate the total sign, and include it in the RDM contribution
                 int sign = alpha_I.operatorPhaseFactor(p) * alpha_J.operatorPhaseFactor(q);
@@ -97,19 +110,18 @@ OneRDMs SelectedRDMBuilder::calculate1RDMs(const Eigen::VectorXd& x) {
 
 
             // 1 electron excitation in beta, 0 in alpha
-            if ((alpha_I.countNumberOfDifferences(alpha_J) == 0) && (beta_I.countNumberOfDifferences(beta_J) == 2)) {
+            if ((alpha_differences == 0) && (beta_differences == 2)) {
 
                 // Find the orbitals that are occupied in one string, and aren't in the other
-                size_t p = beta_I.findDifferentOccupations(beta_J)[0];  // we're sure that there is only 1 element in the std::vector<size_t>
-                size_t q = beta_J.findDifferentOccupations(beta_I)[0];  // we're sure that there is only 1 element in the std::vector<size_t>
+                size_t p = __builtin_ctzl(beta_I_representation & ~beta_J_representation);
+                size_t q = __builtin_ctzl(beta_J_representation & ~beta_I_representation);
 
                 // Calculate the total sign, and include it in the RDM contribution
                 int sign = beta_I.operatorPhaseFactor(p) * beta_J.operatorPhaseFactor(q);
                 D_bb(p,q) += sign * c_I * c_J;
                 D_bb(q,p) += sign * c_I * c_J;
             }
-
-        }  // loop over addresses J > I
+        });  // loop over coupled addresses J > I
     }  // loop over addresses I
 
     OneRDM one_rdm_aa (D_aa);
@@ -126,12 +138,11 @@ OneRDMs SelectedRDMBuilder::calculate1RDMs(const Eigen::VectorXd& x) {
  */
 TwoRDMs SelectedRDMBuilder::calculate2RDMs(const Eigen::VectorXd& x) {
 
-    
     // Initialize as zero matrices
     size_t K = this->fock_space.get_K();
 
-    size_t dim = fock_space.get_dimension();
-    
+    size_t dim = this->canonical_fock_space.get_dimension();
+
     Eigen::Tensor<double, 4> d_aaaa (K,K,K,K);
     d_aaaa.setZero();
     Eigen::Tensor<double, 4> d_aabb (K,K,K,K);
@@ -143,214 +154,213 @@ TwoRDMs SelectedRDMBuilder::calculate2RDMs(const Eigen::VectorXd& x) {
 
     for (size_t I = 0; I < dim; I++) {  // loop over all addresses I
 
-        Configuration configuration_I = this->fock_space.get_configuration(I);
-        ONV alpha_I = configuration_I.onv_alpha;
-        ONV beta_I = configuration_I.onv_beta;
-
-        double c_I = x(I);
-        
-        for (size_t p = 0; p < K; p++) {
-
-            // 'Diagonal' elements of the 2-RDM: aaaa and aabb
-            if (alpha_I.isOccupied(p)) {
-                for (size_t q = 0; q < K; q++) {
-                    if (beta_I.isOccupied(q)) {
-                        d_aabb(p,p,q,q) += std::pow(c_I, 2);
-                    }
-
-                    if (p != q) {  // can't create/annihilate the same orbital twice
-                        if (alpha_I.isOccupied(q)) {
-                            d_aaaa(p,p,q,q) += std::pow(c_I, 2);
-                            d_aaaa(p,q,q,p) -= std::pow(c_I, 2);
-                        }
-                    }
-
-                }  // loop over q
+        const Configuration& configuration_I = this->canonical_fock_space.get_configuration(I);
+        const ONV& alpha_I = configuration_I.onv_alpha;
+        const ONV& beta_I = configuration_I.onv_beta;
+        size_t alpha_I_representation = alpha_I.get_unsigned_representation();
+        size_t beta_I_representation = beta_I.get_unsigned_representation();
+
+        double c_I = x(this->addresses[I]);
+        double c_I_2 = c_I * c_I;
+
+
+        // 'Diagonal' elements of the 2-RDM: aaaa and aabb
+        for (size_t occupied_p = alpha_I_representation; occupied_p != 0; occupied_p &= occupied_p - 1) {
+            size_t p = __builtin_ctzl(occupied_p);
+
+            for (size_t occupied_q = beta_I_representation; occupied_q != 0; occupied_q &= occupied_q - 1) {
+                size_t q = __builtin_ctzl(occupied_q);
+                d_aabb(p,p,q,q) += c_I_2;
             }
 
-            // 'Diagonal' elements of the 2-RDM: bbbb and bbaa
-            if (beta_I.isOccupied(p)) {
-                for (size_t q = 0; q < K; q++) {
-                    if (alpha_I.isOccupied(q)) {
-                        d_bbaa(p,p,q,q) += std::pow(c_I, 2);
-                    }
-
-                    if (p != q) {  // can't create/annihilate the same orbital twice
-                        if (beta_I.isOccupied(q)) {
-                            d_bbbb(p,p,q,q) += std::pow(c_I, 2);
-                            d_bbbb(p,q,q,p) -= std::pow(c_I, 2);
-                        }
-                    }
-                }  // loop over q
+            for (size_t occupied_q = alpha_I_representation & ~(1UL << p); occupied_q != 0; occupied_q &= occupied_q - 1) {  // can't create/annihilate the same orbital twice
+                size_t q = __builtin_ctzl(occupied_q);
+                d_aaaa(p,p,q,q) += c_I_2;
+                d_aaaa(p,q,q,p) -= c_I_2;
             }
-        }  // loop over q
+        }
 
+        // 'Diagonal' elements of the 2-RDM: bbbb and bbaa
+        for (size_t occupied_p = beta_I_representation; occupied_p != 0; occupied_p &= occupied_p - 1) {
+            size_t p = __builtin_ctzl(occupied_p);
 
-        for (size_t J = I+1; J < dim; J++) {
+            for (size_t occupied_q = alpha_I_representation; occupied_q != 0; occupied_q &= occupied_q - 1) {
+                size_t q = __builtin_ctzl(occupied_q);
+                d_bbaa(p,p,q,q) += c_I_2;
+            }
 
-            Configuration configuration_J = this->fock_space.get_configuration(J);
-            ONV alpha_J = configuration_J.onv_alpha;
-            ONV beta_J = configuration_J.onv_beta;
+            for (size_t occupied_q = beta_I_representation & ~(1UL << p); occupied_q != 0; occupied_q &= occupied_q - 1) {  // can't create/annihilate the same orbital twice
+                size_t q = __builtin_ctzl(occupied_q);
+                d_bbbb(p,p,q,q) += c_I_2;
+                d_bbbb(p,q,q,p) -= c_I_2;
+            }
+        }
 
-            double c_J = x(J);
 
-            // 1 electron excitation in alpha, 0 in beta
-            if ((alpha_I.countNumberOfDifferences(alpha_J) == 2) && (beta_I.countNumberOfDifferences(beta_J) == 0)) {
+        this->canonical_fock_space.forEachCoupledConfiguration(I, [&] (size_t J) {
 
-                // Find the orbitals that are occupied in one string, and aren't in the other
-                size_t p = alpha_I.findDifferentOccupations(alpha_J)[0];  // we're sure that there is only 1 element in the std::vector<size_t>
-                size_t q = alpha_J.findDifferentOccupations(alpha_I)[0];  // we're sure that there is only 1 element in the std::vector<size_t>
+            if (J < I) {
+                return;  // every pair of configurations is handled once
+            }
 
-                // Calculate the total sign
-                int sign = alpha_I.operatorPhaseFactor(p) * alpha_J.operatorPhaseFactor(q);
+            const Configuration& configuration_J = this->canonical_fock_space.get_configuration(J);
+            const ONV& alpha_J = configuration_J.onv_alpha;
+            const ONV& beta_J = configuration_J.onv_beta;
+            size_t alpha_J_representation = alpha_J.get_unsigned_representation();
+            size_t beta_J_representation = beta_J.get_unsigned_representation();
 
+            double c_J = x(this->addresses[J]);
 
-                for (size_t r = 0; r < K; r++) {  // r loops over spatial orbitals
+            size_t alpha_differences = __builtin_popcountl(alpha_I_representation ^ alpha_J_representation);
+            size_t beta_differences = __builtin_popcountl(beta_I_representation ^ beta_J_representation);
 
-                    if (alpha_I.isOccupied(r) && alpha_J.isOccupied(r)) {  // r must be occupied on the left and on the right
-                        if ((p != r) && (q != r)) {  // can't create or annihilate the same orbital
-                            // Fill in the 2-RDM contributions
-                            d_aaaa(p,q,r,r) += sign * c_I * c_J;
-                            d_aaaa(r,q,p,r) -= sign * c_I * c_J;
-                            d_aaaa(p,r,r,q) -= sign * c_I * c_J;
-                            d_aaaa(r,r,p,q) += sign * c_I * c_J;
+            // The orbitals that are occupied in one string, and aren't in the other
+            size_t alpha_I_only = alpha_I_representation & ~alpha_J_representation;
+            size_t alpha_J_only = alpha_J_representation & ~alpha_I_representation;
+            size_t beta_I_only = beta_I_representation & ~beta_J_representation;
+            size_t beta_J_only = beta_J_representation & ~beta_I_representation;
 
-                            d_aaaa(q,p,r,r) += sign * c_I * c_J;
-                            d_aaaa(q,r,r,p) -= sign * c_I * c_J;
-                            d_aaaa(r,p,q,r) -= sign * c_I * c_J;
-                            d_aaaa(r,r,q,p) += sign * c_I * c_J;
-                        }
-                    }
 
-                    if (beta_I.isOccupied(r)) {  // beta_I == beta_J from the previous if-branch
+            // 1 electron excitation in alpha, 0 in beta
+            if ((alpha_differences == 2) && (beta_differences == 0)) {
 
-                        // Fill in the 2-RDM contributions
-                        d_aabb(p,q,r,r) += sign * c_I * c_J;
-                        d_aabb(q,p,r,r) += sign * c_I * c_J;
+                size_t p = __builtin_ctzl(alpha_I_only);
+                size_t q = __builtin_ctzl(alpha_J_only);
 
-                        d_bbaa(r,r,p,q) += sign * c_I * c_J;
-                        d_bbaa(r,r,q,p) += sign * c_I * c_J;
-                    }
+                // Calculate the total sign
+                double value = alpha_I.operatorPhaseFactor(p) * alpha_J.operatorPhaseFactor(q) * c_I * c_J;
+
+                // r must be occupied on the left and on the right, so it differs from p and q
+                for (size_t occupied_r = alpha_I_representation & alpha_J_representation; occupied_r != 0; occupied_r &= occupied_r - 1) {
+                    size_t r = __builtin_ctzl(occupied_r);
+
+                    // Fill in the 2-RDM contributions
+                    d_aaaa(p,q,r,r) += value;
+                    d_aaaa(r,q,p,r) -= value;
+                    d_aaaa(p,r,r,q) -= value;
+                    d_aaaa(r,r,p,q) += value;
+
+                    d_aaaa(q,p,r,r) += value;
+                    d_aaaa(q,r,r,p) -= value;
+                    d_aaaa(r,p,q,r) -= value;
+                    d_aaaa(r,r,q,p) += value;
                 }
-            }
 
+                for (size_t occupied_r = beta_I_representation; occupied_r != 0; occupied_r &= occupied_r - 1) {  // beta_I == beta_J
+                    size_t r = __builtin_ctzl(occupied_r);
 
-            // 0 electron excitations in alpha, 1 in beta
-            if ((alpha_I.countNumberOfDifferences(alpha_J) == 0) && (beta_I.countNumberOfDifferences(beta_J) == 2)) {
-
-                // Find the orbitals that are occupied in one string, and aren't in the other
-                size_t p = beta_I.findDifferentOccupations(beta_J)[0];  // we're sure that there is only 1 element in the std::vector<size_t>
-                size_t q = beta_J.findDifferentOccupations(beta_I)[0];  // we're sure that there is only 1 element in the std::vector<size_t>
+                    // Fill in the 2-RDM contributions
+                    d_aabb(p,q,r,r) += value;
+                    d_aabb(q,p,r,r) += value;
 
-                // Calculate the total sign
-                int sign = beta_I.operatorPhaseFactor(p) * beta_J.operatorPhaseFactor(q);
+                    d_bbaa(r,r,p,q) += value;
+                    d_bbaa(r,r,q,p) += value;
+                }
+            }
 
 
-                for (size_t r = 0; r < K; r++) {  // r loops over spatial orbitals
+            // 0 electron excitations in alpha, 1 in beta
+            if ((alpha_differences == 0) && (beta_differences == 2)) {
 
-                    if (beta_I.isOccupied(r) && beta_J.isOccupied(r)) {  // r must be occupied on the left and on the right
-                        if ((p != r) && (q != r)) {  // can't create or annihilate the same orbital
-                            // Fill in the 2-RDM contributions
-                            d_bbbb(p,q,r,r) += sign * c_I * c_J;
-                            d_bbbb(r,q,p,r) -= sign * c_I * c_J;
-                            d_bbbb(p,r,r,q) -= sign * c_I * c_J;
-                            d_bbbb(r,r,p,q) += sign * c_I * c_J;
+                size_t p = __builtin_ctzl(beta_I_only);
+                size_t q = __builtin_ctzl(beta_J_only);
 
-                            d_bbbb(q,p,r,r) += sign * c_I * c_J;
-                            d_bbbb(q,r,r,p) -= sign * c_I * c_J;
-                            d_bbbb(r,p,q,r) -= sign * c_I * c_J;
-                            d_bbbb(r,r,q,p) += sign * c_I * c_J;
-                        }
-                    }
+                // Calculate the total sign
+                double value = beta_I.operatorPhaseFactor(p) * beta_J.operatorPhaseFactor(q) * c_I * c_J;
+
+                // r must be occupied on the left and on the right, so it differs from p and q
+                for (size_t occupied_r = beta_I_representation & beta_J_representation; occupied_r != 0; occupied_r &= occupied_r - 1) {
+                    size_t r = __builtin_ctzl(occupied_r);
+
+                    // Fill in the 2-RDM contributions
+                    d_bbbb(p,q,r,r) += value;
+                    d_bbbb(r,q,p,r) -= value;
+                    d_bbbb(p,r,r,q) -= value;
+                    d_bbbb(r,r,p,q) += value;
+
+                    d_bbbb(q,p,r,r) += value;
+                    d_bbbb(q,r,r,p) -= value;
+                    d_bbbb(r,p,q,r) -= value;
+                    d_bbbb(r,r,q,p) += value;
+                }
 
-                    if (alpha_I.isOccupied(r)) {  // alpha_I == alpha_J from the previous if-branch
+                for (size_t occupied_r = alpha_I_representation; occupied_r != 0; occupied_r &= occupied_r - 1) {  // alpha_I == alpha_J
+                    size_t r = __builtin_ctzl(occupied_r);
 
-                        // Fill in the 2-RDM contributions
-                        d_bbaa(p,q,r,r) += sign * c_I * c_J;
-                        d_bbaa(q,p,r,r) += sign * c_I * c_J;
+                    // Fill in the 2-RDM contributions
+                    d_bbaa(p,q,r,r) += value;
+                    d_bbaa(q,p,r,r) += value;
 
-                        d_aabb(r,r,p,q) += sign * c_I * c_J;
-                        d_aabb(r,r,q,p) += sign * c_I * c_J;
-                    }
+                    d_aabb(r,r,p,q) += value;
+                    d_aabb(r,r,q,p) += value;
                 }
             }
 
 
             // 1 electron excitation in alpha, 1 in beta
-            if ((alpha_I.countNumberOfDifferences(alpha_J) == 2) && (beta_I.countNumberOfDifferences(beta_J) == 2)) {
+            if ((alpha_differences == 2) && (beta_differences == 2)) {
 
-                // Find the orbitals that are occupied in one string, and aren't in the other
-                size_t p = alpha_I.findDifferentOccupations(alpha_J)[0];  // we're sure that there is only 1 element in the std::vector<size_t>
-                size_t q = alpha_J.findDifferentOccupations(alpha_I)[0];  // we're sure that there is only 1 element in the std::vector<size_t>
+                size_t p = __builtin_ctzl(alpha_I_only);
+                size_t q = __builtin_ctzl(alpha_J_only);
 
-                size_t r = beta_I.findDifferentOccupations(beta_J)[0];  // we're sure that there is only 1 element in the std::vector<size_t>
-                size_t s = beta_J.findDifferentOccupations(beta_I)[0];  // we're sure that there is only 1 element in the std::vector<size_t>
+                size_t r = __builtin_ctzl(beta_I_only);
+                size_t s = __builtin_ctzl(beta_J_only);
 
                 // Calculate the total sign, and include it in the 2-RDM contribution
-                int sign = alpha_I.operatorPhaseFactor(p) * alpha_J.operatorPhaseFactor(q) * beta_I.operatorPhaseFactor(r) * beta_J.operatorPhaseFactor(s);
-                d_aabb(p,q,r,s) += sign * c_I * c_J;
-                d_aabb(q,p,s,r) += sign * c_I * c_J;
+                double value = alpha_I.operatorPhaseFactor(p) * alpha_J.operatorPhaseFactor(q) * beta_I.operatorPhaseFactor(r) * beta_J.operatorPhaseFactor(s) * c_I * c_J;
+                d_aabb(p,q,r,s) += value;
+                d_aabb(q,p,s,r) += value;
 
-                d_bbaa(r,s,p,q) += sign * c_I * c_J;
-                d_bbaa(s,r,q,p) += sign * c_I * c_J;
+                d_bbaa(r,s,p,q) += value;
+                d_bbaa(s,r,q,p) += value;
             }
 
 
             // 2 electron excitations in alpha, 0 in beta
-            if ((alpha_I.countNumberOfDifferences(alpha_J) == 4) && (beta_I.countNumberOfDifferences(beta_J) == 0)) {
+            if ((alpha_differences == 4) && (beta_differences == 0)) {
 
-                // Find the orbitals that are occupied in one string, and aren't in the other
-                std::vector<size_t> occupied_indices_I = alpha_I.findDifferentOccupations(alpha_J);  // we're sure this has two elements
-                size_t p = occupied_indices_I[0];
-                size_t r = occupied_indices_I[1];
-
-                std::vector<size_t> occupied_indices_J = alpha_J.findDifferentOccupations(alpha_I);  // we're sure this has two elements
-                size_t q = occupied_indices_J[0];
-                size_t s = occupied_indices_J[1];
+                size_t p = __builtin_ctzl(alpha_I_only);
+                size_t r = __builtin_ctzl(alpha_I_only & (alpha_I_only - 1));
 
+                size_t q = __builtin_ctzl(alpha_J_only);
+                size_t s = __builtin_ctzl(alpha_J_only & (alpha_J_only - 1));
 
                 // Calculate the total sign, and include it in the 2-RDM contribution
-                int sign = alpha_I.operatorPhaseFactor(p) * alpha_I.operatorPhaseFactor(r) * alpha_J.operatorPhaseFactor(q) * alpha_J.operatorPhaseFactor(s);
-                d_aaaa(p,q,r,s) += sign * c_I * c_J;
-                d_aaaa(p,s,r,q) -= sign * c_I * c_J;
-                d_aaaa(r,q,p,s) -= sign * c_I * c_J;
-                d_aaaa(r,s,p,q) += sign * c_I * c_J;
-
-                d_aaaa(q,p,s,r) += sign * c_I * c_J;
-                d_aaaa(s,p,q,r) -= sign * c_I * c_J;
-                d_aaaa(q,r,s,p) -= sign * c_I * c_J;
-                d_aaaa(s,r,q,p) += sign * c_I * c_J;
+                double value = alpha_I.operatorPhaseFactor(p) * alpha_I.operatorPhaseFactor(r) * alpha_J.operatorPhaseFactor(q) * alpha_J.operatorPhaseFactor(s) * c_I * c_J;
+                d_aaaa(p,q,r,s) += value;
+                d_aaaa(p,s,r,q) -= value;
+                d_aaaa(r,q,p,s) -= value;
+                d_aaaa(r,s,p,q) += value;
+
+                d_aaaa(q,p,s,r) += value;
+                d_aaaa(s,p,q,r) -= value;
+                d_aaaa(q,r,s,p) -= value;
+                d_aaaa(s,r,q,p) += value;
             }
 
 
             // 0 electron excitations in alpha, 2 in beta
-            if ((alpha_I.countNumberOfDifferences(alpha_J) == 0) && (beta_I.countNumberOfDifferences(beta_J) == 4)) {
-
-                // Find the orbitals that are occupied in one string, and aren't in the other
-                std::vector<size_t> occupied_indices_I = beta_I.findDifferentOccupations(beta_J);  // we're sure this has two elements
-                size_t p = occupied_indices_I[0];
-                size_t r = occupied_indices_I[1];
+            if ((alpha_differences == 0) && (beta_differences == 4)) {
 
-                std::vector<size_t> occupied_indices_J = beta_J.findDifferentOccupations(beta_I);  // we're sure this has two elements
-                size_t q = occupied_indices_J[0];
-                size_t s = occupied_indices_J[1];
+                size_t p = __builtin_ctzl(beta_I_only);
+                size_t r = __builtin_ctzl(beta_I_only & (beta_I_only - 1));
 
+                size_t q = __builtin_ctzl(beta_J_only);
+                size_t s = __builtin_ctzl(beta_J_only & (beta_J_only - 1));
 
                 // Calculate the total sign, and include it in the 2-RDM contribution
-                int sign = beta_I.operatorPhaseFactor(p) * beta_I.operatorPhaseFactor(r) * beta_J.operatorPhaseFactor(q) * beta_J.operatorPhaseFactor(s);
-                d_bbbb(p,q,r,s) += sign * c_I * c_J;
-                d_bbbb(p,s,r,q) -= sign * c_I * c_J;
-                d_bbbb(r,q,p,s) -= sign * c_I * c_J;
-                d_bbbb(r,s,p,q) += sign * c_I * c_J;
-
-                d_bbbb(q,p,s,r) += sign * c_I * c_J;
-                d_bbbb(s,p,q,r) -= sign * c_I * c_J;
-                d_bbbb(q,r,s,p) -= sign * c_I * c_J;
-                d_bbbb(s,r,q,p) += sign * c_I * c_J;
+                double value = beta_I.operatorPhaseFactor(p) * beta_I.operatorPhaseFactor(r) * beta_J.operatorPhaseFactor(q) * beta_J.operatorPhaseFactor(s) * c_I * c_J;
+                d_bbbb(p,q,r,s) += value;
+                d_bbbb(p,s,r,q) -= value;
+                d_bbbb(r,q,p,s) -= value;
+                d_bbbb(r,s,p,q) += value;
+
+                d_bbbb(q,p,s,r) += value;
+                d_bbbb(s,p,q,r) -= value;
+                d_bbbb(q,r,s,p) -= value;
+                d_bbbb(s,r,q,p) += value;
             }
-
-        }  // loop over all addresses J > I
-
+        });  // loop over coupled addresses J > I
     }  // loop over all addresses I
 
     TwoRDM two_rdm_aaaa (d_aaaa);
@@ -0,0 +1,68 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2018  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#include "WaveFunction/BinaryWaveFunctionFormat.hpp"
+
+#include <cstring>
+
+
+namespace GQCP {
+
+
+constexpr uint32_t BinaryWaveFunctionHeader::current_version;
+constexpr uint64_t BinaryWaveFunctionHeader::initial_checksum;
+
+
+/*
+ *  CONSTRUCTORS
+ */
+
+/**
+ *  @param K            the number of orbitals
+ *  @param N_alpha      the number of alpha electrons
+ *  @param N_beta       the number of beta electrons
+ *
+ *  Construct the header of a file that doesn't contain any configurations yet
+ */
+BinaryWaveFunctionHeader::BinaryWaveFunctionHeader(size_t K, size_t N_alpha, size_t N_beta) :
+    version (BinaryWaveFunctionHeader::current_version),
+    words_per_string (static_cast<uint32_t>((K + 63) / 64)),
+    K (K),
+    N_alpha (N_alpha),
+    N_beta (N_beta),
+    number_of_configurations (0),
+    configuration_checksum (BinaryWaveFunctionHeader::initial_checksum),
+    coefficient_checksum (BinaryWaveFunctionHeader::initial_checksum)
+{
+    std::memcpy(this->magic, "GQCPWFN", sizeof(this->magic));
+}
+
+
+
+/*
+ *  PUBLIC METHODS
+ */
+
+/**
+ *  @return if the header starts with the magic characters of the format
+ */
+bool BinaryWaveFunctionHeader::hasValidMagic() const {
+    return std::memcmp(this->magic, "GQCPWFN", sizeof(this->magic)) == 0;
+}
+
+
+}  // namespace GQCP
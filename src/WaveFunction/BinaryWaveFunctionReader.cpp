@@ -0,0 +1,124 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2018  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#include "WaveFunction/BinaryWaveFunctionReader.hpp"
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace GQCP {
+
+
+/*
+ *  CONSTRUCTORS
+ */
+
+/**
+ *  @param filename     the name of the binary file that contains the 'selected' wave function expansion
+ */
+BinaryWaveFunctionReader::BinaryWaveFunctionReader(const std::string& filename) {
+
+    // Map the whole file into memory
+    int file_descriptor = ::open(filename.c_str(), O_RDONLY);
+    if (file_descriptor < 0) {
+        throw std::runtime_error("BinaryWaveFunctionReader(): The provided binary file is illegible. Maybe you specified a wrong path?");
+    }
+
+    struct stat file_status;
+    if ((::fstat(file_descriptor, &file_status) != 0) || (static_cast<size_t>(file_status.st_size) < sizeof(BinaryWaveFunctionHeader))) {
+        ::close(file_descriptor);
+        throw std::invalid_argument("BinaryWaveFunctionReader(): The provided file is too small to be a binary wave function file.");
+    }
+    size_t file_size = static_cast<size_t>(file_status.st_size);
+
+    void* mapping = ::mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+    ::close(file_descriptor);  // the mapping stays valid
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("BinaryWaveFunctionReader(): The provided binary file could not be memory-mapped.");
+    }
+    ::madvise(mapping, file_size, MADV_SEQUENTIAL);
+    const char* data = static_cast<const char*>(mapping);
+
+
+    try {
+
+        // Validate the header
+        BinaryWaveFunctionHeader header;
+        std::memcpy(&header, data, sizeof(header));
+
+        if (!header.hasValidMagic()) {
+            throw std::invalid_argument("BinaryWaveFunctionReader(): The provided file is not a binary wave function file.");
+        }
+
+        if (header.version != BinaryWaveFunctionHeader::current_version) {
+            throw std::invalid_argument("BinaryWaveFunctionReader(): The version of the provided binary wave function file is not supported.");
+        }
+
+        if ((header.words_per_string != 1) || (header.K > 64)) {
+            throw std::invalid_argument("BinaryWaveFunctionReader(): Configurations with more than 64 orbitals are not supported.");
+        }
+
+        size_t payload_size = file_size - sizeof(header);
+        if ((payload_size % header.get_record_size() != 0) || (payload_size / header.get_record_size() != header.number_of_configurations)) {
+            throw std::invalid_argument("BinaryWaveFunctionReader(): The size of the provided binary wave function file does not match its header: the file may be truncated or incomplete.");
+        }
+
+
+        // Read the records in a single pass
+        size_t dim = header.number_of_configurations;
+        this->fock_space = SelectedFockSpace(header.K, header.N_alpha, header.N_beta);
+        this->fock_space.reserve(dim);
+        this->coefficients = Eigen::VectorXd::Zero(dim);
+
+        uint64_t configuration_checksum = BinaryWaveFunctionHeader::initial_checksum;
+        uint64_t coefficient_checksum = BinaryWaveFunctionHeader::initial_checksum;
+
+        const char* record_pointer = data + sizeof(header);
+        for (size_t I = 0; I < dim; I++) {
+            uint64_t record[3];
+            std::memcpy(record, record_pointer, sizeof(record));
+            record_pointer += sizeof(record);
+
+            configuration_checksum = updateFNVChecksum(configuration_checksum, record[0]);
+            configuration_checksum = updateFNVChecksum(configuration_checksum, record[1]);
+            coefficient_checksum = updateFNVChecksum(coefficient_checksum, record[2]);
+
+            this->fock_space.addConfiguration(ONV(header.K, header.N_alpha, record[0]), ONV(header.K, header.N_beta, record[1]));
+            std::memcpy(&this->coefficients(I), &record[2], sizeof(double));
+        }
+
+        if ((configuration_checksum != header.configuration_checksum) || (coefficient_checksum != header.coefficient_checksum)) {
+            throw std::invalid_argument("BinaryWaveFunctionReader(): The checksums of the provided binary wave function file do not match: the file is corrupted.");
+        }
+
+    } catch (...) {
+        ::munmap(mapping, file_size);
+        throw;
+    }
+
+    ::munmap(mapping, file_size);
+
+    this->wave_function = WaveFunction(this->fock_space, this->coefficients);
+}
+
+
+}  // namespace GQCP
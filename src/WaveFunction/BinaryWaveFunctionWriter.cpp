@@ -0,0 +1,150 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2018  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#include "WaveFunction/BinaryWaveFunctionWriter.hpp"
+
+#include <cstring>
+
+
+namespace GQCP {
+
+
+/*
+ *  CONSTRUCTORS
+ */
+
+/**
+ *  @param filename     the name of the binary file that is (over)written
+ *  @param K            the number of orbitals
+ *  @param N_alpha      the number of alpha electrons
+ *  @param N_beta       the number of beta electrons
+ */
+BinaryWaveFunctionWriter::BinaryWaveFunctionWriter(const std::string& filename, size_t K, size_t N_alpha, size_t N_beta) :
+    output_file_stream (filename, std::ios::binary | std::ios::trunc),
+    header (K, N_alpha, N_beta),
+    is_open (true)
+{
+    if (!this->output_file_stream.good()) {
+        throw std::runtime_error("BinaryWaveFunctionWriter(): The provided file can't be opened for writing. Maybe you specified a wrong path?");
+    }
+
+    if (K > 64) {
+        throw std::invalid_argument("BinaryWaveFunctionWriter(): Configurations with more than 64 orbitals are not supported.");
+    }
+
+    // Reserve the space for the header, which is completed in close()
+    this->output_file_stream.write(reinterpret_cast<const char*>(&this->header), sizeof(this->header));
+}
+
+
+
+/*
+ *  DESTRUCTOR
+ */
+
+/**
+ *  Close the writer if that hasn't happened yet
+ */
+BinaryWaveFunctionWriter::~BinaryWaveFunctionWriter() {
+    if (this->is_open) {
+        try {
+            this->close();
+        } catch (...) {}  // destructors shouldn't throw: an incomplete file is rejected by the reader
+    }
+}
+
+
+
+/*
+ *  PUBLIC METHODS
+ */
+
+/**
+ *  Append a configuration and its coefficient to the file
+ *
+ *  @param configuration        the configuration
+ *  @param coefficient          the expansion coefficient of the configuration
+ */
+void BinaryWaveFunctionWriter::write(const Configuration& configuration, double coefficient) {
+
+    if (!this->is_open) {
+        throw std::logic_error("BinaryWaveFunctionWriter::write(): The writer has already been closed.");
+    }
+
+    if ((configuration.onv_alpha.get_K() != this->header.K) || (configuration.onv_alpha.get_N() != this->header.N_alpha) || (configuration.onv_beta.get_K() != this->header.K) || (configuration.onv_beta.get_N() != this->header.N_beta)) {
+        throw std::invalid_argument("BinaryWaveFunctionWriter::write(): The given configuration is not compatible with the numbers of orbitals and electrons of the file.");
+    }
+
+    uint64_t record[3];
+    record[0] = configuration.onv_alpha.get_unsigned_representation();
+    record[1] = configuration.onv_beta.get_unsigned_representation();
+    std::memcpy(&record[2], &coefficient, sizeof(double));
+
+    this->header.configuration_checksum = updateFNVChecksum(this->header.configuration_checksum, record[0]);
+    this->header.configuration_checksum = updateFNVChecksum(this->header.configuration_checksum, record[1]);
+    this->header.coefficient_checksum = updateFNVChecksum(this->header.coefficient_checksum, record[2]);
+    this->header.number_of_configurations++;
+
+    this->output_file_stream.write(reinterpret_cast<const char*>(record), sizeof(record));
+}
+
+
+/**
+ *  Complete the header and close the file
+ */
+void BinaryWaveFunctionWriter::close() {
+
+    if (!this->is_open) {
+        return;
+    }
+    this->is_open = false;
+
+    this->output_file_stream.seekp(0);
+    this->output_file_stream.write(reinterpret_cast<const char*>(&this->header), sizeof(this->header));
+    this->output_file_stream.close();
+
+    if (this->output_file_stream.fail()) {
+        throw std::runtime_error("BinaryWaveFunctionWriter::close(): The binary file could not be written.");
+    }
+}
+
+
+
+/*
+ *  STATIC PUBLIC METHODS
+ */
+
+/**
+ *  @param filename         the name of the binary file that is (over)written
+ *  @param fock_space       the selected Fock space
+ *  @param coefficients     the expansion coefficients in the selected Fock space
+ */
+void BinaryWaveFunctionWriter::writeToFile(const std::string& filename, const SelectedFockSpace& fock_space, const Eigen::VectorXd& coefficients) {
+
+    if (static_cast<size_t>(coefficients.size()) != fock_space.get_dimension()) {
+        throw std::invalid_argument("BinaryWaveFunctionWriter::writeToFile(): The number of coefficients does not match the dimension of the Fock space.");
+    }
+
+    BinaryWaveFunctionWriter writer (filename, fock_space.get_K(), fock_space.get_N_alpha(), fock_space.get_N_beta());
+    for (size_t I = 0; I < fock_space.get_dimension(); I++) {
+        writer.write(fock_space.get_configuration(I), coefficients(I));
+    }
+    writer.close();
+}
+
+
+}  // namespace GQCP
@@ -0,0 +1,175 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2018  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#include "WaveFunction/SparseWaveFunction.hpp"
+
+#include "FockSpace/FockSpace.hpp"
+#include "FockSpace/ProductFockSpace.hpp"
+
+#include <cmath>
+
+
+namespace GQCP {
+
+
+/*
+ *  CONSTRUCTORS
+ */
+
+/**
+ *  @param base_fock_space      the Fock space in which the wave function 'lives'
+ *  @param addresses            the addresses of the configurations, in increasing order
+ *  @param coefficients         the expansion coefficients of the configurations
+ */
+SparseWaveFunction::SparseWaveFunction(BaseFockSpace& base_fock_space, const std::vector<size_t>& addresses, const Eigen::VectorXd& coefficients) :
+    fock_space (&base_fock_space),
+    addresses (addresses),
+    coefficients (coefficients),
+    discarded_weight (0.0)
+{
+    if (static_cast<size_t>(coefficients.size()) != addresses.size()) {
+        throw std::invalid_argument("The number of coefficients does not match the number of addresses.");
+    }
+
+    for (size_t k = 0; k < addresses.size(); k++) {
+        if (addresses[k] >= base_fock_space.get_dimension()) {
+            throw std::invalid_argument("One of the addresses is out of the bounds of the Fock space.");
+        }
+        if ((k > 0) && (addresses[k] <= addresses[k-1])) {
+            throw std::invalid_argument("The addresses should be given in increasing order.");
+        }
+    }
+}
+
+
+/**
+ *  @param wave_function        the dense wave function
+ *  @param threshold            only the coefficients that are at least this threshold (in absolute value) are retained
+ */
+SparseWaveFunction::SparseWaveFunction(const WaveFunction& wave_function, double threshold) :
+    fock_space (&wave_function.get_fock_space()),
+    discarded_weight (0.0)
+{
+    const auto& dense_coefficients = wave_function.get_coefficients();
+
+    // Count the retained coefficients first, so that they can be stored without reallocations
+    size_t number_of_retained = 0;
+    for (Eigen::Index I = 0; I < dense_coefficients.size(); I++) {
+        if (std::abs(dense_coefficients(I)) >= threshold) {
+            number_of_retained++;
+        }
+    }
+
+    this->addresses.reserve(number_of_retained);
+    this->coefficients = Eigen::VectorXd::Zero(number_of_retained);
+    for (Eigen::Index I = 0; I < dense_coefficients.size(); I++) {
+        double c_I = dense_coefficients(I);
+        if (std::abs(c_I) >= threshold) {
+            this->coefficients(this->addresses.size()) = c_I;
+            this->addresses.push_back(I);
+        } else {
+            this->discarded_weight += c_I * c_I;
+        }
+    }
+}
+
+
+
+/*
+ *  PUBLIC METHODS
+ */
+
+/**
+ *  Normalize the retained coefficients
+ */
+void SparseWaveFunction::normalize() {
+    this->coefficients.normalize();
+}
+
+
+/**
+ *  @return the coefficients in the full Fock space, in which the discarded coefficients are zero
+ */
+Eigen::VectorXd SparseWaveFunction::calculateDenseCoefficients() const {
+
+    Eigen::VectorXd dense_coefficients = Eigen::VectorXd::Zero(this->fock_space->get_dimension());
+    for (size_t k = 0; k < this->addresses.size(); k++) {
+        dense_coefficients(this->addresses[k]) = this->coefficients(k);
+    }
+
+    return dense_coefficients;
+}
+
+
+/**
+ *  @return the selected Fock space that is spanned by the retained configurations, in the order of their addresses
+ */
+SelectedFockSpace SparseWaveFunction::constructSelectedFockSpace() const {
+
+    std::vector<Configuration> configurations;
+    configurations.reserve(this->addresses.size());
+
+    switch (this->fock_space->get_type()) {
+
+        case FockSpaceType::FockSpace: {  // doubly occupied configurations
+            const auto& fock_space = dynamic_cast<const FockSpace&>(*this->fock_space);
+
+            for (size_t address : this->addresses) {
+                ONV onv = fock_space.get_ONV(address);
+                configurations.push_back(Configuration {onv, onv});
+            }
+
+            SelectedFockSpace selected_fock_space (fock_space.get_K(), fock_space.get_N(), fock_space.get_N());
+            selected_fock_space.addConfigurations(configurations);
+            return selected_fock_space;
+        }
+
+        case FockSpaceType::ProductFockSpace: {  // the address is I_alpha * dim_beta + I_beta
+            const auto& fock_space = dynamic_cast<const ProductFockSpace&>(*this->fock_space);
+            const auto& fock_space_alpha = fock_space.get_fock_space_alpha();
+            const auto& fock_space_beta = fock_space.get_fock_space_beta();
+            size_t dim_beta = fock_space_beta.get_dimension();
+
+            for (size_t address : this->addresses) {
+                configurations.push_back(Configuration {fock_space_alpha.get_ONV(address / dim_beta), fock_space_beta.get_ONV(address % dim_beta)});
+            }
+
+            SelectedFockSpace selected_fock_space (fock_space.get_K(), fock_space.get_N_alpha(), fock_space.get_N_beta());
+            selected_fock_space.addConfigurations(configurations);
+            return selected_fock_space;
+        }
+
+        case FockSpaceType::SelectedFockSpace: {
+            const auto& fock_space = dynamic_cast<const SelectedFockSpace&>(*this->fock_space);
+
+            for (size_t address : this->addresses) {
+                configurations.push_back(fock_space.get_configuration(address));
+            }
+
+            SelectedFockSpace selected_fock_space (fock_space.get_K(), fock_space.get_N_alpha(), fock_space.get_N_beta());
+            selected_fock_space.addConfigurations(configurations);
+            return selected_fock_space;
+        }
+
+        default: {
+            throw std::invalid_argument("Sparse wave functions are not supported for the given type of Fock space.");
+        }
+    }
+}
+
+
+}  // namespace GQCP
@@ -15,17 +15,51 @@
 // You should have received a copy of the GNU Lesser General Public License
 // along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
 // 
+#include "WaveFunction/WaveFunctionReader.hpp"
+
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
 #include <fstream>
+#include <vector>
 
-#include <boost/algorithm/string.hpp>
-#include <boost/range/adaptors.hpp>
-#include <boost/dynamic_bitset.hpp>
 
-#include "WaveFunction/WaveFunctionReader.hpp"
+namespace GQCP {
+
 
+/*
+ *  STATIC PRIVATE METHODS
+ */
 
+/**
+ *  Parse a GAMESS bit string, in which the first character corresponds to the first orbital, skipping leading whitespace
+ *
+ *  @param line                 the line that contains the bit string
+ *  @param position             the position in the line at which parsing starts, which is updated to the position right after the bit string
+ *  @param number_of_orbitals   the number of characters of the bit string
+ *
+ *  @return the unsigned representation of the bit string
+ */
+size_t WaveFunctionReader::parseBitString(const std::string& line, size_t& position, size_t& number_of_orbitals) {
+
+    while ((position < line.size()) && std::isspace(static_cast<unsigned char>(line[position]))) {
+        position++;
+    }
+
+    size_t representation = 0;
+    number_of_orbitals = 0;
+    for (; (position < line.size()) && ((line[position] == '0') || (line[position] == '1')); position++, number_of_orbitals++) {
+        if (number_of_orbitals == 64) {
+            throw std::invalid_argument("WaveFunctionReader(): ONVs with more than 64 orbitals are not supported.");
+        }
+        if (line[position] == '1') {
+            representation |= 1UL << number_of_orbitals;
+        }
+    }
+
+    return representation;
+}
 
-namespace GQCP {
 
 
 /*
@@ -33,109 +67,112 @@ namespace GQCP {
  */
 
 /**
- *  @param GAMESS_filename      the name of the GAMESS file that contains the 'selected' wave function expansion
+ *  @param GAMESS_filename          the name of the GAMESS file that contains the 'selected' wave function expansion
+ *  @param coefficient_threshold    only the configurations whose coefficient is at least this threshold (in absolute value) are kept
  */
-WaveFunctionReader::WaveFunctionReader(const std::string& GAMESS_filename)
-{
+WaveFunctionReader::WaveFunctionReader(const std::string& GAMESS_filename, double coefficient_threshold) {
 
-    // If the filename isn't properly converted into an input file stream, we assume the user supplied a wrong file
-    std::ifstream input_file_stream (GAMESS_filename);
-    std::ifstream input_file_stream_count (GAMESS_filename);  // made to count the expansion size
+    // Read the file through a large buffer, which has to be installed before the file is opened
+    std::vector<char> buffer (1 << 20);
+    std::ifstream input_file_stream;
+    input_file_stream.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+    input_file_stream.open(GAMESS_filename);
 
+    // If the filename isn't properly converted into an input file stream, we assume the user supplied a wrong file
     if (!input_file_stream.good()) {
         throw std::runtime_error("WaveFunctionReader(): The provided GAMESS file is illegible. Maybe you specified a wrong path?");
     }
 
-    // Do the actual parsing
+
     // Read in dummy lines up until we actually get to the ONVs and coefficients
     std::string line;
-    std::string buffer;  // dummy for the counting stream  TODO: find "correcter" way if possible
+    bool found_expansion = false;
     while (std::getline(input_file_stream, line)) {
-        std::getline(input_file_stream_count, buffer);
         if (line.find("ALPHA") != std::string::npos
             && line.find("BETA") != std::string::npos
             && line.find("COEFFICIENT") != std::string::npos) {  // if find returns an index that's different from the 'not-found' index
 
             // this line should have dashes and we skip it
             std::getline(input_file_stream, line);
-            std::getline(input_file_stream_count, buffer);
+            found_expansion = true;
             break;
         }
     }
 
-    size_t space_size = 0;
-    // Count the amount of configurations
-    while (std::getline(input_file_stream_count, buffer)) {
-        if (buffer.length() != 0 | buffer[0] != '\n') {
-            space_size++;
-        }
+    if (!found_expansion) {
+        throw std::invalid_argument("WaveFunctionReader(): The provided GAMESS file does not contain a wave function expansion.");
     }
 
-    this->coefficients = Eigen::VectorXd::Zero(space_size);
-
-
-    std::getline(input_file_stream, line);
-    // Read the first line containing the configurations
-    std::vector<std::string> splitted_line;
-    boost::split(splitted_line, line, boost::is_any_of("|"));  // split on '|'
-
 
-    // Create an alpha ONV for the first field
-    std::string trimmed_alpha = boost::algorithm::trim_copy(splitted_line[0]);
-    std::string reversed_alpha (trimmed_alpha.rbegin(), trimmed_alpha.rend());
+    // Read in the ONVs and the coefficients: every line holds an alpha bit string, a beta bit string and a coefficient, separated by '|'
+    // The number of orbitals and electrons are set by the first configuration
+    size_t K = 0;
+    size_t N_alpha = 0;
+    size_t N_beta = 0;
+    std::vector<double> coefficients;
 
-    // Create a beta ONV for the second field
-    std::string trimmed_beta = boost::algorithm::trim_copy(splitted_line[1]);
-    std::string reversed_beta (trimmed_beta.rbegin(), trimmed_beta.rend());
-
-
-    size_t index_count = 0; // counts the configurations added
-
-    // add the double
-    this->coefficients(index_count) = std::stod(splitted_line[2]);
+    while (std::getline(input_file_stream, line)) {
 
-    // Construct dynamic bitsets to use its functionality
-    boost::dynamic_bitset<> alpha_transfer (reversed_alpha);
-    boost::dynamic_bitset<> beta_transfer (reversed_beta);
+        if (line.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;  // skip empty lines
+        }
 
-    size_t K = alpha_transfer.size();
-    size_t N_alpha = alpha_transfer.count();
-    size_t N_beta = beta_transfer.count();
+        size_t position = 0;
+        size_t K_alpha = 0;
+        size_t alpha_representation = WaveFunctionReader::parseBitString(line, position, K_alpha);
 
-    this->fock_space = SelectedFockSpace(K, N_alpha, N_beta);
+        position = line.find('|', position);
+        if (position == std::string::npos) {
+            throw std::invalid_argument("WaveFunctionReader(): One of the lines of the expansion does not contain a beta ONV.");
+        }
+        position++;
 
-    this->fock_space.addConfiguration(reversed_alpha, reversed_beta);
+        size_t K_beta = 0;
+        size_t beta_representation = WaveFunctionReader::parseBitString(line, position, K_beta);
 
+        position = line.find('|', position);
+        if (position == std::string::npos) {
+            throw std::invalid_argument("WaveFunctionReader(): One of the lines of the expansion does not contain a coefficient.");
+        }
+        position++;
 
-    // Read in the ONVs and the coefficients by splitting the line on '|', and then trimming whitespace
-    // In the GAMESS format, the bit strings are ordered in reverse
-    while (std::getline(input_file_stream, line)) {
+        const char* coefficient_begin = line.c_str() + position;
+        char* coefficient_end = nullptr;
+        double coefficient = std::strtod(coefficient_begin, &coefficient_end);
+        if (coefficient_end == coefficient_begin) {
+            throw std::invalid_argument("WaveFunctionReader(): One of the coefficients of the expansion can't be read.");
+        }
 
-        index_count++;
-        boost::split(splitted_line, line, boost::is_any_of("|"));  // split on '|'
 
+        if (K == 0) {  // the first configuration
+            K = K_alpha;
+            N_alpha = __builtin_popcountl(alpha_representation);
+            N_beta = __builtin_popcountl(beta_representation);
+            this->fock_space = SelectedFockSpace(K, N_alpha, N_beta);
+        }
 
-        // Create an alpha ONV for the first field
-        trimmed_alpha = boost::algorithm::trim_copy(splitted_line[0]);
-        if (trimmed_alpha.length() != K) {
+        if (K_alpha != K) {
             throw std::invalid_argument("WaveFunctionReader(): One of the provided alpha ONVs does not have the correct number of orbitals.");
         }
-        reversed_alpha = std::string(trimmed_alpha.rbegin(), trimmed_alpha.rend());
-
-        // Create a beta ONV for the second field
-        trimmed_beta = boost::algorithm::trim_copy(splitted_line[1]);
-        if (trimmed_beta.length() != K) {
+        if (K_beta != K) {
             throw std::invalid_argument("WaveFunctionReader(): One of the provided beta ONVs does not have the correct number of orbitals.");
         }
-        reversed_beta = std::string(trimmed_beta.rbegin(), trimmed_beta.rend());
 
 
-        // Create a double for the third field
-        this->coefficients(index_count) = std::stod(splitted_line[2]);
-        this->fock_space.addConfiguration(reversed_alpha, reversed_beta);
+        // Unimportant configurations are never stored
+        if (std::abs(coefficient) < coefficient_threshold) {
+            continue;
+        }
 
+        this->fock_space.addConfiguration(ONV(K, N_alpha, alpha_representation), ONV(K, N_beta, beta_representation));
+        coefficients.push_back(coefficient);
     }  // while getline
 
+    if (K == 0) {
+        throw std::invalid_argument("WaveFunctionReader(): The provided GAMESS file does not contain a wave function expansion.");
+    }
+
+    this->coefficients = Eigen::Map<Eigen::VectorXd>(coefficients.data(), coefficients.size());
     this->wave_function = WaveFunction(this->fock_space, this->coefficients);
 }
 
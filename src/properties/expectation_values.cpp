@@ -93,4 +93,70 @@ double calculateExpectationValue(const GQCP::HamiltonianParameters& ham_par, con
 }
 
 
+
+/**
+ *  @param model_parameters     the (sparse) model Hamiltonian parameters
+ *  @param one_rdm              the 1-RDM
+ *  @param two_rdm              the 2-RDM
+ *
+ *  @return the expectation value of the model Hamiltonian, which only requires the elements of the 2-RDM that belong to on-site and inter-site repulsions
+ */
+double calculateExpectationValue(const GQCP::ModelHamiltonianParameters& model_parameters, const GQCP::OneRDM& one_rdm, const GQCP::TwoRDM& two_rdm) {
+
+    size_t K = model_parameters.get_K();
+    if (two_rdm.get_dim() != K) {
+        throw std::invalid_argument("The given model Hamiltonian parameters are not compatible with the RDMs.");
+    }
+
+    Eigen::MatrixXd density_density_two_rdm (K, K);
+    for (size_t p = 0; p < K; p++) {
+        for (size_t q = 0; q < K; q++) {
+            density_density_two_rdm(p,q) = two_rdm(p,p,q,q);
+        }
+    }
+
+    return calculateExpectationValue(model_parameters, one_rdm, density_density_two_rdm);
+}
+
+
+/**
+ *  @param model_parameters                 the (sparse) model Hamiltonian parameters
+ *  @param one_rdm                          the 1-RDM
+ *  @param density_density_two_rdm          the K x K matrix of the 2-RDM elements d_ppqq (see e.g. FCIRDMBuilder::calculateDensityDensity2RDM())
+ *
+ *  @return the expectation value of the model Hamiltonian, without requiring the K^4 2-RDM
+ */
+double calculateExpectationValue(const GQCP::ModelHamiltonianParameters& model_parameters, const GQCP::OneRDM& one_rdm, const Eigen::MatrixXd& density_density_two_rdm) {
+
+    size_t K = model_parameters.get_K();
+    if ((one_rdm.get_dim() != K) || (static_cast<size_t>(density_density_two_rdm.rows()) != K) || (static_cast<size_t>(density_density_two_rdm.cols()) != K)) {
+        throw std::invalid_argument("The given model Hamiltonian parameters are not compatible with the RDMs.");
+    }
+
+    const auto& h = model_parameters.get_h();
+    const auto& U = model_parameters.get_U();
+    const auto& V = model_parameters.get_V();
+
+    double expectation_value = 0.0;
+
+    // One-electron contributions: h_pq D_pq
+    for (size_t q = 0; q < K; q++) {
+        for (Eigen::SparseMatrix<double>::InnerIterator it (h, q); it; ++it) {
+            expectation_value += it.value() * one_rdm(it.row(), q);
+        }
+    }
+
+    // Two-electron contributions, with the prefactor 1/2: g_pppp = U_p and g_ppqq = V_pq
+    for (size_t p = 0; p < K; p++) {
+        expectation_value += 0.5 * U(p) * density_density_two_rdm(p,p);
+    }
+    for (size_t q = 0; q < K; q++) {
+        for (Eigen::SparseMatrix<double>::InnerIterator it (V, q); it; ++it) {
+            expectation_value += 0.5 * it.value() * density_density_two_rdm(it.row(), q);
+        }
+    }
+
+    return expectation_value;
+}
+
 }  // namespace GQCP
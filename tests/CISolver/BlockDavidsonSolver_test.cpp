@@ -0,0 +1,235 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2018  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#define BOOST_TEST_MODULE "BlockDavidsonSolver"
+
+
+#include "CISolver/BlockDavidsonSolver.hpp"
+
+#include "CISolver/CISolver.hpp"
+#include "HamiltonianBuilder/DOCI.hpp"
+#include "HamiltonianBuilder/FCI.hpp"
+#include "HamiltonianBuilder/SelectedCI.hpp"
+#include "HamiltonianParameters/HamiltonianParameters_constructors.hpp"
+#include "JacobiRotationParameters.hpp"
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/included/unit_test.hpp>  // include this to get main(), otherwise the compiler will complain
+
+
+BOOST_AUTO_TEST_CASE ( BlockDavidsonSolver_constructor ) {
+
+    auto ham_par = GQCP::readFCIDUMPFile("../tests/data/h2o_sto3g_klaas.FCIDUMP");
+    GQCP::ProductFockSpace fock_space (7, 5, 5);  // dim = 441
+    GQCP::FCI fci (fock_space);
+
+    GQCP::BlockDavidsonSolverOptions options;
+    options.number_of_requested_eigenpairs = 3;
+    BOOST_CHECK_NO_THROW(GQCP::BlockDavidsonSolver(fci, ham_par, options));
+
+    // The number of requested eigenpairs should be positive
+    GQCP::BlockDavidsonSolverOptions options_no_roots;
+    options_no_roots.number_of_requested_eigenpairs = 0;
+    BOOST_CHECK_THROW(GQCP::BlockDavidsonSolver(fci, ham_par, options_no_roots), std::invalid_argument);
+
+    // The collapsed subspace should be able to contain all requested roots
+    GQCP::BlockDavidsonSolverOptions options_small_collapse = options;
+    options_small_collapse.collapsed_subspace_dimension = 2;
+    BOOST_CHECK_THROW(GQCP::BlockDavidsonSolver(fci, ham_par, options_small_collapse), std::invalid_argument);
+
+    // The maximum subspace should leave room for a block of corrections after collapsing
+    GQCP::BlockDavidsonSolverOptions options_small_maximum = options;
+    options_small_maximum.collapsed_subspace_dimension = 4;
+    options_small_maximum.maximum_subspace_dimension = 6;
+    BOOST_CHECK_THROW(GQCP::BlockDavidsonSolver(fci, ham_par, options_small_maximum), std::invalid_argument);
+
+    // The initial guesses should be compatible with the Fock space and the number of requested roots
+    GQCP::BlockDavidsonSolverOptions options_wrong_guess = options;
+    options_wrong_guess.X_0 = Eigen::MatrixXd::Identity(440, 3);
+    BOOST_CHECK_THROW(GQCP::BlockDavidsonSolver(fci, ham_par, options_wrong_guess), std::invalid_argument);
+    options_wrong_guess.X_0 = Eigen::MatrixXd::Identity(441, 2);
+    BOOST_CHECK_THROW(GQCP::BlockDavidsonSolver(fci, ham_par, options_wrong_guess), std::invalid_argument);
+}
+
+
+BOOST_AUTO_TEST_CASE ( selected_CI_block_matvec ) {
+
+    // The block matrix-vector product should be equal to the column-wise matrix-vector products
+    auto ham_par = GQCP::readFCIDUMPFile("../tests/data/h2o_sto3g_klaas.FCIDUMP");
+    GQCP::SelectedFockSpace fock_space (GQCP::ProductFockSpace(7, 5, 5));
+
+    std::srand(0);
+    Eigen::MatrixXd X = Eigen::MatrixXd::Random(fock_space.get_dimension(), 5);
+
+    for (bool use_sparse_hamiltonian : {false, true}) {
+        GQCP::SelectedCI selected_ci (fock_space, use_sparse_hamiltonian);
+        Eigen::VectorXd diagonal = selected_ci.calculateDiagonal(ham_par);
+
+        Eigen::MatrixXd AX = selected_ci.blockMatrixVectorProduct(ham_par, X, diagonal);
+        for (size_t j = 0; j < static_cast<size_t>(X.cols()); j++) {
+            BOOST_CHECK(AX.col(j).isApprox(selected_ci.matrixVectorProduct(ham_par, X.col(j), diagonal), 1.0e-12));
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE ( FCI_h2o_sto3g_dense_vs_block_Davidson ) {
+
+    // The lowest eigenvalues should be equal to the dense ones, also if the subspace has to be restarted frequently
+    auto ham_par = GQCP::readFCIDUMPFile("../tests/data/h2o_sto3g_klaas.FCIDUMP");
+    GQCP::ProductFockSpace fock_space (7, 5, 5);  // dim = 441
+    GQCP::FCI fci (fock_space);
+    GQCP::CISolver ci_solver (fci, ham_par);
+
+    numopt::eigenproblem::DenseSolverOptions dense_solver_options;
+    dense_solver_options.number_of_requested_eigenpairs = 4;
+    ci_solver.solve(dense_solver_options);
+    auto dense_eigenpairs = ci_solver.get_eigenpairs();
+
+    GQCP::BlockDavidsonSolverOptions options;
+    options.number_of_requested_eigenpairs = 4;
+    options.collapsed_subspace_dimension = 8;
+    options.maximum_subspace_dimension = 14;  // forces a restart after the first expansion
+
+    GQCP::BlockDavidsonSolver block_davidson_solver (fci, ham_par, options);
+    block_davidson_solver.solve();
+    BOOST_CHECK(block_davidson_solver.converged());
+
+    Eigen::MatrixXd H = fci.constructHamiltonian(ham_par);
+    for (size_t k = 0; k < 4; k++) {
+        const auto& eigenpair = block_davidson_solver.get_eigenpair(k);
+        BOOST_CHECK(std::abs(eigenpair.get_eigenvalue() - dense_eigenpairs[k].get_eigenvalue()) < 1.0e-08);
+        BOOST_CHECK((H * eigenpair.get_eigenvector() - eigenpair.get_eigenvalue() * eigenpair.get_eigenvector()).norm() < 1.0e-07);
+    }
+
+    // The CISolver should give the same eigenvalues
+    ci_solver.solve(options);
+    for (size_t k = 0; k < 4; k++) {
+        BOOST_CHECK(std::abs(ci_solver.get_eigenpair(k).get_eigenvalue() - dense_eigenpairs[k].get_eigenvalue()) < 1.0e-08);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE ( selected_CI_h2o_sto3g_block_Davidson ) {
+
+    // The block Davidson solver should use the block matrix-vector products of the SelectedCI module
+    auto ham_par = GQCP::readFCIDUMPFile("../tests/data/h2o_sto3g_klaas.FCIDUMP");
+    GQCP::ProductFockSpace product_fock_space (7, 5, 5);
+    GQCP::SelectedFockSpace fock_space (product_fock_space);
+
+    GQCP::FCI fci (product_fock_space);
+    GQCP::SelectedCI selected_ci (fock_space);
+
+    GQCP::BlockDavidsonSolverOptions options;
+    options.number_of_requested_eigenpairs = 3;
+
+    GQCP::BlockDavidsonSolver fci_solver (fci, ham_par, options);
+    fci_solver.solve();
+    GQCP::BlockDavidsonSolver selected_ci_solver (selected_ci, ham_par, options);
+    selected_ci_solver.solve();
+
+    for (size_t k = 0; k < 3; k++) {
+        BOOST_CHECK(std::abs(fci_solver.get_eigenpair(k).get_eigenvalue() - selected_ci_solver.get_eigenpair(k).get_eigenvalue()) < 1.0e-08);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE ( DOCI_h2o_sto3g_dense_vs_block_Davidson ) {
+
+    auto ham_par = GQCP::readFCIDUMPFile("../tests/data/h2o_sto3g_klaas.FCIDUMP");
+    GQCP::FockSpace fock_space (7, 5);  // dim = 21
+    GQCP::DOCI doci (fock_space);
+    GQCP::CISolver ci_solver (doci, ham_par);
+
+    numopt::eigenproblem::DenseSolverOptions dense_solver_options;
+    ci_solver.solve(dense_solver_options);
+    double dense_eigenvalue = ci_solver.get_eigenpair().get_eigenvalue();
+
+    GQCP::BlockDavidsonSolver block_davidson_solver (doci, ham_par);
+    block_davidson_solver.solve();
+
+    BOOST_CHECK(std::abs(block_davidson_solver.get_eigenpair().get_eigenvalue() - dense_eigenvalue) < 1.0e-08);
+}
+
+
+BOOST_AUTO_TEST_CASE ( FCI_h2o_sto3g_block_Davidson_checkpoint_restart ) {
+
+    // An interrupted solve should be able to resume from its checkpoint, from the full subspace or only from the Ritz vectors
+    auto ham_par = GQCP::readFCIDUMPFile("../tests/data/h2o_sto3g_klaas.FCIDUMP");
+    GQCP::ProductFockSpace fock_space (7, 5, 5);  // dim = 441
+    GQCP::FCI fci (fock_space);
+    GQCP::CISolver ci_solver (fci, ham_par);
+
+    numopt::eigenproblem::DenseSolverOptions dense_solver_options;
+    dense_solver_options.number_of_requested_eigenpairs = 3;
+    ci_solver.solve(dense_solver_options);
+    auto dense_eigenpairs = ci_solver.get_eigenpairs();
+
+    GQCP::BlockDavidsonSolverOptions options;
+    options.number_of_requested_eigenpairs = 3;
+    options.maximum_number_of_iterations = 4;  // too little to converge
+    options.checkpoint_filename = "test_block_davidson_checkpoint.bin";
+
+    GQCP::BlockDavidsonSolver interrupted_solver (fci, ham_par, options);
+    BOOST_CHECK_THROW(interrupted_solver.solve(), std::runtime_error);
+
+
+    // Resume from the full subspace: the iterations continue
+    GQCP::BlockDavidsonSolverOptions restart_options;
+    restart_options.number_of_requested_eigenpairs = 3;
+    restart_options.restart_filename = "test_block_davidson_checkpoint.bin";
+
+    GQCP::BlockDavidsonSolver resumed_solver (fci, ham_par, restart_options);
+    resumed_solver.solve();
+    BOOST_CHECK(resumed_solver.get_number_of_iterations() > 4);
+    for (size_t k = 0; k < 3; k++) {
+        BOOST_CHECK(std::abs(resumed_solver.get_eigenpair(k).get_eigenvalue() - dense_eigenpairs[k].get_eigenvalue()) < 1.0e-08);
+    }
+
+
+    // Restart from the Ritz vectors, through the CISolver
+    restart_options.restart_from_ritz_vectors = true;
+    ci_solver.solve(restart_options);
+    for (size_t k = 0; k < 3; k++) {
+        BOOST_CHECK(std::abs(ci_solver.get_eigenpair(k).get_eigenvalue() - dense_eigenpairs[k].get_eigenvalue()) < 1.0e-08);
+    }
+
+
+    // Initial guesses and a restart file can't be combined, and the checkpoint should match the Fock space
+    GQCP::BlockDavidsonSolverOptions conflicting_options = restart_options;
+    conflicting_options.X_0 = Eigen::MatrixXd::Identity(441, 3);
+    BOOST_CHECK_THROW(GQCP::BlockDavidsonSolver(fci, ham_par, conflicting_options), std::invalid_argument);
+
+    GQCP::FockSpace doci_fock_space (7, 5);
+    GQCP::DOCI doci (doci_fock_space);
+    GQCP::BlockDavidsonSolver incompatible_solver (doci, ham_par, restart_options);
+    BOOST_CHECK_THROW(incompatible_solver.solve(), std::invalid_argument);
+
+
+    // A full restart should be rejected for another Hamiltonian of the same dimension, or for another number of requested eigenpairs
+    restart_options.restart_from_ritz_vectors = false;
+
+    auto rotated_ham_par = ham_par;
+    rotated_ham_par.rotate(GQCP::JacobiRotationParameters(1, 0, 0.1));
+    GQCP::BlockDavidsonSolver rotated_solver (fci, rotated_ham_par, restart_options);
+    BOOST_CHECK_THROW(rotated_solver.solve(), std::invalid_argument);
+
+    GQCP::BlockDavidsonSolverOptions fewer_roots_options = restart_options;
+    fewer_roots_options.number_of_requested_eigenpairs = 2;
+    GQCP::BlockDavidsonSolver fewer_roots_solver (fci, ham_par, fewer_roots_options);
+    BOOST_CHECK_THROW(fewer_roots_solver.solve(), std::invalid_argument);
+}
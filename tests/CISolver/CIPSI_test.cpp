@@ -0,0 +1,108 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2018  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#define BOOST_TEST_MODULE "CIPSI"
+
+
+#include "CISolver/CIPSI.hpp"
+
+#include "CISolver/CISolver.hpp"
+#include "HamiltonianBuilder/FCI.hpp"
+#include "HamiltonianParameters/HamiltonianParameters_constructors.hpp"
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/included/unit_test.hpp>  // include this to get main(), otherwise the compiler will complain
+
+
+/**
+ *  @param ham_par      the Hamiltonian parameters
+ *  @param K            the number of orbitals
+ *  @param N_P          the number of electron pairs
+ *
+ *  @return the FCI ground state energy
+ */
+double calculateFCIEnergy(const GQCP::HamiltonianParameters& ham_par, size_t K, size_t N_P) {
+
+    GQCP::ProductFockSpace fock_space (K, N_P, N_P);
+    GQCP::FCI fci (fock_space);
+
+    GQCP::CISolver ci_solver (fci, ham_par);
+    numopt::eigenproblem::DenseSolverOptions solver_options;
+    ci_solver.solve(solver_options);
+
+    return ci_solver.get_eigenpair().get_eigenvalue();
+}
+
+
+BOOST_AUTO_TEST_CASE ( CIPSI_constructor ) {
+
+    auto ham_par = GQCP::readFCIDUMPFile("../tests/data/h2o_sto3g_klaas.FCIDUMP");
+
+    // An empty initial space or an incompatible number of orbitals should throw
+    GQCP::SelectedFockSpace empty_fock_space (7, 5, 5);
+    BOOST_CHECK_THROW(GQCP::CIPSI(ham_par, empty_fock_space), std::invalid_argument);
+
+    GQCP::SelectedFockSpace incompatible_fock_space (6, 5, 5);
+    incompatible_fock_space.addConfiguration("011111", "011111");
+    BOOST_CHECK_THROW(GQCP::CIPSI(ham_par, incompatible_fock_space), std::invalid_argument);
+}
+
+
+BOOST_AUTO_TEST_CASE ( CIPSI_h2o_sto3g_converges_to_FCI ) {
+
+    // Starting from the Hartree-Fock configuration, CIPSI should grow towards the full space and reproduce the FCI energy
+    auto ham_par = GQCP::readFCIDUMPFile("../tests/data/h2o_sto3g_klaas.FCIDUMP");
+    size_t K = ham_par.get_K();  // 7 spatial orbitals
+    double reference_energy = calculateFCIEnergy(ham_par, K, 5);
+
+    GQCP::SelectedFockSpace initial_fock_space (K, 5, 5);
+    initial_fock_space.addConfiguration("0011111", "0011111");
+
+    GQCP::CIPSIOptions options;
+    options.growth_fraction = 2.0;
+    options.dense_dimension_threshold = 100;  // also exercise the Davidson path
+    GQCP::CIPSI cipsi (ham_par, initial_fock_space, options);
+    cipsi.solve();
+
+    BOOST_CHECK(cipsi.converged());
+    BOOST_CHECK(cipsi.get_fock_space().get_dimension() <= 441);
+    BOOST_CHECK(std::abs(cipsi.get_energy() - reference_energy) < 1.0e-06);
+    BOOST_CHECK(std::abs(cipsi.get_pt2_energy()) < 1.0e-06);
+}
+
+
+BOOST_AUTO_TEST_CASE ( CIPSI_h2o_sto3g_pt2_correction ) {
+
+    // After a few iterations, the variational energy is an upper bound to the FCI energy, and the PT2 correction brings it closer to the FCI energy
+    auto ham_par = GQCP::readFCIDUMPFile("../tests/data/h2o_sto3g_klaas.FCIDUMP");
+    size_t K = ham_par.get_K();
+    double reference_energy = calculateFCIEnergy(ham_par, K, 5);
+
+    GQCP::SelectedFockSpace initial_fock_space (K, 5, 5);
+    initial_fock_space.addConfiguration("0011111", "0011111");
+
+    GQCP::CIPSIOptions options;
+    options.maximum_number_of_iterations = 3;
+    GQCP::CIPSI cipsi (ham_par, initial_fock_space, options);
+    cipsi.solve();
+
+    BOOST_CHECK(!cipsi.converged());
+    BOOST_CHECK_EQUAL(cipsi.get_fock_space().get_dimension(), 4);  // 1 -> 2 -> 4 configurations
+    BOOST_CHECK(cipsi.get_energy() > reference_energy);
+    BOOST_CHECK(cipsi.get_pt2_energy() < 0.0);
+    BOOST_CHECK(std::abs(cipsi.get_energy() + cipsi.get_pt2_energy() - reference_energy) < std::abs(cipsi.get_energy() - reference_energy));
+}
@@ -93,3 +93,57 @@ BOOST_AUTO_TEST_CASE ( test_Hubbard_vs_FCI_davidson_large ) {
 
     BOOST_CHECK(std::abs(fci_energy - (hubbard_energy)) < 1.0e-06);
 }
+
+
+BOOST_AUTO_TEST_CASE ( test_Hubbard_model_parameters_vs_FCI_davidson ) {
+
+    // Check if solving directly on (sparse) model parameters produces the same results as FCI for the equivalent dense Hamiltonian parameters
+    size_t K = 8;
+    Eigen::MatrixXd h = Eigen::MatrixXd::Zero(K, K);
+    Eigen::MatrixXd V = Eigen::MatrixXd::Zero(K, K);
+    for (size_t p = 0; p < K; p++) {  // a ring of K sites
+        h(p, (p+1) % K) = -1.0;
+        h((p+1) % K, p) = -1.0;
+        V(p, (p+1) % K) = 0.5;
+        V((p+1) % K, p) = 0.5;
+    }
+    h.diagonal() = 0.1 * Eigen::VectorXd::Random(K);
+    Eigen::VectorXd U = Eigen::VectorXd::Constant(K, 4.0);
+
+    GQCP::ModelHamiltonianParameters model_parameters (h.sparseView(), U, V.sparseView());
+    auto ham_par = model_parameters.constructHamiltonianParameters();
+
+    size_t N = 4;
+    GQCP::ProductFockSpace fock_space (K, N, N);  // dim = 4900
+
+    GQCP::Hubbard hubbard (fock_space);
+    GQCP::FCI fci (fock_space);
+
+    GQCP::CISolver model_solver (hubbard, model_parameters);
+    GQCP::CISolver fci_solver (fci, ham_par);
+
+    // Solve the FCI reference with Davidson
+    Eigen::VectorXd initial_guess = fock_space.randomExpansion();
+    numopt::eigenproblem::DavidsonSolverOptions solver_options (initial_guess);
+    fci_solver.solve(solver_options);
+    double fci_energy = fci_solver.get_eigenpair().get_eigenvalue();
+
+    numopt::eigenproblem::DavidsonSolverOptions model_solver_options (initial_guess);
+    model_solver.solve(model_solver_options);
+    BOOST_CHECK(std::abs(model_solver.get_eigenpair().get_eigenvalue() - fci_energy) < 1.0e-06);
+
+    // Solve the lowest two eigenpairs with the block Davidson solver on the model parameters
+    GQCP::BlockDavidsonSolverOptions block_davidson_options;
+    block_davidson_options.number_of_requested_eigenpairs = 2;
+    model_solver.solve(block_davidson_options);
+    BOOST_CHECK(std::abs(model_solver.get_eigenpair(0).get_eigenvalue() - fci_energy) < 1.0e-06);
+
+    GQCP::BlockDavidsonSolver fci_block_davidson_solver (fci, ham_par, block_davidson_options);
+    fci_block_davidson_solver.solve();
+    BOOST_CHECK(std::abs(model_solver.get_eigenpair(1).get_eigenvalue() - fci_block_davidson_solver.get_eigenpair(1).get_eigenvalue()) < 1.0e-06);
+
+    // Check if an incompatible Fock space throws
+    GQCP::Hubbard hubbard_i (GQCP::ProductFockSpace(K+1, N, N));
+    BOOST_CHECK_THROW(GQCP::CISolver (hubbard_i, model_parameters), std::invalid_argument);
+    BOOST_CHECK_THROW(GQCP::BlockDavidsonSolver (hubbard_i, model_parameters), std::invalid_argument);
+}
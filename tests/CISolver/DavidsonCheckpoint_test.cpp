@@ -0,0 +1,146 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2018  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#define BOOST_TEST_MODULE "DavidsonCheckpoint"
+
+
+#include "CISolver/DavidsonCheckpoint.hpp"
+
+#include <fstream>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/included/unit_test.hpp>  // include this to get main(), otherwise the compiler will complain
+
+
+/**
+ *  @return a checkpoint of a random symmetric matrix in a random subspace, with one locked vector
+ */
+GQCP::DavidsonCheckpoint createCheckpoint() {
+
+    size_t dim = 20;
+    size_t m = 6;
+
+    Eigen::MatrixXd A = Eigen::MatrixXd::Random(dim, dim);
+    A = (A + A.transpose()).eval();
+
+    Eigen::HouseholderQR<Eigen::MatrixXd> qr (Eigen::MatrixXd::Random(dim, m + 1));
+    Eigen::MatrixXd Q = qr.householderQ() * Eigen::MatrixXd::Identity(dim, m + 1);
+
+    Eigen::MatrixXd V = Q.leftCols(m);
+    Eigen::MatrixXd AV = A * V;
+    Eigen::MatrixXd X_locked = Q.rightCols(1);
+    Eigen::VectorXd locked_eigenvalues = Eigen::VectorXd::Constant(1, -1.5);
+
+    return GQCP::DavidsonCheckpoint(3, 42, 7, 25, V, AV, V.transpose() * AV, X_locked, locked_eigenvalues);
+}
+
+
+BOOST_AUTO_TEST_CASE ( constructor ) {
+
+    Eigen::MatrixXd V = Eigen::MatrixXd::Identity(10, 3);
+    Eigen::MatrixXd S = Eigen::MatrixXd::Identity(3, 3);
+
+    BOOST_CHECK_NO_THROW(GQCP::DavidsonCheckpoint(2, 0, 0, 0, V, V, S, Eigen::MatrixXd(10, 0), Eigen::VectorXd()));
+
+    // The blocks should have compatible dimensions, and at least one root should be unconverged
+    BOOST_CHECK_THROW(GQCP::DavidsonCheckpoint(2, 0, 0, 0, V, V, Eigen::MatrixXd::Identity(2, 2), Eigen::MatrixXd(10, 0), Eigen::VectorXd()), std::invalid_argument);
+    BOOST_CHECK_THROW(GQCP::DavidsonCheckpoint(2, 0, 0, 0, V, Eigen::MatrixXd::Identity(10, 2), S, Eigen::MatrixXd(10, 0), Eigen::VectorXd()), std::invalid_argument);
+    BOOST_CHECK_THROW(GQCP::DavidsonCheckpoint(2, 0, 0, 0, V, V, S, Eigen::MatrixXd::Zero(10, 1), Eigen::VectorXd()), std::invalid_argument);
+    BOOST_CHECK_THROW(GQCP::DavidsonCheckpoint(1, 0, 0, 0, V, V, S, Eigen::MatrixXd::Zero(10, 1), Eigen::VectorXd::Zero(1)), std::invalid_argument);
+}
+
+
+BOOST_AUTO_TEST_CASE ( round_trip ) {
+
+    auto checkpoint = createCheckpoint();
+    checkpoint.writeToFile("test_checkpoint.bin");
+
+    // Everything is stored exactly
+    auto read_checkpoint = GQCP::DavidsonCheckpoint::readFromFile("test_checkpoint.bin");
+    BOOST_CHECK_EQUAL(read_checkpoint.get_number_of_requested_eigenpairs(), 3);
+    BOOST_CHECK_EQUAL(read_checkpoint.get_hamiltonian_fingerprint(), 42);
+    BOOST_CHECK_EQUAL(read_checkpoint.get_number_of_iterations(), 7);
+    BOOST_CHECK_EQUAL(read_checkpoint.get_number_of_matrix_vector_products(), 25);
+    BOOST_CHECK(read_checkpoint.get_subspace_vectors() == checkpoint.get_subspace_vectors());
+    BOOST_CHECK(read_checkpoint.get_sigma_vectors() == checkpoint.get_sigma_vectors());
+    BOOST_CHECK(read_checkpoint.get_projected_matrix() == checkpoint.get_projected_matrix());
+    BOOST_CHECK(read_checkpoint.get_locked_vectors() == checkpoint.get_locked_vectors());
+    BOOST_CHECK(read_checkpoint.get_locked_eigenvalues() == checkpoint.get_locked_eigenvalues());
+
+    // The sigma vectors can be skipped, and aren't needed for the Ritz vectors
+    auto ritz_checkpoint = GQCP::DavidsonCheckpoint::readFromFile("test_checkpoint.bin", false);
+    BOOST_CHECK_EQUAL(ritz_checkpoint.get_sigma_vectors().size(), 0);
+    BOOST_CHECK(ritz_checkpoint.get_locked_vectors() == checkpoint.get_locked_vectors());
+
+    Eigen::MatrixXd ritz_vectors = ritz_checkpoint.calculateRitzVectors(2);
+    BOOST_CHECK(ritz_vectors.isApprox(checkpoint.calculateRitzVectors(2), 1.0e-12));
+    BOOST_CHECK((ritz_vectors.transpose() * ritz_vectors).isApprox(Eigen::MatrixXd::Identity(2, 2), 1.0e-12));
+    BOOST_CHECK_THROW(ritz_checkpoint.calculateRitzVectors(7), std::invalid_argument);
+
+    // A checkpoint without sigma vectors can't be written
+    BOOST_CHECK_THROW(ritz_checkpoint.writeToFile("test_checkpoint_ritz.bin"), std::logic_error);
+}
+
+
+BOOST_AUTO_TEST_CASE ( invalid_files ) {
+
+    createCheckpoint().writeToFile("test_checkpoint_valid.bin");
+
+    std::ifstream valid_file ("test_checkpoint_valid.bin", std::ios::binary);
+    std::string contents ((std::istreambuf_iterator<char>(valid_file)), std::istreambuf_iterator<char>());
+
+
+    // Non-existing files and text files
+    BOOST_CHECK_THROW(GQCP::DavidsonCheckpoint::readFromFile("this_file_does_not_exist.bin"), std::runtime_error);
+    BOOST_CHECK_THROW(GQCP::DavidsonCheckpoint::readFromFile("../tests/data/test_GAMESS_expansion"), std::invalid_argument);
+
+
+    // A truncated file
+    std::ofstream truncated_file ("test_checkpoint_truncated.bin", std::ios::binary);
+    truncated_file.write(contents.data(), contents.size() - 8);
+    truncated_file.close();
+    BOOST_CHECK_THROW(GQCP::DavidsonCheckpoint::readFromFile("test_checkpoint_truncated.bin"), std::invalid_argument);
+
+
+    // A file with a flipped bit in a subspace vector
+    std::string corrupted_contents = contents;
+    corrupted_contents[72] ^= 0x01;  // the first byte of the first subspace vector
+    std::ofstream corrupted_file ("test_checkpoint_corrupted.bin", std::ios::binary);
+    corrupted_file.write(corrupted_contents.data(), corrupted_contents.size());
+    corrupted_file.close();
+    BOOST_CHECK_THROW(GQCP::DavidsonCheckpoint::readFromFile("test_checkpoint_corrupted.bin"), std::invalid_argument);
+    BOOST_CHECK_THROW(GQCP::DavidsonCheckpoint::readFromFile("test_checkpoint_corrupted.bin", false), std::invalid_argument);
+
+
+    // A file with a flipped bit in a sigma vector is only rejected if the sigma vectors are read
+    std::string corrupted_sigma_contents = contents;
+    corrupted_sigma_contents[72 + 20 * 6 * 8] ^= 0x01;  // the first byte of the first sigma vector
+    std::ofstream corrupted_sigma_file ("test_checkpoint_corrupted_sigma.bin", std::ios::binary);
+    corrupted_sigma_file.write(corrupted_sigma_contents.data(), corrupted_sigma_contents.size());
+    corrupted_sigma_file.close();
+    BOOST_CHECK_THROW(GQCP::DavidsonCheckpoint::readFromFile("test_checkpoint_corrupted_sigma.bin"), std::invalid_argument);
+    BOOST_CHECK_NO_THROW(GQCP::DavidsonCheckpoint::readFromFile("test_checkpoint_corrupted_sigma.bin", false));
+
+
+    // A file with an unsupported version
+    std::string future_contents = contents;
+    future_contents[8] = 2;  // the (little-endian) version
+    std::ofstream future_file ("test_checkpoint_future.bin", std::ios::binary);
+    future_file.write(future_contents.data(), future_contents.size());
+    future_file.close();
+    BOOST_CHECK_THROW(GQCP::DavidsonCheckpoint::readFromFile("test_checkpoint_future.bin"), std::invalid_argument);
+}
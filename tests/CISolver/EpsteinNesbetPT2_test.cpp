@@ -0,0 +1,193 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2018  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#define BOOST_TEST_MODULE "EpsteinNesbetPT2"
+
+
+#include "CISolver/EpsteinNesbetPT2.hpp"
+
+#include "CISolver/CIPSI.hpp"
+#include "HamiltonianBuilder/SelectedCI.hpp"
+#include "HamiltonianParameters/HamiltonianParameters_constructors.hpp"
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/included/unit_test.hpp>  // include this to get main(), otherwise the compiler will complain
+
+
+/**
+ *  @param ham_par          the Hamiltonian parameters
+ *  @param fock_space       the selected space
+ *  @param coefficients     the coefficients of the wave function in the selected space
+ *  @param energy           the variational energy of the wave function
+ *
+ *  @return the EN-PT2 correction, calculated by summing over all configurations of the full space that are not selected
+ */
+double calculateBruteForcePT2(const GQCP::HamiltonianParameters& ham_par, const GQCP::SelectedFockSpace& fock_space, const Eigen::VectorXd& coefficients, double energy) {
+
+    GQCP::SelectedFockSpace full_fock_space (GQCP::ProductFockSpace(fock_space.get_K(), fock_space.get_N_alpha(), fock_space.get_N_beta()));
+
+    double pt2_energy = 0.0;
+    for (size_t a = 0; a < full_fock_space.get_dimension(); a++) {
+        const auto& configuration_a = full_fock_space.get_configuration(a);
+        if (fock_space.contains(configuration_a.onv_alpha, configuration_a.onv_beta)) {
+            continue;
+        }
+
+        double numerator = 0.0;
+        for (size_t I = 0; I < fock_space.get_dimension(); I++) {
+            const auto& configuration_I = fock_space.get_configuration(I);
+
+            // Only singly and doubly excited configurations are coupled by the Hamiltonian
+            size_t alpha_difference = configuration_a.onv_alpha.get_unsigned_representation() ^ configuration_I.onv_alpha.get_unsigned_representation();
+            size_t beta_difference = configuration_a.onv_beta.get_unsigned_representation() ^ configuration_I.onv_beta.get_unsigned_representation();
+            if (__builtin_popcountl(alpha_difference) + __builtin_popcountl(beta_difference) > 4) {
+                continue;
+            }
+
+            numerator += GQCP::SelectedCI::calculateOffDiagonalElement(ham_par, configuration_a, configuration_I) * coefficients(I);
+        }
+        pt2_energy += numerator * numerator / (energy - GQCP::SelectedCI::calculateDiagonalElement(ham_par, configuration_a));
+    }
+
+    return pt2_energy;
+}
+
+
+/**
+ *  @param ham_par                  the Hamiltonian parameters
+ *  @param number_of_iterations     the number of CIPSI iterations
+ *
+ *  @return a CIPSI calculation for H2O//STO-3G, starting from the Hartree-Fock configuration
+ */
+GQCP::CIPSI runCIPSI(const GQCP::HamiltonianParameters& ham_par, size_t number_of_iterations) {
+
+    GQCP::SelectedFockSpace initial_fock_space (ham_par.get_K(), 5, 5);
+    initial_fock_space.addConfiguration("0011111", "0011111");
+
+    GQCP::CIPSIOptions options;
+    options.maximum_number_of_iterations = number_of_iterations;
+    GQCP::CIPSI cipsi (ham_par, initial_fock_space, options);
+    cipsi.solve();
+
+    return cipsi;
+}
+
+
+BOOST_AUTO_TEST_CASE ( EpsteinNesbetPT2_constructor ) {
+
+    auto ham_par = GQCP::readFCIDUMPFile("../tests/data/h2o_sto3g_klaas.FCIDUMP");
+
+    GQCP::SelectedFockSpace fock_space (7, 5, 5);
+    fock_space.addConfiguration("0011111", "0011111");
+
+    // The number of coefficients should match the dimension, and the number of orbitals should be compatible
+    BOOST_CHECK_THROW(GQCP::EpsteinNesbetPT2(ham_par, fock_space, Eigen::VectorXd::Ones(2), 0.0), std::invalid_argument);
+    BOOST_CHECK_NO_THROW(GQCP::EpsteinNesbetPT2(ham_par, fock_space, Eigen::VectorXd::Ones(1), 0.0));
+
+    GQCP::SelectedFockSpace incompatible_fock_space (6, 5, 5);
+    incompatible_fock_space.addConfiguration("011111", "011111");
+    BOOST_CHECK_THROW(GQCP::EpsteinNesbetPT2(ham_par, incompatible_fock_space, Eigen::VectorXd::Ones(1), 0.0), std::invalid_argument);
+}
+
+
+BOOST_AUTO_TEST_CASE ( EpsteinNesbetPT2_deterministic_h2o_sto3g ) {
+
+    // The EN-PT2 correction should be equal to the one that is calculated by a sum over the full space
+    auto ham_par = GQCP::readFCIDUMPFile("../tests/data/h2o_sto3g_klaas.FCIDUMP");
+    auto cipsi = runCIPSI(ham_par, 4);
+
+    GQCP::EpsteinNesbetPT2 epstein_nesbet_pt2 (ham_par, cipsi.get_fock_space(), cipsi.get_coefficients(), cipsi.get_energy());
+    double reference_pt2_energy = calculateBruteForcePT2(ham_par, cipsi.get_fock_space(), cipsi.get_coefficients(), cipsi.get_energy());
+
+    BOOST_CHECK(std::abs(epstein_nesbet_pt2.calculateDeterministic() - reference_pt2_energy) < 1.0e-10);
+    BOOST_CHECK(std::abs(cipsi.get_pt2_energy() - reference_pt2_energy) < 1.0e-10);
+}
+
+
+BOOST_AUTO_TEST_CASE ( EpsteinNesbetPT2_batches ) {
+
+    // Partitioning the external space into batches should not change the correction
+    auto ham_par = GQCP::readFCIDUMPFile("../tests/data/h2o_sto3g_klaas.FCIDUMP");
+    auto cipsi = runCIPSI(ham_par, 4);
+
+    GQCP::EpsteinNesbetPT2 epstein_nesbet_pt2 (ham_par, cipsi.get_fock_space(), cipsi.get_coefficients(), cipsi.get_energy());
+    double pt2_energy = epstein_nesbet_pt2.calculateDeterministic();
+
+    for (size_t number_of_batches : {2, 3, 7}) {
+        BOOST_CHECK(std::abs(epstein_nesbet_pt2.calculateDeterministic(number_of_batches) - pt2_energy) < 1.0e-10);
+
+        // Every external configuration belongs to exactly one batch
+        size_t number_of_externals = 0;
+        double batched_pt2_energy = 0.0;
+        for (size_t batch_index = 0; batch_index < number_of_batches; batch_index++) {
+            GQCP::SelectedFockSpace externals (ham_par.get_K(), 5, 5);
+            std::vector<double> contributions;
+            epstein_nesbet_pt2.calculateContributions(externals, contributions, batch_index, number_of_batches);
+
+            number_of_externals += externals.get_dimension();
+            for (double contribution : contributions) {
+                batched_pt2_energy += contribution;
+            }
+        }
+
+        GQCP::SelectedFockSpace externals (ham_par.get_K(), 5, 5);
+        std::vector<double> contributions;
+        epstein_nesbet_pt2.calculateContributions(externals, contributions);
+        BOOST_CHECK_EQUAL(number_of_externals, externals.get_dimension());
+        BOOST_CHECK(std::abs(batched_pt2_energy - pt2_energy) < 1.0e-10);
+    }
+
+    BOOST_CHECK_THROW(epstein_nesbet_pt2.calculateDeterministic(0), std::invalid_argument);
+}
+
+
+BOOST_AUTO_TEST_CASE ( EpsteinNesbetPT2_semistochastic_h2o_sto3g ) {
+
+    auto ham_par = GQCP::readFCIDUMPFile("../tests/data/h2o_sto3g_klaas.FCIDUMP");
+    auto cipsi = runCIPSI(ham_par, 5);
+
+    GQCP::EpsteinNesbetPT2 epstein_nesbet_pt2 (ham_par, cipsi.get_fock_space(), cipsi.get_coefficients(), cipsi.get_energy());
+    double pt2_energy = epstein_nesbet_pt2.calculateDeterministic();
+
+
+    // If all selected configurations are treated deterministically, there is no stochastic error
+    GQCP::SemistochasticPT2Options options;
+    options.deterministic_dimension = cipsi.get_fock_space().get_dimension();
+    auto estimate = epstein_nesbet_pt2.calculateSemistochastic(options);
+    BOOST_CHECK(std::abs(estimate.energy - pt2_energy) < 1.0e-10);
+    BOOST_CHECK_EQUAL(estimate.error, 0.0);
+
+
+    // Otherwise, the estimate should be within a few standard errors of the deterministic correction
+    options.deterministic_dimension = 4;
+    options.number_of_samples = 50;
+    options.number_of_sample_sets = 50;
+    options.seed = 42;
+    estimate = epstein_nesbet_pt2.calculateSemistochastic(options);
+    BOOST_CHECK(estimate.error > 0.0);
+    BOOST_CHECK(std::abs(estimate.energy - pt2_energy) < 5 * estimate.error);
+
+    // Purely stochastic estimates should work as well
+    options.deterministic_dimension = 0;
+    estimate = epstein_nesbet_pt2.calculateSemistochastic(options);
+    BOOST_CHECK(std::abs(estimate.energy - pt2_energy) < 5 * estimate.error);
+
+
+    // At least two samples and two sample sets are needed
+    options.number_of_samples = 1;
+    BOOST_CHECK_THROW(epstein_nesbet_pt2.calculateSemistochastic(options), std::invalid_argument);
+}
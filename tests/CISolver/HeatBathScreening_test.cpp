@@ -0,0 +1,109 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2018  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#define BOOST_TEST_MODULE "HeatBathScreening"
+
+
+#include "CISolver/HeatBathScreening.hpp"
+
+#include "CISolver/CIPSI.hpp"
+#include "HamiltonianBuilder/SelectedCI.hpp"
+#include "HamiltonianParameters/HamiltonianParameters_constructors.hpp"
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/included/unit_test.hpp>  // include this to get main(), otherwise the compiler will complain
+
+
+BOOST_AUTO_TEST_CASE ( no_screening ) {
+
+    // Without a threshold, all double excitations should be generated exactly once
+    size_t K = 6;
+    auto random_hamiltonian_parameters = GQCP::constructRandomHamiltonianParameters(K);
+    GQCP::HeatBathScreening heat_bath_screening (random_hamiltonian_parameters);
+
+    GQCP::Configuration configuration {GQCP::ONV(K, 3, 7), GQCP::ONV(K, 2, 3)};  // "000111" and "000011"
+
+    GQCP::SelectedFockSpace excitations (K, 3, 2);
+    heat_bath_screening.forEachDoubleExcitation(configuration, 0.0, [&] (size_t alpha, size_t beta) {
+        BOOST_CHECK_EQUAL(excitations.getIndex(alpha, beta), GQCP::SelectedFockSpace::npos);
+        excitations.addConfiguration(GQCP::ONV(K, 3, alpha), GQCP::ONV(K, 2, beta));
+    });
+
+    // 3*3 alpha-alpha, 1*6 beta-beta and (3*3)*(2*4) alpha-beta double excitations
+    BOOST_CHECK_EQUAL(excitations.get_dimension(), 9 + 6 + 72);
+}
+
+
+BOOST_AUTO_TEST_CASE ( screening_h2o_sto3g ) {
+
+    // Exactly the double excitations of the Hartree-Fock configuration whose matrix element is at least the threshold should be generated
+    auto ham_par = GQCP::readFCIDUMPFile("../tests/data/h2o_sto3g_klaas.FCIDUMP");
+    size_t K = ham_par.get_K();
+    double threshold = 1.0e-02;
+
+    GQCP::HeatBathScreening heat_bath_screening (ham_par);
+
+    GQCP::ProductFockSpace product_fock_space (K, 5, 5);
+    GQCP::SelectedFockSpace full_fock_space (product_fock_space);
+    GQCP::SelectedCI selected_ci (full_fock_space);
+    const auto& hartree_fock = full_fock_space.get_configuration(0);  // "0011111" for both alpha and beta
+
+    GQCP::SelectedFockSpace generated (K, 5, 5);
+    heat_bath_screening.forEachDoubleExcitation(hartree_fock, threshold, [&] (size_t alpha, size_t beta) {
+        generated.addConfiguration(GQCP::ONV(K, 5, alpha), GQCP::ONV(K, 5, beta));
+    });
+
+    size_t number_of_important_doubles = 0;
+    for (size_t I = 0; I < full_fock_space.get_dimension(); I++) {
+        const auto& configuration = full_fock_space.get_configuration(I);
+        size_t excitation_level = (configuration.onv_alpha.countNumberOfDifferences(hartree_fock.onv_alpha) + configuration.onv_beta.countNumberOfDifferences(hartree_fock.onv_beta)) / 2;
+        if (excitation_level != 2) {
+            continue;
+        }
+
+        double element = selected_ci.calculateOffDiagonalElement(ham_par, configuration, hartree_fock);
+        bool is_generated = generated.contains(configuration.onv_alpha, configuration.onv_beta);
+        BOOST_CHECK_EQUAL(is_generated, std::abs(element) >= threshold);
+        if (is_generated) {
+            number_of_important_doubles++;
+        }
+    }
+    BOOST_CHECK_EQUAL(number_of_important_doubles, generated.get_dimension());
+    BOOST_CHECK(number_of_important_doubles > 0);
+}
+
+
+BOOST_AUTO_TEST_CASE ( CIPSI_heat_bath_h2o_sto3g ) {
+
+    // A heat-bath screened CIPSI calculation should still converge to (nearly) the FCI energy
+    auto ham_par = GQCP::readFCIDUMPFile("../tests/data/h2o_sto3g_klaas.FCIDUMP");
+    size_t K = ham_par.get_K();
+
+    GQCP::SelectedFockSpace initial_fock_space (K, 5, 5);
+    initial_fock_space.addConfiguration("0011111", "0011111");
+
+    GQCP::CIPSIOptions options;
+    options.maximum_number_of_iterations = 12;
+    GQCP::CIPSI cipsi (ham_par, initial_fock_space, options);
+    cipsi.solve();
+
+    options.heat_bath_threshold = 1.0e-06;
+    GQCP::CIPSI cipsi_heat_bath (ham_par, initial_fock_space, options);
+    cipsi_heat_bath.solve();
+
+    BOOST_CHECK(std::abs(cipsi.get_energy() - cipsi_heat_bath.get_energy()) < 1.0e-05);
+}
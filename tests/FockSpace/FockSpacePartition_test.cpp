@@ -0,0 +1,105 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2018  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#define BOOST_TEST_MODULE "FockSpacePartition"
+
+
+#include "FockSpace/FockSpacePartition.hpp"
+
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/included/unit_test.hpp>  // include this to get main(), otherwise the compiler will complain
+
+
+BOOST_AUTO_TEST_CASE ( partitionAddresses_uniform ) {
+
+    // The ranges should be contiguous, cover all addresses and be balanced
+    auto ranges = GQCP::partitionAddresses(10, 3);
+    BOOST_CHECK_EQUAL(ranges.size(), 3);
+    BOOST_CHECK_EQUAL(ranges[0].start, 0);
+    BOOST_CHECK_EQUAL(ranges[0].end, 3);
+    BOOST_CHECK_EQUAL(ranges[1].start, 3);
+    BOOST_CHECK_EQUAL(ranges[1].end, 6);
+    BOOST_CHECK_EQUAL(ranges[2].start, 6);
+    BOOST_CHECK_EQUAL(ranges[2].end, 10);
+
+    // More ranges than addresses give empty ranges
+    auto empty_ranges = GQCP::partitionAddresses(2, 4);
+    BOOST_CHECK_EQUAL(empty_ranges[0].start, empty_ranges[0].end);
+    BOOST_CHECK_EQUAL(empty_ranges[3].end, 2);
+
+    BOOST_CHECK_THROW(GQCP::partitionAddresses(10, 0), std::invalid_argument);
+}
+
+
+BOOST_AUTO_TEST_CASE ( partitionAddresses_weighted ) {
+
+    // The first address is as expensive as all the other ones together
+    auto ranges = GQCP::partitionAddresses(11, 2, [] (size_t I) { return (I == 0) ? 10.0 : 1.0; });
+    BOOST_CHECK_EQUAL(ranges[0].start, 0);
+    BOOST_CHECK_EQUAL(ranges[0].end, 1);
+    BOOST_CHECK_EQUAL(ranges[1].start, 1);
+    BOOST_CHECK_EQUAL(ranges[1].end, 11);
+}
+
+
+BOOST_AUTO_TEST_CASE ( FockSpace_partition ) {
+
+    // Every iterator should enumerate the same ONVs as a serial enumeration
+    GQCP::FockSpace fock_space (8, 3);
+
+    size_t address = 0;
+    GQCP::ONV onv = fock_space.get_ONV(0);
+    for (auto& iterator : GQCP::partition(fock_space, 5)) {
+        for (; !iterator.isFinished(); iterator.increment()) {
+            BOOST_CHECK_EQUAL(iterator.get_address(), address);
+            BOOST_CHECK_EQUAL(iterator.get_ONV().get_unsigned_representation(), onv.get_unsigned_representation());
+
+            address++;
+            if (address < fock_space.get_dimension()) {
+                fock_space.setNext(onv);
+            }
+        }
+    }
+    BOOST_CHECK_EQUAL(address, fock_space.get_dimension());
+}
+
+
+BOOST_AUTO_TEST_CASE ( ProductFockSpace_partition ) {
+
+    // Every iterator should enumerate the same pairs of ONVs as a serial enumeration, in which the alpha addresses are major
+    GQCP::ProductFockSpace fock_space (5, 2, 3);
+    const auto& fock_space_alpha = fock_space.get_fock_space_alpha();
+    const auto& fock_space_beta = fock_space.get_fock_space_beta();
+
+    size_t address = 0;
+    for (auto& iterator : GQCP::partition(fock_space, 7)) {
+        for (; !iterator.isFinished(); iterator.increment()) {
+            size_t I_alpha = address / fock_space_beta.get_dimension();
+            size_t I_beta = address % fock_space_beta.get_dimension();
+
+            BOOST_CHECK_EQUAL(iterator.get_address(), address);
+            BOOST_CHECK_EQUAL(iterator.get_address_alpha(), I_alpha);
+            BOOST_CHECK_EQUAL(iterator.get_address_beta(), I_beta);
+            BOOST_CHECK_EQUAL(iterator.get_ONV_alpha().get_unsigned_representation(), fock_space_alpha.get_ONV(I_alpha).get_unsigned_representation());
+            BOOST_CHECK_EQUAL(iterator.get_ONV_beta().get_unsigned_representation(), fock_space_beta.get_ONV(I_beta).get_unsigned_representation());
+
+            address++;
+        }
+    }
+    BOOST_CHECK_EQUAL(address, fock_space.get_dimension());
+}
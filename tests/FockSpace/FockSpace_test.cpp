@@ -52,3 +52,101 @@ BOOST_AUTO_TEST_CASE ( vertex_weights_K5_N3 ) {
                                         {0, 0, 0, 10}};
     BOOST_CHECK(ref_vertex_weights == fock_space.get_vertex_weights());
 }
+
+
+BOOST_AUTO_TEST_CASE ( FockSpace_string_table ) {
+
+    // Check if the materialized string table corresponds to the enumerated ONVs
+    GQCP::FockSpace fock_space (8, 3);
+    GQCP::FockSpace fock_space_table (8, 3, true);
+
+    BOOST_CHECK(!fock_space.hasStringTable());
+    BOOST_CHECK(fock_space_table.hasStringTable());
+
+    GQCP::ONV onv = fock_space.get_ONV(0);
+    GQCP::ONV onv_table = fock_space_table.get_ONV(0);
+    for (size_t I = 0; I < fock_space.get_dimension(); I++) {
+        BOOST_CHECK_EQUAL(fock_space_table.get_representation(I), onv.get_unsigned_representation());
+        for (size_t e = 0; e < 3; e++) {
+            BOOST_CHECK_EQUAL(fock_space_table.get_occupation_indices(I)[e], onv.get_occupied_index(e));
+            BOOST_CHECK_EQUAL(onv_table.get_occupied_index(e), onv.get_occupied_index(e));
+        }
+
+        if (I < fock_space.get_dimension() - 1) {
+            fock_space.setNext(onv);
+            fock_space_table.setNext(onv_table, I);
+        }
+    }
+
+    // Copies of the Fock space share the string table
+    GQCP::FockSpace fock_space_copy = fock_space_table;
+    BOOST_CHECK_EQUAL(fock_space_copy.get_occupation_indices(0), fock_space_table.get_occupation_indices(0));
+}
+
+
+BOOST_AUTO_TEST_CASE ( FockSpace_chunked_address ) {
+
+    // Check the (chunked) addressing for ONVs that span several chunks, including a last chunk that is only partially used
+    GQCP::FockSpace fock_space (21, 3);
+
+    GQCP::ONV onv = fock_space.get_ONV(0);
+    for (size_t I = 0; I < fock_space.get_dimension(); I++) {
+
+        // Calculate the address one electron at a time
+        size_t address = 0;
+        for (size_t e = 0; e < 3; e++) {
+            address += fock_space.get_vertex_weights(onv.get_occupied_index(e), e + 1);
+        }
+
+        BOOST_CHECK_EQUAL(fock_space.getAddress(onv), I);
+        BOOST_CHECK_EQUAL(address, I);
+
+        if (I < fock_space.get_dimension() - 1) {
+            fock_space.setNext(onv);
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE ( FockSpace_coupling_generators ) {
+
+    GQCP::FockSpace fock_space (6, 3);
+    GQCP::ONV onv (6, 3, 22);  // "010110" (22)
+
+    // Check the one-electron couplings against applying the operators on a copy of the ONV
+    size_t number_of_couplings = 0;
+    fock_space.forEachOneElectronCoupling(onv, [&] (size_t J, int sign, size_t p, size_t q) {
+        GQCP::ONV target = onv;
+        int reference_sign = 1;
+        BOOST_CHECK(target.annihilate(p, reference_sign));
+        BOOST_CHECK(target.create(q, reference_sign));
+
+        BOOST_CHECK_EQUAL(J, fock_space.getAddress(target));
+        BOOST_CHECK_EQUAL(sign, reference_sign);
+        number_of_couplings++;
+    });
+    BOOST_CHECK_EQUAL(number_of_couplings, 3 * (6 - 3 + 1));  // N(K-N+1), including the N diagonal couplings
+
+    // Screening away the diagonal couplings leaves the N(K-N) single excitations
+    number_of_couplings = 0;
+    fock_space.forEachOneElectronCoupling(onv, [] (size_t p, size_t q) { return p != q; }, [&] (size_t /*J*/, int /*sign*/, size_t /*p*/, size_t /*q*/) {
+        number_of_couplings++;
+    });
+    BOOST_CHECK_EQUAL(number_of_couplings, 3 * (6 - 3));
+
+    // Check the two-electron couplings against applying the operators on a copy of the ONV
+    number_of_couplings = 0;
+    fock_space.forEachTwoElectronCoupling(onv, [&] (size_t J, int sign, size_t p, size_t q, size_t r, size_t s) {
+        GQCP::ONV target = onv;
+        int reference_sign = 1;
+        BOOST_CHECK(target.annihilate(p, reference_sign));
+        BOOST_CHECK(target.create(q, reference_sign));
+        BOOST_CHECK(target.annihilate(r, reference_sign));
+        BOOST_CHECK(target.create(s, reference_sign));
+
+        BOOST_CHECK_EQUAL(J, fock_space.getAddress(target));
+        BOOST_CHECK_EQUAL(sign, reference_sign);
+        number_of_couplings++;
+    });
+    BOOST_CHECK_EQUAL(number_of_couplings, 12 * 12);  // every one-electron coupling of every one-electron coupling
+}
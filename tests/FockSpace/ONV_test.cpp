@@ -24,6 +24,8 @@
 #include <boost/test/unit_test.hpp>
 #include <boost/test/included/unit_test.hpp>  // include this to get main(), otherwise clang++ will complain
 
+#include <algorithm>
+
 
 BOOST_AUTO_TEST_CASE ( operator_equals_onv ) {
 
@@ -345,3 +347,86 @@ BOOST_AUTO_TEST_CASE ( operator_phase_factor_onv ) {
     BOOST_CHECK_EQUAL(spin_string2.operatorPhaseFactor(4), 1);
     BOOST_CHECK_EQUAL(spin_string2.operatorPhaseFactor(5), -1);
 }
+
+
+BOOST_AUTO_TEST_CASE ( unchecked_operators_onv ) {
+
+    // The unchecked methods should behave exactly as the checked ones for valid indices
+    GQCP::ONV spin_string1 (6, 3, 22);  // "010110" (22)
+    GQCP::ONV spin_string2 (6, 3, 22);  // "010110" (22)
+
+    for (size_t p = 0; p < 6; p++) {
+        BOOST_CHECK_EQUAL(spin_string1.isOccupied_unchecked(p), spin_string1.isOccupied(p));
+        BOOST_CHECK_EQUAL(spin_string1.operatorPhaseFactor_unchecked(p), spin_string1.operatorPhaseFactor(p));
+    }
+
+    int sign1 = 1;
+    int sign2 = 1;
+    BOOST_CHECK(spin_string1.annihilate(2, sign1) == spin_string2.annihilate_unchecked(2, sign2));
+    BOOST_CHECK(spin_string1.create(5, sign1) == spin_string2.create_unchecked(5, sign2));
+    BOOST_CHECK(spin_string1.create(1, sign1) == spin_string2.create_unchecked(1, sign2));  // already occupied
+    BOOST_CHECK_EQUAL(sign1, sign2);
+    BOOST_CHECK_EQUAL(spin_string1.get_unsigned_representation(), spin_string2.get_unsigned_representation());
+
+    spin_string2.set_representation_unchecked(7);  // "000111" (7)
+    BOOST_CHECK_EQUAL(spin_string2.get_occupied_index(0), 0);
+    BOOST_CHECK_EQUAL(spin_string2.get_occupied_index(1), 1);
+    BOOST_CHECK_EQUAL(spin_string2.get_occupied_index(2), 2);
+}
+
+
+BOOST_AUTO_TEST_CASE ( ONV_more_than_32_orbitals ) {
+
+    // Check that orbitals beyond the 32nd bit are handled correctly
+    size_t representation = (1UL << 40) + (1UL << 35) + 1;
+    GQCP::ONV spin_string (48, 3, representation);
+
+    BOOST_CHECK(spin_string.isOccupied(35));
+    BOOST_CHECK(spin_string.isOccupied(40));
+    BOOST_CHECK(!spin_string.isOccupied(33));
+    BOOST_CHECK_EQUAL(spin_string.get_occupied_index(2), 40);
+    BOOST_CHECK_EQUAL(spin_string.operatorPhaseFactor(38), 1);
+    BOOST_CHECK_EQUAL(spin_string.operatorPhaseFactor(36), 1);
+    BOOST_CHECK_EQUAL(spin_string.operatorPhaseFactor(35), -1);
+
+    BOOST_CHECK(spin_string.annihilate(40));
+    BOOST_CHECK(spin_string.create(45));
+    BOOST_CHECK_EQUAL(spin_string.get_unsigned_representation(), (1UL << 45) + (1UL << 35) + 1);
+
+    BOOST_CHECK_EQUAL(spin_string.slice(35, 46), (1UL << 10) + 1);
+
+    // An ONV can't have more than 64 orbitals
+    BOOST_CHECK_THROW(GQCP::ONV (65, 3, 7), std::invalid_argument);
+}
+
+
+BOOST_AUTO_TEST_CASE ( ONV_forEachExcitation ) {
+
+    // Every single and double excitation of "010011" (K=6, N=3) should be generated exactly once
+    size_t representation = 19;
+    size_t all_orbitals = (1UL << 6) - 1;
+
+    std::vector<size_t> singles;
+    GQCP::ONV::forEachSingleExcitation(representation, all_orbitals, [&] (size_t excited) { singles.push_back(excited); });
+    BOOST_CHECK_EQUAL(singles.size(), 3 * 3);  // N(K-N)
+
+    std::vector<size_t> doubles;
+    GQCP::ONV::forEachDoubleExcitation(representation, all_orbitals, [&] (size_t excited) { doubles.push_back(excited); });
+    BOOST_CHECK_EQUAL(doubles.size(), 3 * 3);  // N(N-1)/2 (K-N)(K-N-1)/2
+
+    for (size_t excited : singles) {
+        BOOST_CHECK_EQUAL(__builtin_popcountl(excited), 3);
+        BOOST_CHECK_EQUAL(__builtin_popcountl(excited ^ representation), 2);
+        BOOST_CHECK_EQUAL(excited & ~all_orbitals, 0);
+    }
+    for (size_t excited : doubles) {
+        BOOST_CHECK_EQUAL(__builtin_popcountl(excited), 3);
+        BOOST_CHECK_EQUAL(__builtin_popcountl(excited ^ representation), 4);
+        BOOST_CHECK_EQUAL(excited & ~all_orbitals, 0);
+    }
+
+    std::sort(singles.begin(), singles.end());
+    std::sort(doubles.begin(), doubles.end());
+    BOOST_CHECK(std::unique(singles.begin(), singles.end()) == singles.end());
+    BOOST_CHECK(std::unique(doubles.begin(), doubles.end()) == doubles.end());
+}
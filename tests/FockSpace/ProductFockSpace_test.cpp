@@ -41,3 +41,16 @@ BOOST_AUTO_TEST_CASE ( ProductFockSpace_dimension) {
     BOOST_CHECK_EQUAL(GQCP::ProductFockSpace::calculateDimension(6, 3, 1), 120);
     BOOST_CHECK_EQUAL(GQCP::ProductFockSpace::calculateDimension(8, 4, 2), 1960);
 }
+
+
+BOOST_AUTO_TEST_CASE ( ProductFockSpace_string_tables ) {
+
+    // If N_alpha == N_beta, the alpha and beta Fock space should share their string table
+    GQCP::ProductFockSpace fock_space (6, 3, 3, true);
+    BOOST_CHECK(fock_space.get_fock_space_alpha().hasStringTable());
+    BOOST_CHECK_EQUAL(fock_space.get_fock_space_alpha().get_occupation_indices(0), fock_space.get_fock_space_beta().get_occupation_indices(0));
+
+    GQCP::ProductFockSpace fock_space_different (6, 3, 2, true);
+    BOOST_CHECK(fock_space_different.get_fock_space_beta().hasStringTable());
+    BOOST_CHECK_EQUAL(fock_space_different.get_fock_space_beta().get_representation(0), 3);
+}
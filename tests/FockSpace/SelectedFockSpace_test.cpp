@@ -123,3 +123,135 @@ BOOST_AUTO_TEST_CASE ( reader_test ) {
     BOOST_CHECK(beta2_test == beta2_ref);
 
 }
+
+
+BOOST_AUTO_TEST_CASE ( reader_coefficient_threshold ) {
+
+    // Configurations with a coefficient below the threshold should be skipped
+    GQCP::WaveFunctionReader test_reader ("../tests/data/test_GAMESS_expansion", 0.5);
+
+    BOOST_CHECK_EQUAL(test_reader.get_fock_space().get_dimension(), 1);
+    BOOST_CHECK_EQUAL(test_reader.get_coefficients().size(), 1);
+    BOOST_CHECK_EQUAL(test_reader.get_coefficients()(0), 1.0);
+    BOOST_CHECK_EQUAL(test_reader.get_fock_space().get_configuration(0).onv_beta.asString(), "0000000000000000000000000000000000000000000001");
+
+    // The numbers of orbitals and electrons are set, even if no configuration is kept
+    GQCP::WaveFunctionReader empty_reader ("../tests/data/test_GAMESS_expansion", 2.0);
+    BOOST_CHECK_EQUAL(empty_reader.get_fock_space().get_dimension(), 0);
+    BOOST_CHECK_EQUAL(empty_reader.get_fock_space().get_K(), 46);
+
+    // Non-existing files and files without an expansion should throw
+    BOOST_CHECK_THROW(GQCP::WaveFunctionReader("this_file_does_not_exist"), std::runtime_error);
+    BOOST_CHECK_THROW(GQCP::WaveFunctionReader("../tests/data/h2o.xyz"), std::invalid_argument);
+}
+
+
+BOOST_AUTO_TEST_CASE ( getIndex ) {
+
+    // Every configuration of a full Fock space should be found at its own position
+    GQCP::ProductFockSpace product_fock_space (6, 3, 2);
+    GQCP::SelectedFockSpace fock_space (product_fock_space);
+
+    for (size_t I = 0; I < fock_space.get_dimension(); I++) {
+        const auto& configuration = fock_space.get_configuration(I);
+        BOOST_CHECK_EQUAL(fock_space.getIndex(configuration.onv_alpha, configuration.onv_beta), I);
+    }
+
+    // A configuration that isn't present shouldn't be found
+    GQCP::SelectedFockSpace small_fock_space (3, 1, 1);
+    small_fock_space.addConfiguration("001", "010");
+    small_fock_space.addConfiguration("010", "001");
+
+    GQCP::ONV onv1 (3, 1, 1);  // "001"
+    GQCP::ONV onv2 (3, 1, 2);  // "010"
+    BOOST_CHECK_EQUAL(small_fock_space.getIndex(onv1, onv2), 0);
+    BOOST_CHECK_EQUAL(small_fock_space.getIndex(onv2, onv1), 1);
+    BOOST_CHECK(!small_fock_space.contains(onv1, onv1));
+    BOOST_CHECK_EQUAL(small_fock_space.getIndex(onv2, onv2), GQCP::SelectedFockSpace::npos);
+
+    // Duplicate configurations are kept, but the index refers to the first one
+    small_fock_space.addConfiguration(onv1, onv2);
+    BOOST_CHECK_EQUAL(small_fock_space.get_dimension(), 3);
+    BOOST_CHECK_EQUAL(small_fock_space.getIndex(onv1, onv2), 0);
+
+    // Incompatible ONVs should throw
+    GQCP::ONV onv_wrong_N (3, 2, 3);  // "011"
+    BOOST_CHECK_THROW(small_fock_space.addConfiguration(onv_wrong_N, onv1), std::invalid_argument);
+}
+
+
+BOOST_AUTO_TEST_CASE ( addConfigurations_bulk ) {
+
+    // Adding configurations one by one or in bulk should give the same index
+    GQCP::ProductFockSpace product_fock_space (7, 2, 2);
+    GQCP::SelectedFockSpace reference (product_fock_space);
+
+    std::vector<GQCP::Configuration> configurations;
+    for (size_t I = 0; I < reference.get_dimension(); I++) {
+        configurations.push_back(reference.get_configuration(I));
+    }
+
+    GQCP::SelectedFockSpace one_by_one (7, 2, 2);
+    for (const auto& configuration : configurations) {
+        one_by_one.addConfiguration(configuration.onv_alpha, configuration.onv_beta);
+    }
+
+    GQCP::SelectedFockSpace bulk (7, 2, 2);
+    bulk.addConfigurations(configurations);
+
+    BOOST_CHECK_EQUAL(bulk.get_dimension(), reference.get_dimension());
+    for (size_t I = 0; I < reference.get_dimension(); I++) {
+        const auto& configuration = configurations[I];
+        BOOST_CHECK_EQUAL(one_by_one.getIndex(configuration.onv_alpha, configuration.onv_beta), I);
+        BOOST_CHECK_EQUAL(bulk.getIndex(configuration.onv_alpha, configuration.onv_beta), I);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE ( canonical_layout ) {
+
+    GQCP::SelectedFockSpace fock_space (4, 1, 1);
+    fock_space.addConfiguration("0100", "0001");
+    fock_space.addConfiguration("0001", "0100");
+    fock_space.addConfiguration("0100", "0010");
+    fock_space.addConfiguration("0001", "0001");
+    fock_space.addConfiguration("1000", "0100");
+
+    BOOST_CHECK(!fock_space.isCanonical());
+    BOOST_CHECK_THROW(fock_space.get_number_of_alpha_strings(), std::invalid_argument);
+
+    fock_space.canonicalize();
+    BOOST_CHECK(fock_space.isCanonical());
+
+    // The configurations should be sorted by alpha and then by beta string
+    std::vector<std::pair<size_t, size_t>> ref_configurations = {{1, 1}, {1, 4}, {4, 1}, {4, 2}, {8, 4}};
+    for (size_t I = 0; I < fock_space.get_dimension(); I++) {
+        const auto& configuration = fock_space.get_configuration(I);
+        BOOST_CHECK_EQUAL(configuration.onv_alpha.get_unsigned_representation(), ref_configurations[I].first);
+        BOOST_CHECK_EQUAL(configuration.onv_beta.get_unsigned_representation(), ref_configurations[I].second);
+        BOOST_CHECK_EQUAL(fock_space.getIndex(configuration.onv_alpha, configuration.onv_beta), I);  // the hash index should follow the new positions
+    }
+
+    // Check the unique alpha strings and their ranges
+    BOOST_CHECK_EQUAL(fock_space.get_number_of_alpha_strings(), 3);
+    BOOST_CHECK_EQUAL(fock_space.get_alpha_string(1), 4);
+    BOOST_CHECK_EQUAL(fock_space.get_alpha_range(1).start, 2);
+    BOOST_CHECK_EQUAL(fock_space.get_alpha_range(1).end, 4);
+    BOOST_CHECK_EQUAL(fock_space.get_alpha_string_index(4), 2);
+    BOOST_CHECK_EQUAL(fock_space.findAlphaString(8), 2);
+    BOOST_CHECK_EQUAL(fock_space.findAlphaString(2), GQCP::SelectedFockSpace::npos);
+
+    // Check the unique beta strings and their configuration lists
+    BOOST_CHECK_EQUAL(fock_space.get_number_of_beta_strings(), 3);
+    size_t b = fock_space.findBetaString(4);
+    BOOST_CHECK_EQUAL(b, 2);
+    BOOST_CHECK_EQUAL(fock_space.get_beta_string_index(1), b);
+    auto beta_range = fock_space.get_beta_range(b);
+    BOOST_CHECK_EQUAL(beta_range.end - beta_range.start, 2);
+    BOOST_CHECK_EQUAL(fock_space.get_beta_configuration(beta_range.start), 1);
+    BOOST_CHECK_EQUAL(fock_space.get_beta_configuration(beta_range.start + 1), 4);
+
+    // Adding a configuration invalidates the canonical layout
+    fock_space.addConfiguration("0010", "0010");
+    BOOST_CHECK(!fock_space.isCanonical());
+}
@@ -62,3 +62,111 @@ BOOST_AUTO_TEST_CASE ( DOCI_public_methods ) {
     BOOST_CHECK_THROW(random_doci_i.constructHamiltonian(random_hamiltonian_parameters), std::invalid_argument);
     BOOST_CHECK_THROW(random_doci_i.matrixVectorProduct(random_hamiltonian_parameters, x, x), std::invalid_argument);
 }
+
+
+/**
+ *  @param hamiltonian_parameters       the Hamiltonian parameters
+ *  @param fock_space                   the DOCI Fock space
+ *
+ *  @return the DOCI Hamiltonian, calculated element by element from the Slater rules for doubly occupied (pair) configurations
+ */
+Eigen::MatrixXd calculateReferenceDOCIHamiltonian(const GQCP::HamiltonianParameters& hamiltonian_parameters, const GQCP::FockSpace& fock_space) {
+
+    size_t K = fock_space.get_K();
+    size_t dim = fock_space.get_dimension();
+    const auto& h = hamiltonian_parameters.get_h();
+    const auto& g = hamiltonian_parameters.get_g();
+
+    Eigen::MatrixXd hamiltonian = Eigen::MatrixXd::Zero(dim, dim);
+    for (size_t I = 0; I < dim; I++) {
+        GQCP::ONV onv_I = fock_space.get_ONV(I);
+
+        for (size_t p = 0; p < K; p++) {
+            if (!onv_I.isOccupied(p)) {
+                continue;
+            }
+            hamiltonian(I, I) += 2 * h(p,p) + g(p,p,p,p);
+            for (size_t q = 0; q < p; q++) {
+                if (onv_I.isOccupied(q)) {
+                    hamiltonian(I, I) += 2 * (2*g(p,p,q,q) - g(p,q,q,p));
+                }
+            }
+        }
+
+        for (size_t J = 0; J < dim; J++) {
+            GQCP::ONV onv_J = fock_space.get_ONV(J);
+
+            // Two pair configurations only couple if they differ by a single pair excitation p->q
+            size_t difference = onv_I.get_unsigned_representation() ^ onv_J.get_unsigned_representation();
+            if (__builtin_popcountl(difference) != 2) {
+                continue;
+            }
+            size_t p = __builtin_ctzl(difference);
+            size_t q = 63 - __builtin_clzl(difference);
+            hamiltonian(I, J) = g(q,p,q,p);
+        }
+    }
+
+    return hamiltonian;
+}
+
+
+BOOST_AUTO_TEST_CASE ( DOCI_sparse_hamiltonian ) {
+
+    // Create random HamiltonianParameters and a compatible Fock space
+    size_t K = 6;
+    auto random_hamiltonian_parameters = GQCP::constructRandomHamiltonianParameters(K);
+    GQCP::FockSpace fock_space (K, 3);
+
+    GQCP::DOCI doci (fock_space);
+    GQCP::DOCI sparse_doci (fock_space, true);
+
+    // Check if the sparse Hamiltonian is equal to an independent reference, and has the expected number of non-zero elements
+    Eigen::MatrixXd reference_hamiltonian = calculateReferenceDOCIHamiltonian(random_hamiltonian_parameters, fock_space);
+    auto sparse_hamiltonian = sparse_doci.constructSparseHamiltonian(random_hamiltonian_parameters);
+
+    BOOST_CHECK(reference_hamiltonian.isApprox(Eigen::MatrixXd(sparse_hamiltonian), 1.0e-12));
+    BOOST_CHECK(reference_hamiltonian.isApprox(sparse_doci.constructHamiltonian(random_hamiltonian_parameters), 1.0e-12));
+    BOOST_CHECK(static_cast<size_t>(sparse_hamiltonian.nonZeros()) == fock_space.get_dimension() * (1 + 3*(K-3)));
+
+
+    // Check if the sparse matrix-vector product is equal to the regular one
+    Eigen::VectorXd x = fock_space.randomExpansion();
+
+    Eigen::VectorXd diagonal = doci.calculateDiagonal(random_hamiltonian_parameters);
+    Eigen::VectorXd sparse_diagonal = sparse_doci.calculateDiagonal(random_hamiltonian_parameters);
+    BOOST_CHECK(diagonal.isApprox(reference_hamiltonian.diagonal(), 1.0e-12));
+    BOOST_CHECK(diagonal.isApprox(sparse_diagonal, 1.0e-12));
+
+    Eigen::VectorXd matvec = doci.matrixVectorProduct(random_hamiltonian_parameters, x, diagonal);
+    Eigen::VectorXd sparse_matvec = sparse_doci.matrixVectorProduct(random_hamiltonian_parameters, x, sparse_diagonal);
+    BOOST_CHECK(matvec.isApprox(reference_hamiltonian * x, 1.0e-12));
+    BOOST_CHECK(sparse_matvec.isApprox(reference_hamiltonian * x, 1.0e-12));
+
+
+    // The stored sparse Hamiltonian should follow new Hamiltonian parameters, also if the matrix-vector product is called directly
+    auto other_hamiltonian_parameters = GQCP::constructRandomHamiltonianParameters(K);
+    Eigen::MatrixXd other_reference_hamiltonian = calculateReferenceDOCIHamiltonian(other_hamiltonian_parameters, fock_space);
+
+    Eigen::VectorXd other_sparse_matvec = sparse_doci.matrixVectorProduct(other_hamiltonian_parameters, x, sparse_diagonal);
+    BOOST_CHECK(other_sparse_matvec.isApprox(other_reference_hamiltonian * x, 1.0e-12));
+}
+
+
+BOOST_AUTO_TEST_CASE ( DOCI_matvec ) {
+
+    // Create random HamiltonianParameters and a compatible Fock space, large enough to be split over several threads
+    size_t K = 8;
+    auto random_hamiltonian_parameters = GQCP::constructRandomHamiltonianParameters(K);
+    GQCP::FockSpace fock_space (K, 4);
+
+    GQCP::DOCI doci (fock_space);
+
+    // Check if the (gathered) matrix-vector product is equal to the product with the Hamiltonian matrix
+    Eigen::MatrixXd hamiltonian = doci.constructHamiltonian(random_hamiltonian_parameters);
+    Eigen::VectorXd diagonal = doci.calculateDiagonal(random_hamiltonian_parameters);
+    Eigen::VectorXd x = fock_space.randomExpansion();
+
+    Eigen::VectorXd matvec = doci.matrixVectorProduct(random_hamiltonian_parameters, x, diagonal);
+    BOOST_CHECK(matvec.isApprox(hamiltonian * x, 1.0e-12));
+}
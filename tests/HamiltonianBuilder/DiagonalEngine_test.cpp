@@ -0,0 +1,94 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2018  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#define BOOST_TEST_MODULE "DiagonalEngine"
+
+
+#include "HamiltonianBuilder/DiagonalEngine.hpp"
+#include "FockSpace/FockSpace.hpp"
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/included/unit_test.hpp>  // include this to get main(), otherwise the compiler will complain
+
+
+BOOST_AUTO_TEST_CASE ( DiagonalEngine_constructor ) {
+
+    Eigen::VectorXd one_electron_terms = Eigen::VectorXd::Random(4);
+
+    BOOST_CHECK_NO_THROW(GQCP::DiagonalEngine (one_electron_terms, Eigen::MatrixXd::Random(4, 4)));
+
+    // Check if incompatible dimensions throw
+    BOOST_CHECK_THROW(GQCP::DiagonalEngine (one_electron_terms, Eigen::MatrixXd::Random(5, 5)), std::invalid_argument);
+    BOOST_CHECK_THROW(GQCP::DiagonalEngine (one_electron_terms, Eigen::MatrixXd::Random(4, 5)), std::invalid_argument);
+
+    GQCP::DiagonalEngine diagonal_engine (one_electron_terms, Eigen::MatrixXd::Random(4, 4));
+    BOOST_CHECK_THROW(diagonal_engine.set_one_electron_terms(Eigen::VectorXd::Random(5)), std::invalid_argument);
+}
+
+
+BOOST_AUTO_TEST_CASE ( DiagonalEngine_calculateFull ) {
+
+    // For the ONV "1011", E = a_0 + a_1 + a_3 + b_10 + b_30 + b_31
+    Eigen::VectorXd one_electron_terms (4);
+    one_electron_terms << 1.0, 2.0, 4.0, 8.0;
+
+    Eigen::MatrixXd pair_terms = Eigen::MatrixXd::Zero(4, 4);
+    pair_terms << 0.0,   0.0,   0.0,   0.0,
+                  0.1,   0.0,   0.0,   0.0,
+                  0.2,   0.3,   0.0,   0.0,
+                  0.4,   0.5,   0.6,   0.0;
+
+    GQCP::DiagonalEngine diagonal_engine (one_electron_terms, pair_terms);
+
+    BOOST_CHECK(std::abs(diagonal_engine.calculateFull(11) - 12.0) < 1.0e-12);  // 11 = "1011"
+    BOOST_CHECK(std::abs(diagonal_engine.calculateFull(0)) < 1.0e-12);
+}
+
+
+BOOST_AUTO_TEST_CASE ( DiagonalEngine_incremental ) {
+
+    // Check if the incrementally updated elements are equal to the ones calculated from scratch, for all ONVs in a Fock space
+    size_t K = 10;
+    GQCP::FockSpace fock_space (K, 4);
+
+    GQCP::DiagonalEngine diagonal_engine (Eigen::VectorXd::Random(K), Eigen::MatrixXd::Random(K, K));
+
+    GQCP::ONV onv = fock_space.get_ONV(0);
+    for (size_t I = 0; I < fock_space.get_dimension(); I++) {
+        BOOST_CHECK(std::abs(diagonal_engine.calculate(onv) - diagonal_engine.calculateFull(onv.get_unsigned_representation())) < 1.0e-12);
+
+        if (I < fock_space.get_dimension()-1) {
+            fock_space.setNext(onv);
+        }
+    }
+
+
+    // Check if the elements are also correct when starting at an arbitrary address, after a reset
+    diagonal_engine.reset();
+    onv = fock_space.get_ONV(57);
+    for (size_t I = 57; I < 100; I++) {
+        BOOST_CHECK(std::abs(diagonal_engine.calculate(onv) - diagonal_engine.calculateFull(onv.get_unsigned_representation())) < 1.0e-12);
+        fock_space.setNext(onv);
+    }
+
+
+    // Check if changing the one-electron terms is taken into account
+    Eigen::VectorXd new_one_electron_terms = Eigen::VectorXd::Random(K);
+    diagonal_engine.set_one_electron_terms(new_one_electron_terms);
+    double value = diagonal_engine.calculate(onv);
+    BOOST_CHECK(std::abs(value - diagonal_engine.calculateFull(onv.get_unsigned_representation())) < 1.0e-12);
+}
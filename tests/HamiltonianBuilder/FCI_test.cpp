@@ -62,3 +62,64 @@ BOOST_AUTO_TEST_CASE ( FCI_public_methods ) {
     BOOST_CHECK_THROW(random_fci_i.constructHamiltonian(random_hamiltonian_parameters), std::invalid_argument);
     BOOST_CHECK_THROW(random_fci_i.matrixVectorProduct(random_hamiltonian_parameters, x, x), std::invalid_argument);
 }
+
+
+BOOST_AUTO_TEST_CASE ( FCI_diagonal ) {
+
+    // Check if the (incrementally calculated) diagonal is equal to the diagonal of the FCI Hamiltonian matrix
+    size_t K = 6;
+    auto random_hamiltonian_parameters = GQCP::constructRandomHamiltonianParameters(K);
+    GQCP::ProductFockSpace fock_space (K, 3, 2);
+
+    GQCP::FCI random_fci (fock_space);
+
+    Eigen::VectorXd diagonal = random_fci.calculateDiagonal(random_hamiltonian_parameters);
+    Eigen::MatrixXd hamiltonian = random_fci.constructHamiltonian(random_hamiltonian_parameters);
+
+    BOOST_CHECK(diagonal.isApprox(hamiltonian.diagonal(), 1.0e-12));
+}
+
+
+BOOST_AUTO_TEST_CASE ( FCI_string_tables ) {
+
+    // Check if the FCI builder gives the same results when the strings are read from materialized string tables
+    size_t K = 6;
+    auto random_hamiltonian_parameters = GQCP::constructRandomHamiltonianParameters(K);
+    GQCP::ProductFockSpace fock_space (K, 3, 2);
+    GQCP::ProductFockSpace fock_space_tables (K, 3, 2, true);
+
+    GQCP::FCI fci (fock_space);
+    GQCP::FCI fci_tables (fock_space_tables);
+
+    Eigen::VectorXd diagonal = fci.calculateDiagonal(random_hamiltonian_parameters);
+    BOOST_CHECK(diagonal.isApprox(fci_tables.calculateDiagonal(random_hamiltonian_parameters), 1.0e-12));
+
+    Eigen::VectorXd x = fock_space.randomExpansion();
+    BOOST_CHECK(fci.matrixVectorProduct(random_hamiltonian_parameters, x, diagonal).isApprox(fci_tables.matrixVectorProduct(random_hamiltonian_parameters, x, diagonal), 1.0e-12));
+    BOOST_CHECK(fci.constructHamiltonian(random_hamiltonian_parameters).isApprox(fci_tables.constructHamiltonian(random_hamiltonian_parameters), 1.0e-12));
+}
+
+
+BOOST_AUTO_TEST_CASE ( FCI_blockMatrixVectorProduct ) {
+
+    // Check if the block matrix-vector product is equal to the matrix-vector product of every column
+    size_t K = 6;
+    auto random_hamiltonian_parameters = GQCP::constructRandomHamiltonianParameters(K);
+    GQCP::ProductFockSpace fock_space (K, 3, 2);
+
+    GQCP::FCI random_fci (fock_space);
+    Eigen::VectorXd diagonal = random_fci.calculateDiagonal(random_hamiltonian_parameters);
+
+    Eigen::MatrixXd X = Eigen::MatrixXd::Random(fock_space.get_dimension(), 3);
+    Eigen::MatrixXd block_matvec = random_fci.blockMatrixVectorProduct(random_hamiltonian_parameters, X, diagonal);
+
+    BOOST_REQUIRE_EQUAL(block_matvec.cols(), 3);
+    for (size_t i = 0; i < 3; i++) {
+        BOOST_CHECK(block_matvec.col(i).isApprox(random_fci.matrixVectorProduct(random_hamiltonian_parameters, X.col(i), diagonal), 1.0e-12));
+    }
+
+    // Check if an incompatible Fock space throws
+    GQCP::ProductFockSpace fock_space_i (K+1, 3, 2);
+    GQCP::FCI random_fci_i (fock_space_i);
+    BOOST_CHECK_THROW(random_fci_i.blockMatrixVectorProduct(random_hamiltonian_parameters, X, diagonal), std::invalid_argument);
+}
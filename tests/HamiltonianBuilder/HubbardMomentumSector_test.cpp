@@ -0,0 +1,109 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2018  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#define BOOST_TEST_MODULE "HubbardMomentumSector"
+
+
+#include "HamiltonianBuilder/HubbardMomentumSector.hpp"
+
+#include "HamiltonianBuilder/Hubbard.hpp"
+#include "HamiltonianParameters/HamiltonianParameters_constructors.hpp"
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/included/unit_test.hpp>  // include this to get main(), otherwise the compiler will complain
+
+
+
+/**
+ *  @param K        the number of sites
+ *
+ *  @return the adjacency matrix of a ring of K sites
+ */
+Eigen::MatrixXd ringAdjacencyMatrix(size_t K) {
+
+    Eigen::MatrixXd A = Eigen::MatrixXd::Zero(K, K);
+    for (size_t p = 0; p < K; p++) {
+        A(p, (p+1) % K) = 1;
+        A((p+1) % K, p) = 1;
+    }
+    return A;
+}
+
+
+BOOST_AUTO_TEST_CASE ( HubbardMomentumSector_constructor ) {
+
+    GQCP::ProductFockSpace fock_space (6, 3, 2);
+
+    BOOST_CHECK_NO_THROW(GQCP::HubbardMomentumSector (fock_space, 0));
+    BOOST_CHECK_NO_THROW(GQCP::HubbardMomentumSector (fock_space, 5));
+    BOOST_CHECK_THROW(GQCP::HubbardMomentumSector (fock_space, 6), std::invalid_argument);
+
+    // Every orbit of period P contributes to P momentum sectors, so the momentum sectors should partition the product Fock space
+    size_t number_of_orbit_states = 0;
+    for (size_t k = 0; k < 6; k++) {
+        number_of_orbit_states += GQCP::HubbardMomentumSector(fock_space, k).get_dimension();
+    }
+    BOOST_CHECK(number_of_orbit_states == fock_space.get_dimension());
+}
+
+
+BOOST_AUTO_TEST_CASE ( HubbardMomentumSector_spectrum ) {
+
+    // Check if the union of the spectra of all momentum sectors is the spectrum of the full Hubbard Hamiltonian
+    for (size_t N_beta : {2, 3}) {
+        size_t K = 6;
+        auto ham_par = GQCP::constructHubbardParameters(GQCP::generateUpperTriagonal(ringAdjacencyMatrix(K), -1.0, 4.0));
+        GQCP::ProductFockSpace fock_space (K, 3, N_beta);
+
+        GQCP::Hubbard hubbard (fock_space);
+        Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> self_adjoint_eigensolver (hubbard.constructHamiltonian(ham_par));
+        Eigen::VectorXd reference_eigenvalues = self_adjoint_eigensolver.eigenvalues();
+
+        std::vector<double> eigenvalues;
+        for (size_t k = 0; k < K; k++) {
+            GQCP::HubbardMomentumSector sector (fock_space, k);
+
+            Eigen::MatrixXcd H = sector.constructHamiltonian(ham_par);
+            BOOST_CHECK(H.isApprox(H.adjoint(), 1.0e-12));
+
+            Eigen::VectorXcd x = Eigen::VectorXcd::Random(sector.get_dimension());
+            BOOST_CHECK(sector.matrixVectorProduct(ham_par, x).isApprox(H * x, 1.0e-12));
+
+            Eigen::VectorXd sector_eigenvalues = sector.calculateEigenvalues(ham_par);
+            eigenvalues.insert(eigenvalues.end(), sector_eigenvalues.data(), sector_eigenvalues.data() + sector_eigenvalues.size());
+        }
+        std::sort(eigenvalues.begin(), eigenvalues.end());
+
+        BOOST_REQUIRE(eigenvalues.size() == fock_space.get_dimension());
+        BOOST_CHECK(Eigen::Map<Eigen::VectorXd>(eigenvalues.data(), eigenvalues.size()).isApprox(reference_eigenvalues, 1.0e-10));
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE ( HubbardMomentumSector_not_invariant ) {
+
+    // A chain (i.e. an open ring) is not invariant under translation
+    size_t K = 6;
+    Eigen::MatrixXd A = ringAdjacencyMatrix(K);
+    A(0, K-1) = 0;
+    A(K-1, 0) = 0;
+
+    auto ham_par = GQCP::constructHubbardParameters(GQCP::generateUpperTriagonal(A, -1.0, 4.0));
+    GQCP::HubbardMomentumSector sector (GQCP::ProductFockSpace(K, 3, 3), 0);
+
+    BOOST_CHECK_THROW(sector.constructHamiltonian(ham_par), std::invalid_argument);
+}
@@ -171,4 +171,110 @@ BOOST_AUTO_TEST_CASE ( test_Hubbard_vs_FCI_large_matvec ) {
     Eigen::VectorXd fci_matvec = fci.matrixVectorProduct(mol_ham_par, fci_diagonal, fci_diagonal);
 
     BOOST_CHECK(hubbard_matvec.isApprox(fci_matvec));
-}
\ No newline at end of file
+}
+
+BOOST_AUTO_TEST_CASE ( Hubbard_sparse_and_block ) {
+
+    // Check if the sparse Hamiltonian and the block matrix-vector product are consistent with the dense Hamiltonian
+    Eigen::VectorXd triagonal_test = Eigen::VectorXd::Random(21);
+
+    auto mol_ham_par = GQCP::constructHubbardParameters(triagonal_test);
+    auto K = mol_ham_par.get_K();
+
+    GQCP::ProductFockSpace fock_space (K, 3, 2);  // dim = 300
+
+    GQCP::Hubbard hubbard (fock_space);
+
+    Eigen::MatrixXd hubbard_ham = hubbard.constructHamiltonian(mol_ham_par);
+    Eigen::SparseMatrix<double> sparse_hubbard_ham = hubbard.constructSparseHamiltonian(mol_ham_par);
+    BOOST_CHECK(hubbard_ham.isApprox(Eigen::MatrixXd(sparse_hubbard_ham)));
+
+    Eigen::VectorXd diagonal = hubbard.calculateDiagonal(mol_ham_par);
+    Eigen::MatrixXd X = Eigen::MatrixXd::Random(fock_space.get_dimension(), 3);
+    Eigen::MatrixXd matmat = hubbard.matrixMatrixProduct(mol_ham_par, X, diagonal);
+    BOOST_CHECK(matmat.isApprox(hubbard_ham * X));
+
+    for (size_t i = 0; i < 3; i++) {
+        BOOST_CHECK(matmat.col(i).isApprox(hubbard.matrixVectorProduct(mol_ham_par, X.col(i), diagonal)));
+    }
+
+    BOOST_CHECK(hubbard.blockMatrixVectorProduct(mol_ham_par, X, diagonal).isApprox(matmat));
+}
+
+
+BOOST_AUTO_TEST_CASE ( Hubbard_lattice_vs_FCI ) {
+
+    // Check if FCI and Hubbard produce the same Hamiltonian matrix for a sparse lattice: a ring of 6 sites
+    size_t K = 6;
+    Eigen::MatrixXd A = Eigen::MatrixXd::Zero(K, K);
+    for (size_t p = 0; p < K; p++) {
+        A(p, (p+1) % K) = 1;
+        A((p+1) % K, p) = 1;
+    }
+
+    auto mol_ham_par = GQCP::constructHubbardParameters(GQCP::generateUpperTriagonal(A, 1.0, 2.0));
+
+    // Every site only has neighbours p+1 (and the last site is a neighbour of the first)
+    auto hoppings = GQCP::generateHoppingList(mol_ham_par.get_h());
+    BOOST_REQUIRE_EQUAL(hoppings[0].size(), 2);
+    BOOST_CHECK_EQUAL(hoppings[0][0].first, 1);
+    BOOST_CHECK_EQUAL(hoppings[0][1].first, 5);
+    BOOST_REQUIRE_EQUAL(hoppings[2].size(), 1);
+    BOOST_CHECK_EQUAL(hoppings[2][0].first, 3);
+    BOOST_CHECK(std::abs(hoppings[2][0].second - mol_ham_par.get_h()(2,3)) < 1.0e-12);
+    BOOST_CHECK(hoppings[5].empty());
+
+    GQCP::ProductFockSpace fock_space (K, 3, 2);
+
+    GQCP::Hubbard hubbard (fock_space);
+    GQCP::FCI fci (fock_space);
+
+    Eigen::MatrixXd hubbard_ham = hubbard.constructHamiltonian(mol_ham_par);
+    Eigen::MatrixXd fci_ham = fci.constructHamiltonian(mol_ham_par);
+    BOOST_CHECK(hubbard_ham.isApprox(fci_ham));
+
+    Eigen::VectorXd x = fock_space.randomExpansion();
+    Eigen::VectorXd hubbard_diagonal = hubbard.calculateDiagonal(mol_ham_par);
+    BOOST_CHECK(hubbard.matrixVectorProduct(mol_ham_par, x, hubbard_diagonal).isApprox(fci_ham * x));
+}
+
+
+BOOST_AUTO_TEST_CASE ( Hubbard_model_parameters_vs_FCI ) {
+
+    // Check if the Hubbard builder gives the same Hamiltonian for (sparse) model parameters as FCI does for the equivalent dense Hamiltonian parameters, including on-site energies and inter-site repulsions
+    size_t K = 6;
+    Eigen::MatrixXd h = Eigen::MatrixXd::Zero(K, K);
+    Eigen::MatrixXd V = Eigen::MatrixXd::Zero(K, K);
+    for (size_t p = 0; p < K-1; p++) {
+        h(p, p+1) = -1.0;
+        h(p+1, p) = -1.0;
+        V(p, p+1) = 0.5;
+        V(p+1, p) = 0.5;
+    }
+    h.diagonal() = Eigen::VectorXd::Random(K);
+    Eigen::VectorXd U = Eigen::VectorXd::Random(K).array() + 4.0;
+
+    GQCP::ModelHamiltonianParameters model_parameters (h.sparseView(), U, V.sparseView());
+    auto ham_par = model_parameters.constructHamiltonianParameters();
+
+    GQCP::ProductFockSpace fock_space (K, 3, 2);
+    GQCP::Hubbard hubbard (fock_space);
+    GQCP::FCI fci (fock_space);
+
+    Eigen::MatrixXd fci_ham = fci.constructHamiltonian(ham_par);
+    BOOST_CHECK(hubbard.constructHamiltonian(model_parameters).isApprox(fci_ham));
+
+    Eigen::VectorXd diagonal = hubbard.calculateDiagonal(model_parameters);
+    BOOST_CHECK(diagonal.isApprox(fci.calculateDiagonal(ham_par)));
+
+    Eigen::VectorXd x = fock_space.randomExpansion();
+    BOOST_CHECK(hubbard.matrixVectorProduct(model_parameters, x, diagonal).isApprox(fci_ham * x));
+
+    Eigen::MatrixXd X = Eigen::MatrixXd::Random(fock_space.get_dimension(), 3);
+    BOOST_CHECK(hubbard.blockMatrixVectorProduct(model_parameters, X, diagonal).isApprox(fci_ham * X));
+
+    // Check if an incompatible Fock space throws
+    GQCP::Hubbard hubbard_i (GQCP::ProductFockSpace(K+1, 3, 2));
+    BOOST_CHECK_THROW(hubbard_i.calculateDiagonal(model_parameters), std::invalid_argument);
+    BOOST_CHECK_THROW(hubbard_i.blockMatrixVectorProduct(model_parameters, X, diagonal), std::invalid_argument);
+}
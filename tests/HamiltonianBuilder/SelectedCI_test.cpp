@@ -0,0 +1,247 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2018  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#define BOOST_TEST_MODULE "SelectedCI"
+
+
+#include "HamiltonianBuilder/SelectedCI.hpp"
+
+#include "CISolver/CISolver.hpp"
+#include "HamiltonianBuilder/FCI.hpp"
+#include "HamiltonianParameters/HamiltonianParameters_constructors.hpp"
+#include "properties/expectation_values.hpp"
+#include "RDM/SelectedRDMBuilder.hpp"
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/included/unit_test.hpp>  // include this to get main(), otherwise the compiler will complain
+
+
+/**
+ *  @param K        the number of orbitals
+ *
+ *  @return random Hamiltonian parameters with the symmetries of real orbitals, i.e. h_pq = h_qp and an 8-fold permutational symmetry of g
+ */
+GQCP::HamiltonianParameters constructSymmetricRandomHamiltonianParameters(size_t K) {
+
+    auto random_hamiltonian_parameters = GQCP::constructRandomHamiltonianParameters(K);
+    const auto& h_random = random_hamiltonian_parameters.get_h();
+    const auto& g_random = random_hamiltonian_parameters.get_g();
+
+    Eigen::MatrixXd h (K, K);
+    Eigen::Tensor<double, 4> g (K, K, K, K);
+    for (size_t p = 0; p < K; p++) {
+        for (size_t q = 0; q < K; q++) {
+            h(p,q) = (h_random(p,q) + h_random(q,p)) / 2;
+
+            for (size_t r = 0; r < K; r++) {
+                for (size_t s = 0; s < K; s++) {
+                    g(p,q,r,s) = (g_random(p,q,r,s) + g_random(q,p,r,s) + g_random(p,q,s,r) + g_random(q,p,s,r) + g_random(r,s,p,q) + g_random(s,r,p,q) + g_random(r,s,q,p) + g_random(s,r,q,p)) / 8;
+                }
+            }
+        }
+    }
+
+    GQCP::OneElectronOperator S (Eigen::MatrixXd::Identity(K, K));
+    Eigen::MatrixXd C = Eigen::MatrixXd::Identity(K, K);
+    std::shared_ptr<GQCP::AOBasis> ao_basis;
+    return GQCP::HamiltonianParameters(ao_basis, S, GQCP::OneElectronOperator(h), GQCP::TwoElectronOperator(g), C);
+}
+
+
+BOOST_AUTO_TEST_CASE ( SelectedCI_full_space ) {
+
+    // In the full space, the selected CI Hamiltonian should be equal to the FCI Hamiltonian: the canonical layout of a full space follows the FCI addressing
+    size_t K = 5;
+    auto hamiltonian_parameters = constructSymmetricRandomHamiltonianParameters(K);
+    GQCP::ProductFockSpace product_fock_space (K, 3, 2);
+
+    GQCP::SelectedFockSpace fock_space (product_fock_space);
+
+    GQCP::FCI fci (product_fock_space);
+    GQCP::SelectedCI selected_ci (fock_space);
+
+    Eigen::MatrixXd fci_hamiltonian = fci.constructHamiltonian(hamiltonian_parameters);
+    Eigen::MatrixXd selected_hamiltonian = selected_ci.constructHamiltonian(hamiltonian_parameters);
+    BOOST_CHECK(selected_hamiltonian.isApprox(fci_hamiltonian, 1.0e-12));
+
+    Eigen::VectorXd diagonal = selected_ci.calculateDiagonal(hamiltonian_parameters);
+    BOOST_CHECK(diagonal.isApprox(fci_hamiltonian.diagonal(), 1.0e-12));
+
+    Eigen::VectorXd x = product_fock_space.randomExpansion();
+    BOOST_CHECK(selected_ci.matrixVectorProduct(hamiltonian_parameters, x, diagonal).isApprox(fci_hamiltonian * x, 1.0e-12));
+
+    // Incompatible Hamiltonian parameters should throw
+    auto hamiltonian_parameters_i = constructSymmetricRandomHamiltonianParameters(K+1);
+    BOOST_CHECK_THROW(selected_ci.calculateDiagonal(hamiltonian_parameters_i), std::invalid_argument);
+    BOOST_CHECK_THROW(selected_ci.matrixVectorProduct(hamiltonian_parameters_i, x, diagonal), std::invalid_argument);
+}
+
+
+BOOST_AUTO_TEST_CASE ( SelectedCI_selected_space ) {
+
+    // For a selection of configurations, the selected CI Hamiltonian should be the corresponding submatrix of the FCI Hamiltonian
+    size_t K = 6;
+    auto hamiltonian_parameters = constructSymmetricRandomHamiltonianParameters(K);
+    GQCP::ProductFockSpace product_fock_space (K, 2, 3);
+    GQCP::SelectedFockSpace full_fock_space (product_fock_space);
+
+    // Select every third configuration, and add them in reverse order so that the builder has to bring them in the canonical layout internally
+    GQCP::SelectedFockSpace fock_space (K, 2, 3);
+    for (size_t I = full_fock_space.get_dimension(); I-- > 0; ) {
+        if (I % 3 == 0) {
+            const auto& configuration = full_fock_space.get_configuration(I);
+            fock_space.addConfiguration(configuration.onv_alpha, configuration.onv_beta);
+        }
+    }
+
+    GQCP::SelectedCI selected_ci (fock_space);
+    GQCP::SelectedCI selected_ci_sparse (fock_space, true);
+    GQCP::FCI fci (product_fock_space);
+
+    Eigen::MatrixXd fci_hamiltonian = fci.constructHamiltonian(hamiltonian_parameters);
+    Eigen::MatrixXd selected_hamiltonian = selected_ci.constructHamiltonian(hamiltonian_parameters);
+
+    // The Hamiltonian should follow the ordering of the given Fock space
+    size_t dim = fock_space.get_dimension();
+    for (size_t I = 0; I < dim; I++) {
+        const auto& configuration_I = fock_space.get_configuration(I);
+        size_t address_I = full_fock_space.getIndex(configuration_I.onv_alpha, configuration_I.onv_beta);
+
+        for (size_t J = 0; J < dim; J++) {
+            const auto& configuration_J = fock_space.get_configuration(J);
+            size_t address_J = full_fock_space.getIndex(configuration_J.onv_alpha, configuration_J.onv_beta);
+
+            BOOST_CHECK(std::abs(selected_hamiltonian(I,J) - fci_hamiltonian(address_I, address_J)) < 1.0e-12);
+        }
+    }
+
+    // The matrix-free and the sparse matrix-vector products should agree with the dense Hamiltonian
+    Eigen::VectorXd x = Eigen::VectorXd::Random(dim);
+    Eigen::VectorXd diagonal = selected_ci.calculateDiagonal(hamiltonian_parameters);
+    Eigen::VectorXd diagonal_sparse = selected_ci_sparse.calculateDiagonal(hamiltonian_parameters);
+    BOOST_CHECK(diagonal.isApprox(diagonal_sparse, 1.0e-12));
+    BOOST_CHECK(selected_ci.matrixVectorProduct(hamiltonian_parameters, x, diagonal).isApprox(selected_hamiltonian * x, 1.0e-12));
+    BOOST_CHECK(selected_ci_sparse.matrixVectorProduct(hamiltonian_parameters, x, diagonal_sparse).isApprox(selected_hamiltonian * x, 1.0e-12));
+}
+
+
+BOOST_AUTO_TEST_CASE ( SelectedCI_CISolver ) {
+
+    // The dense and Davidson solvers should find the same ground state energy
+    size_t K = 5;
+    auto hamiltonian_parameters = constructSymmetricRandomHamiltonianParameters(K);
+    GQCP::ProductFockSpace product_fock_space (K, 2, 2);
+    GQCP::SelectedFockSpace fock_space (product_fock_space);
+    GQCP::SelectedCI selected_ci (fock_space, true);
+
+    GQCP::CISolver dense_ci_solver (selected_ci, hamiltonian_parameters);
+    numopt::eigenproblem::DenseSolverOptions dense_solver_options;
+    dense_ci_solver.solve(dense_solver_options);
+
+    GQCP::CISolver davidson_ci_solver (selected_ci, hamiltonian_parameters);
+    Eigen::VectorXd initial_guess = product_fock_space.HartreeFockExpansion();
+    numopt::eigenproblem::DavidsonSolverOptions davidson_solver_options (initial_guess);
+    davidson_ci_solver.solve(davidson_solver_options);
+
+    BOOST_CHECK(std::abs(dense_ci_solver.get_eigenpair().get_eigenvalue() - davidson_ci_solver.get_eigenpair().get_eigenvalue()) < 1.0e-08);
+}
+
+
+BOOST_AUTO_TEST_CASE ( SelectedCI_unsorted_space ) {
+
+    // The diagonal, the matrix-vector product and the eigenvectors should follow the ordering of the given (unsorted) Fock space
+    auto ham_par = GQCP::readFCIDUMPFile("../tests/data/h2o_sto3g_klaas.FCIDUMP");
+    size_t K = ham_par.get_K();
+    GQCP::ProductFockSpace product_fock_space (K, 5, 5);
+    GQCP::SelectedFockSpace full_fock_space (product_fock_space);
+    size_t dim = full_fock_space.get_dimension();
+
+    // Shuffle the full space with a fixed stride that is coprime with the dimension (441 = 3^2 7^2)
+    GQCP::SelectedFockSpace fock_space (K, 5, 5);
+    for (size_t i = 0; i < dim; i++) {
+        const auto& configuration = full_fock_space.get_configuration((100 * i) % dim);
+        fock_space.addConfiguration(configuration.onv_alpha, configuration.onv_beta);
+    }
+
+    GQCP::FCI fci (product_fock_space);
+    GQCP::SelectedCI selected_ci (fock_space);
+    GQCP::SelectedCI selected_ci_sparse (fock_space, true);
+
+    Eigen::VectorXd fci_diagonal = fci.calculateDiagonal(ham_par);
+    Eigen::VectorXd x_fci = product_fock_space.randomExpansion();
+    Eigen::VectorXd fci_matvec = fci.matrixVectorProduct(ham_par, x_fci, fci_diagonal);
+
+    Eigen::VectorXd x (dim);
+    Eigen::VectorXd ref_diagonal (dim);
+    Eigen::VectorXd ref_matvec (dim);
+    for (size_t i = 0; i < dim; i++) {
+        x(i) = x_fci((100 * i) % dim);
+        ref_diagonal(i) = fci_diagonal((100 * i) % dim);
+        ref_matvec(i) = fci_matvec((100 * i) % dim);
+    }
+
+    Eigen::VectorXd diagonal = selected_ci.calculateDiagonal(ham_par);
+    Eigen::VectorXd diagonal_sparse = selected_ci_sparse.calculateDiagonal(ham_par);
+    BOOST_CHECK(diagonal.isApprox(ref_diagonal, 1.0e-12));
+    BOOST_CHECK(diagonal_sparse.isApprox(ref_diagonal, 1.0e-12));
+    BOOST_CHECK(selected_ci.matrixVectorProduct(ham_par, x, diagonal).isApprox(ref_matvec, 1.0e-12));
+    BOOST_CHECK(selected_ci_sparse.matrixVectorProduct(ham_par, x, diagonal_sparse).isApprox(ref_matvec, 1.0e-12));
+    BOOST_CHECK(selected_ci.blockMatrixVectorProduct(ham_par, x, diagonal).col(0).isApprox(ref_matvec, 1.0e-12));
+
+    // The RDMs of the eigenvector should reproduce the eigenvalue
+    GQCP::CISolver ci_solver (selected_ci, ham_par);
+    numopt::eigenproblem::DenseSolverOptions solver_options;
+    ci_solver.solve(solver_options);
+    Eigen::VectorXd coef = ci_solver.get_eigenpair().get_eigenvector();
+    double energy_by_eigenvalue = ci_solver.get_eigenpair().get_eigenvalue();
+
+    GQCP::SelectedRDMBuilder selected_rdm_builder (fock_space);
+    GQCP::OneRDMs one_rdms = selected_rdm_builder.calculate1RDMs(coef);
+    GQCP::TwoRDMs two_rdms = selected_rdm_builder.calculate2RDMs(coef);
+    double energy_by_contraction = GQCP::calculateExpectationValue(ham_par, one_rdms.one_rdm, two_rdms.two_rdm);
+
+    BOOST_CHECK(std::abs(energy_by_eigenvalue - energy_by_contraction) < 1.0e-12);
+}
+
+
+BOOST_AUTO_TEST_CASE ( SelectedCI_sparse_hamiltonian_parameters_change ) {
+
+    // The stored sparse Hamiltonian should follow the Hamiltonian parameters that are passed to the matrix-vector products
+    size_t K = 5;
+    GQCP::ProductFockSpace product_fock_space (K, 2, 2);
+    GQCP::SelectedFockSpace fock_space (product_fock_space);
+    GQCP::SelectedCI selected_ci (fock_space);
+    GQCP::SelectedCI selected_ci_sparse (fock_space, true);
+
+    // Calculating the diagonal shouldn't build the sparse Hamiltonian
+    auto hamiltonian_parameters1 = constructSymmetricRandomHamiltonianParameters(K);
+    Eigen::VectorXd diagonal1 = selected_ci_sparse.calculateDiagonal(hamiltonian_parameters1);
+    BOOST_CHECK_EQUAL(selected_ci_sparse.get_sparse_hamiltonian().rows(), 0);
+
+    auto hamiltonian_parameters2 = constructSymmetricRandomHamiltonianParameters(K);
+    Eigen::VectorXd diagonal2 = selected_ci_sparse.calculateDiagonal(hamiltonian_parameters2);
+
+    Eigen::VectorXd x = product_fock_space.randomExpansion();
+    Eigen::MatrixXd X = Eigen::MatrixXd::Random(fock_space.get_dimension(), 3);
+    for (size_t i = 0; i < 2; i++) {  // alternate twice between both sets of parameters
+        BOOST_CHECK(selected_ci_sparse.matrixVectorProduct(hamiltonian_parameters1, x, diagonal1).isApprox(selected_ci.matrixVectorProduct(hamiltonian_parameters1, x, diagonal1), 1.0e-12));
+        BOOST_CHECK(selected_ci_sparse.matrixVectorProduct(hamiltonian_parameters2, x, diagonal2).isApprox(selected_ci.matrixVectorProduct(hamiltonian_parameters2, x, diagonal2), 1.0e-12));
+        BOOST_CHECK(selected_ci_sparse.blockMatrixVectorProduct(hamiltonian_parameters1, X, diagonal1).isApprox(selected_ci.blockMatrixVectorProduct(hamiltonian_parameters1, X, diagonal1), 1.0e-12));
+        BOOST_CHECK(selected_ci_sparse.blockMatrixVectorProduct(hamiltonian_parameters2, X, diagonal2).isApprox(selected_ci.blockMatrixVectorProduct(hamiltonian_parameters2, X, diagonal2), 1.0e-12));
+    }
+    BOOST_CHECK(selected_ci_sparse.constructHamiltonian(hamiltonian_parameters1).isApprox(selected_ci.constructHamiltonian(hamiltonian_parameters1), 1.0e-12));
+}
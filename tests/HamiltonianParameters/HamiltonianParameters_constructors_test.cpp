@@ -137,3 +137,41 @@ BOOST_AUTO_TEST_CASE ( hubbard_upperTriagonal ) {
     
     BOOST_CHECK_THROW(GQCP::constructHubbardParameters(triagonal_test_faulty), std::invalid_argument);
 }
+
+
+BOOST_AUTO_TEST_CASE ( hubbard_model_upperTriagonal ) {
+
+    Eigen::VectorXd triagonal_test(6);
+    triagonal_test << 1, 2, 0, 4, 5, 6;
+    auto model_parameters = GQCP::constructHubbardModelParameters(triagonal_test, 0.5);
+
+    Eigen::MatrixXd h_ref (3, 3);
+    h_ref << 0, 2, 0,
+             2, 0, 5,
+             0, 5, 0;
+
+    Eigen::VectorXd U_ref (3);
+    U_ref << 1, 4, 6;
+
+    // Only neighbouring sites (i.e. with a non-zero hopping) get an inter-site repulsion
+    Eigen::MatrixXd V_ref (3, 3);
+    V_ref << 0,   0.5, 0,
+             0.5, 0,   0.5,
+             0,   0.5, 0;
+
+    BOOST_CHECK(h_ref.isApprox(Eigen::MatrixXd(model_parameters.get_h())));
+    BOOST_CHECK(U_ref.isApprox(model_parameters.get_U()));
+    BOOST_CHECK(V_ref.isApprox(Eigen::MatrixXd(model_parameters.get_V())));
+    BOOST_CHECK(model_parameters.get_h().nonZeros() == 4);
+
+    // Without inter-site repulsions, the model parameters are equivalent to the dense Hubbard parameters
+    auto hubbard_ham_par = GQCP::constructHubbardParameters(triagonal_test);
+    auto dense_ham_par = GQCP::constructHubbardModelParameters(triagonal_test).constructHamiltonianParameters();
+    BOOST_CHECK(hubbard_ham_par.get_h().get_matrix_representation().isApprox(dense_ham_par.get_h().get_matrix_representation()));
+    BOOST_CHECK(cpputil::linalg::areEqual(hubbard_ham_par.get_g().get_matrix_representation(), dense_ham_par.get_g().get_matrix_representation(), 1.0e-12));
+
+    Eigen::VectorXd triagonal_test_faulty(5);
+    triagonal_test_faulty << 1, 2, 3, 4, 5;
+
+    BOOST_CHECK_THROW(GQCP::constructHubbardModelParameters(triagonal_test_faulty), std::invalid_argument);
+}
@@ -0,0 +1,82 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2018  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#define BOOST_TEST_MODULE "ModelHamiltonianParameters"
+
+
+#include "HamiltonianParameters/ModelHamiltonianParameters.hpp"
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/included/unit_test.hpp>  // include this to get main(), otherwise the compiler will complain
+
+
+
+BOOST_AUTO_TEST_CASE ( ModelHamiltonianParameters_constructor ) {
+
+    Eigen::MatrixXd h (3, 3);
+    h << 0.1, 1.0, 0.0,
+         1.0, 0.2, 1.0,
+         0.0, 1.0, 0.3;
+    Eigen::VectorXd U = Eigen::VectorXd::Constant(3, 4.0);
+
+    Eigen::MatrixXd V (3, 3);
+    V << 0.0, 0.5, 0.0,
+         0.5, 0.0, 0.5,
+         0.0, 0.5, 0.0;
+
+    BOOST_CHECK_NO_THROW(GQCP::ModelHamiltonianParameters (h.sparseView(), U));
+    BOOST_CHECK_NO_THROW(GQCP::ModelHamiltonianParameters (h.sparseView(), U, V.sparseView()));
+
+    // Check if incompatible dimensions throw
+    BOOST_CHECK_THROW(GQCP::ModelHamiltonianParameters (h.sparseView(), Eigen::VectorXd::Zero(4)), std::invalid_argument);
+    BOOST_CHECK_THROW(GQCP::ModelHamiltonianParameters (h.sparseView(), U, Eigen::MatrixXd::Zero(4, 4).sparseView()), std::invalid_argument);
+
+    // Check if a non-symmetric hopping matrix or inter-site repulsion throws
+    Eigen::MatrixXd h_faulty = h;
+    h_faulty(0,1) = 2.0;
+    BOOST_CHECK_THROW(GQCP::ModelHamiltonianParameters (h_faulty.sparseView(), U), std::invalid_argument);
+
+    Eigen::MatrixXd V_faulty = V;
+    V_faulty(1,1) = 1.0;
+    BOOST_CHECK_THROW(GQCP::ModelHamiltonianParameters (h.sparseView(), U, V_faulty.sparseView()), std::invalid_argument);
+}
+
+
+BOOST_AUTO_TEST_CASE ( ModelHamiltonianParameters_constructHamiltonianParameters ) {
+
+    Eigen::MatrixXd h (3, 3);
+    h << 0.1, 1.0, 0.0,
+         1.0, 0.2, 1.0,
+         0.0, 1.0, 0.3;
+    Eigen::VectorXd U (3);
+    U << 4.0, 5.0, 6.0;
+
+    Eigen::MatrixXd V (3, 3);
+    V << 0.0, 0.5, 0.0,
+         0.5, 0.0, 0.7,
+         0.0, 0.7, 0.0;
+
+    GQCP::ModelHamiltonianParameters model_parameters (h.sparseView(), U, V.sparseView());
+    auto ham_par = model_parameters.constructHamiltonianParameters();
+
+    BOOST_CHECK(ham_par.get_h().get_matrix_representation().isApprox(h));
+    BOOST_CHECK(std::abs(ham_par.get_g()(1,1,1,1) - 5.0) < 1.0e-12);
+    BOOST_CHECK(std::abs(ham_par.get_g()(1,1,2,2) - 0.7) < 1.0e-12);
+    BOOST_CHECK(std::abs(ham_par.get_g()(2,2,1,1) - 0.7) < 1.0e-12);
+    BOOST_CHECK(std::abs(ham_par.get_g()(0,0,2,2)) < 1.0e-12);
+    BOOST_CHECK(std::abs(ham_par.get_g()(0,1,0,1)) < 1.0e-12);
+}
@@ -19,8 +19,11 @@
 
 #include "RDM/RDMCalculator.hpp"
 
+#include "RDM/FCIRDMBuilder.hpp"
+
 #include "CISolver/CISolver.hpp"
 #include "HamiltonianBuilder/FCI.hpp"
+#include "HamiltonianBuilder/Hubbard.hpp"
 #include "HamiltonianParameters/HamiltonianParameters_constructors.hpp"
 #include "properties/expectation_values.hpp"
 
@@ -176,3 +179,40 @@ BOOST_AUTO_TEST_CASE ( H2O_energy_RDM_contraction_FCI ) {
 
     BOOST_CHECK(std::abs(energy_by_eigenvalue - energy_by_contraction) < 1.0e-12);
 }
+
+
+BOOST_AUTO_TEST_CASE ( Hubbard_energy_density_density_2RDM ) {
+
+    // The density-density elements of the 2-RDM should be equal to those of the full 2-RDM, and should reproduce the energy of a model Hamiltonian with inter-site repulsions
+    size_t K = 6;
+    Eigen::MatrixXd h = Eigen::MatrixXd::Zero(K, K);
+    Eigen::MatrixXd V = Eigen::MatrixXd::Zero(K, K);
+    for (size_t p = 0; p < K-1; p++) {
+        h(p, p+1) = -1.0;
+        h(p+1, p) = -1.0;
+        V(p, p+1) = 0.5;
+        V(p+1, p) = 0.5;
+    }
+    Eigen::VectorXd U = Eigen::VectorXd::Constant(K, 4.0);
+    GQCP::ModelHamiltonianParameters model_parameters (h.sparseView(), U, V.sparseView());
+
+    GQCP::ProductFockSpace fock_space (K, 3, 2);  // dim = 300
+    GQCP::Hubbard hubbard (fock_space);
+    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> eigensolver (hubbard.constructHamiltonian(model_parameters));
+    double energy = eigensolver.eigenvalues()(0);
+    Eigen::VectorXd coef = eigensolver.eigenvectors().col(0);
+
+    GQCP::FCIRDMBuilder fci_rdm_builder (fock_space);
+    GQCP::OneRDMs one_rdms = fci_rdm_builder.calculate1RDMs(coef);
+    GQCP::TwoRDMs two_rdms = fci_rdm_builder.calculate2RDMs(coef);
+    Eigen::MatrixXd density_density_two_rdm = fci_rdm_builder.calculateDensityDensity2RDM(coef);
+
+    for (size_t p = 0; p < K; p++) {
+        for (size_t q = 0; q < K; q++) {
+            BOOST_CHECK(std::abs(density_density_two_rdm(p,q) - two_rdms.two_rdm(p,p,q,q)) < 1.0e-12);
+        }
+    }
+
+    BOOST_CHECK(std::abs(GQCP::calculateExpectationValue(model_parameters, one_rdms.one_rdm, density_density_two_rdm) - energy) < 1.0e-10);
+    BOOST_CHECK_THROW(fci_rdm_builder.calculateDensityDensity2RDM(Eigen::VectorXd::Zero(2)), std::invalid_argument);
+}
@@ -209,3 +209,50 @@ BOOST_AUTO_TEST_CASE ( two_rdms_doci_H2_6_31G ) {
     BOOST_CHECK(cpputil::linalg::areEqual(two_rdms_s.two_rdm_bbbb.get_matrix_representation(), two_rdms.two_rdm_bbbb.get_matrix_representation(), 1.0e-06));
     BOOST_CHECK(cpputil::linalg::areEqual(two_rdms_s.two_rdm.get_matrix_representation(), two_rdms.two_rdm.get_matrix_representation(), 1.0e-06));
 }
+
+
+BOOST_AUTO_TEST_CASE ( rdms_fci_h2o_sto3g_shuffled ) {
+
+    // Do an H2O@FCI//STO-3G calculation, and check if the RDMs of a selected Fock space that holds the configurations in a different order are equal to the FCI RDMs
+    auto ham_par = GQCP::readFCIDUMPFile("../tests/data/h2o_sto3g_klaas.FCIDUMP");
+    size_t K = ham_par.get_K();  // 7
+
+    GQCP::ProductFockSpace fock_space (K, 5, 5);  // dim = 441
+    GQCP::FCI fci (fock_space);
+
+    GQCP::CISolver ci_solver (fci, ham_par);
+    numopt::eigenproblem::DenseSolverOptions solver_options;
+    ci_solver.solve(solver_options);
+
+    Eigen::VectorXd coef = ci_solver.get_eigenpair().get_eigenvector();
+
+    GQCP::RDMCalculator fci_rdm (fock_space);
+    GQCP::OneRDMs one_rdms = fci_rdm.calculate1RDMs(coef);
+    GQCP::TwoRDMs two_rdms = fci_rdm.calculate2RDMs(coef);
+
+
+    // Add the configurations in reverse order, so that the selected Fock space is not in its canonical layout
+    GQCP::SelectedFockSpace full_selected_fock_space (fock_space);
+    size_t dim = full_selected_fock_space.get_dimension();
+
+    GQCP::SelectedFockSpace selected_fock_space (K, 5, 5);
+    Eigen::VectorXd selected_coef (dim);
+    for (size_t I = 0; I < dim; I++) {
+        const auto& configuration = full_selected_fock_space.get_configuration(dim - 1 - I);
+        selected_fock_space.addConfiguration(configuration.onv_alpha, configuration.onv_beta);
+        selected_coef(I) = coef(dim - 1 - I);
+    }
+
+    GQCP::RDMCalculator selected_rdm (selected_fock_space);
+    GQCP::OneRDMs one_rdms_s = selected_rdm.calculate1RDMs(selected_coef);
+    GQCP::TwoRDMs two_rdms_s = selected_rdm.calculate2RDMs(selected_coef);
+
+
+    BOOST_CHECK(one_rdms_s.one_rdm_aa.get_matrix_representation().isApprox(one_rdms.one_rdm_aa.get_matrix_representation(), 1.0e-08));
+    BOOST_CHECK(one_rdms_s.one_rdm_bb.get_matrix_representation().isApprox(one_rdms.one_rdm_bb.get_matrix_representation(), 1.0e-08));
+
+    BOOST_CHECK(cpputil::linalg::areEqual(two_rdms_s.two_rdm_aaaa.get_matrix_representation(), two_rdms.two_rdm_aaaa.get_matrix_representation(), 1.0e-06));
+    BOOST_CHECK(cpputil::linalg::areEqual(two_rdms_s.two_rdm_aabb.get_matrix_representation(), two_rdms.two_rdm_aabb.get_matrix_representation(), 1.0e-06));
+    BOOST_CHECK(cpputil::linalg::areEqual(two_rdms_s.two_rdm_bbaa.get_matrix_representation(), two_rdms.two_rdm_bbaa.get_matrix_representation(), 1.0e-06));
+    BOOST_CHECK(cpputil::linalg::areEqual(two_rdms_s.two_rdm_bbbb.get_matrix_representation(), two_rdms.two_rdm_bbbb.get_matrix_representation(), 1.0e-06));
+}
@@ -0,0 +1,142 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2018  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#define BOOST_TEST_MODULE "BinaryWaveFunction"
+
+
+#include "WaveFunction/BinaryWaveFunctionReader.hpp"
+#include "WaveFunction/BinaryWaveFunctionWriter.hpp"
+
+#include "WaveFunction/WaveFunctionReader.hpp"
+
+#include <fstream>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/included/unit_test.hpp>  // include this to get main(), otherwise the compiler will complain
+
+
+/**
+ *  @param lhs      a selected Fock space
+ *  @param rhs      another selected Fock space
+ *
+ *  @return if both selected Fock spaces hold the same configurations in the same order
+ */
+bool haveSameConfigurations(const GQCP::SelectedFockSpace& lhs, const GQCP::SelectedFockSpace& rhs) {
+
+    if ((lhs.get_K() != rhs.get_K()) || (lhs.get_N_alpha() != rhs.get_N_alpha()) || (lhs.get_N_beta() != rhs.get_N_beta()) || (lhs.get_dimension() != rhs.get_dimension())) {
+        return false;
+    }
+
+    for (size_t I = 0; I < lhs.get_dimension(); I++) {
+        const auto& lhs_configuration = lhs.get_configuration(I);
+        const auto& rhs_configuration = rhs.get_configuration(I);
+        if ((lhs_configuration.onv_alpha.get_unsigned_representation() != rhs_configuration.onv_alpha.get_unsigned_representation()) || (lhs_configuration.onv_beta.get_unsigned_representation() != rhs_configuration.onv_beta.get_unsigned_representation())) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+BOOST_AUTO_TEST_CASE ( round_trip_GAMESS_expansion ) {
+
+    // Convert the GAMESS expansion to the binary format, and read it back in
+    GQCP::WaveFunctionReader gamess_reader ("../tests/data/test_GAMESS_expansion");
+    GQCP::BinaryWaveFunctionWriter::writeToFile("test_GAMESS_expansion.bin", gamess_reader.get_fock_space(), gamess_reader.get_coefficients());
+
+    GQCP::BinaryWaveFunctionReader binary_reader ("test_GAMESS_expansion.bin");
+    BOOST_CHECK(haveSameConfigurations(binary_reader.get_fock_space(), gamess_reader.get_fock_space()));
+    BOOST_CHECK(binary_reader.get_coefficients() == gamess_reader.get_coefficients());  // the coefficients are stored exactly
+}
+
+
+BOOST_AUTO_TEST_CASE ( round_trip_streaming ) {
+
+    // Stream all configurations of a product Fock space with some coefficients to a file
+    GQCP::SelectedFockSpace fock_space (GQCP::ProductFockSpace(8, 3, 2));
+    size_t dim = fock_space.get_dimension();
+    Eigen::VectorXd coefficients = Eigen::VectorXd::Random(dim);
+
+    {
+        GQCP::BinaryWaveFunctionWriter writer ("test_streaming.bin", 8, 3, 2);
+        for (size_t I = 0; I < dim; I++) {
+            writer.write(fock_space.get_configuration(I), coefficients(I));
+        }
+        BOOST_CHECK_EQUAL(writer.get_number_of_configurations(), dim);
+
+        // Incompatible configurations can't be written
+        GQCP::SelectedFockSpace incompatible_fock_space (8, 2, 2);
+        incompatible_fock_space.addConfiguration("00000011", "00000011");
+        BOOST_CHECK_THROW(writer.write(incompatible_fock_space.get_configuration(0), 1.0), std::invalid_argument);
+    }  // the destructor completes the file
+
+    GQCP::BinaryWaveFunctionReader reader ("test_streaming.bin");
+    BOOST_CHECK(haveSameConfigurations(reader.get_fock_space(), fock_space));
+    BOOST_CHECK(reader.get_coefficients() == coefficients);
+
+    // The read Fock space has a working hash index
+    BOOST_CHECK_EQUAL(reader.get_fock_space().getIndex(fock_space.get_configuration(7).onv_alpha, fock_space.get_configuration(7).onv_beta), 7);
+
+
+    // An empty expansion is valid as well
+    GQCP::BinaryWaveFunctionWriter::writeToFile("test_empty.bin", GQCP::SelectedFockSpace(8, 3, 2), Eigen::VectorXd());
+    GQCP::BinaryWaveFunctionReader empty_reader ("test_empty.bin");
+    BOOST_CHECK_EQUAL(empty_reader.get_fock_space().get_dimension(), 0);
+}
+
+
+BOOST_AUTO_TEST_CASE ( invalid_files ) {
+
+    GQCP::SelectedFockSpace fock_space (GQCP::ProductFockSpace(6, 2, 2));
+    Eigen::VectorXd coefficients = Eigen::VectorXd::Random(fock_space.get_dimension());
+    GQCP::BinaryWaveFunctionWriter::writeToFile("test_valid.bin", fock_space, coefficients);
+
+    std::ifstream valid_file ("test_valid.bin", std::ios::binary);
+    std::string contents ((std::istreambuf_iterator<char>(valid_file)), std::istreambuf_iterator<char>());
+
+
+    // Non-existing files, text files and mismatching coefficients
+    BOOST_CHECK_THROW(GQCP::BinaryWaveFunctionReader("this_file_does_not_exist.bin"), std::runtime_error);
+    BOOST_CHECK_THROW(GQCP::BinaryWaveFunctionReader("../tests/data/test_GAMESS_expansion"), std::invalid_argument);
+    BOOST_CHECK_THROW(GQCP::BinaryWaveFunctionWriter::writeToFile("test_invalid.bin", fock_space, Eigen::VectorXd::Zero(2)), std::invalid_argument);
+
+
+    // A truncated file
+    std::ofstream truncated_file ("test_truncated.bin", std::ios::binary);
+    truncated_file.write(contents.data(), contents.size() - 8);
+    truncated_file.close();
+    BOOST_CHECK_THROW(GQCP::BinaryWaveFunctionReader("test_truncated.bin"), std::invalid_argument);
+
+
+    // A file with a flipped bit in a coefficient
+    std::string corrupted_contents = contents;
+    corrupted_contents[64 + 16] ^= 0x01;  // the first byte of the first coefficient
+    std::ofstream corrupted_file ("test_corrupted.bin", std::ios::binary);
+    corrupted_file.write(corrupted_contents.data(), corrupted_contents.size());
+    corrupted_file.close();
+    BOOST_CHECK_THROW(GQCP::BinaryWaveFunctionReader("test_corrupted.bin"), std::invalid_argument);
+
+
+    // A file with an unsupported version
+    std::string future_contents = contents;
+    future_contents[8] = 2;  // the (little-endian) version
+    std::ofstream future_file ("test_future.bin", std::ios::binary);
+    future_file.write(future_contents.data(), future_contents.size());
+    future_file.close();
+    BOOST_CHECK_THROW(GQCP::BinaryWaveFunctionReader("test_future.bin"), std::invalid_argument);
+}
@@ -0,0 +1,131 @@
+// This file is part of GQCG-gqcp.
+// 
+// Copyright (C) 2017-2018  the GQCG developers
+// 
+// GQCG-gqcp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// GQCG-gqcp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with GQCG-gqcp.  If not, see <http://www.gnu.org/licenses/>.
+// 
+#define BOOST_TEST_MODULE "SparseWaveFunction"
+
+
+#include "WaveFunction/SparseWaveFunction.hpp"
+
+#include "CISolver/CISolver.hpp"
+#include "HamiltonianBuilder/DOCI.hpp"
+#include "HamiltonianBuilder/FCI.hpp"
+#include "HamiltonianParameters/HamiltonianParameters_constructors.hpp"
+#include "RDM/RDMCalculator.hpp"
+
+#include <cpputil.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/included/unit_test.hpp>  // include this to get main(), otherwise the compiler will complain
+
+
+BOOST_AUTO_TEST_CASE ( constructor ) {
+
+    GQCP::FockSpace fock_space (4, 2);  // dim = 6
+    Eigen::VectorXd coefficients (6);
+    coefficients << 0.9, 0.01, -0.3, 0.0, 0.2, -0.001;
+    GQCP::WaveFunction wave_function (fock_space, coefficients);
+
+    // Only the coefficients that are at least the threshold should be retained
+    GQCP::SparseWaveFunction sparse_wave_function (wave_function, 0.1);
+    BOOST_CHECK_EQUAL(sparse_wave_function.get_number_of_configurations(), 3);
+    BOOST_CHECK(sparse_wave_function.get_addresses() == std::vector<size_t>({0, 2, 4}));
+    BOOST_CHECK(std::abs(sparse_wave_function.get_discarded_weight() - (0.01*0.01 + 0.001*0.001)) < 1.0e-12);
+    BOOST_CHECK(std::abs(sparse_wave_function.get_retained_weight() - (0.9*0.9 + 0.3*0.3 + 0.2*0.2)) < 1.0e-12);
+
+    Eigen::VectorXd ref_dense_coefficients (6);
+    ref_dense_coefficients << 0.9, 0.0, -0.3, 0.0, 0.2, 0.0;
+    BOOST_CHECK(sparse_wave_function.calculateDenseCoefficients().isApprox(ref_dense_coefficients));
+
+    sparse_wave_function.normalize();
+    BOOST_CHECK(std::abs(sparse_wave_function.get_retained_weight() - 1.0) < 1.0e-12);
+
+
+    // Addresses should be increasing and in bounds, and match the number of coefficients
+    BOOST_CHECK_NO_THROW(GQCP::SparseWaveFunction(fock_space, {1, 5}, Eigen::Vector2d(0.5, 0.5)));
+    BOOST_CHECK_THROW(GQCP::SparseWaveFunction(fock_space, {5, 1}, Eigen::Vector2d(0.5, 0.5)), std::invalid_argument);
+    BOOST_CHECK_THROW(GQCP::SparseWaveFunction(fock_space, {1, 6}, Eigen::Vector2d(0.5, 0.5)), std::invalid_argument);
+    BOOST_CHECK_THROW(GQCP::SparseWaveFunction(fock_space, {1}, Eigen::Vector2d(0.5, 0.5)), std::invalid_argument);
+}
+
+
+BOOST_AUTO_TEST_CASE ( rdms_fci_h2o_sto3g ) {
+
+    // Do an H2O@FCI//STO-3G calculation
+    auto ham_par = GQCP::readFCIDUMPFile("../tests/data/h2o_sto3g_klaas.FCIDUMP");
+    GQCP::ProductFockSpace fock_space (ham_par.get_K(), 5, 5);  // dim = 441
+    GQCP::FCI fci (fock_space);
+
+    GQCP::CISolver ci_solver (fci, ham_par);
+    numopt::eigenproblem::DenseSolverOptions solver_options;
+    ci_solver.solve(solver_options);
+    GQCP::WaveFunction wave_function (fock_space, ci_solver.get_eigenpair().get_eigenvector());
+
+    GQCP::RDMCalculator rdm_calculator (fock_space);
+    GQCP::OneRDMs one_rdms = rdm_calculator.calculate1RDMs(wave_function.get_coefficients());
+    GQCP::TwoRDMs two_rdms = rdm_calculator.calculate2RDMs(wave_function.get_coefficients());
+
+
+    // Without truncation, the RDMs of the sparse wave function are the FCI RDMs
+    GQCP::SparseWaveFunction full_sparse_wave_function (wave_function, 0.0);
+    BOOST_CHECK_EQUAL(full_sparse_wave_function.get_number_of_configurations(), 441);
+
+    GQCP::OneRDMs one_rdms_sparse = rdm_calculator.calculate1RDMs(full_sparse_wave_function);
+    GQCP::TwoRDMs two_rdms_sparse = rdm_calculator.calculate2RDMs(full_sparse_wave_function);
+    BOOST_CHECK(one_rdms_sparse.one_rdm.get_matrix_representation().isApprox(one_rdms.one_rdm.get_matrix_representation(), 1.0e-08));
+    BOOST_CHECK(cpputil::linalg::areEqual(two_rdms_sparse.two_rdm.get_matrix_representation(), two_rdms.two_rdm.get_matrix_representation(), 1.0e-08));
+
+
+    // With truncation, the RDMs are approximated: their error is of the order of the norm of the discarded coefficients
+    GQCP::SparseWaveFunction sparse_wave_function (wave_function, 1.0e-03);
+    sparse_wave_function.normalize();
+    BOOST_CHECK(sparse_wave_function.get_number_of_configurations() < 441);
+    BOOST_CHECK(sparse_wave_function.get_discarded_weight() < 1.0e-04);
+
+    GQCP::OneRDMs one_rdms_truncated = rdm_calculator.calculate1RDMs(sparse_wave_function);
+    BOOST_CHECK(std::abs(one_rdms_truncated.one_rdm.get_matrix_representation().trace() - 10.0) < 1.0e-10);
+    BOOST_CHECK(one_rdms_truncated.one_rdm.get_matrix_representation().isApprox(one_rdms.one_rdm.get_matrix_representation(), 1.0e-02));
+}
+
+
+BOOST_AUTO_TEST_CASE ( rdms_doci_h2o_sto3g ) {
+
+    // Do an H2O@DOCI//STO-3G calculation
+    auto ham_par = GQCP::readFCIDUMPFile("../tests/data/h2o_sto3g_klaas.FCIDUMP");
+    GQCP::FockSpace fock_space (ham_par.get_K(), 5);  // dim = 21
+    GQCP::DOCI doci (fock_space);
+
+    GQCP::CISolver ci_solver (doci, ham_par);
+    numopt::eigenproblem::DenseSolverOptions solver_options;
+    ci_solver.solve(solver_options);
+    GQCP::WaveFunction wave_function (fock_space, ci_solver.get_eigenpair().get_eigenvector());
+
+    GQCP::RDMCalculator rdm_calculator (fock_space);
+    GQCP::OneRDMs one_rdms = rdm_calculator.calculate1RDMs(wave_function.get_coefficients());
+    GQCP::TwoRDMs two_rdms = rdm_calculator.calculate2RDMs(wave_function.get_coefficients());
+
+    GQCP::SparseWaveFunction sparse_wave_function (wave_function, 0.0);
+    GQCP::OneRDMs one_rdms_sparse = rdm_calculator.calculate1RDMs(sparse_wave_function);
+    GQCP::TwoRDMs two_rdms_sparse = rdm_calculator.calculate2RDMs(sparse_wave_function);
+    BOOST_CHECK(one_rdms_sparse.one_rdm.get_matrix_representation().isApprox(one_rdms.one_rdm.get_matrix_representation(), 1.0e-08));
+    BOOST_CHECK(cpputil::linalg::areEqual(two_rdms_sparse.two_rdm.get_matrix_representation(), two_rdms.two_rdm.get_matrix_representation(), 1.0e-08));
+
+
+    // A sparse wave function of another Fock space can't be used
+    GQCP::ProductFockSpace product_fock_space (ham_par.get_K(), 5, 5);
+    GQCP::SparseWaveFunction other_sparse_wave_function (GQCP::WaveFunction(product_fock_space, Eigen::VectorXd::Ones(441)), 0.0);
+    BOOST_CHECK_THROW(rdm_calculator.calculate1RDMs(other_sparse_wave_function), std::invalid_argument);
+}
@@ -19,6 +19,8 @@
 
 #include "properties/expectation_values.hpp"
 
+#include "HamiltonianParameters/HamiltonianParameters_constructors.hpp"
+
 
 #include <boost/test/unit_test.hpp>
 #include <boost/test/included/unit_test.hpp>
@@ -51,3 +53,33 @@ BOOST_AUTO_TEST_CASE ( two_electron_throw ) {
     BOOST_CHECK_THROW(GQCP::calculateExpectationValue(g, d_invalid), std::invalid_argument);
     BOOST_CHECK_NO_THROW(GQCP::calculateExpectationValue(g, d_valid));
 }
+
+
+BOOST_AUTO_TEST_CASE ( model_hamiltonian_parameters ) {
+
+    // Check if the expectation value of model Hamiltonian parameters is equal to the one of the equivalent dense Hamiltonian parameters
+    Eigen::VectorXd triagonal (10);
+    triagonal << 4.0, -1.0, 0.0, -1.0, 4.0, -1.0, 0.0, 4.0, -1.0, 4.0;
+    auto model_parameters = GQCP::constructHubbardModelParameters(triagonal, 0.5);
+    auto ham_par = model_parameters.constructHamiltonianParameters();
+
+    GQCP::OneRDM D (Eigen::MatrixXd::Random(4, 4));
+    Eigen::Tensor<double, 4> d_tensor (4, 4, 4, 4);
+    d_tensor.setRandom();
+    GQCP::TwoRDM d (d_tensor);
+
+    BOOST_CHECK(std::abs(GQCP::calculateExpectationValue(model_parameters, D, d) - GQCP::calculateExpectationValue(ham_par, D, d)) < 1.0e-12);
+
+    // Only the density-density elements d_ppqq of the 2-RDM are needed
+    Eigen::MatrixXd d_density_density (4, 4);
+    for (size_t p = 0; p < 4; p++) {
+        for (size_t q = 0; q < 4; q++) {
+            d_density_density(p,q) = d(p,p,q,q);
+        }
+    }
+    BOOST_CHECK(std::abs(GQCP::calculateExpectationValue(model_parameters, D, d_density_density) - GQCP::calculateExpectationValue(ham_par, D, d)) < 1.0e-12);
+    BOOST_CHECK_THROW(GQCP::calculateExpectationValue(model_parameters, D, Eigen::MatrixXd::Zero(3, 3)), std::invalid_argument);
+
+    GQCP::OneRDM D_invalid (Eigen::MatrixXd::Zero(3, 3));
+    BOOST_CHECK_THROW(GQCP::calculateExpectationValue(model_parameters, D_invalid, d), std::invalid_argument);
+}